@@ -81,11 +81,15 @@ void setup() {
                      service.service_info->network_type == NTRIP_NETWORK_GOVERNMENT ? "Government" :
                      service.service_info->network_type == NTRIP_NETWORK_COMMERCIAL ? "Commercial" : "Community");
 
-        // Test connectivity
+        // Probe the stream for a few seconds
         Serial.println("\n🔗 Testing connectivity...");
-        result = ntrip_atlas_test_service(&service);
+        ntrip_probe_stats_t probe;
+        result = ntrip_atlas_test_service(&ntrip_platform_esp32, &service, 0, &probe);
         if (result == NTRIP_ATLAS_SUCCESS) {
             Serial.println("✅ Service is accessible and responding");
+            Serial.printf("  Connect: %u ms, first RTCM frame: %u ms, %.1f msg/s\n",
+                         (unsigned)probe.connect_ms, (unsigned)probe.first_frame_ms,
+                         probe.message_rate);
         } else {
             Serial.printf("❌ Service test failed: %s\n", ntrip_atlas_error_string(result));
         }
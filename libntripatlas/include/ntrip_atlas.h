@@ -41,6 +41,35 @@ extern "C" {
     #define NTRIP_ATLAS_MAX_MOUNTPOINTS 256
 #endif
 
+/**
+ * Service index width in bits (8, 16 or 32)
+ * 8-bit keeps per-service structures minimal on embedded targets;
+ * wider indices lift the 255-service ceiling on desktop builds.
+ */
+#ifndef NTRIP_ATLAS_SERVICE_INDEX_BITS
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_SERVICE_INDEX_BITS 8
+    #else
+        #define NTRIP_ATLAS_SERVICE_INDEX_BITS 16
+    #endif
+#endif
+
+#if NTRIP_ATLAS_SERVICE_INDEX_BITS == 8
+typedef uint8_t ntrip_service_idx_t;
+#define NTRIP_SERVICE_INDEX_INVALID UINT8_MAX
+#elif NTRIP_ATLAS_SERVICE_INDEX_BITS == 16
+typedef uint16_t ntrip_service_idx_t;
+#define NTRIP_SERVICE_INDEX_INVALID UINT16_MAX
+#elif NTRIP_ATLAS_SERVICE_INDEX_BITS == 32
+typedef uint32_t ntrip_service_idx_t;
+#define NTRIP_SERVICE_INDEX_INVALID UINT32_MAX
+#else
+#error "NTRIP_ATLAS_SERVICE_INDEX_BITS must be 8, 16 or 32"
+#endif
+
+// Highest usable service index (NTRIP_SERVICE_INDEX_INVALID is reserved)
+#define NTRIP_SERVICE_INDEX_MAX (NTRIP_SERVICE_INDEX_INVALID - 1)
+
 /**
  * Error codes
  */
@@ -69,7 +98,9 @@ typedef enum {
     NTRIP_ATLAS_ERROR_NO_METADATA = -19,         // Service metadata not available
     NTRIP_ATLAS_ERROR_LOAD_FAILED = -20,         // Data loading operation failed
     NTRIP_ATLAS_ERROR_SPATIAL_INDEX_FULL = -21,  // Maximum number of tiles reached
-    NTRIP_ATLAS_ERROR_TILE_FULL = -22            // Maximum services per tile reached
+    NTRIP_ATLAS_ERROR_TILE_FULL = -22,           // Maximum services per tile reached
+    // Non-blocking I/O
+    NTRIP_ATLAS_ERROR_WOULD_BLOCK = -23          // No progress possible until the socket is ready
 } ntrip_atlas_error_t;
 
 /**
@@ -113,6 +144,7 @@ typedef struct {
     uint8_t requires_registration;
     uint8_t typical_free_access;
     uint8_t quality_rating;  // 1-5 stars
+    uint8_t sourcetable_filter;  // Caster accepts NTRIP 2.0 sourcetable filter queries
 
     // Geographic coverage
     double coverage_lat_min;
@@ -243,14 +275,23 @@ typedef struct __attribute__((packed)) {
 #define NTRIP_FLAG_FREE_ACCESS      (1 << 4)  // Free/community access
 #define NTRIP_FLAG_GLOBAL_SERVICE   (1 << 5)  // Global coverage service - skip spatial indexing
 #define NTRIP_FLAG_PAID_SERVICE     (1 << 6)  // Commercial paid service - check credentials
+#define NTRIP_FLAG_SOURCETABLE_FILTER (1 << 7)  // NTRIP 2.0 caster filters sourcetables server-side
 
 /**
  * Geographic blacklisting structures for avoiding repeated queries
  * to services outside their coverage areas
  */
 
-// Maximum services that can have geographic blacklists
-#define NTRIP_MAX_SERVICES 32
+// Blacklisted regions held at once, shared by all services and keyed by
+// service index (at most 8 per service; the oldest region is replaced when
+// full). Follows the index width: 8-bit builds keep 32 (~3KB), wider ones 64.
+#ifndef NTRIP_GEO_BLACKLIST_MAX_ENTRIES
+    #if NTRIP_ATLAS_SERVICE_INDEX_BITS == 8
+        #define NTRIP_GEO_BLACKLIST_MAX_ENTRIES 32
+    #else
+        #define NTRIP_GEO_BLACKLIST_MAX_ENTRIES 64
+    #endif
+#endif
 
 // Geographic blacklist entry for a specific region
 typedef struct {
@@ -280,22 +321,24 @@ typedef struct {
 } ntrip_geo_filtering_stats_t;
 
 /**
- * Compact failure storage for memory-constrained systems (6 bytes vs 80 bytes)
- * Provides 93% memory reduction for ESP32 deployments
+ * Compact failure storage for memory-constrained systems (5 bytes vs 80 bytes
+ * with 8-bit service indices, 8 bytes with 32-bit ones)
+ * Provides 94% memory reduction for ESP32 deployments
  */
 typedef struct __attribute__((packed)) {
-    uint8_t service_index;       // 1 byte - index into service table (0-255)
-    uint8_t backoff_level : 4;   // 4 bits - exponential backoff level (0-15)
-    uint8_t failure_count : 4;   // 4 bits - failure count (0-15, saturates at 15)
-    uint32_t retry_time_hours;   // 4 bytes - hours since epoch when retry allowed
-} ntrip_compact_failure_t;       // 6 bytes total
+    ntrip_service_idx_t service_index; // 1-4 bytes - index into service table
+    uint32_t retry_time_hours : 24;    // 24 bits - hours since epoch when retry allowed
+                                       // (32-bit epoch seconds never need more)
+    uint32_t backoff_level : 4;        // 4 bits - exponential backoff level (0-15)
+    uint32_t failure_count : 4;        // 4 bits - failure count (0-15, saturates at 15)
+} ntrip_compact_failure_t;       // 4 bytes + service index
 
 /**
  * Service index mapping for compact failure storage
  */
 typedef struct {
     char service_id[32];         // Service identifier (shortened)
-    uint8_t service_index;       // Compact index (0-255)
+    ntrip_service_idx_t service_index; // Compact index
 } ntrip_service_index_entry_t;
 
 /**
@@ -323,6 +366,36 @@ typedef int (*ntrip_stream_callback_t)(
     void* context
 );
 
+/**
+ * Non-blocking transport for poll-driven discovery
+ *
+ * No call may wait on the network. send() and recv() return
+ * NTRIP_ATLAS_ERROR_WOULD_BLOCK when the socket is not ready; send() also
+ * does so while connect() is still in progress.
+ */
+typedef struct {
+    // Start connecting; *connection is valid on success even if not yet connected
+    int (*connect)(const char* host, uint16_t port, uint8_t ssl, void** connection);
+
+    // Bytes written (possibly fewer than len) or negative error
+    int (*send)(void* connection, const char* data, size_t len);
+
+    // Bytes read, 0 when the peer closed, or negative error
+    int (*recv)(void* connection, char* buffer, size_t max_len);
+
+    // Descriptor to wait on, or -1 if the connection has none (optional, can be NULL).
+    // *want_write arrives as the caller's direction; a transport still
+    // connecting or in a TLS handshake may change it.
+    int (*poll_fd)(void* connection, bool* want_write);
+
+    void (*close)(void* connection);
+
+    // Block until the connection may make progress in the given direction
+    // or timeout_ms passes (optional, can be NULL; blocking helpers then
+    // keep stepping)
+    void (*wait)(void* connection, bool want_write, uint32_t timeout_ms);
+} ntrip_nb_transport_t;
+
 /**
  * Platform abstraction interface (v2.0 - streaming support)
  */
@@ -363,6 +436,9 @@ typedef struct {
     // Time functions
     uint32_t (*get_time_ms)(void);
     uint32_t (*get_time_seconds)(void);  // For failure tracking timestamps
+
+    // Non-blocking transport for ntrip_atlas_discovery_*() (optional, can be NULL)
+    const ntrip_nb_transport_t* nb_transport;
 } ntrip_platform_t;
 
 /**
@@ -411,6 +487,7 @@ ntrip_atlas_error_t ntrip_atlas_set_credentials(const char* service_id,
  */
 typedef struct {
     uint8_t count;
+    uint32_t generation;  // Changes whenever the set of services changes
     struct {
         char service_id[32];
         char username[NTRIP_ATLAS_MAX_USERNAME];
@@ -529,7 +606,8 @@ ntrip_atlas_error_t ntrip_atlas_get_compact_memory_stats(
 
 /**
  * Geographic Blacklisting Functions
- * Avoid repeated queries to services outside their coverage areas
+ * Avoid repeated queries to services outside their coverage areas.
+ * Services are identified by service index, as in compact failure tracking.
  */
 
 /**
@@ -541,7 +619,7 @@ ntrip_atlas_error_t ntrip_atlas_init_geographic_blacklist(void);
  * Add a geographic region to service blacklist (when service reports no coverage)
  */
 ntrip_atlas_error_t ntrip_atlas_blacklist_service_region(
-    const char* provider,
+    ntrip_service_idx_t service_index,
     double latitude,
     double longitude,
     const char* error_reason
@@ -551,7 +629,7 @@ ntrip_atlas_error_t ntrip_atlas_blacklist_service_region(
  * Check if a service is blacklisted for a geographic region
  */
 bool ntrip_atlas_is_service_geographically_blacklisted(
-    const char* provider,
+    ntrip_service_idx_t service_index,
     double latitude,
     double longitude
 );
@@ -560,7 +638,7 @@ bool ntrip_atlas_is_service_geographically_blacklisted(
  * Remove geographic blacklist entry for a service
  */
 ntrip_atlas_error_t ntrip_atlas_remove_geographic_blacklist(
-    const char* provider,
+    ntrip_service_idx_t service_index,
     double latitude,
     double longitude
 );
@@ -568,13 +646,23 @@ ntrip_atlas_error_t ntrip_atlas_remove_geographic_blacklist(
 /**
  * Clear all geographic blacklist entries for a service
  */
-ntrip_atlas_error_t ntrip_atlas_clear_service_geographic_blacklist(const char* provider);
+ntrip_atlas_error_t ntrip_atlas_clear_service_geographic_blacklist(ntrip_service_idx_t service_index);
 
 /**
  * Clear all geographic blacklist entries (for testing/reset)
  */
 ntrip_atlas_error_t ntrip_atlas_clear_all_geographic_blacklists(void);
 
+/**
+ * Check if a service has any blacklisted regions
+ */
+bool ntrip_atlas_has_geographic_blacklist(ntrip_service_idx_t service_index);
+
+/**
+ * Blacklist generation; changes only when a region is added or removed
+ */
+uint32_t ntrip_atlas_get_geographic_blacklist_generation(void);
+
 /**
  * Get blacklist statistics for monitoring
  */
@@ -584,6 +672,7 @@ ntrip_atlas_error_t ntrip_atlas_get_geographic_blacklist_stats(
 
 /**
  * Filter service list to remove geographically blacklisted services
+ * (a service's position in the list is its service index)
  */
 size_t ntrip_atlas_filter_geographically_blacklisted_services(
     const ntrip_service_compact_t* services,
@@ -619,6 +708,8 @@ double ntrip_atlas_calculate_distance_to_service_center(
 
 /**
  * Calculate distance to nearest edge of service coverage area
+ * Exact great-circle distance to the closest point of the bounding box,
+ * 0 when the user is inside it.
  */
 double ntrip_atlas_calculate_distance_to_coverage_edge(
     const ntrip_service_compact_t* service,
@@ -641,6 +732,8 @@ size_t ntrip_atlas_filter_services_by_coverage(
 
 /**
  * Filter and sort services by geographic proximity
+ * Distance to each service is computed once; no global state, safe to call
+ * concurrently on separate arrays.
  */
 size_t ntrip_atlas_filter_and_sort_services_by_location(
     ntrip_service_compact_t* services,
@@ -650,6 +743,33 @@ size_t ntrip_atlas_filter_and_sort_services_by_location(
     double max_distance_km
 );
 
+/**
+ * Filter services by location and keep only the nearest few, in order
+ * Ranks by coverage center as Q30 unit vectors (see Precomputed Service
+ * Geometry): the user position is converted once, each center once, and
+ * comparisons are integer. Uses a partial sort (O(n log k)) when
+ * max_results is smaller than the number of services that pass the filter. Sort keys for more than 32
+ * services come from the heap (ntrip_atlas_filter_and_sort_nearest_services_in()
+ * takes a workspace instead). When malloc fails, or under
+ * NTRIP_ATLAS_STATIC_ALLOCATION, the same order is found by an
+ * allocation-free O(n * k) selection.
+ * @param services Service array, filtered and reordered in place
+ * @param service_count Number of services in array
+ * @param user_latitude User latitude
+ * @param user_longitude User longitude
+ * @param max_distance_km Maximum distance to coverage edge for inclusion
+ * @param max_results Number of nearest services wanted
+ * @return Number of services in services[0..n) ordered by distance
+ */
+size_t ntrip_atlas_filter_and_sort_nearest_services(
+    ntrip_service_compact_t* services,
+    size_t service_count,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km,
+    size_t max_results
+);
+
 /**
  * Get geographic coverage statistics
  */
@@ -662,9 +782,209 @@ ntrip_atlas_error_t ntrip_atlas_get_geographic_filtering_stats(
 );
 
 /**
- * Test connectivity to a specific service
+ * Precomputed Service Geometry
+ * Per-service coverage center as a fixed-point unit vector plus a bounding
+ * radius, emitted by the generator alongside the service table. The user
+ * position is converted once per lookup; distance ranking and "could this
+ * service beat the current best" tests are then integer multiply-adds.
+ */
+
+// Fixed-point scale for unit vector components and cosines (Q30)
+#define NTRIP_GEOMETRY_Q30_ONE  (1L << 30)
+
+/**
+ * Point on the unit sphere (ECEF direction), components in Q30
+ */
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+} ntrip_unit_vector_t;           // 12 bytes
+
+/**
+ * Precomputed coverage geometry for one service (parallel to service table)
+ */
+typedef struct {
+    ntrip_unit_vector_t center;  // 12 bytes - Coverage box center
+    int32_t cos_radius_q30;      // 4 bytes - cos(radius angle), Q30
+    int32_t sin_radius_q30;      // 4 bytes - sin(radius angle), Q30
+    uint16_t radius_km;          // 2 bytes - Radius enclosing the coverage box
+    uint16_t reserved;           // 2 bytes - Padding
+} ntrip_service_geometry_t;      // 24 bytes
+
+/**
+ * Precomputed distance threshold for pruning tests
+ * Build once per threshold (e.g. whenever the current best changes)
+ */
+typedef struct {
+    double distance_km;
+    int32_t cos_q30;             // cos(distance angle), Q30
+    int32_t sin_q30;             // sin(distance angle), Q30
+} ntrip_distance_bound_t;
+
+/**
+ * Convert lat/lon in decimal degrees to a Q30 unit vector
+ */
+void ntrip_atlas_lat_lon_to_unit_vector(
+    double latitude,
+    double longitude,
+    ntrip_unit_vector_t* vector
+);
+
+/**
+ * Compute geometry for a service at runtime (generator emits the same values)
+ */
+ntrip_atlas_error_t ntrip_atlas_compute_service_geometry(
+    const ntrip_service_compact_t* service,
+    ntrip_service_geometry_t* geometry
+);
+
+/**
+ * Cosine of the angle between two unit vectors in Q60
+ * Larger means closer; rank services without any trig calls.
+ */
+int64_t ntrip_atlas_unit_vector_dot(
+    const ntrip_unit_vector_t* a,
+    const ntrip_unit_vector_t* b
+);
+
+/**
+ * Great-circle distance from user to service coverage center
+ * @param geometry Precomputed service geometry
+ * @param user User position from ntrip_atlas_lat_lon_to_unit_vector()
+ * @return Distance in kilometers, INFINITY on invalid parameters
  */
-ntrip_atlas_error_t ntrip_atlas_test_service(const ntrip_best_service_t* service);
+double ntrip_atlas_geometry_distance_to_center(
+    const ntrip_service_geometry_t* geometry,
+    const ntrip_unit_vector_t* user
+);
+
+/**
+ * Build a distance bound for ntrip_atlas_geometry_may_be_within()
+ */
+ntrip_atlas_error_t ntrip_atlas_make_distance_bound(
+    double distance_km,
+    ntrip_distance_bound_t* bound
+);
+
+/**
+ * Check if any part of a service's coverage could be within a distance
+ * Conservative: false means the whole coverage circle is farther than the
+ * bound, so the service can be skipped without computing its distance.
+ */
+bool ntrip_atlas_geometry_may_be_within(
+    const ntrip_service_geometry_t* geometry,
+    const ntrip_unit_vector_t* user,
+    const ntrip_distance_bound_t* bound
+);
+
+/**
+ * Calculate distance to coverage edge for every service in one pass
+ * Services that O(1) bounds (latitude gap, and center distance minus
+ * bounding radius when geometry is given) place beyond max_distance_km are
+ * rejected without computing an exact distance.
+ * @param services Service array
+ * @param geometry Precomputed geometry parallel to services (NULL to skip)
+ * @param service_count Number of services
+ * @param user_latitude User latitude
+ * @param user_longitude User longitude
+ * @param max_distance_km Maximum distance to coverage edge
+ * @param distances_km Output per-service distance (INFINITY if beyond max)
+ * @return Number of services within max_distance_km
+ */
+size_t ntrip_atlas_calculate_coverage_edge_distances(
+    const ntrip_service_compact_t* services,
+    const ntrip_service_geometry_t* geometry,
+    size_t service_count,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km,
+    double* distances_km
+);
+
+/**
+ * Fixed-Point Geometry
+ * Integer-only backend for targets without an FPU: int32 microdegree
+ * coordinates, CORDIC sin/cos/atan2 on binary angles (2^32 = one turn) and
+ * squared-chord distances finished with one integer square root. With
+ * NTRIP_ATLAS_FIXED_POINT_GEOMETRY set, every distance and coverage
+ * routine in the library runs on it; double-based entry points only
+ * convert their arguments.
+ */
+#ifndef NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    #if defined(CONFIG_IDF_TARGET_ESP32C2) || defined(CONFIG_IDF_TARGET_ESP32C3) || \
+        defined(CONFIG_IDF_TARGET_ESP32C6) || defined(ESP8266)
+        #define NTRIP_ATLAS_FIXED_POINT_GEOMETRY 1
+    #else
+        #define NTRIP_ATLAS_FIXED_POINT_GEOMETRY 0
+    #endif
+#endif
+
+// Degrees to int32 microdegrees (rounded)
+#define NTRIP_ATLAS_DEG_TO_MICRODEG(deg) \
+    ((int32_t)((deg) >= 0 ? (deg) * 1e6 + 0.5 : (deg) * 1e6 - 0.5))
+
+// Stored deg100 coordinates to microdegrees (exact, no floating point)
+#define NTRIP_ATLAS_DEG100_TO_MICRODEG(deg100) ((int32_t)(deg100) * 10000)
+
+// Great-circle distance in km to the angle it subtends in microdegrees (R = 6371 km)
+#define NTRIP_ATLAS_MICRODEG_PER_KM 8993.216059187306
+
+/**
+ * Sine and cosine of an angle in microdegrees, Q30
+ */
+void ntrip_atlas_fixed_sin_cos(int32_t angle_microdeg, int32_t* sin_q30, int32_t* cos_q30);
+
+/**
+ * Angle of (x, y) as a binary angle (2^32 = 360°, signed)
+ */
+int32_t ntrip_atlas_fixed_atan2(int64_t y, int64_t x);
+
+/**
+ * Integer square root (floor)
+ */
+uint32_t ntrip_atlas_fixed_isqrt64(uint64_t value);
+
+/**
+ * Convert microdegree lat/lon to a Q30 unit vector without floating point
+ */
+void ntrip_atlas_fixed_unit_vector(
+    int32_t latitude_microdeg,
+    int32_t longitude_microdeg,
+    ntrip_unit_vector_t* vector
+);
+
+/**
+ * Great-circle distance between two unit vectors in meters
+ */
+uint32_t ntrip_atlas_fixed_vector_distance_m(
+    const ntrip_unit_vector_t* a,
+    const ntrip_unit_vector_t* b
+);
+
+/**
+ * Great-circle distance between two microdegree positions in meters
+ */
+uint32_t ntrip_atlas_fixed_distance_m(
+    int32_t lat1_microdeg,
+    int32_t lon1_microdeg,
+    int32_t lat2_microdeg,
+    int32_t lon2_microdeg
+);
+
+/**
+ * Binary angle subtended by a great-circle distance in meters
+ */
+uint32_t ntrip_atlas_fixed_meters_to_angle(uint32_t meters);
+
+/**
+ * Check if a microdegree position lies inside a service's coverage box
+ */
+bool ntrip_atlas_fixed_is_within_coverage(
+    const ntrip_service_compact_t* service,
+    int32_t latitude_microdeg,
+    int32_t longitude_microdeg
+);
 
 /**
  * Get all available services in a region
@@ -711,7 +1031,7 @@ uint32_t ntrip_atlas_get_service_retry_time(const char* service_id);
 
 /**
  * Compact Failure Tracking API (Memory-optimized for ESP32)
- * Reduces memory usage from 80 bytes to 6 bytes per service (93% reduction)
+ * Reduces memory usage from 80 bytes to 5 bytes per service (94% reduction)
  */
 
 /**
@@ -724,38 +1044,59 @@ ntrip_atlas_error_t ntrip_atlas_init_compact_failure_tracking(
     size_t mapping_count
 );
 
+/**
+ * Initialize compact failure tracking over caller-provided storage
+ * Sizes the failure table to the real database (e.g. NTRIP_GENERATED_SERVICE_COUNT)
+ * instead of the built-in NTRIP_COMPACT_MAX_SERVICES table.
+ * @param service_mapping Array of service ID to index mappings
+ * @param mapping_count Number of entries in service_mapping array
+ * @param storage Failure records, indexed by service index; must outlive tracking
+ * @param capacity Records in storage (greater than every mapped service index)
+ */
+ntrip_atlas_error_t ntrip_atlas_init_compact_failure_tracking_with_storage(
+    const ntrip_service_index_entry_t* service_mapping,
+    size_t mapping_count,
+    ntrip_compact_failure_t* storage,
+    size_t capacity
+);
+
 /**
  * Convert service ID string to compact index
  * @param service_id Service identifier string
- * @return Service index (0-255) or 255 if not found
+ * @return Service index or NTRIP_SERVICE_INDEX_INVALID if not found
  */
-uint8_t ntrip_atlas_get_service_index(const char* service_id);
+ntrip_service_idx_t ntrip_atlas_get_service_index(const char* service_id);
 
 /**
  * Record a service failure using compact storage
  * @param service_index Service index (from ntrip_atlas_get_service_index)
  */
-ntrip_atlas_error_t ntrip_atlas_record_compact_failure(uint8_t service_index);
+ntrip_atlas_error_t ntrip_atlas_record_compact_failure(ntrip_service_idx_t service_index);
 
 /**
  * Record service success using compact storage (resets failure count)
  * @param service_index Service index
  */
-ntrip_atlas_error_t ntrip_atlas_record_compact_success(uint8_t service_index);
+ntrip_atlas_error_t ntrip_atlas_record_compact_success(ntrip_service_idx_t service_index);
 
 /**
  * Check if service is blocked using compact storage
  * @param service_index Service index
  * @return true if service is currently in backoff
  */
-bool ntrip_atlas_is_compact_service_blocked(uint8_t service_index);
+bool ntrip_atlas_is_compact_service_blocked(ntrip_service_idx_t service_index);
 
 /**
  * Get retry time for compact service (hours until retry allowed)
  * @param service_index Service index
  * @return Hours until retry allowed (0 if available now)
  */
-uint32_t ntrip_atlas_get_compact_retry_time_hours(uint8_t service_index);
+uint32_t ntrip_atlas_get_compact_retry_time_hours(ntrip_service_idx_t service_index);
+
+/**
+ * Failure-state generation; changes on every recorded failure or success
+ */
+uint32_t ntrip_atlas_get_compact_failure_generation(void);
 
 /**
  * Convert compact failure to full failure structure (for debugging/analysis)
@@ -824,8 +1165,8 @@ ntrip_atlas_error_t ntrip_atlas_clear_failure_history(void);
 #define NTRIP_DB_FEATURE_GEOGRAPHIC_INDEX   0x02  // Geographic indexing
 #define NTRIP_DB_FEATURE_TIERED_LOADING     0x04  // Tiered data loading
 #define NTRIP_DB_FEATURE_EXTENDED_AUTH      0x08  // Extended auth methods
-#define NTRIP_DB_FEATURE_RESERVED_1         0x10  // Future use
-#define NTRIP_DB_FEATURE_RESERVED_2         0x20  // Future use
+#define NTRIP_DB_FEATURE_COMPRESSED_METADATA 0x10 // Tier 3 records compressed against a shared dictionary
+#define NTRIP_DB_FEATURE_PACKED_INDEX      0x20  // Tier 1 in the packed v2 encoding
 #define NTRIP_DB_FEATURE_RESERVED_3         0x40  // Future use
 #define NTRIP_DB_FEATURE_EXPERIMENTAL       0x80  // Experimental features
 
@@ -951,10 +1292,11 @@ ntrip_atlas_error_t ntrip_atlas_init_with_version_check(
 
 /**
  * Tier 1: Discovery Index (Essential data for service selection)
- * Memory usage: 16 bytes per service (95% reduction from full data)
+ * Memory usage: 14 bytes plus the service index per service
+ * (95% reduction from full data)
  */
 typedef struct __attribute__((packed)) {
-    uint8_t service_index;       // 1 byte - Index into full service table
+    ntrip_service_idx_t service_index; // 1-4 bytes - Index into full service table
     int16_t lat_center_deg100;   // 2 bytes - Center latitude * 100
     int16_t lon_center_deg100;   // 2 bytes - Center longitude * 100
     uint8_t radius_km;           // 1 byte - Coverage radius (0-255km)
@@ -964,7 +1306,7 @@ typedef struct __attribute__((packed)) {
     uint8_t requires_registration; // 1 byte - Boolean
     uint8_t ssl_available;       // 1 byte - Boolean
     char provider_short[4];      // 4 bytes - Short provider name
-} ntrip_service_index_t;         // 16 bytes total
+} ntrip_service_index_t;         // 15 bytes with 8-bit indices
 
 /**
  * Tier 2: Service Endpoints (Loaded when service selected for connection)
@@ -992,6 +1334,20 @@ typedef struct {
     char coverage_notes[256];    // Coverage area notes
 } ntrip_service_metadata_t;      // ~800 bytes
 
+/**
+ * Default tiered cache budgets in bytes (overridable at build time, or per
+ * init through ntrip_tiered_platform_t). Each cached entry costs its payload
+ * plus its service index and a flag byte; the lookup table and borrow pins
+ * outside the budget add under 9 bytes more. Defaults hold 4 endpoint and
+ * 2 metadata entries.
+ */
+#ifndef NTRIP_ATLAS_ENDPOINT_CACHE_BYTES
+#define NTRIP_ATLAS_ENDPOINT_CACHE_BYTES    512
+#endif
+#ifndef NTRIP_ATLAS_METADATA_CACHE_BYTES
+#define NTRIP_ATLAS_METADATA_CACHE_BYTES    1536
+#endif
+
 /**
  * Data loading modes for backward compatibility
  */
@@ -1013,26 +1369,54 @@ typedef struct {
 
     // Load service endpoints (Tier 2) - called per selected service
     ntrip_atlas_error_t (*load_service_endpoints)(
-        uint8_t service_index,
+        ntrip_service_idx_t service_index,
         ntrip_service_endpoints_t* endpoints,
         void* platform_data
     );
 
     // Load service metadata (Tier 3) - called for UI/details only
     ntrip_atlas_error_t (*load_service_metadata)(
-        uint8_t service_index,
+        ntrip_service_idx_t service_index,
         ntrip_service_metadata_t* metadata,
         void* platform_data
     );
 
     void* platform_data;        // Platform-specific context
+
+    // Cache budgets in bytes (0 = NTRIP_ATLAS_*_CACHE_BYTES defaults)
+    size_t endpoint_cache_bytes;
+    size_t metadata_cache_bytes;
 } ntrip_tiered_platform_t;
 
+/**
+ * Tiered cache counters (since initialization)
+ */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint16_t entries;           // Currently cached
+    uint16_t capacity;          // Slots available within the byte budget
+    uint16_t pinned;            // Slots held by outstanding borrows
+} ntrip_tiered_cache_stats_t;
+
+/**
+ * Borrowed reference to a cached Tier 2/3 record
+ * The record is pinned in its cache slot until ntrip_atlas_release_borrow().
+ */
+typedef struct {
+    const void* record;         // Borrowed record (NULL when not held)
+    uint32_t epoch;             // Cache generation at borrow time
+    uint16_t slot;              // Pinned cache slot
+    uint8_t tier;               // 2 = endpoints, 3 = metadata
+} ntrip_tiered_borrow_t;
+
 /**
  * Initialize with tiered data loading for memory optimization
  * @param mode Loading mode (full vs tiered)
  * @param tiered_platform Tiered loading callbacks (NULL for full mode)
- * @return Success/error status
+ * @return Success/error status (INVALID_PARAM if the discovery index holds
+ *         more than NTRIP_SERVICE_INDEX_INVALID entries)
  */
 ntrip_atlas_error_t ntrip_atlas_init_with_loading_mode(
     ntrip_loading_mode_t mode,
@@ -1041,7 +1425,9 @@ ntrip_atlas_error_t ntrip_atlas_init_with_loading_mode(
 
 /**
  * Fast discovery using only Tier 1 data (discovery index)
- * Uses 95% less memory than traditional approach
+ * Uses 95% less memory than traditional approach. Candidates come from a
+ * spatial grid built over the coverage circles when the index is loaded,
+ * so only services near the user are scored.
  * @param result Output best service result
  * @param user_lat User latitude
  * @param user_lon User longitude
@@ -1053,6 +1439,27 @@ ntrip_atlas_error_t ntrip_atlas_find_best_tiered(
     double user_lon
 );
 
+/**
+ * Discovery straight from a packed discovery index (no unpacking, no init)
+ * Scores like ntrip_atlas_find_best_tiered(); records outside the user's
+ * latitude band are skipped after decoding their center only.
+ * @param packed Packed index (ntrip_atlas_pack_discovery_index())
+ * @param packed_size Packed size in bytes
+ * @param user_lat User latitude
+ * @param user_lon User longitude
+ * @param best Output best covering entry
+ * @param distance_km Output distance to its center (nullable)
+ * @return Success/error status (NO_SERVICES if nothing covers the user)
+ */
+ntrip_atlas_error_t ntrip_atlas_find_best_packed(
+    const uint8_t* packed,
+    size_t packed_size,
+    double user_lat,
+    double user_lon,
+    ntrip_service_index_t* best,
+    double* distance_km
+);
+
 /**
  * Load service endpoints on demand (Tier 2)
  * @param service_index Service index from discovery
@@ -1060,7 +1467,7 @@ ntrip_atlas_error_t ntrip_atlas_find_best_tiered(
  * @return Success/error status
  */
 ntrip_atlas_error_t ntrip_atlas_load_service_endpoints(
-    uint8_t service_index,
+    ntrip_service_idx_t service_index,
     ntrip_service_endpoints_t* endpoints
 );
 
@@ -1071,10 +1478,138 @@ ntrip_atlas_error_t ntrip_atlas_load_service_endpoints(
  * @return Success/error status
  */
 ntrip_atlas_error_t ntrip_atlas_load_service_metadata(
-    uint8_t service_index,
+    ntrip_service_idx_t service_index,
     ntrip_service_metadata_t* metadata
 );
 
+/**
+ * Borrow service endpoints from the Tier 2 cache without copying
+ * The pointer stays valid until the borrow is released; its slot is never
+ * evicted or trimmed meanwhile. Release promptly - every pinned slot
+ * shrinks the cache for everyone else.
+ * @param service_index Service index from discovery
+ * @param endpoints Output pointer into the cache
+ * @param borrow Borrow handle to pass to ntrip_atlas_release_borrow()
+ * @return Success/error status (NO_MEMORY when every cache slot is borrowed)
+ */
+ntrip_atlas_error_t ntrip_atlas_borrow_service_endpoints(
+    ntrip_service_idx_t service_index,
+    const ntrip_service_endpoints_t** endpoints,
+    ntrip_tiered_borrow_t* borrow
+);
+
+/**
+ * Borrow service metadata from the Tier 3 cache without copying
+ * @param service_index Service index from discovery
+ * @param metadata Output pointer into the cache
+ * @param borrow Borrow handle to pass to ntrip_atlas_release_borrow()
+ * @return Success/error status (NO_MEMORY when every cache slot is borrowed)
+ */
+ntrip_atlas_error_t ntrip_atlas_borrow_service_metadata(
+    ntrip_service_idx_t service_index,
+    const ntrip_service_metadata_t** metadata,
+    ntrip_tiered_borrow_t* borrow
+);
+
+/**
+ * Release a borrowed record
+ * Borrows that outlived a re-initialization are ignored. The handle is cleared.
+ * @param borrow Borrow handle (NULL or already released is a no-op)
+ */
+void ntrip_atlas_release_borrow(ntrip_tiered_borrow_t* borrow);
+
+/**
+ * Queue Tier 2 endpoints for services likely to be needed soon
+ * Nothing is loaded here; ntrip_atlas_prefetch_step() performs the loads.
+ * ntrip_atlas_find_best_tiered() queues its runners-up automatically.
+ * @param service_indices Services to prefetch (cached or queued ones are skipped)
+ * @param count Number of service indices
+ * @return Number of services newly queued
+ */
+size_t ntrip_atlas_prefetch_endpoints(
+    const ntrip_service_idx_t* service_indices,
+    size_t count
+);
+
+/**
+ * Queue Tier 2 endpoints for services near a moving rover
+ * Covers services whose coverage lies within radius_km of the position,
+ * including those registered in neighbouring grid cells; nearest first.
+ * @param user_lat Current latitude
+ * @param user_lon Current longitude
+ * @param radius_km Look-ahead distance beyond the current position
+ * @return Number of services newly queued
+ */
+size_t ntrip_atlas_prefetch_nearby(
+    double user_lat,
+    double user_lon,
+    double radius_km
+);
+
+/**
+ * Load queued endpoints into the cache (cooperative loader)
+ * Call from an idle loop or low-priority task so that failover to a
+ * fallback caster is served from cache instead of flash or file I/O.
+ * @param max_loads Maximum platform loads to perform in this call
+ * @return Number of endpoints loaded
+ */
+size_t ntrip_atlas_prefetch_step(size_t max_loads);
+
+/**
+ * Get number of services waiting in the prefetch queue
+ * @return Pending prefetch count
+ */
+size_t ntrip_atlas_prefetch_pending(void);
+
+/**
+ * Route point in decimal degrees
+ */
+typedef struct {
+    double latitude;
+    double longitude;
+} ntrip_route_point_t;
+
+/**
+ * One leg of a route plan: the stretch from a handover point to the next
+ */
+typedef struct {
+    ntrip_service_idx_t service_index; // Serving service (when covered)
+    bool covered;                // false = coverage gap, no service
+    uint16_t segment;            // Route segment the leg starts on
+    double start_latitude;       // Handover point
+    double start_longitude;
+    double start_km;             // Distance along the route to the handover
+} ntrip_route_leg_t;
+
+/**
+ * Route plan over caller-provided leg storage
+ */
+typedef struct {
+    ntrip_route_leg_t* legs;     // Caller storage
+    size_t max_legs;
+    size_t leg_count;            // Legs in the plan (may exceed max_legs on NO_MEMORY)
+    double total_km;             // Route length
+    size_t prefetch_queued;      // Endpoints queued for the legs' services
+} ntrip_route_plan_t;
+
+/**
+ * Plan casters and handover points along a route in one call
+ * Walks the polyline through the Tier 1 grid, solves where each segment
+ * enters and leaves every coverage circle it meets, and places handovers
+ * where the ranking of ntrip_atlas_find_best_tiered() changes. Endpoints
+ * of the legs' services are queued for ntrip_atlas_prefetch_step() in
+ * route order, so a device can follow the plan without lookups en route.
+ * @param points Route polyline (at least 2 points)
+ * @param point_count Number of points
+ * @param plan Plan with legs/max_legs set; filled on return
+ * @return Success/error status (NO_MEMORY if the legs did not fit)
+ */
+ntrip_atlas_error_t ntrip_atlas_plan_route(
+    const ntrip_route_point_t* points,
+    size_t point_count,
+    ntrip_route_plan_t* plan
+);
+
 /**
  * Get memory usage statistics for tiered loading
  * @param tier1_bytes Output Tier 1 memory usage
@@ -1088,92 +1623,570 @@ ntrip_atlas_error_t ntrip_atlas_get_tiered_memory_stats(
     size_t* tier3_bytes
 );
 
+/**
+ * Get hit/miss/eviction counters for the tiered caches
+ * @param endpoint_stats Output Tier 2 cache counters (nullable)
+ * @param metadata_stats Output Tier 3 cache counters (nullable)
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_get_tiered_cache_stats(
+    ntrip_tiered_cache_stats_t* endpoint_stats,
+    ntrip_tiered_cache_stats_t* metadata_stats
+);
+
 /**
  * Trim caches under memory pressure (ESP32 optimization)
- * Frees Tier 2/3 cached data while preserving Tier 1 discovery index
+ * Frees Tier 2/3 cached data while preserving Tier 1 discovery index.
+ * Borrowed records are kept in place until released.
+ * Caches living in a workspace keep their storage and only drop entries.
  */
 void ntrip_atlas_trim_caches(void);
 
 /**
- * Get default exponential backoff configuration
- * Returns: 1h, 4h, 12h, 1d, 3d, 1w, 2w, 1month progression
- */
-ntrip_failure_config_t ntrip_atlas_get_default_failure_config(void);
+ * Caller-provided workspace
+ *
+ * A single buffer, sized once by the caller, that discovery, parsing and
+ * sorting draw scratch memory from instead of the heap. Attached with
+ * ntrip_atlas_set_workspace(), tiered loading places its spatial grid,
+ * slot map and caches at the bottom when initialized. Sorting takes its
+ * keys from the workspace passed to
+ * ntrip_atlas_filter_and_sort_nearest_services_in() (which may be the
+ * attached one when only one thread sorts) and returns them before the
+ * call ends. With NTRIP_ATLAS_STATIC_ALLOCATION the library never falls
+ * back to the heap: paths without workspace room degrade or report
+ * NO_MEMORY.
+ */
+#define NTRIP_ATLAS_WORKSPACE_ALIGN 8
+
+// Upper bound on the per-service sort key used by the filter/sort helpers
+#define NTRIP_ATLAS_SORT_KEY_BYTES  16
+
+typedef struct {
+    uint8_t* base;              // Caller's buffer (NTRIP_ATLAS_WORKSPACE_ALIGN aligned)
+    size_t size;
+    size_t used;
+    size_t high_water;          // Peak usage since init
+} ntrip_atlas_workspace_t;
 
 /**
- * Utility Functions
+ * What a workspace must hold; zero fields are not needed
  */
+typedef struct {
+    const ntrip_service_index_t* discovery_index; // Tier 1 that tiered loading will load
+    size_t discovery_count;
+    size_t endpoint_cache_bytes;    // Cache budgets as in ntrip_tiered_platform_t
+    size_t metadata_cache_bytes;    // (0 = defaults; ignored without discovery_index)
+    size_t loader_bytes;            // Drawn by the platform loader itself
+    size_t max_sort_services;       // Largest array passed to the filter/sort helpers
+} ntrip_atlas_workspace_config_t;
 
 /**
- * Calculate distance between two coordinates (Haversine formula)
+ * Bytes a workspace needs for a configuration
+ * @param config Workspace configuration
+ * @return Required size in bytes (0 if config is NULL or the discovery
+ *         index is too large to initialize)
  */
-double ntrip_atlas_calculate_distance(double lat1, double lon1, double lat2, double lon2);
+size_t ntrip_atlas_workspace_required_bytes(const ntrip_atlas_workspace_config_t* config);
 
 /**
- * Format NMEA GGA sentence for VRS position updates
- *
- * Creates a properly formatted NMEA GGA sentence with checksum.
- * Required by many VRS networks to select appropriate virtual reference station.
- *
- * @param buffer        Output buffer for GGA sentence
- * @param max_len       Size of output buffer (recommend 128 bytes minimum)
- * @param latitude      Latitude in decimal degrees (-90 to +90)
- * @param longitude     Longitude in decimal degrees (-180 to +180)
- * @param altitude_m    Altitude in meters above WGS84 ellipsoid
- * @param fix_quality   Fix quality: 0=invalid, 1=GPS, 2=DGPS, 4=RTK fixed, 5=RTK float
- * @param satellites    Number of satellites in use (0-99)
- * @return             Length of formatted sentence, or negative on error
+ * Initialize a workspace over a caller-provided buffer
+ * @param workspace Workspace to initialize
+ * @param buffer Storage aligned to NTRIP_ATLAS_WORKSPACE_ALIGN; must outlive the workspace
+ * @param size Buffer size in bytes
+ * @return Success/error status
  */
-int ntrip_atlas_format_gga(
-    char* buffer,
-    size_t max_len,
-    double latitude,
-    double longitude,
-    double altitude_m,
-    uint8_t fix_quality,
-    uint8_t satellites
+ntrip_atlas_error_t ntrip_atlas_workspace_init(
+    ntrip_atlas_workspace_t* workspace,
+    void* buffer,
+    size_t size
 );
 
 /**
- * Get library version string
+ * Take zeroed, aligned bytes from a workspace
+ * @return Pointer into the workspace, or NULL when it is exhausted
  */
-const char* ntrip_atlas_get_version(void);
+void* ntrip_atlas_workspace_alloc(ntrip_atlas_workspace_t* workspace, size_t bytes);
 
 /**
- * Spatial Indexing System (O(1) Service Discovery)
- * Based on Brad Fitzpatrick's latlong library adaptive grid optimization
+ * Current allocation position, for ntrip_atlas_workspace_release()
  */
+size_t ntrip_atlas_workspace_mark(const ntrip_atlas_workspace_t* workspace);
 
 /**
- * 32-bit tile key for hierarchical spatial indexing
- * Bit layout: [level:3][reserved:3][lat_tile:13][lon_tile:13]
+ * Return everything allocated since a mark
  */
-typedef uint32_t ntrip_tile_key_t;
+void ntrip_atlas_workspace_release(ntrip_atlas_workspace_t* workspace, size_t mark);
 
 /**
- * Spatial index statistics
+ * Attach the workspace tiered loading draws from (NULL = heap)
+ * Takes effect for tiered loading at its next initialization. Platform
+ * loaders may allocate their Tier 1 copy from ntrip_atlas_get_workspace();
+ * that memory is reclaimed when tiered loading is initialized again.
  */
-typedef struct {
-    uint16_t total_tiles;
-    uint16_t populated_tiles;
-    uint16_t total_service_assignments;
-    uint16_t max_services_per_tile;
-    double average_services_per_tile;
-    size_t memory_used_bytes;
-} ntrip_spatial_index_stats_t;
+void ntrip_atlas_set_workspace(ntrip_atlas_workspace_t* workspace);
 
 /**
- * Encode tile coordinates into 32-bit key
+ * Currently attached workspace (NULL if none)
  */
-ntrip_tile_key_t ntrip_atlas_encode_tile_key(uint8_t level, uint16_t lat_tile, uint16_t lon_tile);
+ntrip_atlas_workspace_t* ntrip_atlas_get_workspace(void);
 
 /**
- * Decode tile key into components
+ * As ntrip_atlas_filter_and_sort_nearest_services(), with precomputed
+ * geometry and sort keys taken from a caller-owned workspace
+ * With geometry (e.g. get_generated_service_geometry()) no per-service
+ * trig is left: centers come from the table and far services are rejected
+ * by ntrip_atlas_geometry_may_be_within() before exact edge distances.
+ * Only the services are reordered; geometry is read by original position.
+ * Keys are returned to the workspace before the call ends. A workspace is
+ * not locked: concurrent callers each pass their own. When it has no room
+ * the allocation-free selection is used, never the heap.
+ * @param geometry Geometry parallel to services as passed (NULL = derive
+ *                 centers from the bounding boxes)
+ * @param workspace Scratch for sort keys (NULL = heap)
  */
-void ntrip_atlas_decode_tile_key(ntrip_tile_key_t key, uint8_t* level, uint16_t* lat_tile, uint16_t* lon_tile);
+size_t ntrip_atlas_filter_and_sort_nearest_services_in(
+    ntrip_service_compact_t* services,
+    const ntrip_service_geometry_t* geometry,
+    size_t service_count,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km,
+    size_t max_results,
+    ntrip_atlas_workspace_t* workspace
+);
 
 /**
- * Convert lat/lon coordinates to tile coordinates for given zoom level
+ * Tiered Database File Format
+ * Single image holding all three tiers, designed to be memory mapped
+ * (file on desktop, flash partition on ESP32). Little-endian.
+ *
+ * ┌───────────────────────────────────────┐
+ * │ ntrip_tiered_file_header_t (48 bytes) │
+ * ├───────────────────────────────────────┤
+ * │ Tier 1: tier1_count × tier1_stride    │ ← ntrip_service_index_t array
+ * ├───────────────────────────────────────┤
+ * │ Tier 2: service_count × tier2_stride  │ ← ntrip_service_endpoints_t, by service_index
+ * ├───────────────────────────────────────┤
+ * │ Tier 3 offsets: (service_count + 1)   │ ← uint32_t, relative to blob start
+ * ├───────────────────────────────────────┤
+ * │ Tier 3 blob: metadata records         │ ← see ntrip_atlas_encode_metadata_record()
+ * └───────────────────────────────────────┘
+ *
+ * With NTRIP_DB_FEATURE_PACKED_INDEX, Tier 1 holds a packed discovery index
+ * (tier1_stride 0) running up to the Tier 2 section.
+ *
+ * With NTRIP_DB_FEATURE_COMPRESSED_METADATA the blob starts with a shared
+ * dictionary of offsets[0] bytes, and each record is compressed against it
+ * (ntrip_atlas_compress_metadata_record()), so any single service can be
+ * decompressed on its own.
+ */
+#define NTRIP_TIERED_FILE_MAGIC     0x52454954  // "TIER" in ASCII
+
+typedef struct __attribute__((packed)) {
+    ntrip_db_header_t db;        // 16 bytes - Version header (service_count = Tier 2/3 records)
+    uint32_t layout_magic;       // 4 bytes - NTRIP_TIERED_FILE_MAGIC
+    uint16_t tier1_stride;       // 2 bytes - sizeof(ntrip_service_index_t)
+    uint16_t tier2_stride;       // 2 bytes - sizeof(ntrip_service_endpoints_t)
+    uint32_t tier1_count;        // 4 bytes - Discovery index entries
+    uint32_t tier1_offset;       // 4 bytes - Section offsets from file start
+    uint32_t tier2_offset;       // 4 bytes
+    uint32_t tier3_index_offset; // 4 bytes
+    uint32_t tier3_blob_offset;  // 4 bytes
+    uint32_t tier3_blob_size;    // 4 bytes
+} ntrip_tiered_file_header_t;    // 48 bytes total
+
+/**
+ * Packed Discovery Index (Tier 1 v2)
+ * Header, provider pool (provider_count x 4-char codes), then one record
+ * per service sorted by center latitude:
+ *   varint  latitude delta from the previous record (deg100, first from -9000)
+ *   int16   lon_center_deg100
+ *   uint8   radius_km
+ *   uintN   service_index (index_bytes wide, little-endian)
+ *   uint16  quality:3 network_type:2 auth_method:2 registration:1 ssl:1 provider:7
+ * About 7 bytes per service against 15 for ntrip_service_index_t.
+ * index_bytes is the narrowest width (1, 2 or 4) holding every index, so
+ * files with fewer than 255 services stay readable on 8-bit builds.
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t count;              // 2 bytes - Records
+    uint8_t provider_count;      // 1 byte - Provider pool entries (max 128)
+    uint8_t index_bytes;         // 1 byte - Service index width (0 = 1 byte)
+} ntrip_packed_index_header_t;   // 4 bytes total
+
+/**
+ * Scan position in a packed discovery index
+ * next() decodes only the fields needed to test coverage; the rest of the
+ * record is decoded on request.
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    const char* providers;
+    uint8_t provider_count;
+    uint8_t index_bytes;
+    uint16_t remaining;
+    int16_t lat_center_deg100;   // Current record
+    int16_t lon_center_deg100;
+    uint8_t radius_km;
+    ntrip_service_idx_t service_index;
+    size_t attributes_pos;
+} ntrip_packed_index_cursor_t;
+
+// Largest encoded metadata record (never exceeds the struct it encodes)
+#define NTRIP_METADATA_RECORD_MAX_SIZE  sizeof(ntrip_service_metadata_t)
+
+// Largest compressed record (incompressible data costs 1 byte per 128)
+#define NTRIP_METADATA_COMPRESSED_MAX_SIZE \
+    (NTRIP_METADATA_RECORD_MAX_SIZE + NTRIP_METADATA_RECORD_MAX_SIZE / 128 + 1)
+
+#ifndef NTRIP_METADATA_DICT_MAX_SIZE
+#define NTRIP_METADATA_DICT_MAX_SIZE    1024   // Shared Tier 3 dictionary budget
+#endif
+
+/**
+ * Validate a tiered file header against the size of its image
+ * Checks magic numbers, record strides and that every section lies in bounds.
+ * @param header Header at the start of the image
+ * @param image_size Total image size in bytes
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_validate_tiered_file_header(
+    const ntrip_tiered_file_header_t* header,
+    size_t image_size
+);
+
+/**
+ * Encode metadata as a Tier 3 record
+ * Record: uint32_t last_updated followed by the string fields in struct
+ * order, each NUL-terminated - empty fields cost one byte.
+ * @param metadata Metadata to encode
+ * @param buffer Output buffer (NULL to only measure)
+ * @param buffer_size Output buffer size
+ * @param record_size Output encoded size in bytes
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_encode_metadata_record(
+    const ntrip_service_metadata_t* metadata,
+    uint8_t* buffer,
+    size_t buffer_size,
+    size_t* record_size
+);
+
+/**
+ * Decode a Tier 3 record into metadata
+ * @param record Encoded record
+ * @param record_size Encoded record size in bytes
+ * @param metadata Output metadata structure
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_decode_metadata_record(
+    const uint8_t* record,
+    size_t record_size,
+    ntrip_service_metadata_t* metadata
+);
+
+/**
+ * Pack a discovery index into the v2 encoding
+ * @param index Discovery index (any order)
+ * @param count Number of entries
+ * @param buffer Output buffer (NULL to only measure)
+ * @param buffer_size Output buffer size
+ * @param packed_size Output packed size in bytes
+ * @return Success/error status (INVALID_PARAM if a field does not fit its bits)
+ */
+ntrip_atlas_error_t ntrip_atlas_pack_discovery_index(
+    const ntrip_service_index_t* index,
+    size_t count,
+    uint8_t* buffer,
+    size_t buffer_size,
+    size_t* packed_size
+);
+
+/**
+ * Start scanning a packed discovery index
+ * @param packed Packed index
+ * @param packed_size Packed size in bytes
+ * @param cursor Output cursor, positioned before the first record
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_packed_index_begin(
+    const uint8_t* packed,
+    size_t packed_size,
+    ntrip_packed_index_cursor_t* cursor
+);
+
+/**
+ * Advance to the next record, decoding its center, radius and service index
+ * @param cursor Scan cursor
+ * @return Success, NOT_FOUND past the last record, LOAD_FAILED if corrupt
+ */
+ntrip_atlas_error_t ntrip_atlas_packed_index_next(ntrip_packed_index_cursor_t* cursor);
+
+/**
+ * Fully decode the cursor's current record
+ * @param cursor Scan cursor after a successful next()
+ * @param entry Output discovery index entry
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_packed_index_decode(
+    const ntrip_packed_index_cursor_t* cursor,
+    ntrip_service_index_t* entry
+);
+
+/**
+ * Unpack a packed discovery index into entries (latitude order)
+ * @param packed Packed index
+ * @param packed_size Packed size in bytes
+ * @param index Output entries
+ * @param capacity Output capacity in entries
+ * @param count Output number of entries
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_unpack_discovery_index(
+    const uint8_t* packed,
+    size_t packed_size,
+    ntrip_service_index_t* index,
+    size_t capacity,
+    size_t* count
+);
+
+/**
+ * Build a shared Tier 3 dictionary from strings repeated across services
+ * Picks whole field values and their prefixes/suffixes split at
+ * separators (' ', '/', '.', '@', ',', '-') by bytes saved until full.
+ * @param metadata Metadata of every service
+ * @param count Number of services
+ * @param dictionary Output dictionary
+ * @param dictionary_capacity Dictionary buffer size (see NTRIP_METADATA_DICT_MAX_SIZE)
+ * @param dictionary_size Output dictionary size in bytes
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_build_metadata_dictionary(
+    const ntrip_service_metadata_t* metadata,
+    size_t count,
+    uint8_t* dictionary,
+    size_t dictionary_capacity,
+    size_t* dictionary_size
+);
+
+/**
+ * Compress an encoded Tier 3 record against a shared dictionary
+ * Byte-aligned LZ tokens; back-references may reach into the dictionary.
+ * @param record Encoded record (ntrip_atlas_encode_metadata_record())
+ * @param record_size Encoded record size
+ * @param dictionary Shared dictionary (NULL if dictionary_size is 0)
+ * @param dictionary_size Dictionary size in bytes
+ * @param buffer Output buffer (NTRIP_METADATA_COMPRESSED_MAX_SIZE always fits)
+ * @param buffer_size Output buffer size
+ * @param compressed_size Output compressed size in bytes
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_compress_metadata_record(
+    const uint8_t* record,
+    size_t record_size,
+    const uint8_t* dictionary,
+    size_t dictionary_size,
+    uint8_t* buffer,
+    size_t buffer_size,
+    size_t* compressed_size
+);
+
+/**
+ * Decompress one Tier 3 record into a caller buffer
+ * @param compressed Compressed record
+ * @param compressed_size Compressed size in bytes
+ * @param dictionary Dictionary the record was compressed with
+ * @param dictionary_size Dictionary size in bytes
+ * @param record Output encoded record (NTRIP_METADATA_RECORD_MAX_SIZE always fits)
+ * @param record_capacity Output buffer size
+ * @param record_size Output encoded record size
+ * @return Success/error status (LOAD_FAILED on corrupt input)
+ */
+ntrip_atlas_error_t ntrip_atlas_decompress_metadata_record(
+    const uint8_t* compressed,
+    size_t compressed_size,
+    const uint8_t* dictionary,
+    size_t dictionary_size,
+    uint8_t* record,
+    size_t record_capacity,
+    size_t* record_size
+);
+
+/**
+ * Write a tiered database file (Linux)
+ * @param path Output file path
+ * @param database_version Database version (YYYYMMDD format)
+ * @param index Tier 1 discovery index
+ * @param index_count Discovery index entries
+ * @param endpoints Tier 2 endpoints, indexed by service_index
+ * @param metadata Tier 3 metadata, indexed by service_index
+ * @param service_count Number of endpoint/metadata records
+ * @param encodings NTRIP_DB_FEATURE_PACKED_INDEX and/or
+ *                  NTRIP_DB_FEATURE_COMPRESSED_METADATA (0 = plain v1 layout)
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_tiered_file_write(
+    const char* path,
+    uint32_t database_version,
+    const ntrip_service_index_t* index,
+    size_t index_count,
+    const ntrip_service_endpoints_t* endpoints,
+    const ntrip_service_metadata_t* metadata,
+    size_t service_count,
+    uint8_t encodings
+);
+
+/**
+ * Open a memory-mapped tiered database file as a tiered platform (Linux)
+ * The discovery index is served in place from the mapping; Tier 2 and
+ * Tier 3 loads read directly from it without file I/O.
+ * @param path Tiered database file path
+ * @param tiered_platform Output platform callbacks and context
+ * @return Success/error status
+ */
+ntrip_atlas_error_t ntrip_atlas_tiered_file_open(
+    const char* path,
+    ntrip_tiered_platform_t* tiered_platform
+);
+
+/**
+ * Unmap a tiered database file opened with ntrip_atlas_tiered_file_open()
+ * @param tiered_platform Platform filled by ntrip_atlas_tiered_file_open()
+ */
+void ntrip_atlas_tiered_file_close(ntrip_tiered_platform_t* tiered_platform);
+
+/**
+ * Get default exponential backoff configuration
+ * Returns: 1h, 4h, 12h, 1d, 3d, 1w, 2w, 1month progression
+ */
+ntrip_failure_config_t ntrip_atlas_get_default_failure_config(void);
+
+/**
+ * Utility Functions
+ */
+
+/**
+ * Calculate distance between two coordinates (Haversine formula)
+ */
+double ntrip_atlas_calculate_distance(double lat1, double lon1, double lat2, double lon2);
+
+/**
+ * Convert WGS84 ECEF coordinates (m) to latitude, longitude (degrees) and
+ * ellipsoidal height (m)
+ * @param height Output, may be NULL
+ */
+void ntrip_atlas_ecef_to_geodetic(
+    double x,
+    double y,
+    double z,
+    double* latitude,
+    double* longitude,
+    double* height
+);
+
+/**
+ * Format NMEA GGA sentence for VRS position updates
+ *
+ * Creates a properly formatted NMEA GGA sentence with checksum.
+ * Required by many VRS networks to select appropriate virtual reference station.
+ *
+ * @param buffer        Output buffer for GGA sentence
+ * @param max_len       Size of output buffer (recommend 128 bytes minimum)
+ * @param latitude      Latitude in decimal degrees (-90 to +90)
+ * @param longitude     Longitude in decimal degrees (-180 to +180)
+ * @param altitude_m    Altitude in meters above WGS84 ellipsoid
+ * @param fix_quality   Fix quality: 0=invalid, 1=GPS, 2=DGPS, 4=RTK fixed, 5=RTK float
+ * @param satellites    Number of satellites in use (0-99)
+ * @return             Length of formatted sentence, or negative on error
+ */
+int ntrip_atlas_format_gga(
+    char* buffer,
+    size_t max_len,
+    double latitude,
+    double longitude,
+    double altitude_m,
+    uint8_t fix_quality,
+    uint8_t satellites
+);
+
+/**
+ * Get library version string
+ */
+const char* ntrip_atlas_get_version(void);
+
+/**
+ * Spatial Indexing System (O(1) Service Discovery)
+ * Based on Brad Fitzpatrick's latlong library adaptive grid optimization
+ */
+
+/**
+ * 32-bit tile key for hierarchical spatial indexing
+ * Bit layout: [level:3][reserved:3][lat_tile:13][lon_tile:13]
+ */
+typedef uint32_t ntrip_tile_key_t;
+
+/**
+ * Spatial index tile: a run of service indices in the shared assignment pool
+ */
+typedef struct {
+    ntrip_tile_key_t key;        // 4 bytes
+    uint32_t first;              // 4 bytes - First assignment of this tile
+    uint16_t service_count;      // 2 bytes
+    uint16_t reserved;           // 2 bytes
+} ntrip_spatial_tile_t;          // 12 bytes total
+
+// Storage needed for a spatial index (tiles, then the assignment pool)
+#define NTRIP_SPATIAL_INDEX_STORAGE_SIZE(max_tiles, max_assignments) \
+    ((size_t)(max_tiles) * sizeof(ntrip_spatial_tile_t) + \
+     (size_t)(max_assignments) * sizeof(ntrip_service_idx_t))
+
+// Capacity of the built-in storage behind ntrip_atlas_init_spatial_index().
+// Generated databases emit exact figures (NTRIP_GENERATED_SPATIAL_*) for
+// ntrip_atlas_init_spatial_index_with_storage(); shrink these to match.
+#ifndef NTRIP_ATLAS_SPATIAL_MAX_TILES
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_SPATIAL_MAX_TILES       256
+    #else
+        #define NTRIP_ATLAS_SPATIAL_MAX_TILES       4096
+    #endif
+#endif
+#ifndef NTRIP_ATLAS_SPATIAL_MAX_ASSIGNMENTS
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_SPATIAL_MAX_ASSIGNMENTS 1024
+    #else
+        #define NTRIP_ATLAS_SPATIAL_MAX_ASSIGNMENTS 16384
+    #endif
+#endif
+
+// Finest tile level; lookups start here and widen until a tile has services
+#define NTRIP_SPATIAL_FINEST_LEVEL 4
+
+/**
+ * Spatial index statistics
+ */
+typedef struct {
+    uint16_t total_tiles;
+    uint16_t populated_tiles;
+    uint16_t total_service_assignments;
+    uint16_t max_services_per_tile;
+    double average_services_per_tile;
+    size_t memory_used_bytes;
+} ntrip_spatial_index_stats_t;
+
+/**
+ * Encode tile coordinates into 32-bit key
+ */
+ntrip_tile_key_t ntrip_atlas_encode_tile_key(uint8_t level, uint16_t lat_tile, uint16_t lon_tile);
+
+/**
+ * Decode tile key into components
+ */
+void ntrip_atlas_decode_tile_key(ntrip_tile_key_t key, uint8_t* level, uint16_t* lat_tile, uint16_t* lon_tile);
+
+/**
+ * Convert lat/lon coordinates to tile coordinates for given zoom level
  */
 ntrip_atlas_error_t ntrip_atlas_lat_lon_to_tile(
     double lat,
@@ -1197,16 +2210,36 @@ ntrip_atlas_error_t ntrip_atlas_tile_to_lat_lon_bounds(
 );
 
 /**
- * Initialize spatial index system
+ * Initialize spatial index system (built-in storage)
  */
 ntrip_atlas_error_t ntrip_atlas_init_spatial_index(void);
 
+/**
+ * Spatial index generation; changes on every init or tile assignment
+ */
+uint32_t ntrip_atlas_get_spatial_index_generation(void);
+
+/**
+ * Initialize spatial index system over caller-provided storage
+ * @param storage Buffer aligned for uint32_t; must outlive the index
+ * @param storage_size Buffer size (NTRIP_SPATIAL_INDEX_STORAGE_SIZE)
+ * @param max_tiles Tiles the index may hold
+ * @param max_assignments Service-in-tile entries across all tiles
+ * @return Success, or NO_MEMORY if storage_size is too small
+ */
+ntrip_atlas_error_t ntrip_atlas_init_spatial_index_with_storage(
+    void* storage,
+    size_t storage_size,
+    size_t max_tiles,
+    size_t max_assignments
+);
+
 /**
  * Add service to spatial tile (build-time operation)
  */
 ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(
     ntrip_tile_key_t tile_key,
-    uint8_t service_index
+    ntrip_service_idx_t service_index
 );
 
 /**
@@ -1216,10 +2249,24 @@ ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(
 size_t ntrip_atlas_find_services_by_location_fast(
     double user_lat,
     double user_lon,
-    uint8_t* service_indices,
+    ntrip_service_idx_t* service_indices,
     size_t max_services
 );
 
+/**
+ * Find the tile answering a location and borrow its candidate run
+ * @param tile_key Output: key of the tile that answered (optional)
+ * @param services Output: services in that tile; points into the index
+ *                 and stays valid until the index is next modified
+ * @return Number of services in the tile (0 if none)
+ */
+size_t ntrip_atlas_find_tile_services(
+    double user_lat,
+    double user_lon,
+    ntrip_tile_key_t* tile_key,
+    const ntrip_service_idx_t** services
+);
+
 /**
  * Get spatial index statistics
  */
@@ -1247,10 +2294,22 @@ size_t ntrip_atlas_find_services_spatial_geographic(
     double user_lon,
     const ntrip_service_compact_t* services,
     size_t service_count,
-    uint8_t* found_services,
+    ntrip_service_idx_t* found_services,
     size_t max_services
 );
 
+/**
+ * Score a service for a location (higher is better)
+ *
+ * Quality rating counts 20 points per star; distance to the coverage
+ * center costs one point per km, capped at 100.
+ */
+double ntrip_atlas_score_service_spatial_geographic(
+    const ntrip_service_compact_t* service,
+    double user_lat,
+    double user_lon
+);
+
 /**
  * Find best service using spatial-geographic lookup
  *
@@ -1295,6 +2354,173 @@ ntrip_atlas_error_t ntrip_atlas_get_spatial_geographic_stats(
     size_t* verified_services
 );
 
+/**
+ * Movement-Aware Service Tracking
+ * Follows a moving rover through a stream of positions. Positions inside
+ * the finest tile of the last evaluation, still covered by the current
+ * service and not drifting past the reselect distance cost one distance
+ * check; otherwise the tile's cached candidates are re-scored. A better
+ * service must win by switch_margin for confirm_evaluations evaluations
+ * in a row before the tracker switches, so boundaries do not flap.
+ */
+#define NTRIP_ATLAS_TRACKER_MAX_CANDIDATES 16
+
+/**
+ * Tracker tuning
+ */
+typedef struct {
+    double reselect_distance_km;  // Re-score once the current service is this much farther away
+    double switch_margin;         // Score a challenger must win by
+    uint8_t confirm_evaluations;  // Consecutive wins needed before switching
+} ntrip_tracker_config_t;
+
+/**
+ * Outcome of a tracker update
+ */
+typedef enum {
+    NTRIP_TRACKER_UNCHANGED = 0,  // Still on the same service
+    NTRIP_TRACKER_SELECTED,       // First service chosen
+    NTRIP_TRACKER_SWITCHED,       // Moved to a different service
+    NTRIP_TRACKER_LOST            // No service covers the position any more
+} ntrip_tracker_event_t;
+
+/**
+ * Tracker work counters
+ */
+typedef struct {
+    uint32_t updates;             // Positions fed in
+    uint32_t tile_lookups;        // Spatial index lookups (tile changes)
+    uint32_t evaluations;         // Candidate re-scorings
+    uint32_t switches;            // Service changes after the first selection
+} ntrip_tracker_stats_t;
+
+/**
+ * Session state for one rover (caller-owned)
+ */
+typedef struct {
+    const ntrip_service_compact_t* services;
+    size_t service_count;
+    ntrip_tracker_config_t config;
+
+    // Finest tile of the last lookup and its candidates
+    double tile_lat_min, tile_lat_max;
+    double tile_lon_min, tile_lon_max;
+    ntrip_service_idx_t candidates[NTRIP_ATLAS_TRACKER_MAX_CANDIDATES];
+    uint8_t candidate_count;
+    bool tile_valid;
+
+    // Current selection
+    bool has_current;
+    ntrip_service_idx_t current;
+    double anchor_distance_km;    // Closest distance to the current service since the last re-score
+
+    // Pending switch
+    ntrip_service_idx_t challenger;
+    uint8_t challenger_wins;
+
+    ntrip_tracker_stats_t stats;
+} ntrip_service_tracker_t;
+
+/**
+ * Default tracker tuning (5 km reselect distance, 10 point margin, 2 confirmations)
+ */
+ntrip_tracker_config_t ntrip_atlas_get_default_tracker_config(void);
+
+/**
+ * Start tracking over a service table already loaded into the spatial index
+ * @param config Tuning, or NULL for defaults
+ */
+ntrip_atlas_error_t ntrip_atlas_tracker_init(
+    ntrip_service_tracker_t* tracker,
+    const ntrip_service_compact_t* services,
+    size_t service_count,
+    const ntrip_tracker_config_t* config
+);
+
+/**
+ * Feed the next rover position
+ * @param event Output: what changed (optional)
+ */
+ntrip_atlas_error_t ntrip_atlas_tracker_update(
+    ntrip_service_tracker_t* tracker,
+    double user_lat,
+    double user_lon,
+    ntrip_tracker_event_t* event
+);
+
+/**
+ * Currently selected service
+ * @return Success, or NO_SERVICES if nothing is selected
+ */
+ntrip_atlas_error_t ntrip_atlas_tracker_get_current(
+    const ntrip_service_tracker_t* tracker,
+    ntrip_service_idx_t* service_index
+);
+
+/**
+ * Drop cached tile and selection (call after rebuilding the spatial index)
+ */
+void ntrip_atlas_tracker_reset(ntrip_service_tracker_t* tracker);
+
+/**
+ * Per-Tile Selection Cache
+ * Memoizes the position-independent part of a filtered lookup per finest
+ * tile: candidates that pass the criteria, are not in failure backoff and
+ * are usable with the caller's credentials, pre-ranked by quality. Entries
+ * are keyed on the tile, the criteria and the credential, failure,
+ * blacklist and spatial index generations, so any change to those misses
+ * instead of serving stale results. Tiles with no candidates are cached
+ * too. A repeat lookup is a hash probe plus coverage and distance checks
+ * over the cached candidates.
+ */
+#ifndef NTRIP_ATLAS_SELECTION_CACHE_ENTRIES
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_SELECTION_CACHE_ENTRIES 16
+    #else
+        #define NTRIP_ATLAS_SELECTION_CACHE_ENTRIES 64
+    #endif
+#endif
+
+/**
+ * Selection cache counters
+ */
+typedef struct {
+    uint32_t lookups;
+    uint32_t hits;                // Served from a cached entry
+    uint32_t negative_hits;       // Hits on a tile cached as empty
+    uint32_t misses;              // Entry built from the spatial index
+    uint32_t stale;               // Misses on a tile whose entry was outdated
+} ntrip_selection_cache_stats_t;
+
+/**
+ * Find ranked services for a location through the per-tile cache
+ * @param criteria Filters, or NULL for none (formats, systems and bitrate
+ *                 are mountpoint properties and are not applied here)
+ * @param credentials Credentials for paid services, or NULL
+ * @param ranked Output: service indices, best first
+ * @return Number of services written
+ */
+size_t ntrip_atlas_find_ranked_services_cached(
+    double user_lat,
+    double user_lon,
+    const ntrip_service_compact_t* services,
+    size_t service_count,
+    const ntrip_selection_criteria_t* criteria,
+    const ntrip_credential_store_t* credentials,
+    ntrip_service_idx_t* ranked,
+    size_t max_ranked
+);
+
+/**
+ * Drop every cached tile
+ */
+void ntrip_atlas_selection_cache_clear(void);
+
+/**
+ * Get selection cache counters
+ */
+ntrip_atlas_error_t ntrip_atlas_get_selection_cache_stats(ntrip_selection_cache_stats_t* stats);
+
 /**
  * Print spatial index debug information
  */
@@ -1305,6 +2531,689 @@ void ntrip_atlas_print_spatial_index_debug(void);
  */
 const char* ntrip_atlas_error_string(ntrip_atlas_error_t error);
 
+/**
+ * Sourcetable Fetch Coalescing
+ * Many sessions asking the same caster at once share one download: the
+ * first caller streams the sourcetable into a shared mountpoint table and
+ * the rest wait for it, then every caller scores that table from its own
+ * position and criteria. Results match ntrip_query_service_streaming().
+ * A completed table can also be reused for reuse_ms.
+ */
+#ifndef NTRIP_ATLAS_MAX_COALESCED_FETCHES
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_MAX_COALESCED_FETCHES 2
+    #else
+        #define NTRIP_ATLAS_MAX_COALESCED_FETCHES 16
+    #endif
+#endif
+
+/**
+ * Lock and condition hooks for coalescing across threads
+ * wait() releases the lock while sleeping and holds it again on return,
+ * like pthread_cond_wait(). All NULL means single-threaded use.
+ */
+typedef struct {
+    void* context;
+    void (*lock)(void* context);
+    void (*unlock)(void* context);
+    void (*wait)(void* context);
+    void (*broadcast)(void* context);
+} ntrip_fetch_sync_t;
+
+/**
+ * One caster's sourcetable, fetched once and shared
+ */
+typedef struct {
+    char host[NTRIP_ATLAS_MAX_URL_LEN];
+    uint16_t port;
+    uint8_t ssl;
+    uint8_t state;                // Idle, fetching or complete
+    int status;                   // http_stream() result of the fetch
+    uint32_t completed_ms;
+    uint16_t readers;             // Callers waiting on or scoring this table
+    uint8_t truncated;            // Table filled; later mountpoints were dropped
+    ntrip_mountpoint_t* mountpoints;
+    size_t mountpoint_count;
+    size_t capacity;
+} ntrip_fetch_flight_t;
+
+/**
+ * Coalescing counters
+ */
+typedef struct {
+    uint32_t queries;
+    uint32_t fetches;             // Sourcetables actually downloaded
+    uint32_t coalesced;           // Queries that waited on another caller's fetch
+    uint32_t reused;              // Queries served by a completed fetch within reuse_ms
+    uint32_t uncoalesced;         // Queries that found no free slot and fetched alone
+    uint32_t truncated;           // Fetches that outgrew their table
+} ntrip_fetch_stats_t;
+
+/**
+ * Coalescer shared by all sessions (caller-owned)
+ */
+typedef struct {
+    const ntrip_platform_t* platform;
+    ntrip_fetch_sync_t sync;
+    uint32_t reuse_ms;
+    size_t flight_count;
+    ntrip_fetch_flight_t flights[NTRIP_ATLAS_MAX_COALESCED_FETCHES];
+    ntrip_fetch_stats_t stats;
+} ntrip_fetch_coalescer_t;
+
+/**
+ * Set up a coalescer over caller-provided mountpoint storage
+ * @param sync Locking hooks, or NULL for single-threaded use
+ * @param storage flight_count * mountpoints_per_fetch mountpoints; must
+ *                outlive the coalescer
+ * @param flight_count Casters that can be fetched at once
+ *                     (at most NTRIP_ATLAS_MAX_COALESCED_FETCHES)
+ * @param mountpoints_per_fetch Largest sourcetable to share; size for the
+ *                              biggest caster, extra mountpoints are dropped
+ * @param reuse_ms How long a completed table answers new queries (0 = only
+ *                 while the fetch is in flight)
+ */
+ntrip_atlas_error_t ntrip_atlas_fetch_coalescer_init(
+    ntrip_fetch_coalescer_t* coalescer,
+    const ntrip_platform_t* platform,
+    const ntrip_fetch_sync_t* sync,
+    ntrip_mountpoint_t* storage,
+    size_t flight_count,
+    size_t mountpoints_per_fetch,
+    uint32_t reuse_ms
+);
+
+/**
+ * Query a service, sharing the sourcetable download with concurrent callers
+ * @return 0 on success, negative error code on failure (as
+ *         ntrip_query_service_streaming())
+ */
+int ntrip_query_service_coalesced(
+    ntrip_fetch_coalescer_t* coalescer,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria,
+    ntrip_mountpoint_t* result
+);
+
+/**
+ * HTTP/NTRIP Response Parsing
+ * Allocation-free response state machine shared by every transport, so
+ * all platforms read casters the same way. Accepts NTRIP 2.0 ("HTTP/1.x"),
+ * NTRIP 1.0 sourcetables ("SOURCETABLE 200 OK") and NTRIP 1.0 streams
+ * ("ICY 200 OK", data follows the status line directly). Bodies are
+ * delimited by Content-Length, chunked encoding or connection close, and
+ * handed to the body callback as spans of the input buffer.
+ */
+#ifndef NTRIP_ATLAS_HTTP_LINE_SIZE
+#define NTRIP_ATLAS_HTTP_LINE_SIZE 128  // Longer header lines are truncated
+#endif
+
+// Room for a request line with a full-length path plus fixed headers
+#define NTRIP_ATLAS_HTTP_REQUEST_SIZE (2 * NTRIP_ATLAS_MAX_URL_LEN + 128)
+
+typedef enum {
+    NTRIP_HTTP_STATUS_LINE = 0,
+    NTRIP_HTTP_HEADERS,
+    NTRIP_HTTP_BODY,              // Identity body (length known or until close)
+    NTRIP_HTTP_CHUNK_SIZE,
+    NTRIP_HTTP_CHUNK_DATA,
+    NTRIP_HTTP_CHUNK_END,         // Line end after chunk data
+    NTRIP_HTTP_TRAILERS,
+    NTRIP_HTTP_DONE
+} ntrip_http_state_t;
+
+typedef enum {
+    NTRIP_HTTP_PROTOCOL_HTTP = 0,     // NTRIP 2.0 / plain HTTP
+    NTRIP_HTTP_PROTOCOL_SOURCETABLE,  // NTRIP 1.0 sourcetable reply
+    NTRIP_HTTP_PROTOCOL_ICY           // NTRIP 1.0 stream reply
+} ntrip_http_protocol_t;
+
+/**
+ * Response being parsed (caller-owned)
+ */
+typedef struct {
+    ntrip_http_state_t state;
+    ntrip_http_protocol_t protocol;
+    uint16_t status_code;
+    uint8_t chunked;
+    uint8_t has_length;
+    uint32_t content_length;
+    uint32_t remaining;           // Body or chunk bytes still to come
+    uint32_t body_bytes;          // Decoded body bytes delivered so far
+    char line[NTRIP_ATLAS_HTTP_LINE_SIZE];
+    uint16_t line_len;
+} ntrip_http_response_t;
+
+/**
+ * Reset a response parser
+ */
+void ntrip_atlas_http_response_init(ntrip_http_response_t* response);
+
+/**
+ * Feed received bytes
+ * @param on_body Receives decoded body spans; non-zero return stops
+ * @return 1 once the body is complete or on_body stopped, 0 for more
+ *         data, or NTRIP_ATLAS_ERROR_AUTH_FAILED (401),
+ *         NTRIP_ATLAS_ERROR_NOT_FOUND (404) or
+ *         NTRIP_ATLAS_ERROR_INVALID_RESPONSE (other status or bad framing)
+ */
+int ntrip_atlas_http_response_feed(
+    ntrip_http_response_t* response,
+    const char* data,
+    size_t len,
+    ntrip_stream_callback_t on_body,
+    void* context
+);
+
+/**
+ * Handle the peer closing the connection
+ * @return NTRIP_ATLAS_SUCCESS if the body ended cleanly (complete, or
+ *         delimited by close), NTRIP_ATLAS_ERROR_INVALID_RESPONSE if cut short
+ */
+ntrip_atlas_error_t ntrip_atlas_http_response_finish(ntrip_http_response_t* response);
+
+/**
+ * Format the GET request every transport sends
+ * Advertises NTRIP 2.0; NTRIP 1.0 casters ignore the version header.
+ * @return Request length, or NTRIP_ATLAS_ERROR_INVALID_PARAM if it does not fit
+ */
+int ntrip_atlas_http_format_request(
+    char* buffer,
+    size_t buffer_size,
+    const char* host,
+    uint16_t port,
+    const char* path
+);
+
+/**
+ * Non-blocking HTTP Stream
+ * One GET request over platform->nb_transport, driven by a caller loop:
+ * begin() connects, step() moves whatever bytes are ready through the
+ * response parser to on_data and returns NTRIP_ATLAS_ERROR_WOULD_BLOCK
+ * until the response ends, and poll_fd() names what to wait for. Any
+ * number of streams can share one thread.
+ */
+#ifndef NTRIP_ATLAS_NB_STEP_BYTES
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_NB_STEP_BYTES 1024
+    #else
+        #define NTRIP_ATLAS_NB_STEP_BYTES 16384
+    #endif
+#endif
+
+typedef enum {
+    NTRIP_NB_STREAM_IDLE = 0,
+    NTRIP_NB_STREAM_SENDING,      // Connecting and writing the request
+    NTRIP_NB_STREAM_RECEIVING,    // Reading the response (see http.state)
+    NTRIP_NB_STREAM_DONE          // Finished; see status
+} ntrip_nb_stream_state_t;
+
+/**
+ * One in-flight HTTP stream (caller-owned)
+ */
+typedef struct {
+    const ntrip_platform_t* platform;
+    void* connection;
+    ntrip_nb_stream_state_t state;
+    ntrip_atlas_error_t status;   // Outcome once DONE
+    uint8_t step_again;           // Step budget ran out with data left; step before waiting
+    uint32_t started_ms;
+    uint32_t timeout_ms;
+
+    // Milestones after started_ms, set once reached (need platform->get_time_ms)
+    uint32_t sent_ms;             // Request written: connect and any TLS handshake done
+    uint32_t first_byte_ms;       // First response byte (bytes_received > 0)
+
+    char request[NTRIP_ATLAS_HTTP_REQUEST_SIZE];
+    const char* custom_request;   // Caller-owned request sent instead of request[]
+    size_t request_len;
+    size_t request_sent;
+
+    size_t bytes_received;
+    ntrip_http_response_t http;
+    ntrip_stream_callback_t on_data;
+    void* context;
+} ntrip_http_stream_t;
+
+/**
+ * Start a non-blocking GET
+ * Only host name resolution may block; use a numeric host to avoid it.
+ * @param timeout_ms Whole-request limit, checked on each step (0 = none;
+ *                   needs platform->get_time_ms)
+ * @return NTRIP_ATLAS_SUCCESS, NTRIP_ATLAS_ERROR_MISSING_FEATURE if the
+ *         platform has no non-blocking transport, or the connect error (no
+ *         end() needed after a failed begin)
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_begin(
+    ntrip_http_stream_t* stream,
+    const ntrip_platform_t* platform,
+    const char* host,
+    uint16_t port,
+    uint8_t ssl,
+    const char* path,
+    ntrip_stream_callback_t on_data,
+    void* context,
+    uint32_t timeout_ms
+);
+
+/**
+ * Start a non-blocking stream with a caller-formatted request
+ * For requests that do not fit request[] or need extra headers, such as
+ * mountpoint credentials. The request is sent as is and must outlive the
+ * stream. Parameters and results as ntrip_atlas_http_stream_begin().
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_begin_request(
+    ntrip_http_stream_t* stream,
+    const ntrip_platform_t* platform,
+    const char* host,
+    uint16_t port,
+    uint8_t ssl,
+    const char* request,
+    ntrip_stream_callback_t on_data,
+    void* context,
+    uint32_t timeout_ms
+);
+
+/**
+ * Make as much progress as possible without waiting
+ * Reads at most NTRIP_ATLAS_NB_STEP_BYTES per call so one large response
+ * cannot starve the loop; then step_again is set.
+ * @return NTRIP_ATLAS_ERROR_WOULD_BLOCK while running, NTRIP_ATLAS_SUCCESS
+ *         once the response ended or on_data stopped it, or the error that
+ *         ended the stream
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_step(ntrip_http_stream_t* stream);
+
+/**
+ * Descriptor and direction to wait on before the next step
+ * Readiness is level-triggered.
+ * @return Descriptor, or -1 if there is none (poll by calling step)
+ */
+int ntrip_atlas_http_stream_poll_fd(const ntrip_http_stream_t* stream, bool* want_write);
+
+/**
+ * Close the connection
+ * Ends a running stream early too.
+ * @return The stream's outcome (NTRIP_ATLAS_SUCCESS when cancelled)
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_end(ntrip_http_stream_t* stream);
+
+/**
+ * Sourcetable parser state
+ * Exposed so callers can embed it (see ntrip_discovery_t); treat as opaque.
+ */
+#ifndef NTRIP_LINE_BUFFER_SIZE
+#define NTRIP_LINE_BUFFER_SIZE 256  // Same as ntrip_atlas_config.h
+#endif
+
+typedef struct ntrip_stream_parser_state_t {
+    char line_buffer[NTRIP_LINE_BUFFER_SIZE];
+    size_t line_pos;
+    uint8_t in_sourcetable;
+    uint8_t parsing_complete;
+
+    // Current best mountpoint
+    ntrip_mountpoint_t best;
+    uint8_t has_result;
+
+    // Search criteria
+    double user_lat;
+    double user_lon;
+    const ntrip_service_config_t* service;
+    const ntrip_selection_criteria_t* criteria;
+
+    // Early termination thresholds
+    uint8_t stop_threshold_score;   // Stop if score exceeds this
+    double stop_threshold_distance; // Stop if distance under this
+
+    // Coalesced fetch: store every parsed mountpoint here instead of scoring
+    ntrip_fetch_flight_t* collect;
+} ntrip_stream_parser_state_t;
+
+/**
+ * Non-blocking Discovery
+ * Resumable form of ntrip_query_service_streaming() for single-threaded
+ * loops: a non-blocking HTTP stream of the sourcetable feeding the
+ * streaming parser. step() returns NTRIP_ATLAS_ERROR_WOULD_BLOCK until
+ * the sourcetable is done. Needs platform->nb_transport.
+ */
+#ifndef NTRIP_ATLAS_DISCOVERY_TIMEOUT_MS
+#define NTRIP_ATLAS_DISCOVERY_TIMEOUT_MS 10000
+#endif
+
+/**
+ * One in-flight discovery (caller-owned)
+ */
+typedef struct {
+    ntrip_http_stream_t stream;
+    const ntrip_service_config_t* service;
+    ntrip_stream_parser_state_t parser;
+} ntrip_discovery_t;
+
+/**
+ * Start discovering a service's best mountpoint without blocking
+ * Only host name resolution may block; use a numeric host to avoid it.
+ * Casters flagged sourcetable_filter get the same server-side filter as
+ * ntrip_query_service_streaming(), but a rejected filter is not retried.
+ * @return NTRIP_ATLAS_SUCCESS, NTRIP_ATLAS_ERROR_MISSING_FEATURE if the
+ *         platform has no non-blocking transport, or the connect error (no
+ *         end() needed after a failed begin)
+ */
+ntrip_atlas_error_t ntrip_atlas_discovery_begin(
+    ntrip_discovery_t* discovery,
+    const ntrip_platform_t* platform,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria
+);
+
+/**
+ * Make as much progress as possible without waiting
+ * See ntrip_atlas_http_stream_step(); discovery->stream can also be
+ * driven directly, e.g. by ntrip_platform_linux_run_streams().
+ * @return NTRIP_ATLAS_ERROR_WOULD_BLOCK while running, NTRIP_ATLAS_SUCCESS
+ *         once finished, or the error that ended the discovery
+ */
+ntrip_atlas_error_t ntrip_atlas_discovery_step(ntrip_discovery_t* discovery);
+
+/**
+ * Descriptor and direction to wait on before the next step
+ * @return Descriptor, or -1 if there is none (poll by calling step)
+ */
+int ntrip_atlas_discovery_poll_fd(const ntrip_discovery_t* discovery, bool* want_write);
+
+/**
+ * Close the connection and return the best mountpoint
+ * Ends a running discovery early too.
+ * @param result Output, may be NULL to just cancel
+ * @return NTRIP_ATLAS_SUCCESS, NTRIP_ATLAS_ERROR_NO_SERVICES if the
+ *         sourcetable had no match, or the error that ended the discovery
+ */
+ntrip_atlas_error_t ntrip_atlas_discovery_end(
+    ntrip_discovery_t* discovery,
+    ntrip_mountpoint_t* result
+);
+
+/**
+ * RTCM3 Frame Scanner
+ * Finds RTCM3 frames in a correction stream and checks their CRC-24Q,
+ * counting frames per message type. Reads the caller's buffers in place
+ * (relay buffers need no copy) and keeps a frame's state across calls,
+ * so chunks may split frames anywhere. CRC-24Q runs slicing-by-8 on
+ * desktops and byte-at-a-time on ESP32 to keep tables small.
+ */
+#ifndef NTRIP_ATLAS_CRC24Q_SLICES
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_CRC24Q_SLICES 1   // 1 KB table
+    #else
+        #define NTRIP_ATLAS_CRC24Q_SLICES 8   // 8 KB of tables
+    #endif
+#endif
+
+#ifndef NTRIP_ATLAS_RTCM3_TYPE_SLOTS
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_RTCM3_TYPE_SLOTS 16
+    #else
+        #define NTRIP_ATLAS_RTCM3_TYPE_SLOTS 64
+    #endif
+#endif
+
+#define NTRIP_RTCM3_PREAMBLE 0xD3
+#define NTRIP_RTCM3_MAX_FRAME (3 + 1023 + 3)  // Header, payload, CRC
+
+// Payload bytes of the station messages 1005 and 1006 (1005 plus antenna height)
+#define NTRIP_RTCM3_STATION_PAYLOAD 21
+
+/**
+ * Frames seen of one message type
+ */
+typedef struct {
+    uint16_t message_type;
+    uint32_t count;
+} ntrip_rtcm3_type_count_t;
+
+/**
+ * Antenna reference point from RTCM 1005/1006
+ */
+typedef struct {
+    uint16_t message_type;        // 1005 or 1006
+    uint16_t station_id;
+    double ecef_x;                // m, ITRF
+    double ecef_y;
+    double ecef_z;
+    double antenna_height;        // m above the marker (1006 only, else 0)
+} ntrip_rtcm3_station_t;
+
+/**
+ * Frame scanner state and counters (caller-owned)
+ */
+typedef struct {
+    // Frame in progress across chunks
+    uint16_t pos;                 // Bytes of the current frame seen, 0 while hunting
+    uint16_t length;              // Payload length from the header
+    uint16_t message_type;        // First 12 payload bits
+    uint32_t crc;                 // Running CRC-24Q, in the top 24 bits
+    uint32_t check;               // Transmitted CRC being assembled
+    uint8_t in_sync;              // Last checked frame was valid
+    uint8_t head[NTRIP_RTCM3_STATION_PAYLOAD];  // Payload start of a split frame
+
+    uint64_t bytes;               // Bytes fed
+    uint64_t frame_bytes;         // Bytes inside valid frames
+    uint32_t frames;              // Valid frames
+    uint32_t crc_errors;          // CRC-24Q failures right after a valid frame
+    uint32_t untracked_frames;    // Valid frames of types beyond the slots
+    uint8_t type_count;
+    ntrip_rtcm3_type_count_t types[NTRIP_ATLAS_RTCM3_TYPE_SLOTS];
+
+    uint8_t has_station;          // station holds the last valid 1005/1006
+    ntrip_rtcm3_station_t station;
+} ntrip_rtcm3_framer_t;
+
+/**
+ * CRC-24Q (RTCM 10403, Qualcomm) of a buffer
+ * @param crc 0 to start, or the result over the preceding bytes
+ */
+uint32_t ntrip_atlas_crc24q(uint32_t crc, const uint8_t* data, size_t len);
+
+/**
+ * Reset a frame scanner
+ */
+void ntrip_atlas_rtcm3_init(ntrip_rtcm3_framer_t* framer);
+
+/**
+ * Scan the next chunk of a stream
+ * @return Valid frames completed in this chunk
+ */
+uint32_t ntrip_atlas_rtcm3_feed(ntrip_rtcm3_framer_t* framer, const uint8_t* data, size_t len);
+
+/**
+ * Valid frames seen of one message type
+ */
+uint32_t ntrip_atlas_rtcm3_type_count(const ntrip_rtcm3_framer_t* framer, uint16_t message_type);
+
+/**
+ * Decode a 1005 or 1006 payload (the bytes after the frame header)
+ * @return NTRIP_ATLAS_SUCCESS, or NTRIP_ATLAS_ERROR_INVALID_RESPONSE if
+ *         the payload is another message or too short
+ */
+ntrip_atlas_error_t ntrip_atlas_rtcm3_decode_station(
+    const uint8_t* payload,
+    size_t len,
+    ntrip_rtcm3_station_t* station
+);
+
+/**
+ * Byte and frame rates over an observation time
+ * @param bytes_per_second Output, may be NULL
+ * @param frames_per_second Output, may be NULL
+ */
+void ntrip_atlas_rtcm3_rates(
+    const ntrip_rtcm3_framer_t* framer,
+    uint32_t elapsed_ms,
+    double* bytes_per_second,
+    double* frames_per_second
+);
+
+/**
+ * Station Position Cache
+ * Sourcetable coordinates are often rounded to 0.01 degrees or plain
+ * wrong, while reference stations broadcast their antenna position in
+ * RTCM 1005/1006. Positions decoded while probing or using a stream are
+ * kept per caster host and mountpoint, and the sourcetable ranker scores
+ * distances from them instead of the STR line's lat/lon.
+ */
+#ifndef NTRIP_ATLAS_STATION_CACHE_ENTRIES
+    #if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+        #define NTRIP_ATLAS_STATION_CACHE_ENTRIES 8
+    #else
+        #define NTRIP_ATLAS_STATION_CACHE_ENTRIES 64
+    #endif
+#endif
+
+/**
+ * Remember a mountpoint's broadcast antenna position
+ * Replaces the least recently used entry when the cache is full.
+ * @param host Caster host as in ntrip_service_config_t.base_url
+ * @return NTRIP_ATLAS_SUCCESS, or NTRIP_ATLAS_ERROR_INVALID_PARAM for a
+ *         position that is not near the Earth's surface (some casters
+ *         send zeros)
+ */
+ntrip_atlas_error_t ntrip_atlas_station_position_record(
+    const char* host,
+    const char* mountpoint,
+    const ntrip_rtcm3_station_t* station
+);
+
+/**
+ * Broadcast position of a mountpoint, if one was recorded
+ * @return true with latitude/longitude set, false if unknown
+ */
+bool ntrip_atlas_station_position_lookup(
+    const char* host,
+    const char* mountpoint,
+    double* latitude,
+    double* longitude
+);
+
+/**
+ * Forget every recorded position
+ */
+void ntrip_atlas_station_positions_clear(void);
+
+/**
+ * Stream Health Probe
+ * Opens a mountpoint like a rover would (credentials, plus a GGA at the
+ * mountpoint position when nmea_required) and watches the corrections
+ * for a bounded time: connect time, time to first byte, time to the
+ * first RTCM3 frame with a valid CRC-24Q, and message rate. Probes run
+ * like discoveries, so many candidates can be measured side by side
+ * before committing a rover to one.
+ */
+#ifndef NTRIP_ATLAS_PROBE_DURATION_MS
+#define NTRIP_ATLAS_PROBE_DURATION_MS 5000
+#endif
+
+// Credentials and a GGA do not fit ntrip_http_stream_t's request[]
+#define NTRIP_ATLAS_PROBE_REQUEST_SIZE (NTRIP_ATLAS_HTTP_REQUEST_SIZE + 384)
+
+// Timing for a milestone the probe never reached
+#define NTRIP_ATLAS_PROBE_NOT_REACHED UINT32_MAX
+
+/**
+ * Probe results; times in ms from the start of the connect
+ */
+typedef struct {
+    ntrip_atlas_error_t status;   // SUCCESS once a valid frame arrived
+    uint32_t connect_ms;          // Request written (TCP and any TLS handshake done)
+    uint32_t first_byte_ms;       // First response byte
+    uint32_t first_frame_ms;      // First RTCM3 frame with a valid CRC
+    uint32_t elapsed_ms;          // Whole probe
+    uint32_t bytes;               // Correction bytes after the response header
+    uint32_t frames;              // Valid RTCM3 frames
+    uint32_t crc_errors;          // Frames that failed CRC-24Q in a valid stream
+    double message_rate;          // Frames per second from the first frame on
+    uint8_t station_position;     // 1005/1006 seen and recorded in the station cache
+} ntrip_probe_stats_t;
+
+/**
+ * One in-flight probe (caller-owned)
+ */
+typedef struct {
+    ntrip_http_stream_t stream;
+    char request[NTRIP_ATLAS_PROBE_REQUEST_SIZE];
+    const ntrip_service_config_t* service;
+    char host[NTRIP_ATLAS_MAX_URL_LEN];
+    char mountpoint[NTRIP_ATLAS_MAX_MOUNTPOINT];
+    uint32_t duration_ms;
+    uint8_t expect_rtcm3;         // Format is RTCM 3, so health means valid frames
+
+    ntrip_rtcm3_framer_t framer;
+    ntrip_probe_stats_t stats;
+} ntrip_service_probe_t;
+
+/**
+ * Start probing a mountpoint without blocking
+ * Only host name resolution may block; use a numeric host to avoid it.
+ * @param duration_ms How long to watch the stream (0 = NTRIP_ATLAS_PROBE_DURATION_MS)
+ * @return NTRIP_ATLAS_SUCCESS, NTRIP_ATLAS_ERROR_MISSING_FEATURE if the
+ *         platform has no non-blocking transport or clock, or the connect
+ *         error (no end() needed after a failed begin)
+ */
+ntrip_atlas_error_t ntrip_atlas_probe_begin(
+    ntrip_service_probe_t* probe,
+    const ntrip_platform_t* platform,
+    const ntrip_best_service_t* service,
+    uint32_t duration_ms
+);
+
+/**
+ * Make as much progress as possible without waiting
+ * probe->stream can also be driven directly, e.g. by
+ * ntrip_platform_linux_run_streams().
+ * @return NTRIP_ATLAS_ERROR_WOULD_BLOCK while running, NTRIP_ATLAS_SUCCESS
+ *         once the probe time is up, or the error that ended the stream
+ */
+ntrip_atlas_error_t ntrip_atlas_probe_step(ntrip_service_probe_t* probe);
+
+/**
+ * Descriptor and direction to wait on before the next step
+ * @return Descriptor, or -1 if there is none (poll by calling step)
+ */
+int ntrip_atlas_probe_poll_fd(const ntrip_service_probe_t* probe, bool* want_write);
+
+/**
+ * Close the connection, fill in the stats and record the outcome
+ * With compact failure tracking set up, a probe without a valid frame
+ * counts as a failure of its service (bad credentials do not) and one
+ * with frames as a success. A station position seen in the stream goes
+ * into the station cache. Ends a running probe early too.
+ * @param stats Output, may be NULL
+ * @return stats->status
+ */
+ntrip_atlas_error_t ntrip_atlas_probe_end(
+    ntrip_service_probe_t* probe,
+    ntrip_probe_stats_t* stats
+);
+
+/**
+ * Probe a service's mountpoint and wait for the result
+ * Blocking form of ntrip_atlas_probe_begin()/step()/end(); waits through
+ * platform->nb_transport->wait when the transport has it.
+ * @param duration_ms How long to watch the stream (0 = NTRIP_ATLAS_PROBE_DURATION_MS)
+ * @param stats Output, may be NULL
+ * @return NTRIP_ATLAS_SUCCESS once valid RTCM3 frames arrived, or the
+ *         error (NTRIP_ATLAS_ERROR_TIMEOUT if no valid frame came in time)
+ */
+ntrip_atlas_error_t ntrip_atlas_test_service(
+    const ntrip_platform_t* platform,
+    const ntrip_best_service_t* service,
+    uint32_t duration_ms,
+    ntrip_probe_stats_t* stats
+);
+
 /**
  * Platform Implementations (declared in separate headers)
  */
@@ -1315,6 +3224,72 @@ extern const ntrip_platform_t ntrip_platform_esp32;
 // Linux platform
 extern const ntrip_platform_t ntrip_platform_linux;
 
+// Linux pthread hooks for ntrip_atlas_fetch_coalescer_init()
+extern const ntrip_fetch_sync_t ntrip_platform_linux_fetch_sync;
+
+// Linux non-blocking sockets (ntrip_platform_linux.nb_transport)
+extern const ntrip_nb_transport_t ntrip_platform_linux_nb_transport;
+
+/**
+ * TLS hooks for the Linux socket transport
+ * Wraps a connected non-blocking socket; every call returns
+ * NTRIP_ATLAS_ERROR_WOULD_BLOCK rather than waiting. Lets SSL casters use
+ * OpenSSL, mbedTLS or any other library without the core linking it.
+ */
+typedef struct {
+    void* (*open)(int fd, const char* host);     // NULL on failure
+    int (*handshake)(void* session);             // Success, would-block or error
+    int (*read)(void* session, char* buffer, size_t max_len);   // As nb_transport recv
+    int (*write)(void* session, const char* data, size_t len);  // As nb_transport send
+    bool (*want_write)(void* session);           // Last would-block waits for writability
+    void (*close)(void* session);
+} ntrip_tls_hooks_t;
+
+/**
+ * Route SSL casters through TLS hooks (NULL: they report MISSING_FEATURE)
+ */
+void ntrip_platform_linux_set_tls(const ntrip_tls_hooks_t* hooks);
+
+// OpenSSL hooks, built with NTRIP_ATLAS_USE_OPENSSL
+extern const ntrip_tls_hooks_t ntrip_platform_linux_openssl_tls;
+
+/**
+ * Set up the OpenSSL client context
+ * @param ca_file PEM trust anchors, or NULL for the system store
+ * @param verify_peer Check the certificate chain and host name
+ */
+ntrip_atlas_error_t ntrip_platform_linux_openssl_init(const char* ca_file, bool verify_peer);
+
+/**
+ * Drive non-blocking streams from one thread with epoll
+ * Returns once every stream is DONE or timeout_ms passes; each stream's
+ * outcome is in its status, and the caller still ends each one.
+ * Discoveries run here too through their embedded stream.
+ * @param timeout_ms Overall limit (0 = until all finish)
+ * @return NTRIP_ATLAS_SUCCESS, NTRIP_ATLAS_ERROR_TIMEOUT with streams
+ *         still running, or NTRIP_ATLAS_ERROR_PLATFORM if epoll failed
+ */
+ntrip_atlas_error_t ntrip_platform_linux_run_streams(
+    ntrip_http_stream_t* const* streams,
+    size_t count,
+    uint32_t timeout_ms
+);
+
+/**
+ * Blocking http_stream over native sockets and epoll instead of libcurl
+ * Same contract as ntrip_platform_t.http_stream; ntrip_platform_linux
+ * uses it when built with NTRIP_ATLAS_LINUX_NATIVE_HTTP.
+ */
+int ntrip_platform_linux_native_http_stream(
+    const char* host,
+    uint16_t port,
+    uint8_t ssl,
+    const char* path,
+    ntrip_stream_callback_t on_data,
+    void* user_context,
+    uint32_t timeout_ms
+);
+
 // Windows platform
 extern const ntrip_platform_t ntrip_platform_windows;
 
@@ -13,10 +13,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "ntrip_atlas.h"
 
 // Coverage tile hierarchy (following Brad Fitzpatrick's approach)
 #define COVERAGE_MAX_LEVELS           5
-#define COVERAGE_MAX_SERVICES_PER_TILE 32  // 32-bit bitmap limit
+#ifndef COVERAGE_MAX_SERVICES_PER_TILE
+#define COVERAGE_MAX_SERVICES_PER_TILE 32  // One 32-bit bitmap word
+#endif
+#define COVERAGE_BITMAP_WORDS ((COVERAGE_MAX_SERVICES_PER_TILE + 31) / 32)
 
 // Hierarchical coverage levels (similar to zoom levels)
 typedef enum {
@@ -35,27 +39,30 @@ typedef struct __attribute__((packed)) {
     uint8_t level;              // Coverage level (0-4)
     uint16_t lat_tile;          // Tile latitude index
     uint16_t lon_tile;          // Tile longitude index
-    uint32_t service_bitmap;    // Bitmap of services covering this tile (32 services max)
-    uint8_t service_count;      // Number of services in this tile (population count)
-    uint8_t reserved[2];        // Padding for 12-byte alignment
-} ntrip_coverage_tile_t;        // 12 bytes per tile
+    uint32_t service_bitmap[COVERAGE_BITMAP_WORDS]; // Services covering this tile (bit = service index)
+    uint16_t service_count;     // Number of services in this tile (population count)
+    uint8_t reserved;           // Padding for 12-byte alignment
+} ntrip_coverage_tile_t;        // 12 bytes per tile with one bitmap word
 
 /**
  * Hierarchical coverage index (stores all tiles compactly)
+ * Tile storage is supplied by the caller - typically a const table emitted
+ * by the generator, sized to the tiles the database actually populates.
  */
 typedef struct {
-    ntrip_coverage_tile_t tiles[2560]; // Max tiles across all levels (2^11)
+    ntrip_coverage_tile_t* tiles;      // Caller-provided, tile_capacity entries
+    uint16_t tile_capacity;            // Tiles available in storage
     uint16_t tile_count;               // Actual tiles used
-    uint8_t max_service_index;         // Highest service ID in use
+    ntrip_service_idx_t max_service_index; // Highest service ID in use
     bool initialized;
-} ntrip_coverage_index_t;             // ~30KB total
+} ntrip_coverage_index_t;
 
 /**
  * Service coverage area definition (for YAML schema)
  * Used during build-time generation of coverage bitmaps
  */
 typedef struct {
-    uint8_t service_index;      // Index in service array
+    ntrip_service_idx_t service_index; // Index in service array
     int16_t lat_min_deg100;     // Bounding box (for tile assignment)
     int16_t lat_max_deg100;
     int16_t lon_min_deg100;
@@ -79,9 +86,13 @@ typedef enum {
 } ntrip_coverage_error_t;
 
 /**
- * Initialize the hierarchical coverage index
+ * Initialize the hierarchical coverage index over caller-provided tiles
  */
-ntrip_coverage_error_t ntrip_coverage_init(ntrip_coverage_index_t* index);
+ntrip_coverage_error_t ntrip_coverage_init(
+    ntrip_coverage_index_t* index,
+    ntrip_coverage_tile_t* tiles,
+    uint16_t tile_capacity
+);
 
 /**
  * Convert geographic coordinates to tile coordinates at specific level
@@ -102,7 +113,7 @@ size_t ntrip_coverage_find_services(
     const ntrip_coverage_index_t* index,
     double latitude,
     double longitude,
-    uint8_t* service_indices,
+    ntrip_service_idx_t* service_indices,
     size_t max_services
 );
 
@@ -111,7 +122,7 @@ size_t ntrip_coverage_find_services(
  */
 ntrip_coverage_error_t ntrip_coverage_add_service(
     ntrip_coverage_index_t* index,
-    uint8_t service_index,
+    ntrip_service_idx_t service_index,
     const ntrip_service_coverage_t* coverage
 );
 
@@ -121,7 +132,7 @@ ntrip_coverage_error_t ntrip_coverage_add_service(
 typedef struct {
     uint16_t tiles_per_level[COVERAGE_MAX_LEVELS];
     uint16_t total_tiles_populated;
-    uint8_t services_in_index;
+    ntrip_service_idx_t services_in_index;
     size_t memory_usage_bytes;
     double coverage_efficiency; // % of tiles with services
 } ntrip_coverage_stats_t;
@@ -17,6 +17,10 @@
 #include <WiFiClient.h>
 #include <WiFiClientSecure.h>
 #include <Preferences.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <lwip/netdb.h>
+#include <lwip/sockets.h>
 
 // Preferences namespace for NTRIP Atlas data
 #define PREFS_NAMESPACE "ntripatlas"
@@ -29,7 +33,7 @@ static Preferences prefs;
  * HTTP streaming implementation for ESP32
  *
  * Uses WiFiClient to stream data in chunks, calling the callback
- * function for each received chunk without buffering the entire response.
+ * function for each decoded body span without buffering the entire response.
  */
 static int esp32_http_stream(
     const char* host,
@@ -62,62 +66,47 @@ static int esp32_http_stream(
     }
 
     // Send HTTP GET request
-    client->printf("GET %s HTTP/1.1\r\n", path);
-    client->printf("Host: %s\r\n", host);
-    client->printf("User-Agent: NTRIP-Atlas/1.0\r\n");
-    client->printf("Accept: */*\r\n");
-    client->printf("Connection: close\r\n");
-    client->printf("\r\n");
-
-    // Wait for response headers
-    uint32_t start_ms = millis();
-    while (!client->available() && (millis() - start_ms) < timeout_ms) {
-        delay(10);
-    }
-
-    if (!client->available()) {
+    char request[NTRIP_ATLAS_HTTP_REQUEST_SIZE];
+    int request_len = ntrip_atlas_http_format_request(request, sizeof(request), host, port, path);
+    if (request_len < 0) {
         client->stop();
         delete client;
-        return NTRIP_ATLAS_ERROR_TIMEOUT;
+        return request_len;
     }
+    client->write((const uint8_t*)request, (size_t)request_len);
 
-    // Skip HTTP headers (read until \r\n\r\n)
-    int header_state = 0;
-    while (client->available() && header_state < 4) {
-        char c = client->read();
-        if (c == '\r' && header_state == 0) header_state = 1;
-        else if (c == '\n' && header_state == 1) header_state = 2;
-        else if (c == '\r' && header_state == 2) header_state = 3;
-        else if (c == '\n' && header_state == 3) header_state = 4;
-        else if (c != '\r' && c != '\n') header_state = 0;
-    }
+    // Status, headers and chunked bodies go through the shared core parser
+    ntrip_http_response_t response;
+    ntrip_atlas_http_response_init(&response);
 
-    // Stream response body in chunks
     char chunk_buffer[NTRIP_TCP_CHUNK_SIZE];
-    int callback_result = 0;
-
-    while (client->connected() || client->available()) {
-        if (client->available()) {
-            size_t bytes_read = client->readBytes(chunk_buffer, NTRIP_TCP_CHUNK_SIZE);
+    uint32_t start_ms = millis();
+    int result = NTRIP_ATLAS_SUCCESS;
 
+    while (true) {
+        int available = client->available();
+        if (available > 0) {
+            size_t want = (size_t)available < sizeof(chunk_buffer) ? (size_t)available : sizeof(chunk_buffer);
+            int bytes_read = client->read((uint8_t*)chunk_buffer, want);
             if (bytes_read > 0) {
-                // Call user callback with chunk
-                callback_result = on_data(chunk_buffer, bytes_read, user_context);
-
-                // If callback returns non-zero, stop streaming
-                if (callback_result != 0) {
+                int ret = ntrip_atlas_http_response_feed(&response, chunk_buffer, (size_t)bytes_read,
+                                                         on_data, user_context);
+                if (ret != 0) {
+                    result = ret < 0 ? ret : NTRIP_ATLAS_SUCCESS;
                     break;
                 }
             }
+        } else if (!client->connected()) {
+            result = ntrip_atlas_http_response_finish(&response);
+            break;
         } else {
             delay(10); // Brief delay to allow more data to arrive
         }
 
         // Check timeout
         if ((millis() - start_ms) > timeout_ms) {
-            client->stop();
-            delete client;
-            return NTRIP_ATLAS_ERROR_TIMEOUT;
+            result = NTRIP_ATLAS_ERROR_TIMEOUT;
+            break;
         }
     }
 
@@ -125,7 +114,7 @@ static int esp32_http_stream(
     client->stop();
     delete client;
 
-    return NTRIP_ATLAS_SUCCESS;
+    return result;
 }
 
 /**
@@ -295,6 +284,180 @@ static uint32_t esp32_get_time_seconds(void) {
 /**
  * ESP32 Platform Implementation
  */
+/**
+ * Non-blocking transport for ntrip_atlas_discovery_*()
+ *
+ * Plain lwIP sockets with O_NONBLOCK: connect() returns with the TCP
+ * handshake in progress and the descriptor can go to select(). Host names
+ * still resolve through getaddrinfo(), which may block. WiFiClientSecure
+ * has no non-blocking handshake, so SSL casters report MISSING_FEATURE
+ * here and stay reachable through esp32_http_stream().
+ */
+typedef struct {
+    int fd;
+    uint8_t connected;
+} esp32_socket_t;
+
+/**
+ * Start a non-blocking connect to the first address that accepts one
+ */
+static int esp32_nb_connect(const char* host, uint16_t port, uint8_t ssl, void** connection) {
+    if (!host || !connection) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (ssl) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", (unsigned)port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* addresses = NULL;
+    if (getaddrinfo(host, service, &hints, &addresses) != 0 || !addresses) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+
+    int fd = -1;
+    uint8_t connected = 0;
+    for (struct addrinfo* address = addresses; address; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) == 0) {
+            if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+                connected = 1;
+                break;
+            }
+            if (errno == EINPROGRESS) {
+                break;
+            }
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+
+    esp32_socket_t* sock = (esp32_socket_t*)calloc(1, sizeof(esp32_socket_t));
+    if (!sock) {
+        close(fd);
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    sock->fd = fd;
+    sock->connected = connected;
+
+    *connection = sock;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Wait up to timeout_ms for the socket to turn readable or writable
+ */
+static bool esp32_nb_select(int fd, bool want_write, uint32_t timeout_ms) {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+
+    return select(fd + 1, want_write ? NULL : &fds, want_write ? &fds : NULL, NULL, &timeout) > 0;
+}
+
+/**
+ * Finish an in-progress connect once the socket turns writable
+ */
+static int esp32_nb_check_connected(esp32_socket_t* sock) {
+    if (sock->connected) {
+        return NTRIP_ATLAS_SUCCESS;
+    }
+    if (!esp32_nb_select(sock->fd, true, 0)) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(sock->fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+
+    sock->connected = 1;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+static int esp32_nb_send(void* connection, const char* data, size_t len) {
+    esp32_socket_t* sock = (esp32_socket_t*)connection;
+
+    int ret = esp32_nb_check_connected(sock);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+
+    ssize_t sent = send(sock->fd, data, len, 0);
+    if (sent >= 0) {
+        return (int)sent;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    return NTRIP_ATLAS_ERROR_NO_NETWORK;
+}
+
+static int esp32_nb_recv(void* connection, char* buffer, size_t max_len) {
+    esp32_socket_t* sock = (esp32_socket_t*)connection;
+
+    ssize_t received = recv(sock->fd, buffer, max_len, 0);
+    if (received >= 0) {
+        return (int)received;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    return NTRIP_ATLAS_ERROR_NO_NETWORK;
+}
+
+static int esp32_nb_poll_fd(void* connection, bool* want_write) {
+    esp32_socket_t* sock = (esp32_socket_t*)connection;
+    if (!sock->connected) {
+        *want_write = true;
+    }
+    return sock->fd;
+}
+
+// select() sleeps the calling task, so blocking helpers let others run
+static void esp32_nb_wait(void* connection, bool want_write, uint32_t timeout_ms) {
+    esp32_socket_t* sock = (esp32_socket_t*)connection;
+    esp32_nb_poll_fd(connection, &want_write);
+    esp32_nb_select(sock->fd, want_write, timeout_ms);
+}
+
+static void esp32_nb_close(void* connection) {
+    esp32_socket_t* sock = (esp32_socket_t*)connection;
+    if (sock) {
+        close(sock->fd);
+        free(sock);
+    }
+}
+
+static const ntrip_nb_transport_t esp32_nb_transport = {
+    esp32_nb_connect,
+    esp32_nb_send,
+    esp32_nb_recv,
+    esp32_nb_poll_fd,
+    esp32_nb_close,
+    esp32_nb_wait
+};
+
 const ntrip_platform_t ntrip_platform_esp32 = {
     .interface_version = 2,
     .http_stream = esp32_http_stream,
@@ -306,7 +469,8 @@ const ntrip_platform_t ntrip_platform_esp32 = {
     .clear_failure_data = esp32_clear_failure_data,
     .log_message = esp32_log_message,
     .get_time_ms = esp32_get_time_ms,
-    .get_time_seconds = esp32_get_time_seconds
+    .get_time_seconds = esp32_get_time_seconds,
+    .nb_transport = &esp32_nb_transport
 };
 
 #endif // ESP32
@@ -0,0 +1,214 @@
+/**
+ * Linux epoll Driver for NTRIP Atlas
+ *
+ * Runs any number of ntrip_http_stream_t from one thread: each stream's
+ * socket sits in one epoll set and is stepped only when ready. Also
+ * provides a libcurl-free http_stream for ntrip_platform_linux built on
+ * the same loop, so SSL casters go through ntrip_platform_linux_set_tls().
+ *
+ * Copyright (c) 2024 NTRIP Atlas Contributors
+ * Licensed under MIT License
+ */
+
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+#include "ntrip_atlas.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+// Longest epoll wait, so streams without readiness still hit their timeouts
+#define EPOLL_MAX_WAIT_MS 250
+#define EPOLL_MAX_EVENTS 64
+
+/**
+ * Registration of one stream in the epoll set
+ */
+typedef struct {
+    int fd;                       // -1 when not registered
+    bool want_write;
+} epoll_slot_t;
+
+static uint32_t epoll_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec * 1000) + (ts.tv_nsec / 1000000));
+}
+
+/**
+ * Bring a stream's epoll registration in line with what it waits on
+ */
+static void epoll_sync(int epfd, ntrip_http_stream_t* stream, epoll_slot_t* slot, size_t index) {
+    if (!stream->connection) {
+        // Closing the descriptor already took it out of the set; a DEL here
+        // could hit another stream that reused the number
+        slot->fd = -1;
+        return;
+    }
+
+    bool want_write = false;
+    int fd = ntrip_atlas_http_stream_poll_fd(stream, &want_write);
+    if (fd != slot->fd && slot->fd >= 0) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, slot->fd, NULL);
+        slot->fd = -1;
+    }
+    if (fd < 0) {
+        return;
+    }
+
+    struct epoll_event event = {0};
+    event.events = want_write ? EPOLLOUT : EPOLLIN;
+    event.data.u64 = index;
+
+    if (slot->fd < 0) {
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event) == 0) {
+            slot->fd = fd;
+            slot->want_write = want_write;
+        }
+    } else if (slot->want_write != want_write) {
+        epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &event);
+        slot->want_write = want_write;
+    }
+}
+
+/**
+ * Drive non-blocking streams from one thread with epoll
+ */
+ntrip_atlas_error_t ntrip_platform_linux_run_streams(
+    ntrip_http_stream_t* const* streams,
+    size_t count,
+    uint32_t timeout_ms
+) {
+    if (!streams && count > 0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (count == 0) {
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        return NTRIP_ATLAS_ERROR_PLATFORM;
+    }
+    epoll_slot_t* slots = malloc(count * sizeof(epoll_slot_t));
+    if (!slots) {
+        close(epfd);
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    for (size_t i = 0; i < count; i++) {
+        slots[i].fd = -1;
+        epoll_sync(epfd, streams[i], &slots[i], i);
+    }
+
+    ntrip_atlas_error_t result = NTRIP_ATLAS_SUCCESS;
+    uint32_t start = epoll_time_ms();
+    uint32_t last_sweep = start;
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+
+    for (;;) {
+        size_t running = 0;
+        bool step_again = false;
+        for (size_t i = 0; i < count; i++) {
+            if (streams[i]->state == NTRIP_NB_STREAM_SENDING ||
+                streams[i]->state == NTRIP_NB_STREAM_RECEIVING) {
+                running++;
+                step_again = step_again || streams[i]->step_again;
+            }
+        }
+        if (running == 0) {
+            break;
+        }
+
+        uint32_t now = epoll_time_ms();
+        if (timeout_ms && now - start >= timeout_ms) {
+            result = NTRIP_ATLAS_ERROR_TIMEOUT;
+            break;
+        }
+
+        int wait_ms = step_again ? 0 : EPOLL_MAX_WAIT_MS;
+        if (timeout_ms && timeout_ms - (now - start) < (uint32_t)wait_ms) {
+            wait_ms = (int)(timeout_ms - (now - start));
+        }
+
+        int ready = epoll_wait(epfd, events, EPOLL_MAX_EVENTS, wait_ms);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result = NTRIP_ATLAS_ERROR_PLATFORM;
+            break;
+        }
+
+        for (int e = 0; e < ready; e++) {
+            size_t i = (size_t)events[e].data.u64;
+            ntrip_atlas_http_stream_step(streams[i]);
+            epoll_sync(epfd, streams[i], &slots[i], i);
+        }
+
+        // Buffered TLS data, streams without a descriptor and per-stream
+        // timeouts all need a step that readiness will not trigger
+        now = epoll_time_ms();
+        bool sweep = now - last_sweep >= EPOLL_MAX_WAIT_MS;
+        if (sweep) {
+            last_sweep = now;
+        }
+        for (size_t i = 0; i < count; i++) {
+            ntrip_http_stream_t* stream = streams[i];
+            if (stream->state == NTRIP_NB_STREAM_DONE || stream->state == NTRIP_NB_STREAM_IDLE) {
+                continue;
+            }
+            if (stream->step_again || slots[i].fd < 0 || sweep) {
+                ntrip_atlas_http_stream_step(stream);
+                epoll_sync(epfd, stream, &slots[i], i);
+            }
+        }
+    }
+
+    free(slots);
+    close(epfd);
+    return result;
+}
+
+/**
+ * Platform for the native stream: sockets plus a monotonic clock
+ */
+static const ntrip_platform_t g_native_platform = {
+    .interface_version = 2,
+    .get_time_ms = epoll_time_ms,
+    .nb_transport = &ntrip_platform_linux_nb_transport
+};
+
+/**
+ * Blocking http_stream over native sockets and epoll instead of libcurl
+ */
+int ntrip_platform_linux_native_http_stream(
+    const char* host,
+    uint16_t port,
+    uint8_t ssl,
+    const char* path,
+    ntrip_stream_callback_t on_data,
+    void* user_context,
+    uint32_t timeout_ms
+) {
+    ntrip_http_stream_t stream;
+    ntrip_atlas_error_t ret = ntrip_atlas_http_stream_begin(&stream, &g_native_platform,
+                                                            host, port, ssl, path,
+                                                            on_data, user_context, timeout_ms);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+
+    // The stream enforces timeout_ms itself
+    ntrip_http_stream_t* streams[1] = { &stream };
+    ret = ntrip_platform_linux_run_streams(streams, 1, 0);
+
+    ntrip_atlas_error_t status = ntrip_atlas_http_stream_end(&stream);
+    return ret != NTRIP_ATLAS_SUCCESS ? ret : status;
+}
+
+#endif // __linux__
@@ -2,21 +2,29 @@
  * Linux Platform Implementation for NTRIP Atlas
  *
  * Uses libcurl for HTTP streaming and libsecret/keyring for credentials.
+ * Built with NTRIP_ATLAS_LINUX_NATIVE_HTTP, HTTP goes through the native
+ * socket/epoll client instead and libcurl is not needed.
  *
  * Copyright (c) 2024 NTRIP Atlas Contributors
  * Licensed under MIT License
  */
 
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
 #include "ntrip_atlas.h"
-#include "ntrip_atlas_config.h"
 
 #ifdef __linux__
 
+#ifndef NTRIP_ATLAS_LINUX_NATIVE_HTTP
 #include <curl/curl.h>
+#endif
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#ifndef NTRIP_ATLAS_LINUX_NATIVE_HTTP
 
 /**
  * Context for curl write callback
@@ -30,7 +38,7 @@ typedef struct {
 /**
  * libcurl write callback - forwards data to user callback
  */
-static size_t curl_write_callback(
+static size_t linux_curl_write(
     char* ptr,
     size_t size,
     size_t nmemb,
@@ -84,7 +92,7 @@ static int linux_http_stream(
 
     // Configure curl for streaming
     curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, linux_curl_write);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "NTRIP-Atlas/1.0");
@@ -113,6 +121,8 @@ static int linux_http_stream(
     return NTRIP_ATLAS_SUCCESS;
 }
 
+#endif // !NTRIP_ATLAS_LINUX_NATIVE_HTTP
+
 /**
  * Send NMEA sentence (for socket-based connections)
  */
@@ -300,12 +310,50 @@ static uint32_t linux_get_time_seconds(void) {
     return (uint32_t)time(NULL);
 }
 
+/**
+ * Process-wide lock and condition for sourcetable fetch coalescing
+ */
+static pthread_mutex_t g_fetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_fetch_cond = PTHREAD_COND_INITIALIZER;
+
+static void linux_fetch_lock(void* context) {
+    (void)context;
+    pthread_mutex_lock(&g_fetch_mutex);
+}
+
+static void linux_fetch_unlock(void* context) {
+    (void)context;
+    pthread_mutex_unlock(&g_fetch_mutex);
+}
+
+static void linux_fetch_wait(void* context) {
+    (void)context;
+    pthread_cond_wait(&g_fetch_cond, &g_fetch_mutex);
+}
+
+static void linux_fetch_broadcast(void* context) {
+    (void)context;
+    pthread_cond_broadcast(&g_fetch_cond);
+}
+
+const ntrip_fetch_sync_t ntrip_platform_linux_fetch_sync = {
+    .context = NULL,
+    .lock = linux_fetch_lock,
+    .unlock = linux_fetch_unlock,
+    .wait = linux_fetch_wait,
+    .broadcast = linux_fetch_broadcast
+};
+
 /**
  * Linux Platform Implementation
  */
 const ntrip_platform_t ntrip_platform_linux = {
     .interface_version = 2,
+#ifdef NTRIP_ATLAS_LINUX_NATIVE_HTTP
+    .http_stream = ntrip_platform_linux_native_http_stream,
+#else
     .http_stream = linux_http_stream,
+#endif
     .send_nmea = linux_send_nmea,
     .store_credential = linux_store_credential,
     .load_credential = linux_load_credential,
@@ -314,7 +362,8 @@ const ntrip_platform_t ntrip_platform_linux = {
     .clear_failure_data = linux_clear_failure_data,
     .log_message = linux_log_message,
     .get_time_ms = linux_get_time_ms,
-    .get_time_seconds = linux_get_time_seconds
+    .get_time_seconds = linux_get_time_seconds,
+    .nb_transport = &ntrip_platform_linux_nb_transport
 };
 
 #endif // __linux__
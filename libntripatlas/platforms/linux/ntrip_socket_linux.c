@@ -0,0 +1,244 @@
+/**
+ * Linux Non-Blocking Socket Transport for NTRIP Atlas
+ *
+ * Implements ntrip_nb_transport_t over O_NONBLOCK TCP sockets for
+ * ntrip_atlas_http_stream_*(). Connects return at once with the handshake
+ * in progress; the descriptor can be handed to poll()/epoll directly.
+ * SSL casters go through TLS hooks set with ntrip_platform_linux_set_tls().
+ * Host names go through getaddrinfo(), which may block, so event loops
+ * with many casters should resolve ahead of time or use numeric hosts.
+ *
+ * Copyright (c) 2024 NTRIP Atlas Contributors
+ * Licensed under MIT License
+ */
+
+#define _POSIX_C_SOURCE 200809L  // getaddrinfo
+#include "ntrip_atlas.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * Socket connection (nb_transport connection handle)
+ */
+typedef struct {
+    int fd;
+    uint8_t connected;
+    uint8_t tls_ready;            // Handshake finished
+    void* tls;                    // TLS session, NULL for plain TCP
+    char host[NTRIP_ATLAS_MAX_URL_LEN];  // For SNI and certificate checks
+} linux_socket_t;
+
+static const ntrip_tls_hooks_t* g_tls = NULL;
+
+/**
+ * Route SSL casters through TLS hooks
+ */
+void ntrip_platform_linux_set_tls(const ntrip_tls_hooks_t* hooks) {
+    g_tls = hooks;
+}
+
+/**
+ * Start a non-blocking connect to the first address that accepts one
+ */
+static int linux_nb_connect(const char* host, uint16_t port, uint8_t ssl, void** connection) {
+    if (!host || !connection) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    const ntrip_tls_hooks_t* tls = g_tls;
+    if (ssl && !tls) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", (unsigned)port);
+
+    struct addrinfo hints = {0};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+
+    struct addrinfo* addresses = NULL;
+    if (getaddrinfo(host, service, &hints, &addresses) != 0) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+
+    int fd = -1;
+    uint8_t connected = 0;
+    for (struct addrinfo* address = addresses; address; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            connected = 1;
+            break;
+        }
+        if (errno == EINPROGRESS) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+
+    linux_socket_t* sock = calloc(1, sizeof(linux_socket_t));
+    if (!sock) {
+        close(fd);
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    sock->fd = fd;
+    sock->connected = connected;
+    strncpy(sock->host, host, sizeof(sock->host) - 1);
+
+    if (ssl) {
+        sock->tls = tls->open(fd, sock->host);
+        if (!sock->tls) {
+            close(fd);
+            free(sock);
+            return NTRIP_ATLAS_ERROR_PLATFORM;
+        }
+    }
+
+    *connection = sock;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Finish an in-progress connect once the socket turns writable
+ */
+static int linux_nb_check_connected(linux_socket_t* sock) {
+    if (sock->connected) {
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    struct pollfd pfd = { .fd = sock->fd, .events = POLLOUT };
+    if (poll(&pfd, 1, 0) == 0) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(sock->fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+
+    sock->connected = 1;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Connect, then finish the TLS handshake if this is an SSL caster
+ */
+static int linux_nb_ready(linux_socket_t* sock) {
+    int ret = linux_nb_check_connected(sock);
+    if (ret != NTRIP_ATLAS_SUCCESS || !sock->tls || sock->tls_ready) {
+        return ret;
+    }
+
+    ret = g_tls->handshake(sock->tls);
+    if (ret == NTRIP_ATLAS_SUCCESS) {
+        sock->tls_ready = 1;
+    }
+    return ret;
+}
+
+static int linux_nb_send(void* connection, const char* data, size_t len) {
+    linux_socket_t* sock = (linux_socket_t*)connection;
+
+    int ret = linux_nb_ready(sock);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+    if (sock->tls) {
+        return g_tls->write(sock->tls, data, len);
+    }
+
+    ssize_t sent = send(sock->fd, data, len, MSG_NOSIGNAL);
+    if (sent >= 0) {
+        return (int)sent;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    return NTRIP_ATLAS_ERROR_NO_NETWORK;
+}
+
+static int linux_nb_recv(void* connection, char* buffer, size_t max_len) {
+    linux_socket_t* sock = (linux_socket_t*)connection;
+
+    if (sock->tls) {
+        int ret = linux_nb_ready(sock);
+        if (ret != NTRIP_ATLAS_SUCCESS) {
+            return ret;
+        }
+        return g_tls->read(sock->tls, buffer, max_len);
+    }
+
+    ssize_t received = recv(sock->fd, buffer, max_len, 0);
+    if (received >= 0) {
+        return (int)received;
+    }
+    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    return NTRIP_ATLAS_ERROR_NO_NETWORK;
+}
+
+static int linux_nb_poll_fd(void* connection, bool* want_write) {
+    linux_socket_t* sock = (linux_socket_t*)connection;
+
+    // Under TLS the last blocked record operation decides the direction:
+    // handshakes go both ways and reads may need to write
+    if (!sock->connected) {
+        *want_write = true;
+    } else if (sock->tls) {
+        *want_write = g_tls->want_write(sock->tls);
+    }
+    return sock->fd;
+}
+
+static void linux_nb_wait(void* connection, bool want_write, uint32_t timeout_ms) {
+    linux_socket_t* sock = (linux_socket_t*)connection;
+    linux_nb_poll_fd(connection, &want_write);
+
+    struct pollfd pfd = { .fd = sock->fd, .events = want_write ? POLLOUT : POLLIN };
+    poll(&pfd, 1, (int)timeout_ms);
+}
+
+static void linux_nb_close(void* connection) {
+    linux_socket_t* sock = (linux_socket_t*)connection;
+    if (sock) {
+        if (sock->tls) {
+            g_tls->close(sock->tls);
+        }
+        close(sock->fd);
+        free(sock);
+    }
+}
+
+const ntrip_nb_transport_t ntrip_platform_linux_nb_transport = {
+    .connect = linux_nb_connect,
+    .send = linux_nb_send,
+    .recv = linux_nb_recv,
+    .poll_fd = linux_nb_poll_fd,
+    .close = linux_nb_close,
+    .wait = linux_nb_wait
+};
+
+#endif // __linux__
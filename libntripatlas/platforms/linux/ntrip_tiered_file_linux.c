@@ -0,0 +1,379 @@
+/**
+ * Linux Tiered Database File Backend for NTRIP Atlas
+ *
+ * Implements ntrip_tiered_platform_t over a single memory-mapped tiered
+ * database file. Tier 1 is handed to the tiered loader in place (or
+ * unpacked once at open when stored packed), Tier 2
+ * records are located by stride and Tier 3 records by offset table, so no
+ * load touches the file system after open. Compressed Tier 3 records are
+ * decompressed one at a time on load. Also writes such files, which
+ * makes it the desktop stand-in for the ESP32 flash partition image.
+ *
+ * Copyright (c) 2024 NTRIP Atlas Contributors
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Mapped file context (tiered platform_data)
+ */
+typedef struct {
+    const uint8_t* base;
+    size_t size;
+    const ntrip_tiered_file_header_t* header;
+    ntrip_service_index_t* unpacked_index;  // Owned copy of a packed Tier 1
+    const uint8_t* dictionary;   // Shared Tier 3 dictionary (compressed files)
+    size_t dictionary_size;
+} tiered_file_t;
+
+/**
+ * Read a Tier 3 offset (the table need not be 4-byte aligned)
+ */
+static uint32_t read_tier3_offset(const tiered_file_t* file, size_t i) {
+    uint32_t offset;
+    memcpy(&offset, file->base + file->header->tier3_index_offset + i * sizeof(uint32_t),
+           sizeof(offset));
+    return offset;
+}
+
+/**
+ * Tier 1: point the loader at the mapped discovery index
+ */
+static ntrip_atlas_error_t file_load_discovery_index(
+    ntrip_service_index_t** index,
+    size_t* count,
+    void* platform_data
+) {
+    const tiered_file_t* file = (const tiered_file_t*)platform_data;
+    if (!file || !index || !count) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    // Mapping is read-only; the tiered loader never writes the index
+    *index = file->unpacked_index ? file->unpacked_index :
+             (ntrip_service_index_t*)(file->base + file->header->tier1_offset);
+    *count = file->header->tier1_count;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Tier 2: fixed-stride record at service_index
+ */
+static ntrip_atlas_error_t file_load_service_endpoints(
+    ntrip_service_idx_t service_index,
+    ntrip_service_endpoints_t* endpoints,
+    void* platform_data
+) {
+    const tiered_file_t* file = (const tiered_file_t*)platform_data;
+    if (!file || !endpoints) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (service_index >= file->header->db.service_count) {
+        return NTRIP_ATLAS_ERROR_NO_ENDPOINTS;
+    }
+
+    memcpy(endpoints,
+           file->base + file->header->tier2_offset +
+               (size_t)service_index * file->header->tier2_stride,
+           sizeof(*endpoints));
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Tier 3: record between consecutive offsets in the blob
+ */
+static ntrip_atlas_error_t file_load_service_metadata(
+    ntrip_service_idx_t service_index,
+    ntrip_service_metadata_t* metadata,
+    void* platform_data
+) {
+    const tiered_file_t* file = (const tiered_file_t*)platform_data;
+    if (!file || !metadata) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (service_index >= file->header->db.service_count) {
+        return NTRIP_ATLAS_ERROR_NO_METADATA;
+    }
+
+    uint32_t start = read_tier3_offset(file, service_index);
+    uint32_t end = read_tier3_offset(file, (size_t)service_index + 1);
+    if (start > end || end > file->header->tier3_blob_size) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;  // Corrupt offset table
+    }
+
+    const uint8_t* record = file->base + file->header->tier3_blob_offset + start;
+    size_t record_size = end - start;
+
+    // Only this service is decompressed; the stack buffer bounds any record
+    uint8_t decompressed[NTRIP_METADATA_RECORD_MAX_SIZE];
+    if (file->dictionary) {
+        ntrip_atlas_error_t result = ntrip_atlas_decompress_metadata_record(
+            record, record_size, file->dictionary, file->dictionary_size,
+            decompressed, sizeof(decompressed), &record_size);
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+        }
+        record = decompressed;
+    }
+
+    return ntrip_atlas_decode_metadata_record(record, record_size, metadata);
+}
+
+/**
+ * Open a memory-mapped tiered database file as a tiered platform
+ */
+ntrip_atlas_error_t ntrip_atlas_tiered_file_open(
+    const char* path,
+    ntrip_tiered_platform_t* tiered_platform
+) {
+    if (!path || !tiered_platform) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NTRIP_ATLAS_ERROR_NOT_FOUND;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ntrip_tiered_file_header_t)) {
+        close(fd);
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // Mapping stays valid after close
+    if (base == MAP_FAILED) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    const ntrip_tiered_file_header_t* header = (const ntrip_tiered_file_header_t*)base;
+    ntrip_atlas_error_t result = ntrip_atlas_validate_tiered_file_header(header, size);
+    if (result == NTRIP_ATLAS_SUCCESS) {
+        ntrip_compatibility_t compatibility;
+        result = ntrip_atlas_check_database_compatibility(&header->db, &compatibility);
+    }
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        munmap(base, size);
+        return result;
+    }
+
+    tiered_file_t* file = malloc(sizeof(tiered_file_t));
+    if (!file) {
+        munmap(base, size);
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    file->base = (const uint8_t*)base;
+    file->size = size;
+    file->header = header;
+    file->unpacked_index = NULL;
+    file->dictionary = NULL;
+    file->dictionary_size = 0;
+
+    // Packed Tier 1: the loader indexes entries directly, so unpack once
+    if (header->db.feature_flags & NTRIP_DB_FEATURE_PACKED_INDEX) {
+        size_t count = 0;
+        file->unpacked_index = malloc((header->tier1_count ? header->tier1_count : 1) *
+                                      sizeof(ntrip_service_index_t));
+        result = file->unpacked_index ?
+            ntrip_atlas_unpack_discovery_index(file->base + header->tier1_offset,
+                                               header->tier2_offset - header->tier1_offset,
+                                               file->unpacked_index, header->tier1_count, &count) :
+            NTRIP_ATLAS_ERROR_NO_MEMORY;
+        if (result == NTRIP_ATLAS_SUCCESS && count != header->tier1_count) {
+            result = NTRIP_ATLAS_ERROR_LOAD_FAILED;
+        }
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            free(file->unpacked_index);
+            free(file);
+            munmap(base, size);
+            return result == NTRIP_ATLAS_ERROR_NO_MEMORY ? result : NTRIP_ATLAS_ERROR_LOAD_FAILED;
+        }
+    }
+
+    // Compressed Tier 3: the dictionary fills the blob up to the first record
+    if (header->db.feature_flags & NTRIP_DB_FEATURE_COMPRESSED_METADATA) {
+        uint32_t dictionary_size = read_tier3_offset(file, 0);
+        if (dictionary_size > header->tier3_blob_size) {
+            free(file->unpacked_index);
+            free(file);
+            munmap(base, size);
+            return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+        }
+        file->dictionary = file->base + header->tier3_blob_offset;
+        file->dictionary_size = dictionary_size;
+    }
+
+    memset(tiered_platform, 0, sizeof(*tiered_platform));
+    tiered_platform->load_discovery_index = file_load_discovery_index;
+    tiered_platform->load_service_endpoints = file_load_service_endpoints;
+    tiered_platform->load_service_metadata = file_load_service_metadata;
+    tiered_platform->platform_data = file;
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Unmap a tiered database file
+ */
+void ntrip_atlas_tiered_file_close(ntrip_tiered_platform_t* tiered_platform) {
+    if (!tiered_platform || tiered_platform->load_discovery_index != file_load_discovery_index) {
+        return;
+    }
+
+    tiered_file_t* file = (tiered_file_t*)tiered_platform->platform_data;
+    if (file) {
+        munmap((void*)file->base, file->size);
+        free(file->unpacked_index);
+        free(file);
+    }
+    memset(tiered_platform, 0, sizeof(*tiered_platform));
+}
+
+/**
+ * Write a tiered database file
+ */
+ntrip_atlas_error_t ntrip_atlas_tiered_file_write(
+    const char* path,
+    uint32_t database_version,
+    const ntrip_service_index_t* index,
+    size_t index_count,
+    const ntrip_service_endpoints_t* endpoints,
+    const ntrip_service_metadata_t* metadata,
+    size_t service_count,
+    uint8_t encodings
+) {
+    if (!path || (!index && index_count > 0) || !endpoints || !metadata ||
+        service_count == 0 || service_count > UINT16_MAX ||
+        service_count > NTRIP_SERVICE_INDEX_INVALID ||
+        (encodings & ~(NTRIP_DB_FEATURE_PACKED_INDEX | NTRIP_DB_FEATURE_COMPRESSED_METADATA))) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;  // Every service needs a valid index
+    }
+    bool compress = (encodings & NTRIP_DB_FEATURE_COMPRESSED_METADATA) != 0;
+
+    // Tier 1 section size, packed or as an array
+    size_t tier1_size = index_count * sizeof(ntrip_service_index_t);
+    ntrip_atlas_error_t result = NTRIP_ATLAS_SUCCESS;
+    if (encodings & NTRIP_DB_FEATURE_PACKED_INDEX) {
+        result = ntrip_atlas_pack_discovery_index(index, index_count, NULL, 0, &tier1_size);
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            return result;
+        }
+    }
+
+    // Compress Tier 3 up front so the offset table can precede the blob
+    uint32_t* offsets = malloc((service_count + 1) * sizeof(uint32_t));
+    uint8_t* blob = malloc(NTRIP_METADATA_DICT_MAX_SIZE +
+                           service_count * NTRIP_METADATA_COMPRESSED_MAX_SIZE);
+    uint8_t* tier1 = malloc(tier1_size ? tier1_size : 1);
+    if (!offsets || !blob || !tier1) {
+        free(offsets);
+        free(blob);
+        free(tier1);
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+
+    if (encodings & NTRIP_DB_FEATURE_PACKED_INDEX) {
+        result = ntrip_atlas_pack_discovery_index(index, index_count, tier1, tier1_size, &tier1_size);
+    } else if (tier1_size > 0) {
+        memcpy(tier1, index, tier1_size);
+    }
+
+    size_t blob_size = 0;
+    if (result == NTRIP_ATLAS_SUCCESS && compress) {
+        result = ntrip_atlas_build_metadata_dictionary(
+            metadata, service_count, blob, NTRIP_METADATA_DICT_MAX_SIZE, &blob_size);
+    }
+    size_t dictionary_size = blob_size;
+
+    uint8_t record[NTRIP_METADATA_RECORD_MAX_SIZE];
+    for (size_t i = 0; result == NTRIP_ATLAS_SUCCESS && i < service_count; i++) {
+        size_t record_size, compressed_size;
+        offsets[i] = (uint32_t)blob_size;
+        result = ntrip_atlas_encode_metadata_record(&metadata[i], record, sizeof(record), &record_size);
+        if (result == NTRIP_ATLAS_SUCCESS && compress) {
+            result = ntrip_atlas_compress_metadata_record(
+                record, record_size, blob, dictionary_size,
+                blob + blob_size, NTRIP_METADATA_COMPRESSED_MAX_SIZE, &compressed_size);
+            blob_size += compressed_size;
+        } else if (result == NTRIP_ATLAS_SUCCESS) {
+            memcpy(blob + blob_size, record, record_size);
+            blob_size += record_size;
+        }
+    }
+    offsets[service_count] = (uint32_t)blob_size;
+
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        free(offsets);
+        free(blob);
+        free(tier1);
+        return result;
+    }
+
+    ntrip_tiered_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    ntrip_atlas_create_database_header(&header.db, database_version, 1, (uint16_t)service_count);
+    // Encoding bits describe this file's layout, not what the library supports
+    header.db.feature_flags &= (uint8_t)~(NTRIP_DB_FEATURE_PACKED_INDEX | NTRIP_DB_FEATURE_COMPRESSED_METADATA);
+    header.db.feature_flags |= NTRIP_DB_FEATURE_TIERED_LOADING | encodings;
+    header.layout_magic = NTRIP_TIERED_FILE_MAGIC;
+    header.tier1_stride = (encodings & NTRIP_DB_FEATURE_PACKED_INDEX) ? 0 : sizeof(ntrip_service_index_t);
+    header.tier2_stride = sizeof(ntrip_service_endpoints_t);
+    header.tier1_count = (uint32_t)index_count;
+    header.tier1_offset = sizeof(header);
+    header.tier2_offset = header.tier1_offset + (uint32_t)tier1_size;
+    header.tier3_index_offset = header.tier2_offset + (uint32_t)(service_count * header.tier2_stride);
+    header.tier3_blob_offset = header.tier3_index_offset + (uint32_t)((service_count + 1) * sizeof(uint32_t));
+    header.tier3_blob_size = (uint32_t)blob_size;
+
+    FILE* out = fopen(path, "wb");
+    if (!out) {
+        free(offsets);
+        free(blob);
+        free(tier1);
+        return NTRIP_ATLAS_ERROR_PLATFORM;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    if (ok && tier1_size > 0) {
+        ok = fwrite(tier1, 1, tier1_size, out) == tier1_size;
+    }
+    if (ok) {
+        ok = fwrite(endpoints, sizeof(ntrip_service_endpoints_t), service_count, out) == service_count;
+    }
+
+    // Offset table: service_count + 1 entries, first is the dictionary size (0 if
+    // uncompressed), last the blob size
+    if (ok) {
+        ok = fwrite(offsets, sizeof(uint32_t), service_count + 1, out) == service_count + 1;
+    }
+    if (ok) {
+        ok = fwrite(blob, 1, blob_size, out) == blob_size;
+    }
+
+    free(offsets);
+    free(blob);
+    free(tier1);
+
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+
+    return ok ? NTRIP_ATLAS_SUCCESS : NTRIP_ATLAS_ERROR_PLATFORM;
+}
+
+#endif // __linux__
@@ -0,0 +1,166 @@
+/**
+ * OpenSSL TLS Hooks for the Linux Socket Transport
+ *
+ * Non-blocking TLS for SSL casters in ntrip_platform_linux_nb_transport.
+ * Built only with NTRIP_ATLAS_USE_OPENSSL so the core never links a TLS
+ * library; register with:
+ *
+ *   ntrip_platform_linux_openssl_init(NULL, true);
+ *   ntrip_platform_linux_set_tls(&ntrip_platform_linux_openssl_tls);
+ *
+ * Copyright (c) 2024 NTRIP Atlas Contributors
+ * Licensed under MIT License
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "ntrip_atlas.h"
+
+#if defined(__linux__) && defined(NTRIP_ATLAS_USE_OPENSSL)
+
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+/**
+ * One TLS session (tls hooks session handle)
+ */
+typedef struct {
+    SSL* ssl;
+    bool want_write;              // Direction of the last would-block
+} openssl_session_t;
+
+static SSL_CTX* g_ctx = NULL;
+
+/**
+ * Set up the OpenSSL client context
+ */
+ntrip_atlas_error_t ntrip_platform_linux_openssl_init(const char* ca_file, bool verify_peer) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    if (!ctx) {
+        return NTRIP_ATLAS_ERROR_PLATFORM;
+    }
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+
+    if (verify_peer) {
+        int loaded = ca_file ? SSL_CTX_load_verify_locations(ctx, ca_file, NULL)
+                             : SSL_CTX_set_default_verify_paths(ctx);
+        if (loaded != 1) {
+            SSL_CTX_free(ctx);
+            return NTRIP_ATLAS_ERROR_PLATFORM;
+        }
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, NULL);
+    } else {
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
+    }
+
+    if (g_ctx) {
+        SSL_CTX_free(g_ctx);
+    }
+    g_ctx = ctx;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+static bool is_ip_literal(const char* host) {
+    unsigned char address[16];
+    return inet_pton(AF_INET, host, address) == 1 || inet_pton(AF_INET6, host, address) == 1;
+}
+
+static void* openssl_open(int fd, const char* host) {
+    if (!g_ctx) {
+        return NULL;
+    }
+
+    openssl_session_t* session = calloc(1, sizeof(openssl_session_t));
+    if (!session) {
+        return NULL;
+    }
+    session->ssl = SSL_new(g_ctx);
+    if (!session->ssl || SSL_set_fd(session->ssl, fd) != 1) {
+        SSL_free(session->ssl);
+        free(session);
+        return NULL;
+    }
+
+    // SNI and certificate name checks only apply to DNS names
+    if (is_ip_literal(host)) {
+        X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(session->ssl), host);
+    } else {
+        SSL_set_tlsext_host_name(session->ssl, host);
+        SSL_set1_host(session->ssl, host);
+    }
+
+    SSL_set_connect_state(session->ssl);
+    return session;
+}
+
+/**
+ * Map an OpenSSL result to bytes, would-block, 0 (closed) or an error
+ */
+static int openssl_result(openssl_session_t* session, int ret) {
+    if (ret > 0) {
+        return ret;
+    }
+
+    int error = SSL_get_error(session->ssl, ret);
+    switch (error) {
+        case SSL_ERROR_WANT_READ:
+            session->want_write = false;
+            return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+        case SSL_ERROR_WANT_WRITE:
+            session->want_write = true;
+            return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+        case SSL_ERROR_ZERO_RETURN:
+            return 0;
+        case SSL_ERROR_SYSCALL:
+            // Casters often drop the socket without close_notify
+            ERR_clear_error();
+            return ret == 0 ? 0 : NTRIP_ATLAS_ERROR_NO_NETWORK;
+        default:
+            ERR_clear_error();
+            return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+}
+
+static int openssl_handshake(void* handle) {
+    openssl_session_t* session = (openssl_session_t*)handle;
+    int ret = openssl_result(session, SSL_do_handshake(session->ssl));
+    if (ret > 0) {
+        return NTRIP_ATLAS_SUCCESS;
+    }
+    return ret == 0 ? NTRIP_ATLAS_ERROR_NO_NETWORK : ret;
+}
+
+static int openssl_read(void* handle, char* buffer, size_t max_len) {
+    openssl_session_t* session = (openssl_session_t*)handle;
+    return openssl_result(session, SSL_read(session->ssl, buffer, (int)max_len));
+}
+
+static int openssl_write(void* handle, const char* data, size_t len) {
+    openssl_session_t* session = (openssl_session_t*)handle;
+    int ret = openssl_result(session, SSL_write(session->ssl, data, (int)len));
+    return ret == 0 ? NTRIP_ATLAS_ERROR_NO_NETWORK : ret;
+}
+
+static bool openssl_want_write(void* handle) {
+    return ((openssl_session_t*)handle)->want_write;
+}
+
+static void openssl_close(void* handle) {
+    openssl_session_t* session = (openssl_session_t*)handle;
+    // No close_notify: the socket is about to go and nothing waits for it
+    SSL_free(session->ssl);
+    free(session);
+}
+
+const ntrip_tls_hooks_t ntrip_platform_linux_openssl_tls = {
+    .open = openssl_open,
+    .handshake = openssl_handshake,
+    .read = openssl_read,
+    .write = openssl_write,
+    .want_write = openssl_want_write,
+    .close = openssl_close
+};
+
+#endif // __linux__ && NTRIP_ATLAS_USE_OPENSSL
@@ -2,7 +2,7 @@
  * NTRIP Atlas - Compact Failure Tracking Implementation
  *
  * Memory-optimized failure tracking for ESP32 and embedded systems.
- * Reduces failure storage from 80 bytes to 6 bytes per service (93% reduction).
+ * Reduces failure storage from 80 bytes to 5 bytes per service (94% reduction).
  *
  * Licensed under MIT License
  */
@@ -12,17 +12,34 @@
 #include <time.h>
 
 // Maximum number of services supported in compact mode
+#ifndef NTRIP_COMPACT_MAX_SERVICES
+#if NTRIP_ATLAS_SERVICE_INDEX_BITS == 8
 #define NTRIP_COMPACT_MAX_SERVICES 255
-#define NTRIP_COMPACT_INVALID_INDEX 255
+#else
+#define NTRIP_COMPACT_MAX_SERVICES 1024
+#endif
+#endif
+#define NTRIP_COMPACT_INVALID_INDEX NTRIP_SERVICE_INDEX_INVALID
+
+#if NTRIP_COMPACT_MAX_SERVICES > NTRIP_SERVICE_INDEX_INVALID
+#error "NTRIP_COMPACT_MAX_SERVICES exceeds the configured service index width"
+#endif
 
 // Global state for compact failure tracking
 static struct {
-    ntrip_compact_failure_t failures[NTRIP_COMPACT_MAX_SERVICES];
+    ntrip_compact_failure_t* failures;   // Indexed by service index
+    size_t capacity;
     const ntrip_service_index_entry_t* service_mapping;
     size_t mapping_count;
     bool initialized;
 } g_compact_failure_state = {0};
 
+// Bumped on every state change; kept outside the state so re-init still moves it
+static uint32_t g_compact_failure_generation = 0;
+
+// Built-in storage for ntrip_atlas_init_compact_failure_tracking()
+static ntrip_compact_failure_t g_compact_failure_storage[NTRIP_COMPACT_MAX_SERVICES];
+
 // Default exponential backoff intervals (seconds)
 // 1h, 4h, 12h, 1d, 3d, 1w, 2w, 1month
 static const uint32_t g_default_backoff_intervals[8] = {
@@ -46,32 +63,56 @@ static uint32_t get_current_time_hours(void) {
 }
 
 /**
- * Initialize compact failure tracking with service index mapping
+ * Initialize compact failure tracking over caller-provided storage
  */
-ntrip_atlas_error_t ntrip_atlas_init_compact_failure_tracking(
+ntrip_atlas_error_t ntrip_atlas_init_compact_failure_tracking_with_storage(
     const ntrip_service_index_entry_t* service_mapping,
-    size_t mapping_count
+    size_t mapping_count,
+    ntrip_compact_failure_t* storage,
+    size_t capacity
 ) {
-    if (!service_mapping || mapping_count == 0 || mapping_count > NTRIP_COMPACT_MAX_SERVICES) {
+    if (!service_mapping || mapping_count == 0 || !storage ||
+        mapping_count > capacity || capacity > NTRIP_SERVICE_INDEX_INVALID) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
+    // Every mapped index must have a record
+    for (size_t i = 0; i < mapping_count; i++) {
+        if (service_mapping[i].service_index >= capacity) {
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
+    }
+
     // Store service mapping
     g_compact_failure_state.service_mapping = service_mapping;
     g_compact_failure_state.mapping_count = mapping_count;
 
     // Initialize all failure records to zero
-    memset(g_compact_failure_state.failures, 0, sizeof(g_compact_failure_state.failures));
+    g_compact_failure_state.failures = storage;
+    g_compact_failure_state.capacity = capacity;
+    memset(storage, 0, capacity * sizeof(ntrip_compact_failure_t));
 
     g_compact_failure_state.initialized = true;
+    g_compact_failure_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
 
+/**
+ * Initialize compact failure tracking with service index mapping (built-in storage)
+ */
+ntrip_atlas_error_t ntrip_atlas_init_compact_failure_tracking(
+    const ntrip_service_index_entry_t* service_mapping,
+    size_t mapping_count
+) {
+    return ntrip_atlas_init_compact_failure_tracking_with_storage(
+        service_mapping, mapping_count, g_compact_failure_storage, NTRIP_COMPACT_MAX_SERVICES);
+}
+
 /**
  * Convert service ID string to compact index
  */
-uint8_t ntrip_atlas_get_service_index(const char* service_id) {
+ntrip_service_idx_t ntrip_atlas_get_service_index(const char* service_id) {
     if (!g_compact_failure_state.initialized || !service_id) {
         return NTRIP_COMPACT_INVALID_INDEX;
     }
@@ -89,8 +130,8 @@ uint8_t ntrip_atlas_get_service_index(const char* service_id) {
 /**
  * Record a service failure using compact storage
  */
-ntrip_atlas_error_t ntrip_atlas_record_compact_failure(uint8_t service_index) {
-    if (!g_compact_failure_state.initialized || service_index >= NTRIP_COMPACT_MAX_SERVICES) {
+ntrip_atlas_error_t ntrip_atlas_record_compact_failure(ntrip_service_idx_t service_index) {
+    if (!g_compact_failure_state.initialized || service_index >= g_compact_failure_state.capacity) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
@@ -113,6 +154,7 @@ ntrip_atlas_error_t ntrip_atlas_record_compact_failure(uint8_t service_index) {
     uint32_t current_hours = get_current_time_hours();
     uint32_t backoff_hours = (backoff_seconds + 3599) / 3600;  // Round up to next hour
     failure->retry_time_hours = current_hours + backoff_hours;
+    g_compact_failure_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
@@ -120,8 +162,8 @@ ntrip_atlas_error_t ntrip_atlas_record_compact_failure(uint8_t service_index) {
 /**
  * Record service success using compact storage (resets failure count)
  */
-ntrip_atlas_error_t ntrip_atlas_record_compact_success(uint8_t service_index) {
-    if (!g_compact_failure_state.initialized || service_index >= NTRIP_COMPACT_MAX_SERVICES) {
+ntrip_atlas_error_t ntrip_atlas_record_compact_success(ntrip_service_idx_t service_index) {
+    if (!g_compact_failure_state.initialized || service_index >= g_compact_failure_state.capacity) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
@@ -131,6 +173,7 @@ ntrip_atlas_error_t ntrip_atlas_record_compact_success(uint8_t service_index) {
     failure->failure_count = 0;
     failure->backoff_level = 0;
     failure->retry_time_hours = 0;
+    g_compact_failure_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
@@ -138,8 +181,8 @@ ntrip_atlas_error_t ntrip_atlas_record_compact_success(uint8_t service_index) {
 /**
  * Check if service is blocked using compact storage
  */
-bool ntrip_atlas_is_compact_service_blocked(uint8_t service_index) {
-    if (!g_compact_failure_state.initialized || service_index >= NTRIP_COMPACT_MAX_SERVICES) {
+bool ntrip_atlas_is_compact_service_blocked(ntrip_service_idx_t service_index) {
+    if (!g_compact_failure_state.initialized || service_index >= g_compact_failure_state.capacity) {
         return false;  // If we can't check, assume not blocked
     }
 
@@ -158,8 +201,8 @@ bool ntrip_atlas_is_compact_service_blocked(uint8_t service_index) {
 /**
  * Get retry time for compact service (hours until retry allowed)
  */
-uint32_t ntrip_atlas_get_compact_retry_time_hours(uint8_t service_index) {
-    if (!g_compact_failure_state.initialized || service_index >= NTRIP_COMPACT_MAX_SERVICES) {
+uint32_t ntrip_atlas_get_compact_retry_time_hours(ntrip_service_idx_t service_index) {
+    if (!g_compact_failure_state.initialized || service_index >= g_compact_failure_state.capacity) {
         return 0;  // Available immediately if we can't check
     }
 
@@ -177,6 +220,13 @@ uint32_t ntrip_atlas_get_compact_retry_time_hours(uint8_t service_index) {
     return failure->retry_time_hours - current_hours;
 }
 
+/**
+ * Failure-state generation
+ */
+uint32_t ntrip_atlas_get_compact_failure_generation(void) {
+    return g_compact_failure_generation;
+}
+
 /**
  * Convert compact failure to full failure structure (for debugging/analysis)
  */
@@ -271,7 +321,7 @@ bool ntrip_atlas_should_skip_service(const char* service_id) {
     }
 
     // Get service index
-    uint8_t service_index = ntrip_atlas_get_service_index(service_id);
+    ntrip_service_idx_t service_index = ntrip_atlas_get_service_index(service_id);
     if (service_index == NTRIP_COMPACT_INVALID_INDEX) {
         // Unknown service - don't skip (might be a new service)
         return false;
@@ -295,10 +345,10 @@ void ntrip_atlas_get_compact_failure_stats(uint32_t* total_failures, uint32_t* b
     uint32_t failures = 0;
     uint32_t blocked = 0;
 
-    for (size_t i = 0; i < NTRIP_COMPACT_MAX_SERVICES; i++) {
+    for (size_t i = 0; i < g_compact_failure_state.capacity; i++) {
         if (g_compact_failure_state.failures[i].failure_count > 0) {
             failures++;
-            if (ntrip_atlas_is_compact_service_blocked((uint8_t)i)) {
+            if (ntrip_atlas_is_compact_service_blocked((ntrip_service_idx_t)i)) {
                 blocked++;
             }
         }
@@ -306,5 +356,5 @@ void ntrip_atlas_get_compact_failure_stats(uint32_t* total_failures, uint32_t* b
 
     if (total_failures) *total_failures = failures;
     if (blocked_services) *blocked_services = blocked;
-    if (memory_used) *memory_used = sizeof(g_compact_failure_state.failures);
+    if (memory_used) *memory_used = g_compact_failure_state.capacity * sizeof(ntrip_compact_failure_t);
 }
\ No newline at end of file
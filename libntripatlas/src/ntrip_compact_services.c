@@ -100,6 +100,7 @@ ntrip_atlas_error_t ntrip_atlas_compress_service(
     if (full->auth_method == NTRIP_AUTH_DIGEST) compact->flags |= NTRIP_FLAG_AUTH_DIGEST;
     if (full->requires_registration) compact->flags |= NTRIP_FLAG_REQUIRES_REG;
     if (full->typical_free_access) compact->flags |= NTRIP_FLAG_FREE_ACCESS;
+    if (full->sourcetable_filter) compact->flags |= NTRIP_FLAG_SOURCETABLE_FILTER;
 
     // Geographic coverage (convert double to int16 with 0.01 precision)
     compact->lat_min_deg100 = (int16_t)(full->coverage_lat_min * 100.0);
@@ -144,6 +145,7 @@ ntrip_atlas_error_t ntrip_atlas_expand_service(
 
     full->requires_registration = (compact->flags & NTRIP_FLAG_REQUIRES_REG) ? 1 : 0;
     full->typical_free_access = (compact->flags & NTRIP_FLAG_FREE_ACCESS) ? 1 : 0;
+    full->sourcetable_filter = (compact->flags & NTRIP_FLAG_SOURCETABLE_FILTER) ? 1 : 0;
 
     // Geographic coverage (convert int16 back to double)
     full->coverage_lat_min = compact->lat_min_deg100 / 100.0;
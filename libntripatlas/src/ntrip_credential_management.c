@@ -12,6 +12,10 @@
 #include <string.h>
 #include <stdio.h>
 
+// Source of store generations; unique across stores so a re-initialised
+// store never repeats a generation it had before
+static uint32_t g_credential_generation = 0;
+
 /**
  * Initialize credential store
  */
@@ -20,6 +24,7 @@ void ntrip_atlas_init_credential_store(ntrip_credential_store_t* store) {
 
     memset(store, 0, sizeof(ntrip_credential_store_t));
     store->count = 0;
+    store->generation = ++g_credential_generation;
 }
 
 /**
@@ -60,6 +65,7 @@ ntrip_atlas_error_t ntrip_atlas_add_credential(ntrip_credential_store_t* store,
     store->credentials[index].password[NTRIP_ATLAS_MAX_PASSWORD - 1] = '\0';
 
     store->count++;
+    store->generation = ++g_credential_generation;
     return NTRIP_ATLAS_SUCCESS;
 }
 
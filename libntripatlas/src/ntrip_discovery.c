@@ -0,0 +1,94 @@
+/**
+ * NTRIP Atlas - Non-Blocking Discovery
+ *
+ * Resumable sourcetable query for single-threaded event loops. A
+ * non-blocking HTTP stream feeds the same streaming parser as
+ * ntrip_query_service_streaming(), so an Arduino loop keeps handling GNSS
+ * data and one epoll thread can run many discoveries at once.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include "ntrip_stream_parser.h"
+#include <string.h>
+
+/**
+ * Body callback: feed decoded sourcetable bytes to the line parser
+ */
+static int sourcetable_body(const char* chunk, size_t len, void* context) {
+    return ntrip_stream_parser_process_chunk((ntrip_stream_parser_state_t*)context, chunk, len);
+}
+
+/**
+ * Start discovering a service's best mountpoint without blocking
+ */
+ntrip_atlas_error_t ntrip_atlas_discovery_begin(
+    ntrip_discovery_t* discovery,
+    const ntrip_platform_t* platform,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria
+) {
+    if (!discovery || !platform || !service) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    memset(discovery, 0, sizeof(*discovery));
+    discovery->service = service;
+    ntrip_stream_parser_init(&discovery->parser, user_lat, user_lon, service, criteria);
+
+    // Same server-side filter as the blocking query, without its retry
+    char path[NTRIP_SOURCETABLE_PATH_SIZE];
+    ntrip_stream_parser_build_path(path, sizeof(path), service, user_lat, user_lon, criteria);
+
+    return ntrip_atlas_http_stream_begin(&discovery->stream, platform,
+                                         service->base_url, service->port, service->ssl, path,
+                                         sourcetable_body, &discovery->parser,
+                                         NTRIP_ATLAS_DISCOVERY_TIMEOUT_MS);
+}
+
+/**
+ * Make as much progress as possible without waiting
+ */
+ntrip_atlas_error_t ntrip_atlas_discovery_step(ntrip_discovery_t* discovery) {
+    if (!discovery) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    return ntrip_atlas_http_stream_step(&discovery->stream);
+}
+
+/**
+ * Descriptor and direction to wait on before the next step
+ */
+int ntrip_atlas_discovery_poll_fd(const ntrip_discovery_t* discovery, bool* want_write) {
+    return ntrip_atlas_http_stream_poll_fd(discovery ? &discovery->stream : NULL, want_write);
+}
+
+/**
+ * Close the connection and return the best mountpoint
+ */
+ntrip_atlas_error_t ntrip_atlas_discovery_end(
+    ntrip_discovery_t* discovery,
+    ntrip_mountpoint_t* result
+) {
+    if (!discovery) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    // Cancelling keeps whatever was parsed so far
+    ntrip_atlas_error_t status = ntrip_atlas_http_stream_end(&discovery->stream);
+    if (status != NTRIP_ATLAS_SUCCESS) {
+        return status;
+    }
+
+    ntrip_mountpoint_t best;
+    if (ntrip_stream_parser_get_result(&discovery->parser, &best) != 0) {
+        return NTRIP_ATLAS_ERROR_NO_SERVICES;
+    }
+    if (result) {
+        *result = best;
+    }
+    return NTRIP_ATLAS_SUCCESS;
+}
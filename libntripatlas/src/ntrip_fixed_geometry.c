@@ -0,0 +1,275 @@
+/**
+ * NTRIP Atlas - Fixed-Point Geometry
+ *
+ * Integer-only distance and coverage math for MCUs without an FPU, where
+ * double trig is soft-float and dominates discovery time. Angles are binary
+ * angles (2^32 per turn) so wraparound is free; sin/cos and atan2 use
+ * CORDIC, and distances come from the chord between Q30 unit vectors with
+ * a single integer square root.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+
+#define CORDIC_ITERATIONS       31
+
+// CORDIC gain compensation 1/K in Q30 (K = prod sqrt(1 + 2^-2i))
+#define CORDIC_INV_GAIN_Q30     652032874
+
+// Microdegrees to binary angle: 2^32 / 360e6 in Q28
+#define MICRODEG_TO_BAM_Q28     3202559735ULL
+
+// Earth circumference in meters (mean radius 6371 km) and meters to binary angle in Q16
+#define EARTH_CIRCUMFERENCE_M   40030174ULL
+#define METERS_TO_BAM_Q16       7031570ULL
+
+#define BAM_QUARTER_TURN        0x40000000
+#define BAM_HALF_TURN           0x80000000U
+
+/**
+ * atan(2^-i) as binary angles
+ */
+static const int32_t g_cordic_atan_bam[CORDIC_ITERATIONS] = {
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465, 10679838,
+    5340245, 2670163, 1335087, 667544, 333772, 166886, 83443, 41722, 20861,
+    10430, 5215, 2608, 1304, 652, 326, 163, 81, 41, 20, 10, 5, 3, 1, 1
+};
+
+/**
+ * Convert microdegrees to a binary angle (wraps at ±180°)
+ */
+static int32_t microdeg_to_bam(int32_t microdeg) {
+    uint64_t magnitude = microdeg < 0 ? (uint64_t)(-(int64_t)microdeg) : (uint64_t)microdeg;
+    uint32_t bam = (uint32_t)((magnitude * MICRODEG_TO_BAM_Q28 + (1ULL << 27)) >> 28);
+    return (int32_t)(microdeg < 0 ? 0U - bam : bam);
+}
+
+/**
+ * Sine and cosine of a binary angle, Q30
+ */
+static void bam_sin_cos(int32_t angle, int32_t* sin_q30, int32_t* cos_q30) {
+    // CORDIC converges within ±90°; fold the other half turn by symmetry
+    bool flip = false;
+    if (angle > BAM_QUARTER_TURN || angle < -BAM_QUARTER_TURN) {
+        angle = (int32_t)((uint32_t)angle + BAM_HALF_TURN);
+        flip = true;
+    }
+
+    int64_t x = CORDIC_INV_GAIN_Q30;
+    int64_t y = 0;
+    int64_t z = angle;
+
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+        int64_t dx = y >> i;
+        int64_t dy = x >> i;
+        if (z >= 0) {
+            x -= dx;
+            y += dy;
+            z -= g_cordic_atan_bam[i];
+        } else {
+            x += dx;
+            y -= dy;
+            z += g_cordic_atan_bam[i];
+        }
+    }
+
+    if (flip) {
+        x = -x;
+        y = -y;
+    }
+
+    if (sin_q30) *sin_q30 = (int32_t)y;
+    if (cos_q30) *cos_q30 = (int32_t)x;
+}
+
+/**
+ * Sine and cosine of an angle in microdegrees, Q30
+ */
+void ntrip_atlas_fixed_sin_cos(int32_t angle_microdeg, int32_t* sin_q30, int32_t* cos_q30) {
+    bam_sin_cos(microdeg_to_bam(angle_microdeg), sin_q30, cos_q30);
+}
+
+/**
+ * Angle of (x, y) as a binary angle
+ *
+ * CORDIC vectoring: rotate the vector onto the x axis, accumulating the
+ * rotation. Inputs are normalized to about 2^40 first so small vectors
+ * keep precision and the gain cannot overflow.
+ */
+int32_t ntrip_atlas_fixed_atan2(int64_t y, int64_t x) {
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+
+    // Fold into the right half plane
+    uint32_t base = 0;
+    if (x < 0) {
+        base = y >= 0 ? BAM_HALF_TURN : 0U - BAM_HALF_TURN;
+        x = -x;
+        y = -y;
+    }
+
+    const int64_t limit = (int64_t)1 << 40;
+    while (x > limit || y > limit || y < -limit) {
+        x >>= 1;
+        y >>= 1;
+    }
+    while (x <= limit / 2 && y <= limit / 2 && y >= -limit / 2) {
+        x <<= 1;
+        y <<= 1;
+    }
+
+    int64_t z = 0;
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+        int64_t dx = y >> i;
+        int64_t dy = x >> i;
+        if (y > 0) {
+            x += dx;
+            y -= dy;
+            z += g_cordic_atan_bam[i];
+        } else {
+            x -= dx;
+            y += dy;
+            z -= g_cordic_atan_bam[i];
+        }
+    }
+
+    return (int32_t)(base + (uint32_t)z);
+}
+
+/**
+ * Integer square root (floor), bit by bit
+ */
+uint32_t ntrip_atlas_fixed_isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+/**
+ * Q30 product with rounding
+ */
+static int32_t mul_q30(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b + (1 << 29)) >> 30);
+}
+
+/**
+ * Convert microdegree lat/lon to a Q30 unit vector
+ */
+void ntrip_atlas_fixed_unit_vector(
+    int32_t latitude_microdeg,
+    int32_t longitude_microdeg,
+    ntrip_unit_vector_t* vector
+) {
+    if (!vector) {
+        return;
+    }
+
+    int32_t sin_lat, cos_lat, sin_lon, cos_lon;
+    ntrip_atlas_fixed_sin_cos(latitude_microdeg, &sin_lat, &cos_lat);
+    ntrip_atlas_fixed_sin_cos(longitude_microdeg, &sin_lon, &cos_lon);
+
+    vector->x = mul_q30(cos_lat, cos_lon);
+    vector->y = mul_q30(cos_lat, sin_lon);
+    vector->z = sin_lat;
+}
+
+/**
+ * Great-circle distance between two unit vectors in meters
+ *
+ * The squared chord is exact in Q60; its root gives the half chord h, and
+ * the half angle is atan2(h, sqrt(1 - h^2)), accurate at any range.
+ */
+uint32_t ntrip_atlas_fixed_vector_distance_m(
+    const ntrip_unit_vector_t* a,
+    const ntrip_unit_vector_t* b
+) {
+    if (!a || !b) {
+        return UINT32_MAX;
+    }
+
+    int64_t dx = (int64_t)a->x - b->x;
+    int64_t dy = (int64_t)a->y - b->y;
+    int64_t dz = (int64_t)a->z - b->z;
+
+    // Each term is below 2^62, so the sum fits in uint64
+    uint64_t chord_sq_q60 = (uint64_t)(dx * dx) + (uint64_t)(dy * dy) + (uint64_t)(dz * dz);
+    if (chord_sq_q60 == 0) {
+        return 0;
+    }
+
+    // Half chord in Q30, clamped to the antipode
+    uint64_t half_chord = (ntrip_atlas_fixed_isqrt64(chord_sq_q60) + 1) >> 1;
+    const uint64_t one_q30 = (uint64_t)1 << 30;
+    if (half_chord > one_q30) {
+        half_chord = one_q30;
+    }
+    uint64_t cos_half = ntrip_atlas_fixed_isqrt64((one_q30 << 30) - half_chord * half_chord);
+
+    uint32_t half_angle = (uint32_t)ntrip_atlas_fixed_atan2((int64_t)half_chord, (int64_t)cos_half);
+    return (uint32_t)(((uint64_t)half_angle * 2 * EARTH_CIRCUMFERENCE_M + (1ULL << 31)) >> 32);
+}
+
+/**
+ * Great-circle distance between two microdegree positions in meters
+ */
+uint32_t ntrip_atlas_fixed_distance_m(
+    int32_t lat1_microdeg,
+    int32_t lon1_microdeg,
+    int32_t lat2_microdeg,
+    int32_t lon2_microdeg
+) {
+    ntrip_unit_vector_t a, b;
+    ntrip_atlas_fixed_unit_vector(lat1_microdeg, lon1_microdeg, &a);
+    ntrip_atlas_fixed_unit_vector(lat2_microdeg, lon2_microdeg, &b);
+    return ntrip_atlas_fixed_vector_distance_m(&a, &b);
+}
+
+/**
+ * Binary angle subtended by a great-circle distance in meters
+ */
+uint32_t ntrip_atlas_fixed_meters_to_angle(uint32_t meters) {
+    uint64_t angle = ((uint64_t)meters * METERS_TO_BAM_Q16 + (1 << 15)) >> 16;
+    return angle > BAM_HALF_TURN ? BAM_HALF_TURN : (uint32_t)angle;
+}
+
+/**
+ * Round microdegrees to the deg100 grid the service bounds are stored on
+ */
+static int32_t microdeg_to_deg100(int32_t microdeg) {
+    return microdeg >= 0 ? (microdeg + 5000) / 10000 : -((-microdeg + 5000) / 10000);
+}
+
+/**
+ * Check if a microdegree position lies inside a service's coverage box
+ * (rounded to the bounds' precision, matching the double path)
+ */
+bool ntrip_atlas_fixed_is_within_coverage(
+    const ntrip_service_compact_t* service,
+    int32_t latitude_microdeg,
+    int32_t longitude_microdeg
+) {
+    if (!service) {
+        return false;
+    }
+
+    int32_t lat_deg100 = microdeg_to_deg100(latitude_microdeg);
+    int32_t lon_deg100 = microdeg_to_deg100(longitude_microdeg);
+
+    return lat_deg100 >= service->lat_min_deg100 && lat_deg100 <= service->lat_max_deg100 &&
+           lon_deg100 >= service->lon_min_deg100 && lon_deg100 <= service->lon_max_deg100;
+}
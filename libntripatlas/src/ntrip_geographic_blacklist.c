@@ -5,13 +5,16 @@
  * to avoid repeated queries. Improves discovery performance by learning
  * from service coverage limitations.
  *
+ * Regions live in one pool shared by all services, each tagged with its
+ * service index, so storage follows the regions actually blacklisted
+ * rather than the number of services.
+ *
  * Licensed under MIT License
  */
 
 #include "ntrip_atlas.h"
 #include <string.h>
 #include <stdlib.h>
-#include <stdio.h>
 #include <math.h>
 #include <time.h>
 
@@ -22,13 +25,24 @@
 // Using 1-degree grid squares for reasonable granularity
 #define BLACKLIST_GRID_SIZE_DEGREES 1.0
 
-// Global geographic blacklist state
+// One blacklisted region of one service
+typedef struct {
+    ntrip_service_idx_t service_index;
+    ntrip_geo_blacklist_entry_t region;
+} geo_blacklist_slot_t;
+
+// Global geographic blacklist state (slots in use are packed at the front,
+// oldest first)
 static struct {
-    ntrip_geo_blacklist_entry_t entries[NTRIP_MAX_SERVICES][MAX_BLACKLIST_ENTRIES_PER_SERVICE];
-    uint8_t entry_counts[NTRIP_MAX_SERVICES];
+    geo_blacklist_slot_t slots[NTRIP_GEO_BLACKLIST_MAX_ENTRIES];
+    size_t count;
     bool initialized;
 } g_geo_blacklist = {0};
 
+// Bumped whenever the set of blacklisted regions changes; kept outside the
+// state so re-init still moves it
+static uint32_t g_geo_blacklist_generation = 0;
+
 /**
  * Convert lat/lon to grid coordinates for blacklisting
  */
@@ -56,18 +70,35 @@ static void lat_lon_to_grid(double latitude, double longitude, int16_t* grid_lat
 }
 
 /**
- * Get service index from provider name
+ * Find a service's region (g_geo_blacklist.count if not blacklisted)
  */
-static uint8_t get_service_index_by_provider(const char* provider) {
-    // This would integrate with the existing service index mapping
-    // For now, use a simple hash of provider name
-    if (!provider) return 255;
-
-    uint8_t hash = 0;
-    for (int i = 0; provider[i] && i < 32; i++) {
-        hash = (hash * 33) + provider[i];
+static size_t find_region(ntrip_service_idx_t service_index, int16_t grid_lat, int16_t grid_lon) {
+    for (size_t i = 0; i < g_geo_blacklist.count; i++) {
+        const geo_blacklist_slot_t* slot = &g_geo_blacklist.slots[i];
+        if (slot->service_index == service_index &&
+            slot->region.grid_lat == grid_lat && slot->region.grid_lon == grid_lon) {
+            return i;
+        }
     }
-    return hash % NTRIP_MAX_SERVICES;
+    return g_geo_blacklist.count;
+}
+
+/**
+ * Remove a slot, keeping the rest in age order
+ */
+static void remove_slot(size_t index) {
+    memmove(&g_geo_blacklist.slots[index], &g_geo_blacklist.slots[index + 1],
+            (g_geo_blacklist.count - index - 1) * sizeof(geo_blacklist_slot_t));
+    g_geo_blacklist.count--;
+}
+
+/**
+ * Fill in a region's reason and timestamp
+ */
+static void set_region_reason(ntrip_geo_blacklist_entry_t* region, const char* error_reason) {
+    strncpy(region->reason, error_reason ? error_reason : "No coverage", sizeof(region->reason) - 1);
+    region->reason[sizeof(region->reason) - 1] = '\0';
+    region->blacklisted_time = time(NULL);
 }
 
 /**
@@ -81,6 +112,7 @@ ntrip_atlas_error_t ntrip_atlas_init_geographic_blacklist(void) {
     // Clear all blacklist entries
     memset(&g_geo_blacklist, 0, sizeof(g_geo_blacklist));
     g_geo_blacklist.initialized = true;
+    g_geo_blacklist_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
@@ -89,17 +121,12 @@ ntrip_atlas_error_t ntrip_atlas_init_geographic_blacklist(void) {
  * Add a geographic region to service blacklist
  */
 ntrip_atlas_error_t ntrip_atlas_blacklist_service_region(
-    const char* provider,
+    ntrip_service_idx_t service_index,
     double latitude,
     double longitude,
     const char* error_reason
 ) {
-    if (!provider || !g_geo_blacklist.initialized) {
-        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
-    }
-
-    uint8_t service_index = get_service_index_by_provider(provider);
-    if (service_index >= NTRIP_MAX_SERVICES) {
+    if (service_index == NTRIP_SERVICE_INDEX_INVALID || !g_geo_blacklist.initialized) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
@@ -107,54 +134,37 @@ ntrip_atlas_error_t ntrip_atlas_blacklist_service_region(
     int16_t grid_lat, grid_lon;
     lat_lon_to_grid(latitude, longitude, &grid_lat, &grid_lon);
 
-    // Check if already blacklisted
-    for (uint8_t i = 0; i < g_geo_blacklist.entry_counts[service_index]; i++) {
-        ntrip_geo_blacklist_entry_t* entry = &g_geo_blacklist.entries[service_index][i];
-        if (entry->grid_lat == grid_lat && entry->grid_lon == grid_lon) {
-            // Already blacklisted, update reason and timestamp
-            strncpy(entry->reason, error_reason ? error_reason : "No coverage",
-                   sizeof(entry->reason) - 1);
-            entry->reason[sizeof(entry->reason) - 1] = '\0';
-            entry->blacklisted_time = time(NULL);
-            return NTRIP_ATLAS_SUCCESS;
-        }
-    }
-
-    // Add new blacklist entry if space available
-    if (g_geo_blacklist.entry_counts[service_index] < MAX_BLACKLIST_ENTRIES_PER_SERVICE) {
-        uint8_t index = g_geo_blacklist.entry_counts[service_index];
-        ntrip_geo_blacklist_entry_t* entry = &g_geo_blacklist.entries[service_index][index];
-
-        entry->grid_lat = grid_lat;
-        entry->grid_lon = grid_lon;
-        strncpy(entry->reason, error_reason ? error_reason : "No coverage",
-               sizeof(entry->reason) - 1);
-        entry->reason[sizeof(entry->reason) - 1] = '\0';
-        entry->blacklisted_time = time(NULL);
-
-        g_geo_blacklist.entry_counts[service_index]++;
+    // Already blacklisted: refresh it as the newest region, the set is unchanged
+    size_t existing = find_region(service_index, grid_lat, grid_lon);
+    if (existing < g_geo_blacklist.count) {
+        geo_blacklist_slot_t refreshed = g_geo_blacklist.slots[existing];
+        remove_slot(existing);
+        set_region_reason(&refreshed.region, error_reason);
+        g_geo_blacklist.slots[g_geo_blacklist.count++] = refreshed;
         return NTRIP_ATLAS_SUCCESS;
     }
 
-    // Blacklist is full - replace oldest entry (LRU)
-    uint8_t oldest_index = 0;
-    time_t oldest_time = g_geo_blacklist.entries[service_index][0].blacklisted_time;
-
-    for (uint8_t i = 1; i < MAX_BLACKLIST_ENTRIES_PER_SERVICE; i++) {
-        if (g_geo_blacklist.entries[service_index][i].blacklisted_time < oldest_time) {
-            oldest_time = g_geo_blacklist.entries[service_index][i].blacklisted_time;
-            oldest_index = i;
+    // Make room: the service's oldest region once it has the maximum,
+    // otherwise the oldest region overall when the pool is full
+    size_t service_regions = 0;
+    size_t oldest_own = 0;
+    for (size_t i = 0; i < g_geo_blacklist.count; i++) {
+        if (g_geo_blacklist.slots[i].service_index == service_index && service_regions++ == 0) {
+            oldest_own = i;
         }
     }
+    if (service_regions >= MAX_BLACKLIST_ENTRIES_PER_SERVICE) {
+        remove_slot(oldest_own);
+    } else if (g_geo_blacklist.count >= NTRIP_GEO_BLACKLIST_MAX_ENTRIES) {
+        remove_slot(0);
+    }
 
-    // Replace oldest entry
-    ntrip_geo_blacklist_entry_t* entry = &g_geo_blacklist.entries[service_index][oldest_index];
-    entry->grid_lat = grid_lat;
-    entry->grid_lon = grid_lon;
-    strncpy(entry->reason, error_reason ? error_reason : "No coverage",
-           sizeof(entry->reason) - 1);
-    entry->reason[sizeof(entry->reason) - 1] = '\0';
-    entry->blacklisted_time = time(NULL);
+    geo_blacklist_slot_t* slot = &g_geo_blacklist.slots[g_geo_blacklist.count++];
+    slot->service_index = service_index;
+    slot->region.grid_lat = grid_lat;
+    slot->region.grid_lon = grid_lon;
+    set_region_reason(&slot->region, error_reason);
+    g_geo_blacklist_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
@@ -163,16 +173,11 @@ ntrip_atlas_error_t ntrip_atlas_blacklist_service_region(
  * Check if a service is blacklisted for a geographic region
  */
 bool ntrip_atlas_is_service_geographically_blacklisted(
-    const char* provider,
+    ntrip_service_idx_t service_index,
     double latitude,
     double longitude
 ) {
-    if (!provider || !g_geo_blacklist.initialized) {
-        return false;
-    }
-
-    uint8_t service_index = get_service_index_by_provider(provider);
-    if (service_index >= NTRIP_MAX_SERVICES) {
+    if (service_index == NTRIP_SERVICE_INDEX_INVALID || !g_geo_blacklist.initialized) {
         return false;
     }
 
@@ -180,31 +185,18 @@ bool ntrip_atlas_is_service_geographically_blacklisted(
     int16_t grid_lat, grid_lon;
     lat_lon_to_grid(latitude, longitude, &grid_lat, &grid_lon);
 
-    // Check if blacklisted
-    for (uint8_t i = 0; i < g_geo_blacklist.entry_counts[service_index]; i++) {
-        ntrip_geo_blacklist_entry_t* entry = &g_geo_blacklist.entries[service_index][i];
-        if (entry->grid_lat == grid_lat && entry->grid_lon == grid_lon) {
-            return true;
-        }
-    }
-
-    return false;
+    return find_region(service_index, grid_lat, grid_lon) < g_geo_blacklist.count;
 }
 
 /**
  * Remove geographic blacklist entry for a service
  */
 ntrip_atlas_error_t ntrip_atlas_remove_geographic_blacklist(
-    const char* provider,
+    ntrip_service_idx_t service_index,
     double latitude,
     double longitude
 ) {
-    if (!provider || !g_geo_blacklist.initialized) {
-        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
-    }
-
-    uint8_t service_index = get_service_index_by_provider(provider);
-    if (service_index >= NTRIP_MAX_SERVICES) {
+    if (service_index == NTRIP_SERVICE_INDEX_INVALID || !g_geo_blacklist.initialized) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
@@ -213,38 +205,35 @@ ntrip_atlas_error_t ntrip_atlas_remove_geographic_blacklist(
     lat_lon_to_grid(latitude, longitude, &grid_lat, &grid_lon);
 
     // Find and remove entry
-    for (uint8_t i = 0; i < g_geo_blacklist.entry_counts[service_index]; i++) {
-        ntrip_geo_blacklist_entry_t* entry = &g_geo_blacklist.entries[service_index][i];
-        if (entry->grid_lat == grid_lat && entry->grid_lon == grid_lon) {
-            // Remove by shifting remaining entries
-            for (uint8_t j = i; j < g_geo_blacklist.entry_counts[service_index] - 1; j++) {
-                g_geo_blacklist.entries[service_index][j] =
-                    g_geo_blacklist.entries[service_index][j + 1];
-            }
-            g_geo_blacklist.entry_counts[service_index]--;
-            return NTRIP_ATLAS_SUCCESS;
-        }
+    size_t index = find_region(service_index, grid_lat, grid_lon);
+    if (index >= g_geo_blacklist.count) {
+        return NTRIP_ATLAS_ERROR_NOT_FOUND;
     }
 
-    return NTRIP_ATLAS_ERROR_NOT_FOUND;
+    remove_slot(index);
+    g_geo_blacklist_generation++;
+    return NTRIP_ATLAS_SUCCESS;
 }
 
 /**
  * Clear all geographic blacklist entries for a service
  */
-ntrip_atlas_error_t ntrip_atlas_clear_service_geographic_blacklist(const char* provider) {
-    if (!provider || !g_geo_blacklist.initialized) {
+ntrip_atlas_error_t ntrip_atlas_clear_service_geographic_blacklist(ntrip_service_idx_t service_index) {
+    if (service_index == NTRIP_SERVICE_INDEX_INVALID || !g_geo_blacklist.initialized) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
-    uint8_t service_index = get_service_index_by_provider(provider);
-    if (service_index >= NTRIP_MAX_SERVICES) {
-        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    // Compact the pool over the service's regions
+    size_t kept = 0;
+    for (size_t i = 0; i < g_geo_blacklist.count; i++) {
+        if (g_geo_blacklist.slots[i].service_index != service_index) {
+            g_geo_blacklist.slots[kept++] = g_geo_blacklist.slots[i];
+        }
+    }
+    if (kept != g_geo_blacklist.count) {
+        g_geo_blacklist.count = kept;
+        g_geo_blacklist_generation++;
     }
-
-    g_geo_blacklist.entry_counts[service_index] = 0;
-    memset(g_geo_blacklist.entries[service_index], 0,
-           sizeof(g_geo_blacklist.entries[service_index]));
 
     return NTRIP_ATLAS_SUCCESS;
 }
@@ -257,12 +246,40 @@ ntrip_atlas_error_t ntrip_atlas_clear_all_geographic_blacklists(void) {
         return NTRIP_ATLAS_ERROR_PLATFORM;
     }
 
-    memset(g_geo_blacklist.entry_counts, 0, sizeof(g_geo_blacklist.entry_counts));
-    memset(g_geo_blacklist.entries, 0, sizeof(g_geo_blacklist.entries));
+    if (g_geo_blacklist.count == 0) {
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    memset(g_geo_blacklist.slots, 0, sizeof(g_geo_blacklist.slots));
+    g_geo_blacklist.count = 0;
+    g_geo_blacklist_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
 
+/**
+ * Check if a service has any blacklisted regions
+ */
+bool ntrip_atlas_has_geographic_blacklist(ntrip_service_idx_t service_index) {
+    if (service_index == NTRIP_SERVICE_INDEX_INVALID || !g_geo_blacklist.initialized) {
+        return false;
+    }
+
+    for (size_t i = 0; i < g_geo_blacklist.count; i++) {
+        if (g_geo_blacklist.slots[i].service_index == service_index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Blacklist generation
+ */
+uint32_t ntrip_atlas_get_geographic_blacklist_generation(void) {
+    return g_geo_blacklist_generation;
+}
+
 /**
  * Get blacklist statistics for monitoring
  */
@@ -275,12 +292,16 @@ ntrip_atlas_error_t ntrip_atlas_get_geographic_blacklist_stats(
 
     memset(stats, 0, sizeof(*stats));
 
-    // Count total entries and services with blacklists
-    for (uint8_t i = 0; i < NTRIP_MAX_SERVICES; i++) {
-        if (g_geo_blacklist.entry_counts[i] > 0) {
+    // Count total entries and services with blacklists (first region of each)
+    for (size_t i = 0; i < g_geo_blacklist.count; i++) {
+        size_t first = 0;
+        while (g_geo_blacklist.slots[first].service_index != g_geo_blacklist.slots[i].service_index) {
+            first++;
+        }
+        if (first == i) {
             stats->services_with_blacklists++;
-            stats->total_blacklisted_regions += g_geo_blacklist.entry_counts[i];
         }
+        stats->total_blacklisted_regions++;
     }
 
     stats->max_entries_per_service = MAX_BLACKLIST_ENTRIES_PER_SERVICE;
@@ -307,16 +328,15 @@ size_t ntrip_atlas_filter_geographically_blacklisted_services(
     size_t filtered_count = 0;
 
     for (size_t i = 0; i < service_count && filtered_count < max_filtered; i++) {
-        // Use service index as provider identifier for geographic blacklist lookup
-        char provider_id[16];
-        snprintf(provider_id, sizeof(provider_id), "service_%zu", i);
+        // Position in the list is the service index; past the index width nothing is blacklisted
+        bool blacklisted = i < NTRIP_SERVICE_INDEX_INVALID &&
+            ntrip_atlas_is_service_geographically_blacklisted((ntrip_service_idx_t)i, latitude, longitude);
 
-        // Skip if geographically blacklisted
-        if (!ntrip_atlas_is_service_geographically_blacklisted(provider_id, latitude, longitude)) {
+        if (!blacklisted) {
             filtered_services[filtered_count] = services[i];
             filtered_count++;
         }
     }
 
     return filtered_count;
-}
\ No newline at end of file
+}
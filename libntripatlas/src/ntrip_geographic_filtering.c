@@ -31,6 +31,11 @@ bool ntrip_atlas_is_location_within_service_coverage(
         return false;
     }
 
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    return ntrip_atlas_fixed_is_within_coverage(service,
+                                                NTRIP_ATLAS_DEG_TO_MICRODEG(user_latitude),
+                                                NTRIP_ATLAS_DEG_TO_MICRODEG(user_longitude));
+#else
     // Convert user coordinates to same precision as service bounds (×100)
     // Use rounding instead of truncation for consistent precision
     int16_t user_lat_deg100 = (int16_t)round(user_latitude * 100.0);
@@ -44,6 +49,36 @@ bool ntrip_atlas_is_location_within_service_coverage(
                         (user_lon_deg100 <= service->lon_max_deg100);
 
     return lat_in_range && lon_in_range;
+#endif
+}
+
+// Earth's radius in kilometers and length of one degree of latitude
+#define EARTH_RADIUS_KM 6371.0
+#define KM_PER_DEGREE_LAT (EARTH_RADIUS_KM * M_PI / 180.0)
+
+/**
+ * Great-circle distance between two points (haversine formula)
+ */
+static double great_circle_distance_km(double lat1_deg, double lon1_deg,
+                                       double lat2_deg, double lon2_deg) {
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    return ntrip_atlas_fixed_distance_m(NTRIP_ATLAS_DEG_TO_MICRODEG(lat1_deg), NTRIP_ATLAS_DEG_TO_MICRODEG(lon1_deg),
+                                        NTRIP_ATLAS_DEG_TO_MICRODEG(lat2_deg), NTRIP_ATLAS_DEG_TO_MICRODEG(lon2_deg)) / 1000.0;
+#else
+    double lat1 = lat1_deg * M_PI / 180.0;
+    double lon1 = lon1_deg * M_PI / 180.0;
+    double lat2 = lat2_deg * M_PI / 180.0;
+    double lon2 = lon2_deg * M_PI / 180.0;
+
+    double dlat = lat2 - lat1;
+    double dlon = lon2 - lon1;
+
+    double a = sin(dlat/2) * sin(dlat/2) +
+               cos(lat1) * cos(lat2) * sin(dlon/2) * sin(dlon/2);
+    double c = 2 * atan2(sqrt(a), sqrt(1-a));
+
+    return EARTH_RADIUS_KM * c;
+#endif
 }
 
 /**
@@ -62,26 +97,80 @@ double ntrip_atlas_calculate_distance_to_service_center(
     double service_lat_center = (service->lat_min_deg100 + service->lat_max_deg100) / 200.0;
     double service_lon_center = (service->lon_min_deg100 + service->lon_max_deg100) / 200.0;
 
-    // Use existing distance calculation from ntrip_distance.c
-    // Haversine formula for great circle distance
-    double lat1 = user_latitude * M_PI / 180.0;
-    double lon1 = user_longitude * M_PI / 180.0;
-    double lat2 = service_lat_center * M_PI / 180.0;
-    double lon2 = service_lon_center * M_PI / 180.0;
+    return great_circle_distance_km(user_latitude, user_longitude,
+                                    service_lat_center, service_lon_center);
+}
 
-    double dlat = lat2 - lat1;
-    double dlon = lon2 - lon1;
+/**
+ * O(1) lower bound on distance to coverage: latitude gap to the box
+ *
+ * Any path to a point in the box must cover at least the latitude
+ * difference, so this never exceeds the exact distance. No trig needed.
+ */
+static double coverage_edge_lower_bound_km(
+    const ntrip_service_compact_t* service,
+    double user_latitude
+) {
+    double lat_min = service->lat_min_deg100 / 100.0;
+    double lat_max = service->lat_max_deg100 / 100.0;
 
-    double a = sin(dlat/2) * sin(dlat/2) +
-               cos(lat1) * cos(lat2) * sin(dlon/2) * sin(dlon/2);
-    double c = 2 * atan2(sqrt(a), sqrt(1-a));
+    if (user_latitude < lat_min) return (lat_min - user_latitude) * KM_PER_DEGREE_LAT;
+    if (user_latitude > lat_max) return (user_latitude - lat_max) * KM_PER_DEGREE_LAT;
+    return 0.0;
+}
+
+/**
+ * Great-circle distance from a point to a meridian segment
+ *
+ * The nearest point on the meridian's great circle has latitude
+ * atan(tan(lat) / cos(dlon)) when |dlon| < 90°; distance grows
+ * monotonically away from it, so clamping to the segment (i.e. also
+ * checking both endpoints) gives the exact answer. For |dlon| >= 90° the
+ * distance is monotonic along the segment and an endpoint is nearest.
+ */
+static double distance_to_meridian_segment_km(
+    double user_latitude,
+    double user_longitude,
+    double edge_longitude,
+    double lat_min,
+    double lat_max
+) {
+    double nearest = great_circle_distance_km(user_latitude, user_longitude, lat_min, edge_longitude);
+    double to_max = great_circle_distance_km(user_latitude, user_longitude, lat_max, edge_longitude);
+    if (to_max < nearest) {
+        nearest = to_max;
+    }
 
-    const double earth_radius_km = 6371.0;
-    return earth_radius_km * c;
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    // Same foot latitude as atan2(sin(lat), cos(lat) * cos(dlon))
+    int32_t sin_lat, cos_lat, cos_dlon;
+    ntrip_atlas_fixed_sin_cos(NTRIP_ATLAS_DEG_TO_MICRODEG(user_latitude), &sin_lat, &cos_lat);
+    ntrip_atlas_fixed_sin_cos(NTRIP_ATLAS_DEG_TO_MICRODEG(user_longitude - edge_longitude), NULL, &cos_dlon);
+    if (cos_dlon > 0) {
+        int32_t foot_bam = ntrip_atlas_fixed_atan2(sin_lat, ((int64_t)cos_lat * cos_dlon) >> 30);
+        double foot_lat = foot_bam * (360.0 / 4294967296.0);
+#else
+    double cos_dlon = cos((user_longitude - edge_longitude) * M_PI / 180.0);
+    if (cos_dlon > 0.0) {
+        double foot_lat = atan(tan(user_latitude * M_PI / 180.0) / cos_dlon) * 180.0 / M_PI;
+#endif
+        if (foot_lat > lat_min && foot_lat < lat_max) {
+            double to_foot = great_circle_distance_km(user_latitude, user_longitude,
+                                                      foot_lat, edge_longitude);
+            if (to_foot < nearest) {
+                nearest = to_foot;
+            }
+        }
+    }
+
+    return nearest;
 }
 
 /**
  * Calculate distance to nearest edge of service coverage area
+ *
+ * Exact great-circle distance from the user to the closest point of the
+ * coverage bounding box (0 when inside).
  */
 double ntrip_atlas_calculate_distance_to_coverage_edge(
     const ntrip_service_compact_t* service,
@@ -92,29 +181,108 @@ double ntrip_atlas_calculate_distance_to_coverage_edge(
         return INFINITY;
     }
 
+    // If user is within coverage, return 0
+    if (ntrip_atlas_is_location_within_service_coverage(service, user_latitude, user_longitude)) {
+        return 0.0;
+    }
+
     // Convert service bounds back to degrees
     double lat_min = service->lat_min_deg100 / 100.0;
     double lat_max = service->lat_max_deg100 / 100.0;
     double lon_min = service->lon_min_deg100 / 100.0;
     double lon_max = service->lon_max_deg100 / 100.0;
 
-    // If user is within coverage, return 0
-    if (ntrip_atlas_is_location_within_service_coverage(service, user_latitude, user_longitude)) {
-        return 0.0;
+    // Within the box's longitude range the nearest point is due north/south
+    if (user_longitude >= lon_min && user_longitude <= lon_max) {
+        return coverage_edge_lower_bound_km(service, user_latitude);
     }
 
-    // Find closest point on the coverage rectangle
-    double closest_lat = user_latitude;
-    double closest_lon = user_longitude;
+    // Otherwise it lies on one of the two meridian edges (corners included)
+    double to_west = distance_to_meridian_segment_km(
+        user_latitude, user_longitude, lon_min, lat_min, lat_max
+    );
+    double to_east = distance_to_meridian_segment_km(
+        user_latitude, user_longitude, lon_max, lat_min, lat_max
+    );
 
-    // Clamp to coverage bounds
-    if (closest_lat < lat_min) closest_lat = lat_min;
-    if (closest_lat > lat_max) closest_lat = lat_max;
-    if (closest_lon < lon_min) closest_lon = lon_min;
-    if (closest_lon > lon_max) closest_lon = lon_max;
+    return to_west < to_east ? to_west : to_east;
+}
 
-    // Calculate distance to closest point
-    return ntrip_atlas_calculate_distance_to_service_center(service, closest_lat, closest_lon);
+/**
+ * Check whether a service is within max_distance_km of the user, rejecting
+ * far services on the O(1) latitude bound before computing exact distance
+ */
+static bool is_service_within_distance(
+    const ntrip_service_compact_t* service,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km
+) {
+    if (coverage_edge_lower_bound_km(service, user_latitude) > max_distance_km) {
+        return false;
+    }
+
+    return ntrip_atlas_calculate_distance_to_coverage_edge(
+        service, user_latitude, user_longitude
+    ) <= max_distance_km;
+}
+
+/**
+ * Calculate distance to coverage edge for every service in one pass
+ */
+size_t ntrip_atlas_calculate_coverage_edge_distances(
+    const ntrip_service_compact_t* services,
+    const ntrip_service_geometry_t* geometry,
+    size_t service_count,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km,
+    double* distances_km
+) {
+    if (!services || !distances_km) {
+        return 0;
+    }
+
+    // Per-lookup setup, amortised over all services
+    ntrip_unit_vector_t user_vector;
+    ntrip_distance_bound_t bound;
+    bool use_geometry = geometry &&
+        ntrip_atlas_make_distance_bound(max_distance_km, &bound) == NTRIP_ATLAS_SUCCESS;
+    if (use_geometry) {
+        ntrip_atlas_lat_lon_to_unit_vector(user_latitude, user_longitude, &user_vector);
+    }
+
+    size_t within_count = 0;
+
+    for (size_t i = 0; i < service_count; i++) {
+        const ntrip_service_compact_t* service = &services[i];
+
+        if (ntrip_atlas_is_location_within_service_coverage(service, user_latitude, user_longitude)) {
+            distances_km[i] = 0.0;
+            within_count++;
+            continue;
+        }
+
+        // Reject on O(1) bounds: latitude gap, then center distance minus radius
+        if (coverage_edge_lower_bound_km(service, user_latitude) > max_distance_km ||
+            (use_geometry && !ntrip_atlas_geometry_may_be_within(&geometry[i], &user_vector, &bound))) {
+            distances_km[i] = INFINITY;
+            continue;
+        }
+
+        double distance = ntrip_atlas_calculate_distance_to_coverage_edge(
+            service, user_latitude, user_longitude
+        );
+
+        if (distance <= max_distance_km) {
+            distances_km[i] = distance;
+            within_count++;
+        } else {
+            distances_km[i] = INFINITY;
+        }
+    }
+
+    return within_count;
 }
 
 /**
@@ -150,13 +318,8 @@ size_t ntrip_atlas_filter_services_by_coverage(
             continue;
         }
 
-        // If user is outside coverage, check distance to coverage edge
-        double distance_to_edge = ntrip_atlas_calculate_distance_to_coverage_edge(
-            service, user_latitude, user_longitude
-        );
-
-        // Include service if it's within the maximum distance threshold
-        if (distance_to_edge <= max_distance_km) {
+        // Include service if its coverage edge is within the maximum distance threshold
+        if (is_service_within_distance(service, user_latitude, user_longitude, max_distance_km)) {
             filtered_services[filtered_count] = *service;
             filtered_count++;
         }
@@ -166,74 +329,311 @@ size_t ntrip_atlas_filter_services_by_coverage(
 }
 
 /**
- * Global state for sorting (avoid non-portable qsort_r)
+ * Sort key for decorate-sort-undecorate ranking: squared chord between the
+ * service's center and the user as Q30 unit vectors (Q60, grows with
+ * great-circle distance), computed once per service and paired with the
+ * service's position in the caller's array
  */
-static double g_sort_user_latitude = 0.0;
-static double g_sort_user_longitude = 0.0;
+typedef struct {
+    uint64_t chord_sq_q60;
+    size_t index;               // Fills the key's padding on 64-bit targets
+} geo_sort_key_t;
+
+// Keys for up to this many services live on the stack; larger sets use the
+// caller's workspace, or the heap without one
+#define GEO_SORT_STACK_KEYS 32
+
+// Workspace sizing assumes keys fit NTRIP_ATLAS_SORT_KEY_BYTES
+typedef char geo_sort_key_size_check[sizeof(geo_sort_key_t) <= NTRIP_ATLAS_SORT_KEY_BYTES ? 1 : -1];
 
 /**
- * Sort services by distance to user location
+ * Order keys by distance, breaking ties by original position so results
+ * are deterministic regardless of the qsort implementation
  */
-static int compare_services_by_distance(const void* a, const void* b) {
-    const ntrip_service_compact_t* service_a = (const ntrip_service_compact_t*)a;
-    const ntrip_service_compact_t* service_b = (const ntrip_service_compact_t*)b;
+static int compare_sort_keys(const void* a, const void* b) {
+    const geo_sort_key_t* key_a = (const geo_sort_key_t*)a;
+    const geo_sort_key_t* key_b = (const geo_sort_key_t*)b;
+
+    if (key_a->chord_sq_q60 < key_b->chord_sq_q60) return -1;
+    if (key_a->chord_sq_q60 > key_b->chord_sq_q60) return 1;
+    if (key_a->index < key_b->index) return -1;
+    if (key_a->index > key_b->index) return 1;
+    return 0;
+}
 
-    double dist_a = ntrip_atlas_calculate_distance_to_service_center(
-        service_a, g_sort_user_latitude, g_sort_user_longitude
-    );
-    double dist_b = ntrip_atlas_calculate_distance_to_service_center(
-        service_b, g_sort_user_latitude, g_sort_user_longitude
+/**
+ * Restore max-heap order below position root (heap spans keys[0..count))
+ */
+static void sift_down_sort_keys(geo_sort_key_t* keys, size_t root, size_t count) {
+    while (2 * root + 1 < count) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < count && compare_sort_keys(&keys[child], &keys[child + 1]) < 0) {
+            child++;
+        }
+        if (compare_sort_keys(&keys[root], &keys[child]) >= 0) {
+            return;
+        }
+        geo_sort_key_t tmp = keys[root];
+        keys[root] = keys[child];
+        keys[child] = tmp;
+        root = child;
+    }
+}
+
+/**
+ * Partial sort: move the k smallest keys to keys[0..k) in ascending order.
+ * Remaining keys stay in keys[k..count) in unspecified order. O(n log k).
+ */
+static void partial_sort_keys(geo_sort_key_t* keys, size_t k, size_t count) {
+    // Max-heap over the first k keys holds the k best seen so far
+    for (size_t i = k / 2; i-- > 0; ) {
+        sift_down_sort_keys(keys, i, k);
+    }
+
+    for (size_t i = k; i < count; i++) {
+        if (compare_sort_keys(&keys[i], &keys[0]) < 0) {
+            geo_sort_key_t tmp = keys[0];
+            keys[0] = keys[i];
+            keys[i] = tmp;
+            sift_down_sort_keys(keys, 0, k);
+        }
+    }
+
+    // Heap sort the selected keys into ascending order
+    for (size_t end = k; end > 1; end--) {
+        geo_sort_key_t tmp = keys[0];
+        keys[0] = keys[end - 1];
+        keys[end - 1] = tmp;
+        sift_down_sort_keys(keys, 0, end - 1);
+    }
+}
+
+/**
+ * Apply the key order to the service array in place: services[i] becomes the
+ * service originally at keys[i].index. Follows permutation cycles so every
+ * service is moved exactly once. Consumes the key indices.
+ */
+static void permute_services_by_keys(
+    ntrip_service_compact_t* services,
+    geo_sort_key_t* keys,
+    size_t count
+) {
+    for (size_t start = 0; start < count; start++) {
+        if (keys[start].index == start) {
+            continue; // Already in place or cycle already applied
+        }
+
+        ntrip_service_compact_t held = services[start];
+        size_t dest = start;
+
+        while (keys[dest].index != start) {
+            size_t src = keys[dest].index;
+            services[dest] = services[src];
+            keys[dest].index = dest;
+            dest = src;
+        }
+
+        services[dest] = held;
+        keys[dest].index = dest;
+    }
+}
+
+/**
+ * Squared chord between two unit vectors in Q60
+ *
+ * Orders services exactly as great-circle distance does, with no trig:
+ * component differences keep full Q30 precision at short range, where a
+ * dot product would round nearby services together. Both vectors have
+ * unit length, so the sum stays below 2^63.
+ */
+static uint64_t chord_squared_q60(const ntrip_unit_vector_t* a, const ntrip_unit_vector_t* b) {
+    int64_t dx = (int64_t)a->x - b->x;
+    int64_t dy = (int64_t)a->y - b->y;
+    int64_t dz = (int64_t)a->z - b->z;
+    return (uint64_t)(dx * dx) + (uint64_t)(dy * dy) + (uint64_t)(dz * dz);
+}
+
+/**
+ * Rank key for a service without precomputed geometry: its bounding box
+ * center as a unit vector, the value the generator would have emitted
+ */
+static uint64_t service_chord_squared_q60(
+    const ntrip_service_compact_t* service,
+    const ntrip_unit_vector_t* user_vector
+) {
+    ntrip_unit_vector_t center;
+    ntrip_atlas_lat_lon_to_unit_vector(
+        (service->lat_min_deg100 + service->lat_max_deg100) / 200.0,
+        (service->lon_min_deg100 + service->lon_max_deg100) / 200.0,
+        &center
     );
+    return chord_squared_q60(&center, user_vector);
+}
 
-    if (dist_a < dist_b) return -1;
-    if (dist_a > dist_b) return 1;
-    return 0;
+/**
+ * Ranking without key storage: for each result position in turn, find the
+ * nearest remaining service (first one wins ties) and rotate it into place.
+ * Rank keys are recomputed on every pass, O(n * k), but nothing is
+ * allocated, and the rotation keeps the rest in their original order so
+ * results match the keyed path exactly.
+ */
+static void select_nearest_in_place(
+    ntrip_service_compact_t* services,
+    size_t count,
+    size_t result_count,
+    const ntrip_unit_vector_t* user_vector
+) {
+    for (size_t rank = 0; rank < result_count; rank++) {
+        size_t nearest = rank;
+        uint64_t nearest_key = service_chord_squared_q60(&services[rank], user_vector);
+
+        for (size_t i = rank + 1; i < count; i++) {
+            uint64_t key = service_chord_squared_q60(&services[i], user_vector);
+            if (key < nearest_key) {
+                nearest = i;
+                nearest_key = key;
+            }
+        }
+
+        if (nearest != rank) {
+            ntrip_service_compact_t held = services[nearest];
+            memmove(&services[rank + 1], &services[rank],
+                    (nearest - rank) * sizeof(ntrip_service_compact_t));
+            services[rank] = held;
+        }
+    }
 }
 
 /**
- * Filter and sort services by geographic proximity
+ * Filter services by location and return the nearest max_results in order,
+ * taking sort keys from a caller-owned workspace
  */
-size_t ntrip_atlas_filter_and_sort_services_by_location(
+size_t ntrip_atlas_filter_and_sort_nearest_services_in(
     ntrip_service_compact_t* services,
+    const ntrip_service_geometry_t* geometry,
     size_t service_count,
     double user_latitude,
     double user_longitude,
-    double max_distance_km
+    double max_distance_km,
+    size_t max_results,
+    ntrip_atlas_workspace_t* workspace
 ) {
-    if (!services || service_count == 0) {
+    if (!services || service_count == 0 || max_results == 0) {
         return 0;
     }
 
-    // First pass: Filter by coverage and distance
+    geo_sort_key_t stack_keys[GEO_SORT_STACK_KEYS];
+    geo_sort_key_t* keys = stack_keys;
+    size_t workspace_mark = ntrip_atlas_workspace_mark(workspace);
+    bool heap_keys = false;
+
+    if (service_count > GEO_SORT_STACK_KEYS) {
+        if (workspace) {
+            keys = (geo_sort_key_t*)ntrip_atlas_workspace_alloc(
+                workspace, service_count * sizeof(geo_sort_key_t));
+        } else {
+#ifdef NTRIP_ATLAS_STATIC_ALLOCATION
+            keys = NULL;
+#else
+            keys = (geo_sort_key_t*)malloc(service_count * sizeof(geo_sort_key_t));
+            heap_keys = keys != NULL;
+#endif
+        }
+    }
+
+    // Per-lookup setup: the user's unit vector and, with geometry, the
+    // bound that rejects far services before any exact distance
+    ntrip_unit_vector_t user_vector;
+    ntrip_distance_bound_t bound;
+    ntrip_atlas_lat_lon_to_unit_vector(user_latitude, user_longitude, &user_vector);
+    bool use_bound = geometry &&
+        ntrip_atlas_make_distance_bound(max_distance_km, &bound) == NTRIP_ATLAS_SUCCESS;
+
+    // First pass: Filter by coverage and distance, compacting survivors to
+    // the front and recording each one's rank key exactly once. geometry is
+    // indexed by original position, read before any service moves past i.
     size_t filtered_count = 0;
     for (size_t i = 0; i < service_count; i++) {
         bool within_coverage = ntrip_atlas_is_location_within_service_coverage(
             &services[i], user_latitude, user_longitude
         );
 
-        double distance = within_coverage ? 0.0 :
-            ntrip_atlas_calculate_distance_to_coverage_edge(
-                &services[i], user_latitude, user_longitude
-            );
-
         // Include if within coverage or within distance threshold
-        if (within_coverage || distance <= max_distance_km) {
-            if (filtered_count != i) {
-                services[filtered_count] = services[i];
-            }
-            filtered_count++;
+        if (!within_coverage &&
+            ((use_bound && !ntrip_atlas_geometry_may_be_within(&geometry[i], &user_vector, &bound)) ||
+             !is_service_within_distance(&services[i], user_latitude, user_longitude, max_distance_km))) {
+            continue;
+        }
+
+        if (keys) {
+            keys[filtered_count].chord_sq_q60 = geometry ?
+                chord_squared_q60(&geometry[i].center, &user_vector) :
+                service_chord_squared_q60(&services[i], &user_vector);
+            keys[filtered_count].index = filtered_count;
+        }
+        if (filtered_count != i) {
+            services[filtered_count] = services[i];
+        }
+        filtered_count++;
+    }
+
+    // Second pass: Sort keys (or select the nearest few), then move each
+    // service once into its ranked position
+    size_t result_count = filtered_count < max_results ? filtered_count : max_results;
+
+    if (!keys) {
+        // No room for keys (workspace full, malloc failed or no heap):
+        // same order, found without them
+        select_nearest_in_place(services, filtered_count, result_count, &user_vector);
+    } else if (filtered_count > 1) {
+        if (result_count < filtered_count) {
+            partial_sort_keys(keys, result_count, filtered_count);
+        } else {
+            qsort(keys, filtered_count, sizeof(geo_sort_key_t), compare_sort_keys);
         }
+        permute_services_by_keys(services, keys, filtered_count);
     }
 
-    // Second pass: Sort filtered services by distance
-    if (filtered_count > 1) {
-        g_sort_user_latitude = user_latitude;
-        g_sort_user_longitude = user_longitude;
-        qsort(services, filtered_count, sizeof(ntrip_service_compact_t),
-              compare_services_by_distance);
+    if (heap_keys) {
+        free(keys);
+    } else {
+        ntrip_atlas_workspace_release(workspace, workspace_mark);
     }
 
-    return filtered_count;
+    return result_count;
+}
+
+/**
+ * Filter services by location and return the nearest max_results in order
+ */
+size_t ntrip_atlas_filter_and_sort_nearest_services(
+    ntrip_service_compact_t* services,
+    size_t service_count,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km,
+    size_t max_results
+) {
+    return ntrip_atlas_filter_and_sort_nearest_services_in(
+        services, NULL, service_count, user_latitude, user_longitude,
+        max_distance_km, max_results, NULL
+    );
+}
+
+/**
+ * Filter and sort services by geographic proximity
+ */
+size_t ntrip_atlas_filter_and_sort_services_by_location(
+    ntrip_service_compact_t* services,
+    size_t service_count,
+    double user_latitude,
+    double user_longitude,
+    double max_distance_km
+) {
+    return ntrip_atlas_filter_and_sort_nearest_services(
+        services, service_count, user_latitude, user_longitude,
+        max_distance_km, service_count
+    );
 }
 
 /**
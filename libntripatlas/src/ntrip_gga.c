@@ -148,11 +148,11 @@ int ntrip_atlas_format_gga(
 
     // Calculate and append checksum
     uint8_t checksum = calculate_checksum(buffer);
-    int total_len = snprintf(buffer, max_len, "%s*%02X\r\n", buffer, checksum);
+    int suffix_len = snprintf(buffer + len, max_len - (size_t)len, "*%02X\r\n", checksum);
 
-    if (total_len < 0 || (size_t)total_len >= max_len) {
+    if (suffix_len < 0 || (size_t)(len + suffix_len) >= max_len) {
         return NTRIP_ATLAS_ERROR_NO_MEMORY;
     }
 
-    return total_len;
+    return len + suffix_len;
 }
@@ -0,0 +1,636 @@
+/**
+ * NTRIP Atlas - HTTP/NTRIP Client Core
+ *
+ * One response state machine for every platform transport. Status and
+ * header lines are assembled with memchr() over whole receive buffers;
+ * body and chunk data are never copied, only handed on as spans of the
+ * caller's buffer. No allocation, and all state lives in the caller's
+ * ntrip_http_response_t, so it can be resumed at any byte boundary.
+ * On top of it, a non-blocking GET over the platform's byte transport.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <stdio.h>
+#include <string.h>
+
+static char lower_ascii(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+/**
+ * Value of a header line if its (lowercase) name matches
+ */
+static const char* header_value(const char* line, const char* name) {
+    size_t i = 0;
+    for (; name[i] != '\0'; i++) {
+        if (lower_ascii(line[i]) != name[i]) {
+            return NULL;
+        }
+    }
+    if (line[i] != ':') {
+        return NULL;
+    }
+    i++;
+    while (line[i] == ' ' || line[i] == '\t') {
+        i++;
+    }
+    return line + i;
+}
+
+/**
+ * Case-insensitive search for a (lowercase) token in a header value
+ */
+static bool contains_token(const char* value, const char* token) {
+    size_t token_len = strlen(token);
+    for (; *value != '\0'; value++) {
+        size_t i = 0;
+        while (i < token_len && lower_ascii(value[i]) == token[i]) {
+            i++;
+        }
+        if (i == token_len) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parse_decimal(const char* text, uint32_t* out) {
+    uint32_t value = 0;
+    size_t digits = 0;
+    for (; *text >= '0' && *text <= '9'; text++, digits++) {
+        uint32_t digit = (uint32_t)(*text - '0');
+        if (value > (UINT32_MAX - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    if (digits == 0 || *text != '\0') {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * Parse a chunk size line ("1a2b" with optional ";extension")
+ */
+static bool parse_chunk_size(const char* text, uint32_t* out) {
+    uint32_t value = 0;
+    size_t digits = 0;
+    for (;; text++, digits++) {
+        char c = lower_ascii(*text);
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = (uint32_t)(c - 'a' + 10);
+        } else {
+            break;
+        }
+        if (value > (UINT32_MAX >> 4)) {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    if (digits == 0 || (*text != '\0' && *text != ';')) {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * Reset a response parser
+ */
+void ntrip_atlas_http_response_init(ntrip_http_response_t* response) {
+    if (response) {
+        memset(response, 0, sizeof(*response));
+    }
+}
+
+/**
+ * Collect bytes up to the next line end into the line buffer
+ *
+ * @return Bytes consumed; *complete is set once a whole line (without
+ *         its CR LF) is in the buffer
+ */
+static size_t take_line(ntrip_http_response_t* response, const char* data, size_t len, bool* complete) {
+    const char* end = memchr(data, '\n', len);
+    size_t span = end ? (size_t)(end - data) : len;
+
+    size_t room = sizeof(response->line) - 1 - response->line_len;
+    size_t copy = span < room ? span : room;
+    memcpy(response->line + response->line_len, data, copy);
+    response->line_len += (uint16_t)copy;
+
+    *complete = end != NULL;
+    if (!end) {
+        return span;
+    }
+
+    if (response->line_len > 0 && response->line[response->line_len - 1] == '\r') {
+        response->line_len--;
+    }
+    response->line[response->line_len] = '\0';
+    return span + 1;
+}
+
+/**
+ * Interpret the status line
+ */
+static int handle_status_line(ntrip_http_response_t* response) {
+    const char* line = response->line;
+
+    if (strncmp(line, "SOURCETABLE 200", 15) == 0) {
+        response->protocol = NTRIP_HTTP_PROTOCOL_SOURCETABLE;
+        response->status_code = 200;
+        response->state = NTRIP_HTTP_HEADERS;
+        return 0;
+    }
+
+    // NTRIP 1.0 streams carry no headers: data starts after the status line
+    if (strncmp(line, "ICY 200", 7) == 0) {
+        response->protocol = NTRIP_HTTP_PROTOCOL_ICY;
+        response->status_code = 200;
+        response->state = NTRIP_HTTP_BODY;
+        return 0;
+    }
+
+    if (strncmp(line, "HTTP/1.", 7) != 0 || line[7] == '\0' || line[8] != ' ' ||
+        line[9] < '1' || line[9] > '5' || line[10] < '0' || line[10] > '9' ||
+        line[11] < '0' || line[11] > '9' || (line[12] != ' ' && line[12] != '\0')) {
+        return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+    }
+
+    response->protocol = NTRIP_HTTP_PROTOCOL_HTTP;
+    response->status_code = (uint16_t)((line[9] - '0') * 100 + (line[10] - '0') * 10 + (line[11] - '0'));
+    response->state = NTRIP_HTTP_HEADERS;
+
+    if (response->status_code == 401) {
+        return NTRIP_ATLAS_ERROR_AUTH_FAILED;
+    }
+    if (response->status_code == 404) {
+        return NTRIP_ATLAS_ERROR_NOT_FOUND;
+    }
+    if (response->status_code < 200 || response->status_code >= 300) {
+        return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+    }
+    return 0;
+}
+
+/**
+ * Interpret a header line, or the blank line that ends the headers
+ *
+ * @return 1 if the response has no body left, 0 to continue, negative error
+ */
+static int handle_header_line(ntrip_http_response_t* response) {
+    const char* line = response->line;
+
+    if (line[0] == '\0') {
+        // Chunked wins over Content-Length (RFC 7230 3.3.3)
+        if (response->chunked) {
+            response->state = NTRIP_HTTP_CHUNK_SIZE;
+            return 0;
+        }
+        response->state = NTRIP_HTTP_BODY;
+        if (response->has_length) {
+            response->remaining = response->content_length;
+            if (response->remaining == 0) {
+                response->state = NTRIP_HTTP_DONE;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    const char* value;
+    if ((value = header_value(line, "content-length")) != NULL) {
+        if (!parse_decimal(value, &response->content_length)) {
+            return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+        }
+        response->has_length = 1;
+    } else if ((value = header_value(line, "transfer-encoding")) != NULL) {
+        if (contains_token(value, "chunked")) {
+            response->chunked = 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Hand a body span to the caller
+ *
+ * @return true if the caller asked to stop
+ */
+static bool deliver(
+    ntrip_http_response_t* response,
+    const char* data,
+    size_t len,
+    ntrip_stream_callback_t on_body,
+    void* context
+) {
+    if (len == 0) {
+        return false;
+    }
+    response->body_bytes += (uint32_t)len;
+    if (on_body && on_body(data, len, context) != 0) {
+        response->state = NTRIP_HTTP_DONE;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Feed received bytes
+ */
+int ntrip_atlas_http_response_feed(
+    ntrip_http_response_t* response,
+    const char* data,
+    size_t len,
+    ntrip_stream_callback_t on_body,
+    void* context
+) {
+    if (!response || (!data && len > 0)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    size_t pos = 0;
+    while (response->state != NTRIP_HTTP_DONE) {
+        size_t available = len - pos;
+        bool complete = false;
+        int ret = 0;
+
+        switch (response->state) {
+            case NTRIP_HTTP_STATUS_LINE:
+            case NTRIP_HTTP_HEADERS:
+            case NTRIP_HTTP_CHUNK_SIZE:
+            case NTRIP_HTTP_CHUNK_END:
+            case NTRIP_HTTP_TRAILERS:
+                if (available == 0) {
+                    return 0;
+                }
+                pos += take_line(response, data + pos, available, &complete);
+                if (!complete) {
+                    return 0;
+                }
+                response->line_len = 0;
+
+                if (response->state == NTRIP_HTTP_STATUS_LINE) {
+                    ret = handle_status_line(response);
+                } else if (response->state == NTRIP_HTTP_HEADERS) {
+                    ret = handle_header_line(response);
+                } else if (response->state == NTRIP_HTTP_CHUNK_SIZE) {
+                    if (!parse_chunk_size(response->line, &response->remaining)) {
+                        return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+                    }
+                    response->state = response->remaining > 0 ? NTRIP_HTTP_CHUNK_DATA : NTRIP_HTTP_TRAILERS;
+                } else if (response->state == NTRIP_HTTP_CHUNK_END) {
+                    if (response->line[0] != '\0') {
+                        return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+                    }
+                    response->state = NTRIP_HTTP_CHUNK_SIZE;
+                } else if (response->line[0] == '\0') {
+                    response->state = NTRIP_HTTP_DONE;
+                    ret = 1;
+                }
+
+                if (ret != 0) {
+                    return ret;
+                }
+                break;
+
+            case NTRIP_HTTP_BODY:
+            case NTRIP_HTTP_CHUNK_DATA: {
+                if (available == 0) {
+                    return 0;
+                }
+                bool counted = response->state == NTRIP_HTTP_CHUNK_DATA || response->has_length;
+                size_t span = available;
+                if (counted && span > response->remaining) {
+                    span = response->remaining;
+                }
+
+                if (deliver(response, data + pos, span, on_body, context)) {
+                    return 1;
+                }
+                pos += span;
+
+                if (counted) {
+                    response->remaining -= (uint32_t)span;
+                    if (response->remaining == 0) {
+                        if (response->state == NTRIP_HTTP_CHUNK_DATA) {
+                            response->state = NTRIP_HTTP_CHUNK_END;
+                        } else {
+                            response->state = NTRIP_HTTP_DONE;
+                            return 1;
+                        }
+                    }
+                }
+                break;
+            }
+
+            case NTRIP_HTTP_DONE:
+                break;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Handle the peer closing the connection
+ */
+ntrip_atlas_error_t ntrip_atlas_http_response_finish(ntrip_http_response_t* response) {
+    if (!response) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (response->state == NTRIP_HTTP_BODY && !response->has_length) {
+        response->state = NTRIP_HTTP_DONE;
+    }
+    return response->state == NTRIP_HTTP_DONE ? NTRIP_ATLAS_SUCCESS : NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+}
+
+/**
+ * Format the GET request every transport sends
+ */
+int ntrip_atlas_http_format_request(
+    char* buffer,
+    size_t buffer_size,
+    const char* host,
+    uint16_t port,
+    const char* path
+) {
+    if (!buffer || !host || host[0] == '\0') {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (!path || path[0] == '\0') {
+        path = "/";
+    }
+
+    // Host carries the port unless it is the HTTP default
+    char port_suffix[8] = "";
+    if (port != 0 && port != 80) {
+        snprintf(port_suffix, sizeof(port_suffix), ":%u", (unsigned)port);
+    }
+
+    int length = snprintf(buffer, buffer_size,
+                          "GET %s HTTP/1.1\r\n"
+                          "Host: %s%s\r\n"
+                          "Ntrip-Version: Ntrip/2.0\r\n"
+                          "User-Agent: NTRIP NTRIP-Atlas/1.0\r\n"
+                          "Connection: close\r\n"
+                          "\r\n",
+                          path, host, port_suffix);
+    if (length < 0 || (size_t)length >= buffer_size) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    return length;
+}
+
+/**
+ * Non-blocking HTTP Stream
+ */
+
+// Receive chunk on the stack of each step; one recv() per chunk, so
+// desktops take whole socket buffers at a time
+#if defined(ESP32) || defined(ESP8266) || defined(ARDUINO)
+#define NB_CHUNK_SIZE 256
+#else
+#define NB_CHUNK_SIZE 16384
+#endif
+
+/**
+ * Close the connection and record the outcome
+ */
+static ntrip_atlas_error_t finish_stream(ntrip_http_stream_t* stream, ntrip_atlas_error_t status) {
+    if (stream->connection) {
+        stream->platform->nb_transport->close(stream->connection);
+        stream->connection = NULL;
+    }
+    stream->state = NTRIP_NB_STREAM_DONE;
+    stream->status = status;
+    stream->step_again = 0;
+    return status;
+}
+
+/**
+ * Connect a stream whose request is already in place
+ */
+static ntrip_atlas_error_t stream_connect(
+    ntrip_http_stream_t* stream,
+    const char* host,
+    uint16_t port,
+    uint8_t ssl
+) {
+    const ntrip_platform_t* platform = stream->platform;
+    ntrip_atlas_http_response_init(&stream->http);
+
+    int ret = platform->nb_transport->connect(host, port, ssl, &stream->connection);
+    if (ret < 0) {
+        stream->connection = NULL;
+        return (ntrip_atlas_error_t)ret;
+    }
+
+    if (platform->get_time_ms) {
+        stream->started_ms = platform->get_time_ms();
+    }
+    stream->state = NTRIP_NB_STREAM_SENDING;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Check arguments and reset the stream
+ */
+static ntrip_atlas_error_t stream_prepare(
+    ntrip_http_stream_t* stream,
+    const ntrip_platform_t* platform,
+    const char* host,
+    ntrip_stream_callback_t on_data,
+    void* context,
+    uint32_t timeout_ms
+) {
+    if (!stream || !platform || !host || host[0] == '\0') {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    const ntrip_nb_transport_t* transport = platform->nb_transport;
+    if (!transport || !transport->connect || !transport->send ||
+        !transport->recv || !transport->close) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->platform = platform;
+    stream->on_data = on_data;
+    stream->context = context;
+    stream->timeout_ms = platform->get_time_ms ? timeout_ms : 0;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Start a non-blocking GET
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_begin(
+    ntrip_http_stream_t* stream,
+    const ntrip_platform_t* platform,
+    const char* host,
+    uint16_t port,
+    uint8_t ssl,
+    const char* path,
+    ntrip_stream_callback_t on_data,
+    void* context,
+    uint32_t timeout_ms
+) {
+    ntrip_atlas_error_t ret = stream_prepare(stream, platform, host, on_data, context, timeout_ms);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+
+    int length = ntrip_atlas_http_format_request(stream->request, sizeof(stream->request), host, port, path);
+    if (length < 0) {
+        return (ntrip_atlas_error_t)length;
+    }
+    stream->request_len = (size_t)length;
+    return stream_connect(stream, host, port, ssl);
+}
+
+/**
+ * Start a non-blocking stream with a caller-formatted request
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_begin_request(
+    ntrip_http_stream_t* stream,
+    const ntrip_platform_t* platform,
+    const char* host,
+    uint16_t port,
+    uint8_t ssl,
+    const char* request,
+    ntrip_stream_callback_t on_data,
+    void* context,
+    uint32_t timeout_ms
+) {
+    if (!request || request[0] == '\0') {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    ntrip_atlas_error_t ret = stream_prepare(stream, platform, host, on_data, context, timeout_ms);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+
+    stream->custom_request = request;
+    stream->request_len = strlen(request);
+    return stream_connect(stream, host, port, ssl);
+}
+
+/**
+ * Make as much progress as possible without waiting
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_step(ntrip_http_stream_t* stream) {
+    if (!stream || stream->state == NTRIP_NB_STREAM_IDLE) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (stream->state == NTRIP_NB_STREAM_DONE) {
+        return stream->status;
+    }
+
+    const ntrip_platform_t* platform = stream->platform;
+    const ntrip_nb_transport_t* transport = platform->nb_transport;
+    stream->step_again = 0;
+
+    if (stream->timeout_ms && platform->get_time_ms() - stream->started_ms > stream->timeout_ms) {
+        return finish_stream(stream, NTRIP_ATLAS_ERROR_TIMEOUT);
+    }
+
+    const char* request = stream->custom_request ? stream->custom_request : stream->request;
+    while (stream->state == NTRIP_NB_STREAM_SENDING) {
+        int sent = transport->send(stream->connection,
+                                   request + stream->request_sent,
+                                   stream->request_len - stream->request_sent);
+        if (sent == NTRIP_ATLAS_ERROR_WOULD_BLOCK || sent == 0) {
+            return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+        }
+        if (sent < 0) {
+            return finish_stream(stream, (ntrip_atlas_error_t)sent);
+        }
+
+        stream->request_sent += (size_t)sent;
+        if (stream->request_sent >= stream->request_len) {
+            stream->state = NTRIP_NB_STREAM_RECEIVING;
+            if (platform->get_time_ms) {
+                stream->sent_ms = platform->get_time_ms() - stream->started_ms;
+            }
+        }
+    }
+
+    // Bounded so one large response cannot hold up the rest of the loop
+    char chunk[NB_CHUNK_SIZE];
+    size_t budget = NTRIP_ATLAS_NB_STEP_BYTES;
+    while (budget > 0) {
+        size_t want = budget < sizeof(chunk) ? budget : sizeof(chunk);
+        int received = transport->recv(stream->connection, chunk, want);
+        if (received == NTRIP_ATLAS_ERROR_WOULD_BLOCK) {
+            return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+        }
+        if (received < 0) {
+            return finish_stream(stream, (ntrip_atlas_error_t)received);
+        }
+        if (received == 0) {
+            // Peer closed: fine only if that is how the body was delimited
+            return finish_stream(stream, ntrip_atlas_http_response_finish(&stream->http));
+        }
+
+        if (stream->bytes_received == 0 && platform->get_time_ms) {
+            stream->first_byte_ms = platform->get_time_ms() - stream->started_ms;
+        }
+        budget -= (size_t)received;
+        stream->bytes_received += (size_t)received;
+
+        int ret = ntrip_atlas_http_response_feed(&stream->http, chunk, (size_t)received,
+                                                 stream->on_data, stream->context);
+        if (ret != 0) {
+            return finish_stream(stream, ret < 0 ? (ntrip_atlas_error_t)ret : NTRIP_ATLAS_SUCCESS);
+        }
+    }
+
+    // TLS may hold decrypted bytes the descriptor no longer signals
+    stream->step_again = 1;
+    return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+}
+
+/**
+ * Descriptor and direction to wait on before the next step
+ */
+int ntrip_atlas_http_stream_poll_fd(const ntrip_http_stream_t* stream, bool* want_write) {
+    bool write = stream && stream->state == NTRIP_NB_STREAM_SENDING;
+    int fd = -1;
+    if (stream && stream->connection && stream->platform->nb_transport->poll_fd) {
+        fd = stream->platform->nb_transport->poll_fd(stream->connection, &write);
+    }
+    if (want_write) {
+        *want_write = write;
+    }
+    return fd;
+}
+
+/**
+ * Close the connection
+ */
+ntrip_atlas_error_t ntrip_atlas_http_stream_end(ntrip_http_stream_t* stream) {
+    if (!stream || stream->state == NTRIP_NB_STREAM_IDLE) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (stream->state != NTRIP_NB_STREAM_DONE) {
+        finish_stream(stream, NTRIP_ATLAS_SUCCESS);
+    }
+    stream->state = NTRIP_NB_STREAM_IDLE;
+    return stream->status;
+}
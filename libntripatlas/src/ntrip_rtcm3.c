@@ -0,0 +1,332 @@
+/**
+ * NTRIP Atlas - RTCM3 Frame Scanner
+ *
+ * Finds RTCM3 frames (preamble 0xD3, 10-bit length, payload, CRC-24Q)
+ * in correction streams at line rate. Frames that lie whole inside a
+ * chunk are checked in place with one CRC pass; only frames split across
+ * chunks carry a running CRC into the next call, plus the first payload
+ * bytes so a split 1005/1006 can still be decoded. Nothing else is
+ * copied, so the scanner can watch relay buffers on their way through.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <string.h>
+
+#if NTRIP_ATLAS_CRC24Q_SLICES != 1 && NTRIP_ATLAS_CRC24Q_SLICES != 8
+#error "NTRIP_ATLAS_CRC24Q_SLICES must be 1 or 8"
+#endif
+
+#include "ntrip_crc24q_tables.h"
+
+#define RTCM3_HEADER_SIZE 3
+#define RTCM3_CRC_SIZE 3
+
+#define RTCM3_STATION_1005_SIZE 19
+#define RTCM3_ARP_SCALE 0.0001  // DF025-DF028 resolution, m
+
+/**
+ * Fold bytes into a CRC-24Q held in the top 24 bits
+ */
+static uint32_t crc24q_update(uint32_t crc, const uint8_t* p, size_t len) {
+#if NTRIP_ATLAS_CRC24Q_SLICES == 8
+    // Byte loads keep this independent of host byte order and alignment
+    while (len >= 8) {
+        uint32_t word = crc ^ ((uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+                               (uint32_t)p[2] << 8 | p[3]);
+        crc = crc24q_table[7][word >> 24] ^ crc24q_table[6][(word >> 16) & 0xFF] ^
+              crc24q_table[5][(word >> 8) & 0xFF] ^ crc24q_table[4][word & 0xFF] ^
+              crc24q_table[3][p[4]] ^ crc24q_table[2][p[5]] ^
+              crc24q_table[1][p[6]] ^ crc24q_table[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+#endif
+    while (len--) {
+        crc = (crc << 8) ^ crc24q_table[0][(crc >> 24) ^ *p++];
+    }
+    return crc;
+}
+
+/**
+ * CRC-24Q (RTCM 10403, Qualcomm) of a buffer
+ */
+uint32_t ntrip_atlas_crc24q(uint32_t crc, const uint8_t* data, size_t len) {
+    if (!data) {
+        return crc;
+    }
+    return crc24q_update(crc << 8, data, len) >> 8;
+}
+
+/**
+ * Reset a frame scanner
+ */
+void ntrip_atlas_rtcm3_init(ntrip_rtcm3_framer_t* framer) {
+    if (framer) {
+        memset(framer, 0, sizeof(*framer));
+    }
+}
+
+static void count_type(ntrip_rtcm3_framer_t* framer, uint16_t message_type) {
+    for (uint8_t i = 0; i < framer->type_count; i++) {
+        if (framer->types[i].message_type == message_type) {
+            framer->types[i].count++;
+            return;
+        }
+    }
+    if (framer->type_count < NTRIP_ATLAS_RTCM3_TYPE_SLOTS) {
+        framer->types[framer->type_count].message_type = message_type;
+        framer->types[framer->type_count].count = 1;
+        framer->type_count++;
+    } else {
+        framer->untracked_frames++;
+    }
+}
+
+/**
+ * Unsigned big-endian bit field
+ */
+static uint64_t get_bits(const uint8_t* data, size_t pos, unsigned len) {
+    uint64_t value = 0;
+    for (unsigned i = 0; i < len; i++, pos++) {
+        value = (value << 1) | ((data[pos / 8] >> (7 - pos % 8)) & 1);
+    }
+    return value;
+}
+
+/**
+ * Two's complement bit field
+ */
+static int64_t get_signed_bits(const uint8_t* data, size_t pos, unsigned len) {
+    uint64_t value = get_bits(data, pos, len);
+    uint64_t sign = (uint64_t)1 << (len - 1);
+    return (int64_t)(value ^ sign) - (int64_t)sign;
+}
+
+/**
+ * Decode a 1005 or 1006 payload (the bytes after the frame header)
+ */
+ntrip_atlas_error_t ntrip_atlas_rtcm3_decode_station(
+    const uint8_t* payload,
+    size_t len,
+    ntrip_rtcm3_station_t* station
+) {
+    if (!payload || !station) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (len < 2) {
+        return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+    }
+
+    uint16_t message_type = (uint16_t)get_bits(payload, 0, 12);
+    size_t needed = message_type == 1005 ? RTCM3_STATION_1005_SIZE : NTRIP_RTCM3_STATION_PAYLOAD;
+    if ((message_type != 1005 && message_type != 1006) || len < needed) {
+        return NTRIP_ATLAS_ERROR_INVALID_RESPONSE;
+    }
+
+    // DF002 type, DF003 station, DF021 ITRF year, four indicator bits,
+    // then 38-bit X, Y and Z each followed by two bits of flags
+    memset(station, 0, sizeof(*station));
+    station->message_type = message_type;
+    station->station_id = (uint16_t)get_bits(payload, 12, 12);
+    station->ecef_x = get_signed_bits(payload, 34, 38) * RTCM3_ARP_SCALE;
+    station->ecef_y = get_signed_bits(payload, 74, 38) * RTCM3_ARP_SCALE;
+    station->ecef_z = get_signed_bits(payload, 114, 38) * RTCM3_ARP_SCALE;
+    if (message_type == 1006) {
+        station->antenna_height = get_bits(payload, 152, 16) * RTCM3_ARP_SCALE;
+    }
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Book a checked frame (length and message_type already set)
+ * @param payload Start of the payload; split frames pass the captured head
+ * @param available Payload bytes readable at payload
+ */
+static void finish_frame(ntrip_rtcm3_framer_t* framer, bool valid,
+                         const uint8_t* payload, size_t available) {
+    framer->pos = 0;
+    if (!valid) {
+        // Out of sync most failures are stray 0xD3 bytes, so only the
+        // first failure after a good frame counts
+        if (framer->in_sync) {
+            framer->crc_errors++;
+            framer->in_sync = 0;
+        }
+        return;
+    }
+
+    framer->in_sync = 1;
+    framer->frames++;
+    framer->frame_bytes += RTCM3_HEADER_SIZE + framer->length + RTCM3_CRC_SIZE;
+    if (framer->length >= 2) {
+        count_type(framer, framer->message_type);
+    }
+    if ((framer->message_type == 1005 || framer->message_type == 1006) &&
+        ntrip_atlas_rtcm3_decode_station(payload, available, &framer->station) == NTRIP_ATLAS_SUCCESS) {
+        framer->has_station = 1;
+    }
+}
+
+/**
+ * Advance a frame that runs past the end of a chunk
+ * @return Bytes consumed; stops early when the frame ends or turns out
+ *         not to be one
+ */
+static size_t carry_frame(ntrip_rtcm3_framer_t* framer, const uint8_t* data, size_t len) {
+    size_t used = 0;
+    while (used < len) {
+        uint16_t pos = framer->pos;
+
+        if (pos < RTCM3_HEADER_SIZE) {
+            uint8_t byte = data[used];
+            if (pos == 1) {
+                // Six reserved bits after the preamble are zero in a real header;
+                // leave this byte for the preamble search
+                if (byte & 0xFC) {
+                    framer->pos = 0;
+                    return used;
+                }
+                framer->length = (uint16_t)((byte & 0x03) << 8);
+            } else if (pos == 2) {
+                framer->length |= byte;
+            }
+            framer->crc = crc24q_update(framer->crc, &byte, 1);
+            framer->pos++;
+            used++;
+            continue;
+        }
+
+        uint16_t crc_start = RTCM3_HEADER_SIZE + framer->length;
+        if (pos < crc_start) {
+            size_t take = crc_start - pos;
+            if (take > len - used) {
+                take = len - used;
+            }
+
+            // Message type: the first 12 payload bits, possibly split too
+            if (pos == RTCM3_HEADER_SIZE) {
+                framer->message_type = (uint16_t)(data[used] << 4);
+            }
+            if (pos <= RTCM3_HEADER_SIZE + 1 && pos + take > RTCM3_HEADER_SIZE + 1) {
+                framer->message_type |= data[used + RTCM3_HEADER_SIZE + 1 - pos] >> 4;
+            }
+
+            // Keep the payload start for 1005/1006, whose bytes will be gone
+            if (pos < RTCM3_HEADER_SIZE + NTRIP_RTCM3_STATION_PAYLOAD) {
+                size_t offset = pos - RTCM3_HEADER_SIZE;
+                size_t keep = NTRIP_RTCM3_STATION_PAYLOAD - offset;
+                memcpy(framer->head + offset, data + used, take < keep ? take : keep);
+            }
+
+            framer->crc = crc24q_update(framer->crc, data + used, take);
+            framer->pos = (uint16_t)(pos + take);
+            used += take;
+            continue;
+        }
+
+        framer->check = (framer->check << 8) | data[used++];
+        framer->pos++;
+        if (framer->pos == crc_start + RTCM3_CRC_SIZE) {
+            // The frame's bytes are gone, so a failure resumes after it
+            size_t available = framer->length < NTRIP_RTCM3_STATION_PAYLOAD ?
+                               framer->length : NTRIP_RTCM3_STATION_PAYLOAD;
+            finish_frame(framer, (framer->crc >> 8) == framer->check, framer->head, available);
+            return used;
+        }
+    }
+    return used;
+}
+
+/**
+ * Scan the next chunk of a stream
+ */
+uint32_t ntrip_atlas_rtcm3_feed(ntrip_rtcm3_framer_t* framer, const uint8_t* data, size_t len) {
+    if (!framer || !data) {
+        return 0;
+    }
+
+    uint32_t frames_before = framer->frames;
+    framer->bytes += len;
+
+    size_t i = 0;
+    while (i < len) {
+        if (framer->pos == 0) {
+            const uint8_t* preamble = memchr(data + i, NTRIP_RTCM3_PREAMBLE, len - i);
+            if (!preamble) {
+                break;
+            }
+            i = (size_t)(preamble - data);
+
+            // Whole frame in this chunk: check it in place
+            const uint8_t* frame = preamble;
+            size_t available = len - i;
+            if (available >= RTCM3_HEADER_SIZE) {
+                if (frame[1] & 0xFC) {
+                    i++;
+                    continue;
+                }
+                uint16_t length = (uint16_t)(((frame[1] & 0x03) << 8) | frame[2]);
+                size_t total = RTCM3_HEADER_SIZE + length + RTCM3_CRC_SIZE;
+                if (available >= total) {
+                    const uint8_t* check = frame + total - RTCM3_CRC_SIZE;
+                    uint32_t crc = crc24q_update(0, frame, RTCM3_HEADER_SIZE + length) >> 8;
+                    bool valid = crc == ((uint32_t)check[0] << 16 | (uint32_t)check[1] << 8 | check[2]);
+
+                    framer->length = length;
+                    framer->message_type = length >= 2 ? (uint16_t)(frame[3] << 4 | frame[4] >> 4) : 0;
+                    finish_frame(framer, valid, frame + RTCM3_HEADER_SIZE, length);
+
+                    // A false preamble may hide a real one inside what it claimed
+                    i += valid ? total : 1;
+                    continue;
+                }
+            }
+
+            framer->crc = 0;
+            framer->check = 0;
+            framer->length = 0;
+            framer->message_type = 0;
+        }
+
+        i += carry_frame(framer, data + i, len - i);
+    }
+
+    return framer->frames - frames_before;
+}
+
+/**
+ * Valid frames seen of one message type
+ */
+uint32_t ntrip_atlas_rtcm3_type_count(const ntrip_rtcm3_framer_t* framer, uint16_t message_type) {
+    if (!framer) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < framer->type_count; i++) {
+        if (framer->types[i].message_type == message_type) {
+            return framer->types[i].count;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Byte and frame rates over an observation time
+ */
+void ntrip_atlas_rtcm3_rates(
+    const ntrip_rtcm3_framer_t* framer,
+    uint32_t elapsed_ms,
+    double* bytes_per_second,
+    double* frames_per_second
+) {
+    double seconds = elapsed_ms / 1000.0;
+    bool valid = framer && elapsed_ms > 0;
+
+    if (bytes_per_second) {
+        *bytes_per_second = valid ? framer->bytes / seconds : 0.0;
+    }
+    if (frames_per_second) {
+        *frames_per_second = valid ? framer->frames / seconds : 0.0;
+    }
+}
@@ -0,0 +1,375 @@
+/**
+ * NTRIP Atlas - Per-Tile Selection Cache
+ *
+ * A stationary or slow rover keeps asking about the same finest tile with
+ * the same criteria. Everything about that answer that does not depend on
+ * the exact position - which tile candidates pass the criteria, which are
+ * in failure backoff, which are usable with the current credentials, and
+ * their quality order - is computed once and memoized per tile. Entries
+ * carry the generations of the credential store, failure tracker,
+ * geographic blacklist and spatial index they were built from, so any
+ * change to those turns the next probe into a miss. Backoff expiry is
+ * time-driven rather than event-driven, so entries that excluded a blocked
+ * service also expire at the hour it becomes retryable.
+ *
+ * Coverage boxes, distances and 1-degree blacklist cells are finer than a
+ * tile, so those are still checked per lookup, over at most
+ * NTRIP_ATLAS_TRACKER_MAX_CANDIDATES cached services.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <string.h>
+#include <time.h>
+
+#define SELECTION_CACHE_WAYS 4
+#define SELECTION_CACHE_SETS (NTRIP_ATLAS_SELECTION_CACHE_ENTRIES / SELECTION_CACHE_WAYS)
+#define SELECTION_CACHE_MAX_CANDIDATES NTRIP_ATLAS_TRACKER_MAX_CANDIDATES
+#define SELECTION_CACHE_NO_EXPIRY UINT32_MAX
+
+#if NTRIP_ATLAS_SELECTION_CACHE_ENTRIES < SELECTION_CACHE_WAYS || \
+    (SELECTION_CACHE_SETS & (SELECTION_CACHE_SETS - 1)) != 0
+#error "NTRIP_ATLAS_SELECTION_CACHE_ENTRIES must be 4 times a power of two"
+#endif
+
+// Criteria fields that can change the cached stage
+typedef struct {
+    uint8_t free_only;
+    uint8_t max_auth;
+    uint8_t min_quality_rating;
+    uint8_t preferred_network;
+} selection_criteria_key_t;
+
+typedef struct {
+    // Key
+    ntrip_tile_key_t tile_key;
+    selection_criteria_key_t criteria;
+    const ntrip_service_compact_t* services;
+    size_t service_count;
+    uint32_t credential_generation;
+    uint32_t failure_generation;
+    uint32_t blacklist_generation;
+    uint32_t index_generation;
+    uint32_t expires_hours;       // Earliest backoff expiry among excluded services
+
+    // Candidates passing every position-independent filter, best quality first
+    ntrip_service_idx_t candidates[SELECTION_CACHE_MAX_CANDIDATES];
+    uint16_t blacklist_mask;      // Candidates that need a per-position blacklist check
+    uint8_t candidate_count;
+    bool valid;
+} selection_cache_entry_t;
+
+// Global selection cache state
+static struct {
+    selection_cache_entry_t entries[SELECTION_CACHE_SETS][SELECTION_CACHE_WAYS];
+    uint8_t victim[SELECTION_CACHE_SETS];
+    ntrip_selection_cache_stats_t stats;
+} g_selection_cache = {0};
+
+/**
+ * Reduce criteria to the fields the cached stage depends on
+ *
+ * Zero fields mean "no constraint", as in the sourcetable filters;
+ * preferred_network only breaks score ties, so NULL criteria get an
+ * out-of-range value that matches no service.
+ */
+static selection_criteria_key_t make_criteria_key(const ntrip_selection_criteria_t* criteria) {
+    selection_criteria_key_t key = {0, 0, 0, 0xFF};
+    if (criteria) {
+        key.free_only = criteria->free_only ? 1 : 0;
+        key.max_auth = (uint8_t)criteria->max_auth;
+        key.min_quality_rating = criteria->min_quality_rating;
+        key.preferred_network = (uint8_t)criteria->preferred_network;
+    }
+    return key;
+}
+
+/**
+ * FNV-1a over tile key and criteria, for set selection
+ */
+static uint32_t hash_key(ntrip_tile_key_t tile_key, const selection_criteria_key_t* criteria) {
+    const uint8_t bytes[8] = {
+        (uint8_t)tile_key, (uint8_t)(tile_key >> 8), (uint8_t)(tile_key >> 16), (uint8_t)(tile_key >> 24),
+        criteria->free_only, criteria->max_auth, criteria->min_quality_rating, criteria->preferred_network
+    };
+
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(bytes); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash ^ (hash >> 16);
+}
+
+static uint32_t current_time_hours(void) {
+    return (uint32_t)time(NULL) / 3600;
+}
+
+/**
+ * Check if an entry answers this tile, criteria and service table
+ */
+static bool entry_matches_query(
+    const selection_cache_entry_t* entry,
+    ntrip_tile_key_t tile_key,
+    const selection_criteria_key_t* criteria,
+    const ntrip_service_compact_t* services,
+    size_t service_count
+) {
+    return entry->valid &&
+           entry->tile_key == tile_key &&
+           memcmp(&entry->criteria, criteria, sizeof(*criteria)) == 0 &&
+           entry->services == services &&
+           entry->service_count == service_count;
+}
+
+/**
+ * Check if an entry still reflects current credential, failure, blacklist and index state
+ */
+static bool entry_is_current(const selection_cache_entry_t* entry, uint32_t credential_generation) {
+    return entry->credential_generation == credential_generation &&
+           entry->failure_generation == ntrip_atlas_get_compact_failure_generation() &&
+           entry->blacklist_generation == ntrip_atlas_get_geographic_blacklist_generation() &&
+           entry->index_generation == ntrip_atlas_get_spatial_index_generation() &&
+           (entry->expires_hours == SELECTION_CACHE_NO_EXPIRY || current_time_hours() < entry->expires_hours);
+}
+
+/**
+ * Strongest authentication a compact service asks for
+ */
+static ntrip_auth_method_t service_auth_method(const ntrip_service_compact_t* service) {
+    if (service->flags & NTRIP_FLAG_AUTH_DIGEST) return NTRIP_AUTH_DIGEST;
+    if (service->flags & NTRIP_FLAG_AUTH_BASIC) return NTRIP_AUTH_BASIC;
+    return NTRIP_AUTH_NONE;
+}
+
+/**
+ * Run the position-independent filters over a tile's candidates
+ */
+static void build_entry(
+    selection_cache_entry_t* entry,
+    double user_lat,
+    double user_lon,
+    const ntrip_service_compact_t* services,
+    size_t service_count,
+    const ntrip_credential_store_t* credentials
+) {
+    entry->candidate_count = 0;
+    entry->blacklist_mask = 0;
+    entry->expires_hours = SELECTION_CACHE_NO_EXPIRY;
+
+    const ntrip_service_idx_t* tile_services;
+    size_t tile_count = ntrip_atlas_find_tile_services(user_lat, user_lon, NULL, &tile_services);
+    uint32_t now_hours = 0;
+
+    for (size_t i = 0; i < tile_count && entry->candidate_count < SELECTION_CACHE_MAX_CANDIDATES; i++) {
+        ntrip_service_idx_t service_index = tile_services[i];
+        if (service_index >= service_count) {
+            continue;
+        }
+
+        const ntrip_service_compact_t* service = &services[service_index];
+        if (entry->criteria.free_only && (service->flags & NTRIP_FLAG_PAID_SERVICE)) {
+            continue;
+        }
+        if (entry->criteria.max_auth != NTRIP_AUTH_NONE &&
+            service_auth_method(service) > entry->criteria.max_auth) {
+            continue;
+        }
+        if (service->quality_rating < entry->criteria.min_quality_rating) {
+            continue;
+        }
+        if (!ntrip_atlas_is_service_usable(service, credentials)) {
+            continue;
+        }
+
+        if (ntrip_atlas_is_compact_service_blocked(service_index)) {
+            if (now_hours == 0) {
+                now_hours = current_time_hours();
+            }
+            uint32_t expires = now_hours + ntrip_atlas_get_compact_retry_time_hours(service_index);
+            if (expires < entry->expires_hours) {
+                entry->expires_hours = expires;
+            }
+            continue;
+        }
+
+        // Insert by quality, keeping tile order among equals
+        uint8_t slot = entry->candidate_count;
+        while (slot > 0 && services[entry->candidates[slot - 1]].quality_rating < service->quality_rating) {
+            entry->candidates[slot] = entry->candidates[slot - 1];
+            slot--;
+        }
+        entry->candidates[slot] = service_index;
+        entry->candidate_count++;
+    }
+
+    // Mask bits follow the final order
+    for (uint8_t i = 0; i < entry->candidate_count; i++) {
+        if (ntrip_atlas_has_geographic_blacklist(entry->candidates[i])) {
+            entry->blacklist_mask |= (uint16_t)(1u << i);
+        }
+    }
+}
+
+/**
+ * Find the entry for a query, building it on a miss
+ */
+static const selection_cache_entry_t* lookup_entry(
+    double user_lat,
+    double user_lon,
+    ntrip_tile_key_t tile_key,
+    const selection_criteria_key_t* criteria,
+    const ntrip_service_compact_t* services,
+    size_t service_count,
+    const ntrip_credential_store_t* credentials
+) {
+    uint32_t set = hash_key(tile_key, criteria) & (SELECTION_CACHE_SETS - 1);
+    selection_cache_entry_t* ways = g_selection_cache.entries[set];
+    uint32_t credential_generation = credentials ? credentials->generation : 0;
+
+    selection_cache_entry_t* target = NULL;
+    for (uint8_t way = 0; way < SELECTION_CACHE_WAYS; way++) {
+        if (entry_matches_query(&ways[way], tile_key, criteria, services, service_count)) {
+            if (entry_is_current(&ways[way], credential_generation)) {
+                g_selection_cache.stats.hits++;
+                if (ways[way].candidate_count == 0) {
+                    g_selection_cache.stats.negative_hits++;
+                }
+                return &ways[way];
+            }
+
+            // Rebuild the outdated entry in place
+            g_selection_cache.stats.stale++;
+            target = &ways[way];
+            break;
+        }
+    }
+
+    if (!target) {
+        for (uint8_t way = 0; way < SELECTION_CACHE_WAYS && !target; way++) {
+            if (!ways[way].valid) {
+                target = &ways[way];
+            }
+        }
+    }
+    if (!target) {
+        target = &ways[g_selection_cache.victim[set]];
+        g_selection_cache.victim[set] = (uint8_t)((g_selection_cache.victim[set] + 1) % SELECTION_CACHE_WAYS);
+    }
+
+    g_selection_cache.stats.misses++;
+
+    target->tile_key = tile_key;
+    target->criteria = *criteria;
+    target->services = services;
+    target->service_count = service_count;
+    target->credential_generation = credential_generation;
+    target->failure_generation = ntrip_atlas_get_compact_failure_generation();
+    target->blacklist_generation = ntrip_atlas_get_geographic_blacklist_generation();
+    target->index_generation = ntrip_atlas_get_spatial_index_generation();
+    build_entry(target, user_lat, user_lon, services, service_count, credentials);
+    target->valid = true;
+
+    return target;
+}
+
+/**
+ * Find ranked services for a location through the per-tile cache
+ */
+size_t ntrip_atlas_find_ranked_services_cached(
+    double user_lat,
+    double user_lon,
+    const ntrip_service_compact_t* services,
+    size_t service_count,
+    const ntrip_selection_criteria_t* criteria,
+    const ntrip_credential_store_t* credentials,
+    ntrip_service_idx_t* ranked,
+    size_t max_ranked
+) {
+    if (!services || service_count == 0 || !ranked || max_ranked == 0) {
+        return 0;
+    }
+
+    uint16_t tile_lat, tile_lon;
+    if (ntrip_atlas_lat_lon_to_tile(user_lat, user_lon, NTRIP_SPATIAL_FINEST_LEVEL,
+                                    &tile_lat, &tile_lon) != NTRIP_ATLAS_SUCCESS) {
+        return 0;
+    }
+
+    g_selection_cache.stats.lookups++;
+
+    // Every point of a finest tile resolves to the same tile candidates
+    ntrip_tile_key_t tile_key = ntrip_atlas_encode_tile_key(NTRIP_SPATIAL_FINEST_LEVEL, tile_lat, tile_lon);
+    selection_criteria_key_t criteria_key = make_criteria_key(criteria);
+    const selection_cache_entry_t* entry = lookup_entry(
+        user_lat, user_lon, tile_key, &criteria_key, services, service_count, credentials);
+
+    double max_distance_km = criteria ? criteria->max_distance_km : 0.0;
+    double scores[SELECTION_CACHE_MAX_CANDIDATES];
+    size_t count = 0;
+
+    for (uint8_t i = 0; i < entry->candidate_count; i++) {
+        ntrip_service_idx_t service_index = entry->candidates[i];
+        const ntrip_service_compact_t* service = &services[service_index];
+
+        if (!ntrip_atlas_is_location_within_service_coverage(service, user_lat, user_lon)) {
+            continue;
+        }
+        if ((entry->blacklist_mask & (1u << i)) &&
+            ntrip_atlas_is_service_geographically_blacklisted(service_index, user_lat, user_lon)) {
+            continue;
+        }
+        if (max_distance_km > 0 &&
+            ntrip_atlas_calculate_distance_to_service_center(service, user_lat, user_lon) > max_distance_km) {
+            continue;
+        }
+
+        // Insert by score; the preferred network wins ties, then quality order
+        double score = ntrip_atlas_score_service_spatial_geographic(service, user_lat, user_lon);
+        bool preferred = service->network_type == entry->criteria.preferred_network;
+        size_t slot = count < max_ranked ? count : max_ranked;
+        while (slot > 0) {
+            const ntrip_service_compact_t* above = &services[ranked[slot - 1]];
+            bool ahead = score > scores[slot - 1] ||
+                         (score == scores[slot - 1] && preferred &&
+                          above->network_type != entry->criteria.preferred_network);
+            if (!ahead) {
+                break;
+            }
+            if (slot < max_ranked) {
+                ranked[slot] = ranked[slot - 1];
+                scores[slot] = scores[slot - 1];
+            }
+            slot--;
+        }
+        if (slot < max_ranked) {
+            ranked[slot] = service_index;
+            scores[slot] = score;
+            if (count < max_ranked) {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Drop every cached tile
+ */
+void ntrip_atlas_selection_cache_clear(void) {
+    memset(g_selection_cache.entries, 0, sizeof(g_selection_cache.entries));
+    memset(g_selection_cache.victim, 0, sizeof(g_selection_cache.victim));
+}
+
+/**
+ * Get selection cache counters
+ */
+ntrip_atlas_error_t ntrip_atlas_get_selection_cache_stats(ntrip_selection_cache_stats_t* stats) {
+    if (!stats) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    *stats = g_selection_cache.stats;
+    return NTRIP_ATLAS_SUCCESS;
+}
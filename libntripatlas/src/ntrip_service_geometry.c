@@ -0,0 +1,232 @@
+/**
+ * NTRIP Atlas - Precomputed Service Geometry
+ *
+ * Represents each service's coverage center as a fixed-point unit vector
+ * with a bounding radius, so per-service distance work during discovery is
+ * a dot product instead of a haversine. The generator emits these values
+ * for the compiled-in database; ntrip_atlas_compute_service_geometry()
+ * produces identical values at runtime for services loaded from elsewhere.
+ *
+ * Licensed under MIT License
+ */
+
+#define _USE_MATH_DEFINES  // For M_PI on Windows/MSVC
+#include "ntrip_atlas.h"
+#include <string.h>
+#include <math.h>
+
+// Ensure M_PI is defined on all platforms
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define EARTH_RADIUS_KM         6371.0
+#define Q30_SCALE               1073741824.0   // 2^30
+
+// Half the Earth's circumference: no two points are farther apart
+#define MAX_GREAT_CIRCLE_KM     20016
+
+// Absorbs Q30 rounding in pruning tests so they stay conservative
+// (CORDIC sin/cos carry a few more LSB of error than libm)
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+#define GEOMETRY_DOT_SLACK_Q60  ((int64_t)64 << 30)
+#else
+#define GEOMETRY_DOT_SLACK_Q60  ((int64_t)16 << 30)
+
+/**
+ * Convert a value in [-1, 1] to Q30
+ */
+static int32_t to_q30(double value) {
+    if (value > 1.0) value = 1.0;
+    if (value < -1.0) value = -1.0;
+    return (int32_t)llround(value * Q30_SCALE);
+}
+#endif
+
+/**
+ * Convert lat/lon in decimal degrees to a Q30 unit vector
+ */
+void ntrip_atlas_lat_lon_to_unit_vector(
+    double latitude,
+    double longitude,
+    ntrip_unit_vector_t* vector
+) {
+    if (!vector) {
+        return;
+    }
+
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    ntrip_atlas_fixed_unit_vector(NTRIP_ATLAS_DEG_TO_MICRODEG(latitude),
+                                  NTRIP_ATLAS_DEG_TO_MICRODEG(longitude), vector);
+#else
+    double lat = latitude * M_PI / 180.0;
+    double lon = longitude * M_PI / 180.0;
+    double cos_lat = cos(lat);
+
+    vector->x = to_q30(cos_lat * cos(lon));
+    vector->y = to_q30(cos_lat * sin(lon));
+    vector->z = to_q30(sin(lat));
+#endif
+}
+
+/**
+ * Compute geometry for a service at runtime
+ *
+ * Radius is the farthest bounding box corner from the center, rounded up.
+ * For boxes up to 180° wide the farthest point always lies on a corner;
+ * wider (near-global) boxes get the maximum possible radius.
+ */
+ntrip_atlas_error_t ntrip_atlas_compute_service_geometry(
+    const ntrip_service_compact_t* service,
+    ntrip_service_geometry_t* geometry
+) {
+    if (!service || !geometry) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    memset(geometry, 0, sizeof(*geometry));
+
+    double lat_center = (service->lat_min_deg100 + service->lat_max_deg100) / 200.0;
+    double lon_center = (service->lon_min_deg100 + service->lon_max_deg100) / 200.0;
+    ntrip_atlas_lat_lon_to_unit_vector(lat_center, lon_center, &geometry->center);
+
+    uint32_t radius_km = MAX_GREAT_CIRCLE_KM;
+    if (service->lon_max_deg100 - service->lon_min_deg100 <= 18000) {
+        double max_km = 0.0;
+        const int16_t lats[2] = { service->lat_min_deg100, service->lat_max_deg100 };
+        const int16_t lons[2] = { service->lon_min_deg100, service->lon_max_deg100 };
+
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 2; j++) {
+                ntrip_unit_vector_t corner;
+                ntrip_atlas_lat_lon_to_unit_vector(lats[i] / 100.0, lons[j] / 100.0, &corner);
+                double km = ntrip_atlas_geometry_distance_to_center(geometry, &corner);
+                if (km > max_km) {
+                    max_km = km;
+                }
+            }
+        }
+
+        radius_km = (uint32_t)ceil(max_km) + 1;  // +1km absorbs fixed-point rounding
+        if (radius_km > MAX_GREAT_CIRCLE_KM) {
+            radius_km = MAX_GREAT_CIRCLE_KM;
+        }
+    }
+
+    geometry->radius_km = (uint16_t)radius_km;
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    ntrip_atlas_fixed_sin_cos((int32_t)(radius_km * NTRIP_ATLAS_MICRODEG_PER_KM),
+                              &geometry->sin_radius_q30, &geometry->cos_radius_q30);
+#else
+    double radius_angle = radius_km / EARTH_RADIUS_KM;
+    geometry->cos_radius_q30 = to_q30(cos(radius_angle));
+    geometry->sin_radius_q30 = to_q30(sin(radius_angle));
+#endif
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Cosine of the angle between two unit vectors in Q60
+ */
+int64_t ntrip_atlas_unit_vector_dot(
+    const ntrip_unit_vector_t* a,
+    const ntrip_unit_vector_t* b
+) {
+    if (!a || !b) {
+        return INT64_MIN;
+    }
+
+    // Each product is at most 2^60, so the sum of three fits in int64
+    return (int64_t)a->x * b->x + (int64_t)a->y * b->y + (int64_t)a->z * b->z;
+}
+
+/**
+ * Great-circle distance from user to service coverage center
+ *
+ * Uses the chord between the two vectors (one sqrt, one asin), which stays
+ * accurate at short range where acos of the dot product would not.
+ */
+double ntrip_atlas_geometry_distance_to_center(
+    const ntrip_service_geometry_t* geometry,
+    const ntrip_unit_vector_t* user
+) {
+    if (!geometry || !user) {
+        return INFINITY;
+    }
+
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    return ntrip_atlas_fixed_vector_distance_m(&geometry->center, user) / 1000.0;
+#else
+    double dx = (double)((int64_t)user->x - geometry->center.x) / Q30_SCALE;
+    double dy = (double)((int64_t)user->y - geometry->center.y) / Q30_SCALE;
+    double dz = (double)((int64_t)user->z - geometry->center.z) / Q30_SCALE;
+
+    double half_chord = sqrt(dx * dx + dy * dy + dz * dz) / 2.0;
+    if (half_chord > 1.0) {
+        half_chord = 1.0;
+    }
+
+    return EARTH_RADIUS_KM * 2.0 * asin(half_chord);
+#endif
+}
+
+/**
+ * Build a distance bound for ntrip_atlas_geometry_may_be_within()
+ */
+ntrip_atlas_error_t ntrip_atlas_make_distance_bound(
+    double distance_km,
+    ntrip_distance_bound_t* bound
+) {
+    if (!bound || distance_km < 0.0 || isnan(distance_km)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    bound->distance_km = distance_km;
+
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    double angle_microdeg = distance_km * NTRIP_ATLAS_MICRODEG_PER_KM;
+    if (angle_microdeg > 180e6) {
+        angle_microdeg = 180e6;
+    }
+    ntrip_atlas_fixed_sin_cos((int32_t)angle_microdeg, &bound->sin_q30, &bound->cos_q30);
+#else
+    double angle = distance_km / EARTH_RADIUS_KM;
+    if (angle > M_PI) {
+        angle = M_PI;
+    }
+
+    bound->cos_q30 = to_q30(cos(angle));
+    bound->sin_q30 = to_q30(sin(angle));
+#endif
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Check if any part of a service's coverage could be within a distance
+ *
+ * The nearest covered point is at least (center distance - radius) away, so
+ * the service can only qualify if center angle <= bound angle + radius angle,
+ * i.e. dot >= cos(b)cos(r) - sin(b)sin(r). All terms are Q60 integers.
+ */
+bool ntrip_atlas_geometry_may_be_within(
+    const ntrip_service_geometry_t* geometry,
+    const ntrip_unit_vector_t* user,
+    const ntrip_distance_bound_t* bound
+) {
+    if (!geometry || !user || !bound) {
+        return true;  // Can't prune without data - let caller check precisely
+    }
+
+    // Combined angle reaches the antipode: every point qualifies
+    if (bound->distance_km + geometry->radius_km >= M_PI * EARTH_RADIUS_KM) {
+        return true;
+    }
+
+    int64_t dot = ntrip_atlas_unit_vector_dot(&geometry->center, user);
+    int64_t threshold = (int64_t)bound->cos_q30 * geometry->cos_radius_q30 -
+                        (int64_t)bound->sin_q30 * geometry->sin_radius_q30;
+
+    return dot >= threshold - GEOMETRY_DOT_SLACK_Q60;
+}
@@ -0,0 +1,294 @@
+/**
+ * NTRIP Atlas - Stream Health Probe
+ *
+ * Connects to a mountpoint the way a rover would and times the stream:
+ * request written, first response byte, first RTCM3 frame that passes
+ * CRC-24Q, and frames per second after that. A 1005/1006 in the stream
+ * corrects the mountpoint's position in the station cache. Runs over the non-blocking
+ * HTTP stream, so probes share event loops with discoveries, and feeds
+ * the outcome into compact failure tracking.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t probe_now_ms(const ntrip_service_probe_t* probe) {
+    return probe->stream.platform->get_time_ms() - probe->stream.started_ms;
+}
+
+/**
+ * Body callback: check frames until the probe time is up
+ */
+static int probe_body(const char* chunk, size_t len, void* context) {
+    ntrip_service_probe_t* probe = (ntrip_service_probe_t*)context;
+
+    probe->stats.bytes += (uint32_t)len;
+    if (ntrip_atlas_rtcm3_feed(&probe->framer, (const uint8_t*)chunk, len) > 0 &&
+        probe->stats.first_frame_ms == NTRIP_ATLAS_PROBE_NOT_REACHED) {
+        probe->stats.first_frame_ms = probe_now_ms(probe);
+    }
+    return probe_now_ms(probe) >= probe->duration_ms;
+}
+
+/**
+ * Encode credentials for Basic authorization
+ */
+static bool base64_encode(const char* input, char* output, size_t output_size) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t len = strlen(input);
+    if ((len + 2) / 3 * 4 + 1 > output_size) {
+        return false;
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t group = (uint32_t)(uint8_t)input[i] << 16;
+        if (i + 1 < len) group |= (uint32_t)(uint8_t)input[i + 1] << 8;
+        if (i + 2 < len) group |= (uint8_t)input[i + 2];
+
+        output[out++] = alphabet[(group >> 18) & 0x3F];
+        output[out++] = alphabet[(group >> 12) & 0x3F];
+        output[out++] = i + 1 < len ? alphabet[(group >> 6) & 0x3F] : '=';
+        output[out++] = i + 2 < len ? alphabet[group & 0x3F] : '=';
+    }
+    output[out] = '\0';
+    return true;
+}
+
+/**
+ * Format the mountpoint request: the shared GET plus credentials and GGA
+ */
+static ntrip_atlas_error_t format_probe_request(char* buffer, size_t size, const ntrip_best_service_t* service) {
+    char path[NTRIP_ATLAS_MAX_MOUNTPOINT + 2];
+    snprintf(path, sizeof(path), "/%s", service->mountpoint);
+
+    int length = ntrip_atlas_http_format_request(buffer, size, service->server, service->port, path);
+    if (length < 0) {
+        return (ntrip_atlas_error_t)length;
+    }
+    // Reopen the header block before its closing blank line
+    size_t pos = (size_t)length - 2;
+    buffer[pos] = '\0';
+
+    if (service->username[0] != '\0') {
+        char credentials[NTRIP_ATLAS_MAX_USERNAME + NTRIP_ATLAS_MAX_PASSWORD + 2];
+        char encoded[(sizeof(credentials) + 2) / 3 * 4 + 1];
+        snprintf(credentials, sizeof(credentials), "%s:%s", service->username, service->password);
+        if (!base64_encode(credentials, encoded, sizeof(encoded))) {
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
+        length = snprintf(buffer + pos, size - pos, "Authorization: Basic %s\r\n", encoded);
+        if (length < 0 || (size_t)length >= size - pos) {
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
+        pos += (size_t)length;
+    }
+
+    char gga[128] = "";
+    if (service->nmea_required &&
+        ntrip_atlas_format_gga(gga, sizeof(gga), service->mountpoint_latitude,
+                               service->mountpoint_longitude, 0.0, 1, 10) < 0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    // NTRIP 2.0 casters read the Ntrip-GGA header; 1.0 casters read the
+    // sentence as the first upstream data after the request
+    if (gga[0] != '\0') {
+        length = snprintf(buffer + pos, size - pos, "Ntrip-GGA: %.*s\r\n\r\n%s",
+                          (int)(strlen(gga) - 2), gga, gga);
+    } else {
+        length = snprintf(buffer + pos, size - pos, "\r\n");
+    }
+    if (length < 0 || (size_t)length >= size - pos) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Feed an outcome that says something about the service into failure tracking
+ */
+static void record_outcome(const ntrip_service_config_t* service, ntrip_atlas_error_t status) {
+    if (!service) {
+        return;
+    }
+    ntrip_service_idx_t index = ntrip_atlas_get_service_index(service->provider);
+    if (index == NTRIP_SERVICE_INDEX_INVALID) {
+        return;
+    }
+
+    switch (status) {
+        case NTRIP_ATLAS_SUCCESS:
+            ntrip_atlas_record_compact_success(index);
+            break;
+        case NTRIP_ATLAS_ERROR_NO_NETWORK:
+        case NTRIP_ATLAS_ERROR_TIMEOUT:
+        case NTRIP_ATLAS_ERROR_NOT_FOUND:
+        case NTRIP_ATLAS_ERROR_INVALID_RESPONSE:
+            ntrip_atlas_record_compact_failure(index);
+            break;
+        default:
+            // Bad credentials or a local problem, not the caster's fault
+            break;
+    }
+}
+
+/**
+ * RTCM 3 mountpoints must show valid frames; others just data
+ */
+static bool expects_rtcm3(const char* format) {
+    return format[0] == '\0' || strstr(format, "RTCM 3") || strstr(format, "RTCM3");
+}
+
+/**
+ * Start probing a mountpoint without blocking
+ */
+ntrip_atlas_error_t ntrip_atlas_probe_begin(
+    ntrip_service_probe_t* probe,
+    const ntrip_platform_t* platform,
+    const ntrip_best_service_t* service,
+    uint32_t duration_ms
+) {
+    if (!probe || !platform || !service || service->server[0] == '\0') {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (!platform->get_time_ms) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    memset(probe, 0, sizeof(*probe));
+    probe->service = service->service_info;
+    snprintf(probe->host, sizeof(probe->host), "%s", service->server);
+    snprintf(probe->mountpoint, sizeof(probe->mountpoint), "%s", service->mountpoint);
+    probe->duration_ms = duration_ms ? duration_ms : NTRIP_ATLAS_PROBE_DURATION_MS;
+    probe->stats.first_frame_ms = NTRIP_ATLAS_PROBE_NOT_REACHED;
+    ntrip_atlas_rtcm3_init(&probe->framer);
+    probe->expect_rtcm3 = expects_rtcm3(service->format);
+
+    ntrip_atlas_error_t ret = format_probe_request(probe->request, sizeof(probe->request), service);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+
+    // The stream timeout bounds silent casters; on_data ends talkative ones
+    return ntrip_atlas_http_stream_begin_request(&probe->stream, platform,
+                                                 service->server, service->port, service->ssl,
+                                                 probe->request, probe_body, probe,
+                                                 probe->duration_ms);
+}
+
+/**
+ * Make as much progress as possible without waiting
+ */
+ntrip_atlas_error_t ntrip_atlas_probe_step(ntrip_service_probe_t* probe) {
+    if (!probe) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    return ntrip_atlas_http_stream_step(&probe->stream);
+}
+
+/**
+ * Descriptor and direction to wait on before the next step
+ */
+int ntrip_atlas_probe_poll_fd(const ntrip_service_probe_t* probe, bool* want_write) {
+    return ntrip_atlas_http_stream_poll_fd(probe ? &probe->stream : NULL, want_write);
+}
+
+/**
+ * Close the connection, fill in the stats and record the outcome
+ */
+ntrip_atlas_error_t ntrip_atlas_probe_end(
+    ntrip_service_probe_t* probe,
+    ntrip_probe_stats_t* stats
+) {
+    if (!probe || probe->stream.state == NTRIP_NB_STREAM_IDLE) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    ntrip_http_stream_t* stream = &probe->stream;
+    ntrip_probe_stats_t* result = &probe->stats;
+    bool finished = stream->state == NTRIP_NB_STREAM_DONE;
+
+    // The stream cannot outlast the probe time, only the last step can
+    result->elapsed_ms = probe_now_ms(probe);
+    if (result->elapsed_ms > probe->duration_ms) {
+        result->elapsed_ms = probe->duration_ms;
+    }
+    ntrip_atlas_error_t status = ntrip_atlas_http_stream_end(stream);
+
+    result->connect_ms = stream->request_sent >= stream->request_len ?
+                         stream->sent_ms : NTRIP_ATLAS_PROBE_NOT_REACHED;
+    result->first_byte_ms = stream->bytes_received > 0 ?
+                            stream->first_byte_ms : NTRIP_ATLAS_PROBE_NOT_REACHED;
+    result->frames = probe->framer.frames;
+    result->crc_errors = probe->framer.crc_errors;
+    if (result->frames > 0 && result->elapsed_ms > result->first_frame_ms) {
+        result->message_rate = result->frames * 1000.0 / (result->elapsed_ms - result->first_frame_ms);
+    }
+    result->station_position = probe->framer.has_station &&
+        ntrip_atlas_station_position_record(probe->host, probe->mountpoint,
+                                            &probe->framer.station) == NTRIP_ATLAS_SUCCESS;
+
+    // Running out of probe time is how a healthy stream ends
+    bool healthy = probe->expect_rtcm3 ? result->frames > 0 : result->bytes > 0;
+    if (healthy && (status == NTRIP_ATLAS_SUCCESS || status == NTRIP_ATLAS_ERROR_TIMEOUT)) {
+        status = NTRIP_ATLAS_SUCCESS;
+    } else if (status == NTRIP_ATLAS_SUCCESS) {
+        // Caster closed without usable data, or the caller cancelled first
+        status = finished ? NTRIP_ATLAS_ERROR_INVALID_RESPONSE : NTRIP_ATLAS_ERROR_TIMEOUT;
+    }
+    result->status = status;
+
+    // A cancelled probe says nothing about the caster
+    if (finished || healthy) {
+        record_outcome(probe->service, status);
+    }
+
+    if (stats) {
+        *stats = *result;
+    }
+    return status;
+}
+
+/**
+ * Probe a service's mountpoint and wait for the result
+ */
+ntrip_atlas_error_t ntrip_atlas_test_service(
+    const ntrip_platform_t* platform,
+    const ntrip_best_service_t* service,
+    uint32_t duration_ms,
+    ntrip_probe_stats_t* stats
+) {
+    ntrip_service_probe_t probe;
+    ntrip_atlas_error_t ret = ntrip_atlas_probe_begin(&probe, platform, service, duration_ms);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        if (ret == NTRIP_ATLAS_ERROR_NO_NETWORK) {
+            record_outcome(service->service_info, ret);
+        }
+        if (stats) {
+            memset(stats, 0, sizeof(*stats));
+            stats->status = ret;
+            stats->connect_ms = NTRIP_ATLAS_PROBE_NOT_REACHED;
+            stats->first_byte_ms = NTRIP_ATLAS_PROBE_NOT_REACHED;
+            stats->first_frame_ms = NTRIP_ATLAS_PROBE_NOT_REACHED;
+        }
+        return ret;
+    }
+
+    const ntrip_nb_transport_t* transport = platform->nb_transport;
+    while (ntrip_atlas_probe_step(&probe) == NTRIP_ATLAS_ERROR_WOULD_BLOCK) {
+        if (transport->wait && !probe.stream.step_again && probe.stream.connection) {
+            bool want_write = false;
+            ntrip_atlas_probe_poll_fd(&probe, &want_write);
+
+            // One past the deadline so the next step sees the timeout
+            uint32_t elapsed = probe_now_ms(&probe);
+            uint32_t wait_ms = elapsed < probe.duration_ms ? probe.duration_ms - elapsed + 1 : 1;
+            transport->wait(probe.stream.connection, want_write, wait_ms);
+        }
+    }
+    return ntrip_atlas_probe_end(&probe, stats);
+}
@@ -0,0 +1,263 @@
+/**
+ * NTRIP Atlas - Movement-Aware Service Tracking
+ *
+ * Incremental reselection for a moving rover. The finest spatial tile and
+ * its candidate run are cached from the last lookup, so positions inside
+ * that tile never touch the index; while the current service still covers
+ * the rover and has not drifted past the reselect distance, an update is a
+ * box check and one distance. Switching needs a margin sustained over
+ * several evaluations, so a rover parked on a coverage boundary does not
+ * bounce between casters.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <string.h>
+
+/**
+ * Default tracker tuning
+ */
+ntrip_tracker_config_t ntrip_atlas_get_default_tracker_config(void) {
+    ntrip_tracker_config_t config = {
+        .reselect_distance_km = 5.0,
+        .switch_margin = 10.0,
+        .confirm_evaluations = 2
+    };
+    return config;
+}
+
+/**
+ * Start tracking over a service table already loaded into the spatial index
+ */
+ntrip_atlas_error_t ntrip_atlas_tracker_init(
+    ntrip_service_tracker_t* tracker,
+    const ntrip_service_compact_t* services,
+    size_t service_count,
+    const ntrip_tracker_config_t* config
+) {
+    if (!tracker || !services || service_count == 0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (config && (config->reselect_distance_km < 0.0 || config->switch_margin < 0.0)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->services = services;
+    tracker->service_count = service_count;
+    tracker->config = config ? *config : ntrip_atlas_get_default_tracker_config();
+    if (tracker->config.confirm_evaluations == 0) {
+        tracker->config.confirm_evaluations = 1;
+    }
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Drop cached tile and selection
+ */
+void ntrip_atlas_tracker_reset(ntrip_service_tracker_t* tracker) {
+    if (!tracker) {
+        return;
+    }
+
+    tracker->tile_valid = false;
+    tracker->candidate_count = 0;
+    tracker->has_current = false;
+    tracker->challenger_wins = 0;
+}
+
+/**
+ * Check if a position lies in the cached finest tile
+ *
+ * Half-open like ntrip_atlas_lat_lon_to_tile(), so a rover on a tile edge
+ * belongs to exactly one tile.
+ */
+static bool in_cached_tile(const ntrip_service_tracker_t* tracker, double lat, double lon) {
+    return tracker->tile_valid &&
+           lat >= tracker->tile_lat_min && lat < tracker->tile_lat_max &&
+           lon >= tracker->tile_lon_min && lon < tracker->tile_lon_max;
+}
+
+/**
+ * Look up the candidates for a new tile and cache them with its bounds
+ */
+static void refresh_tile(ntrip_service_tracker_t* tracker, double lat, double lon) {
+    tracker->tile_valid = false;
+    tracker->candidate_count = 0;
+
+    uint16_t tile_lat, tile_lon;
+    if (ntrip_atlas_lat_lon_to_tile(lat, lon, NTRIP_SPATIAL_FINEST_LEVEL, &tile_lat, &tile_lon) != NTRIP_ATLAS_SUCCESS ||
+        ntrip_atlas_tile_to_lat_lon_bounds(NTRIP_SPATIAL_FINEST_LEVEL, tile_lat, tile_lon,
+                                           &tracker->tile_lat_min, &tracker->tile_lat_max,
+                                           &tracker->tile_lon_min, &tracker->tile_lon_max) != NTRIP_ATLAS_SUCCESS) {
+        return;
+    }
+
+    // Every point of a finest tile resolves to the same (possibly coarser) answer
+    const ntrip_service_idx_t* services;
+    size_t count = ntrip_atlas_find_tile_services(lat, lon, NULL, &services);
+    for (size_t i = 0; i < count && tracker->candidate_count < NTRIP_ATLAS_TRACKER_MAX_CANDIDATES; i++) {
+        if (services[i] < tracker->service_count) {
+            tracker->candidates[tracker->candidate_count++] = services[i];
+        }
+    }
+
+    tracker->tile_valid = true;
+    tracker->stats.tile_lookups++;
+}
+
+/**
+ * Make a service current
+ */
+static void select_service(
+    ntrip_service_tracker_t* tracker,
+    ntrip_service_idx_t service_index,
+    double lat,
+    double lon
+) {
+    tracker->current = service_index;
+    tracker->has_current = true;
+    tracker->challenger_wins = 0;
+    tracker->anchor_distance_km = ntrip_atlas_calculate_distance_to_service_center(
+        &tracker->services[service_index], lat, lon);
+}
+
+/**
+ * Re-score the cached candidates and apply hysteresis
+ */
+static ntrip_tracker_event_t evaluate(ntrip_service_tracker_t* tracker, double lat, double lon) {
+    tracker->stats.evaluations++;
+
+    bool found = false;
+    ntrip_service_idx_t best = 0;
+    double best_score = 0.0;
+
+    for (uint8_t i = 0; i < tracker->candidate_count; i++) {
+        const ntrip_service_compact_t* service = &tracker->services[tracker->candidates[i]];
+        if (!ntrip_atlas_is_location_within_service_coverage(service, lat, lon)) {
+            continue;
+        }
+
+        double score = ntrip_atlas_score_service_spatial_geographic(service, lat, lon);
+        if (!found || score > best_score) {
+            found = true;
+            best = tracker->candidates[i];
+            best_score = score;
+        }
+    }
+
+    if (!found) {
+        if (!tracker->has_current) {
+            return NTRIP_TRACKER_UNCHANGED;
+        }
+        tracker->has_current = false;
+        tracker->challenger_wins = 0;
+        return NTRIP_TRACKER_LOST;
+    }
+
+    if (!tracker->has_current) {
+        select_service(tracker, best, lat, lon);
+        return NTRIP_TRACKER_SELECTED;
+    }
+
+    const ntrip_service_compact_t* current = &tracker->services[tracker->current];
+
+    // Losing coverage forces the switch; no point waiting for confirmation
+    if (!ntrip_atlas_is_location_within_service_coverage(current, lat, lon)) {
+        select_service(tracker, best, lat, lon);
+        tracker->stats.switches++;
+        return NTRIP_TRACKER_SWITCHED;
+    }
+
+    tracker->anchor_distance_km = ntrip_atlas_calculate_distance_to_service_center(current, lat, lon);
+
+    double current_score = ntrip_atlas_score_service_spatial_geographic(current, lat, lon);
+    if (best == tracker->current || best_score <= current_score + tracker->config.switch_margin) {
+        tracker->challenger_wins = 0;
+        return NTRIP_TRACKER_UNCHANGED;
+    }
+
+    if (tracker->challenger_wins == 0 || tracker->challenger != best) {
+        tracker->challenger = best;
+        tracker->challenger_wins = 0;
+    }
+    if (++tracker->challenger_wins < tracker->config.confirm_evaluations) {
+        return NTRIP_TRACKER_UNCHANGED;
+    }
+
+    select_service(tracker, best, lat, lon);
+    tracker->stats.switches++;
+    return NTRIP_TRACKER_SWITCHED;
+}
+
+/**
+ * Feed the next rover position
+ */
+ntrip_atlas_error_t ntrip_atlas_tracker_update(
+    ntrip_service_tracker_t* tracker,
+    double user_lat,
+    double user_lon,
+    ntrip_tracker_event_t* event
+) {
+    if (!tracker || !tracker->services) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (user_lat < -90.0 || user_lat > 90.0 || user_lon < -180.0 || user_lon > 180.0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    tracker->stats.updates++;
+    ntrip_tracker_event_t result = NTRIP_TRACKER_UNCHANGED;
+
+    if (!in_cached_tile(tracker, user_lat, user_lon)) {
+        refresh_tile(tracker, user_lat, user_lon);
+        result = evaluate(tracker, user_lat, user_lon);
+    } else if (!tracker->has_current) {
+        // Coverage boxes are finer than tiles, so a candidate may start covering us
+        if (tracker->candidate_count > 0) {
+            result = evaluate(tracker, user_lat, user_lon);
+        }
+    } else {
+        const ntrip_service_compact_t* current = &tracker->services[tracker->current];
+        bool covered = ntrip_atlas_is_location_within_service_coverage(current, user_lat, user_lon);
+        bool drifted = false;
+        if (covered) {
+            // Measure growth from the closest approach, not from the last re-score
+            double distance = ntrip_atlas_calculate_distance_to_service_center(current, user_lat, user_lon);
+            if (distance < tracker->anchor_distance_km) {
+                tracker->anchor_distance_km = distance;
+            }
+            drifted = distance > tracker->anchor_distance_km + tracker->config.reselect_distance_km;
+        }
+
+        // A pending challenger is re-checked every update until it confirms or fades
+        if (!covered || drifted || tracker->challenger_wins > 0) {
+            result = evaluate(tracker, user_lat, user_lon);
+        }
+    }
+
+    if (event) {
+        *event = result;
+    }
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Currently selected service
+ */
+ntrip_atlas_error_t ntrip_atlas_tracker_get_current(
+    const ntrip_service_tracker_t* tracker,
+    ntrip_service_idx_t* service_index
+) {
+    if (!tracker || !service_index) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (!tracker->has_current) {
+        return NTRIP_ATLAS_ERROR_NO_SERVICES;
+    }
+
+    *service_index = tracker->current;
+    return NTRIP_ATLAS_SUCCESS;
+}
@@ -34,7 +34,7 @@ size_t ntrip_atlas_find_services_spatial_geographic(
     double user_lon,
     const ntrip_service_compact_t* services,
     size_t service_count,
-    uint8_t* found_services,
+    ntrip_service_idx_t* found_services,
     size_t max_services
 ) {
     if (!found_services || !services || service_count == 0) {
@@ -42,7 +42,7 @@ size_t ntrip_atlas_find_services_spatial_geographic(
     }
 
     // Step 1: Get candidate services from spatial indexing (O(1) fast lookup)
-    uint8_t spatial_candidates[16];  // Reasonable buffer for tile services
+    ntrip_service_idx_t spatial_candidates[16];  // Reasonable buffer for tile services
     size_t spatial_count = ntrip_atlas_find_services_by_location_fast(
         user_lat, user_lon, spatial_candidates, 16
     );
@@ -55,7 +55,7 @@ size_t ntrip_atlas_find_services_spatial_geographic(
     size_t verified_count = 0;
 
     for (size_t i = 0; i < spatial_count && verified_count < max_services; i++) {
-        uint8_t service_idx = spatial_candidates[i];
+        ntrip_service_idx_t service_idx = spatial_candidates[i];
 
         // Validate service index is within bounds
         if (service_idx >= service_count) {
@@ -75,6 +75,26 @@ size_t ntrip_atlas_find_services_spatial_geographic(
     return verified_count;
 }
 
+/**
+ * Score a service for a location (higher is better)
+ */
+double ntrip_atlas_score_service_spatial_geographic(
+    const ntrip_service_compact_t* service,
+    double user_lat,
+    double user_lon
+) {
+    // Calculate distance to service center
+    double distance = ntrip_atlas_calculate_distance_to_service_center(
+        service, user_lat, user_lon
+    );
+
+    // Calculate composite score (higher is better)
+    // Quality rating: 1-5, Distance penalty: 0-100km normalized
+    double quality_score = service->quality_rating * 20.0;  // Max 100 points
+    double distance_penalty = (distance > 100.0) ? 100.0 : distance;  // Cap at 100km
+    return quality_score - distance_penalty;
+}
+
 /**
  * Find best service using spatial-geographic lookup
  *
@@ -99,7 +119,7 @@ ntrip_atlas_error_t ntrip_atlas_find_best_service_spatial_geographic(
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
 
-    uint8_t found_services[8];
+    ntrip_service_idx_t found_services[8];
     size_t found_count = ntrip_atlas_find_services_spatial_geographic(
         user_lat, user_lon, services, service_count, found_services, 8
     );
@@ -110,23 +130,14 @@ ntrip_atlas_error_t ntrip_atlas_find_best_service_spatial_geographic(
 
     // Find best service based on quality rating and distance
     double best_score = -1.0;
-    uint8_t best_index = 0;
+    ntrip_service_idx_t best_index = 0;
 
     for (size_t i = 0; i < found_count; i++) {
-        uint8_t service_idx = found_services[i];
-        const ntrip_service_compact_t* service = &services[service_idx];
-
-        // Calculate distance to service center
-        double distance = ntrip_atlas_calculate_distance_to_service_center(
-            service, user_lat, user_lon
+        ntrip_service_idx_t service_idx = found_services[i];
+        double score = ntrip_atlas_score_service_spatial_geographic(
+            &services[service_idx], user_lat, user_lon
         );
 
-        // Calculate composite score (higher is better)
-        // Quality rating: 1-5, Distance penalty: 0-100km normalized
-        double quality_score = service->quality_rating * 20.0;  // Max 100 points
-        double distance_penalty = (distance > 100.0) ? 100.0 : distance;  // Cap at 100km
-        double score = quality_score - distance_penalty;
-
         if (i == 0 || score > best_score) {
             best_score = score;
             best_index = service_idx;
@@ -165,7 +176,7 @@ ntrip_atlas_error_t ntrip_atlas_get_spatial_geographic_stats(
     }
 
     // Get spatial indexing candidates
-    uint8_t candidates[16];
+    ntrip_service_idx_t candidates[16];
     *spatial_candidates = ntrip_atlas_find_services_by_location_fast(
         user_lat, user_lon, candidates, 16
     );
@@ -173,7 +184,7 @@ ntrip_atlas_error_t ntrip_atlas_get_spatial_geographic_stats(
     // Count how many have verified coverage
     *verified_services = 0;
     for (size_t i = 0; i < *spatial_candidates; i++) {
-        uint8_t service_idx = candidates[i];
+        ntrip_service_idx_t service_idx = candidates[i];
 
         if (service_idx < service_count) {
             bool within_coverage = ntrip_atlas_is_location_within_service_coverage(
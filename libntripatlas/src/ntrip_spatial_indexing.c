@@ -17,7 +17,6 @@
 #include <math.h>
 
 // Spatial indexing constants
-#define SPATIAL_INDEX_MAX_TILES 4096   // Regional services only (31 services) - globals handled separately
 #define SPATIAL_INDEX_MAX_SERVICES_PER_TILE 64  // Regional services only - globals handled separately
 #define SPATIAL_INDEX_MAX_LEVELS 5
 
@@ -29,23 +28,30 @@
 #define TILE_LON_MASK       0x1FFF  // 13 bits = 8192 max tiles
 #define TILE_LEVEL_MASK     0x07    // 3 bits = 8 max levels
 
-// Tile entry contains service indices for geographic area
-typedef struct {
-    ntrip_tile_key_t key;
-    uint8_t service_count;
-    uint8_t service_indices[SPATIAL_INDEX_MAX_SERVICES_PER_TILE];
-} ntrip_tile_t;
-
 // Global spatial index (pre-computed at build time)
+// Tiles are sorted by key; each owns a contiguous run of the assignment pool.
 typedef struct {
-    ntrip_tile_t tiles[SPATIAL_INDEX_MAX_TILES];
-    uint16_t tile_count;
+    ntrip_spatial_tile_t* tiles;
+    ntrip_service_idx_t* assignments;
+    size_t max_tiles;
+    size_t max_assignments;
+    size_t storage_size;
+    uint32_t tile_count;
+    uint32_t assignment_count;
     bool initialized;
 } ntrip_spatial_index_t;
 
 // Global spatial index instance
 static ntrip_spatial_index_t g_spatial_index = {0};
 
+// Bumped on every change; kept outside the index so re-init still moves it
+static uint32_t g_spatial_index_generation = 0;
+
+// Built-in storage for ntrip_atlas_init_spatial_index()
+static uint32_t g_spatial_storage[
+    (NTRIP_SPATIAL_INDEX_STORAGE_SIZE(NTRIP_ATLAS_SPATIAL_MAX_TILES, NTRIP_ATLAS_SPATIAL_MAX_ASSIGNMENTS) +
+     sizeof(uint32_t) - 1) / sizeof(uint32_t)];
+
 /**
  * Encode tile coordinates into 32-bit key
  *
@@ -184,28 +190,63 @@ ntrip_atlas_error_t ntrip_atlas_tile_to_lat_lon_bounds(
 }
 
 /**
- * Initialize spatial index system
+ * Initialize spatial index system over caller-provided storage
  */
-ntrip_atlas_error_t ntrip_atlas_init_spatial_index(void) {
+ntrip_atlas_error_t ntrip_atlas_init_spatial_index_with_storage(
+    void* storage,
+    size_t storage_size,
+    size_t max_tiles,
+    size_t max_assignments
+) {
+    if (!storage || max_tiles == 0 || max_tiles > UINT32_MAX || max_assignments > UINT32_MAX ||
+        ((uintptr_t)storage % sizeof(uint32_t)) != 0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (storage_size < NTRIP_SPATIAL_INDEX_STORAGE_SIZE(max_tiles, max_assignments)) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+
     memset(&g_spatial_index, 0, sizeof(g_spatial_index));
+    g_spatial_index.tiles = (ntrip_spatial_tile_t*)storage;
+    g_spatial_index.assignments = (ntrip_service_idx_t*)(g_spatial_index.tiles + max_tiles);
+    g_spatial_index.max_tiles = max_tiles;
+    g_spatial_index.max_assignments = max_assignments;
+    g_spatial_index.storage_size = NTRIP_SPATIAL_INDEX_STORAGE_SIZE(max_tiles, max_assignments);
     g_spatial_index.initialized = true;
+    g_spatial_index_generation++;
 
     return NTRIP_ATLAS_SUCCESS;
 }
 
+/**
+ * Initialize spatial index system (built-in storage)
+ */
+ntrip_atlas_error_t ntrip_atlas_init_spatial_index(void) {
+    return ntrip_atlas_init_spatial_index_with_storage(
+        g_spatial_storage, sizeof(g_spatial_storage),
+        NTRIP_ATLAS_SPATIAL_MAX_TILES, NTRIP_ATLAS_SPATIAL_MAX_ASSIGNMENTS);
+}
+
+/**
+ * Spatial index generation
+ */
+uint32_t ntrip_atlas_get_spatial_index_generation(void) {
+    return g_spatial_index_generation;
+}
+
 /**
  * Binary search for tile by key
  */
-static ntrip_tile_t* find_tile_by_key(ntrip_tile_key_t key) {
+static ntrip_spatial_tile_t* find_tile_by_key(ntrip_tile_key_t key) {
     if (!g_spatial_index.initialized || g_spatial_index.tile_count == 0) {
         return NULL;
     }
 
-    int left = 0;
-    int right = g_spatial_index.tile_count - 1;
+    int32_t left = 0;
+    int32_t right = (int32_t)g_spatial_index.tile_count - 1;
 
     while (left <= right) {
-        int mid = left + (right - left) / 2;
+        int32_t mid = left + (right - left) / 2;
 
         if (g_spatial_index.tiles[mid].key == key) {
             return &g_spatial_index.tiles[mid];
@@ -224,23 +265,23 @@ static ntrip_tile_t* find_tile_by_key(ntrip_tile_key_t key) {
  */
 ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(
     ntrip_tile_key_t tile_key,
-    uint8_t service_index
+    ntrip_service_idx_t service_index
 ) {
     if (!g_spatial_index.initialized) {
         return NTRIP_ATLAS_ERROR_PLATFORM; // Not initialized
     }
 
     // Find existing tile or create new one
-    ntrip_tile_t* tile = find_tile_by_key(tile_key);
+    ntrip_spatial_tile_t* tile = find_tile_by_key(tile_key);
 
     if (!tile) {
         // Create new tile
-        if (g_spatial_index.tile_count >= SPATIAL_INDEX_MAX_TILES) {
+        if (g_spatial_index.tile_count >= g_spatial_index.max_tiles) {
             return NTRIP_ATLAS_ERROR_SPATIAL_INDEX_FULL; // No space for more tiles
         }
 
         // Find insertion point to maintain sorted order
-        int insert_pos = 0;
+        uint32_t insert_pos = 0;
         while (insert_pos < g_spatial_index.tile_count &&
                g_spatial_index.tiles[insert_pos].key < tile_key) {
             insert_pos++;
@@ -249,51 +290,67 @@ ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(
         // Shift tiles to make room
         memmove(&g_spatial_index.tiles[insert_pos + 1],
                 &g_spatial_index.tiles[insert_pos],
-                (g_spatial_index.tile_count - insert_pos) * sizeof(ntrip_tile_t));
+                (g_spatial_index.tile_count - insert_pos) * sizeof(ntrip_spatial_tile_t));
 
-        // Initialize new tile
+        // New tile starts where its successor's run begins
         tile = &g_spatial_index.tiles[insert_pos];
         tile->key = tile_key;
+        tile->first = insert_pos < g_spatial_index.tile_count ?
+                      g_spatial_index.tiles[insert_pos + 1].first : g_spatial_index.assignment_count;
         tile->service_count = 0;
-        memset(tile->service_indices, 0, sizeof(tile->service_indices));
+        tile->reserved = 0;
 
         g_spatial_index.tile_count++;
     }
 
     // Add service to tile if not already present
-    for (uint8_t i = 0; i < tile->service_count; i++) {
-        if (tile->service_indices[i] == service_index) {
+    const ntrip_service_idx_t* services = &g_spatial_index.assignments[tile->first];
+    for (uint16_t i = 0; i < tile->service_count; i++) {
+        if (services[i] == service_index) {
             return NTRIP_ATLAS_SUCCESS; // Service already in tile
         }
     }
 
-    // Add service if there's space
-    if (tile->service_count < SPATIAL_INDEX_MAX_SERVICES_PER_TILE) {
-        tile->service_indices[tile->service_count] = service_index;
-        tile->service_count++;
-        return NTRIP_ATLAS_SUCCESS;
+    if (tile->service_count >= SPATIAL_INDEX_MAX_SERVICES_PER_TILE) {
+        return NTRIP_ATLAS_ERROR_TILE_FULL; // Tile full
+    }
+    if (g_spatial_index.assignment_count >= g_spatial_index.max_assignments) {
+        return NTRIP_ATLAS_ERROR_SPATIAL_INDEX_FULL; // Assignment pool full
     }
 
-    return NTRIP_ATLAS_ERROR_TILE_FULL; // Tile full
+    // Open a gap at the end of this tile's run and shift later runs up
+    uint32_t end = tile->first + tile->service_count;
+    memmove(&g_spatial_index.assignments[end + 1],
+            &g_spatial_index.assignments[end],
+            (g_spatial_index.assignment_count - end) * sizeof(ntrip_service_idx_t));
+    g_spatial_index.assignments[end] = service_index;
+    tile->service_count++;
+    g_spatial_index.assignment_count++;
+    g_spatial_index_generation++;
+
+    for (ntrip_spatial_tile_t* later = tile + 1;
+         later < g_spatial_index.tiles + g_spatial_index.tile_count; later++) {
+        later->first++;
+    }
+
+    return NTRIP_ATLAS_SUCCESS;
 }
 
 /**
- * Find services covering user location using spatial index
- *
- * O(1) lookup replacing O(n) linear scan
+ * Find the tile answering a location and borrow its candidate run
  */
-size_t ntrip_atlas_find_services_by_location_fast(
+size_t ntrip_atlas_find_tile_services(
     double user_lat,
     double user_lon,
-    uint8_t* service_indices,
-    size_t max_services
+    ntrip_tile_key_t* tile_key,
+    const ntrip_service_idx_t** services
 ) {
-    if (!service_indices || !g_spatial_index.initialized) {
+    if (!services || !g_spatial_index.initialized) {
         return 0;
     }
 
     // Start with finest resolution and work up until we find services
-    for (int level = 4; level >= 0; level--) {
+    for (int level = NTRIP_SPATIAL_FINEST_LEVEL; level >= 0; level--) {
         uint16_t tile_lat, tile_lon;
 
         ntrip_atlas_error_t result = ntrip_atlas_lat_lon_to_tile(
@@ -307,22 +364,45 @@ size_t ntrip_atlas_find_services_by_location_fast(
         ntrip_tile_key_t key = ntrip_atlas_encode_tile_key(level, tile_lat, tile_lon);
 
         // Binary search for tile (O(log k) where k = number of tiles)
-        ntrip_tile_t* tile = find_tile_by_key(key);
+        ntrip_spatial_tile_t* tile = find_tile_by_key(key);
 
         if (tile && tile->service_count > 0) {
-            size_t count = tile->service_count;
-            if (count > max_services) {
-                count = max_services;
+            if (tile_key) {
+                *tile_key = key;
             }
-
-            memcpy(service_indices, tile->service_indices, count * sizeof(uint8_t));
-            return count;
+            *services = &g_spatial_index.assignments[tile->first];
+            return tile->service_count;
         }
     }
 
     return 0; // No services found
 }
 
+/**
+ * Find services covering user location using spatial index
+ *
+ * O(1) lookup replacing O(n) linear scan
+ */
+size_t ntrip_atlas_find_services_by_location_fast(
+    double user_lat,
+    double user_lon,
+    ntrip_service_idx_t* service_indices,
+    size_t max_services
+) {
+    if (!service_indices) {
+        return 0;
+    }
+
+    const ntrip_service_idx_t* services;
+    size_t count = ntrip_atlas_find_tile_services(user_lat, user_lon, NULL, &services);
+    if (count > max_services) {
+        count = max_services;
+    }
+
+    memcpy(service_indices, services, count * sizeof(ntrip_service_idx_t));
+    return count;
+}
+
 /**
  * Get spatial index statistics
  */
@@ -339,12 +419,12 @@ ntrip_atlas_error_t ntrip_atlas_get_spatial_index_stats(
         return NTRIP_ATLAS_ERROR_PLATFORM;
     }
 
-    stats->total_tiles = g_spatial_index.tile_count;
-    stats->memory_used_bytes = sizeof(g_spatial_index);
+    stats->total_tiles = (uint16_t)g_spatial_index.tile_count;
+    stats->memory_used_bytes = g_spatial_index.storage_size;
 
     // Count services and analyze distribution
-    for (uint16_t i = 0; i < g_spatial_index.tile_count; i++) {
-        const ntrip_tile_t* tile = &g_spatial_index.tiles[i];
+    for (uint32_t i = 0; i < g_spatial_index.tile_count; i++) {
+        const ntrip_spatial_tile_t* tile = &g_spatial_index.tiles[i];
 
         stats->total_service_assignments += tile->service_count;
 
@@ -392,18 +472,18 @@ void ntrip_atlas_print_spatial_index_debug(void) {
     printf("  Max services per tile: %d\n", stats.max_services_per_tile);
 
     printf("\n🔍 Tile Details:\n");
-    for (uint16_t i = 0; i < g_spatial_index.tile_count && i < 10; i++) {
-        const ntrip_tile_t* tile = &g_spatial_index.tiles[i];
+    for (uint32_t i = 0; i < g_spatial_index.tile_count && i < 10; i++) {
+        const ntrip_spatial_tile_t* tile = &g_spatial_index.tiles[i];
 
         uint8_t level;
         uint16_t lat_tile, lon_tile;
         ntrip_atlas_decode_tile_key(tile->key, &level, &lat_tile, &lon_tile);
 
-        printf("  Tile %d: L%d [%d,%d] = 0x%08X (%d services)\n",
-               i, level, lat_tile, lon_tile, tile->key, tile->service_count);
+        printf("  Tile %u: L%d [%d,%d] = 0x%08X (%d services)\n",
+               (unsigned)i, level, lat_tile, lon_tile, tile->key, tile->service_count);
     }
 
     if (g_spatial_index.tile_count > 10) {
-        printf("  ... and %d more tiles\n", g_spatial_index.tile_count - 10);
+        printf("  ... and %u more tiles\n", (unsigned)(g_spatial_index.tile_count - 10));
     }
 }
\ No newline at end of file
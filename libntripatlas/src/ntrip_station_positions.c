@@ -0,0 +1,141 @@
+/**
+ * NTRIP Atlas - Station Position Cache
+ *
+ * Sourcetable STR lines carry the station position rounded to a couple
+ * of decimals, sometimes the network's centre, sometimes nothing useful
+ * at all. At 1 ppm RTK error per kilometre of baseline that is worth
+ * correcting: reference stations broadcast their antenna reference point
+ * in RTCM 1005/1006, which the frame scanner decodes. Positions seen that
+ * way are kept here per caster host and mountpoint, converted to WGS84
+ * latitude/longitude, and the sourcetable ranker scores distances from
+ * them in place of the STR line's values.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <math.h>
+#include <string.h>
+
+// Broadcast positions further than this from the Earth's centre are junk
+#define STATION_MIN_RADIUS_M 6300000.0
+#define STATION_MAX_RADIUS_M 6400000.0
+
+typedef struct {
+    uint32_t host_hash;
+    char mountpoint[NTRIP_ATLAS_MAX_MOUNTPOINT];
+    double latitude;
+    double longitude;
+    uint32_t last_used;
+    bool valid;
+} station_position_entry_t;
+
+// Global station position cache
+static struct {
+    station_position_entry_t entries[NTRIP_ATLAS_STATION_CACHE_ENTRIES];
+    uint32_t clock;
+} g_station_positions = {0};
+
+/**
+ * FNV-1a over the host name
+ */
+static uint32_t hash_host(const char* host) {
+    uint32_t hash = 2166136261u;
+    while (*host) {
+        hash = (hash ^ (uint8_t)*host++) * 16777619u;
+    }
+    return hash;
+}
+
+static station_position_entry_t* find_entry(uint32_t host_hash, const char* mountpoint) {
+    for (size_t i = 0; i < NTRIP_ATLAS_STATION_CACHE_ENTRIES; i++) {
+        station_position_entry_t* entry = &g_station_positions.entries[i];
+        if (entry->valid && entry->host_hash == host_hash &&
+            strcmp(entry->mountpoint, mountpoint) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Remember a mountpoint's broadcast antenna position
+ */
+ntrip_atlas_error_t ntrip_atlas_station_position_record(
+    const char* host,
+    const char* mountpoint,
+    const ntrip_rtcm3_station_t* station
+) {
+    if (!host || !mountpoint || !station || mountpoint[0] == '\0' ||
+        strlen(mountpoint) >= NTRIP_ATLAS_MAX_MOUNTPOINT) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    double radius = sqrt(station->ecef_x * station->ecef_x +
+                         station->ecef_y * station->ecef_y +
+                         station->ecef_z * station->ecef_z);
+    if (radius < STATION_MIN_RADIUS_M || radius > STATION_MAX_RADIUS_M) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t host_hash = hash_host(host);
+    station_position_entry_t* entry = find_entry(host_hash, mountpoint);
+    if (!entry) {
+        // Take a free slot, else the least recently used one
+        entry = &g_station_positions.entries[0];
+        for (size_t i = 0; i < NTRIP_ATLAS_STATION_CACHE_ENTRIES; i++) {
+            station_position_entry_t* candidate = &g_station_positions.entries[i];
+            if (!candidate->valid) {
+                entry = candidate;
+                break;
+            }
+            if (candidate->last_used < entry->last_used) {
+                entry = candidate;
+            }
+        }
+        entry->host_hash = host_hash;
+        strcpy(entry->mountpoint, mountpoint);
+        entry->valid = true;
+    }
+
+    // The antenna height is along the vertical, so it does not move lat/lon
+    ntrip_atlas_ecef_to_geodetic(station->ecef_x, station->ecef_y, station->ecef_z,
+                                 &entry->latitude, &entry->longitude, NULL);
+    entry->last_used = ++g_station_positions.clock;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Broadcast position of a mountpoint, if one was recorded
+ */
+bool ntrip_atlas_station_position_lookup(
+    const char* host,
+    const char* mountpoint,
+    double* latitude,
+    double* longitude
+) {
+    if (!host || !mountpoint) {
+        return false;
+    }
+
+    station_position_entry_t* entry = find_entry(hash_host(host), mountpoint);
+    if (!entry) {
+        return false;
+    }
+
+    entry->last_used = ++g_station_positions.clock;
+    if (latitude) {
+        *latitude = entry->latitude;
+    }
+    if (longitude) {
+        *longitude = entry->longitude;
+    }
+    return true;
+}
+
+/**
+ * Forget every recorded position
+ */
+void ntrip_atlas_station_positions_clear(void) {
+    memset(&g_station_positions, 0, sizeof(g_station_positions));
+}
@@ -9,37 +9,17 @@
  * Licensed under MIT License
  */
 
+#define _POSIX_C_SOURCE 200809L  // strtok_r
 #include "ntrip_stream_parser.h"
 #include "ntrip_atlas.h"
-#include "ntrip_atlas_config.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
-/**
- * Parser state for streaming sourcetable processing
- */
-typedef struct {
-    char line_buffer[NTRIP_LINE_BUFFER_SIZE];
-    size_t line_pos;
-    uint8_t in_sourcetable;
-    uint8_t parsing_complete;
-
-    // Current best mountpoint
-    ntrip_mountpoint_t best;
-    uint8_t has_result;
-
-    // Search criteria
-    double user_lat;
-    double user_lon;
-    const ntrip_service_config_t* service;
-    const ntrip_selection_criteria_t* criteria;
-
-    // Early termination thresholds
-    uint8_t stop_threshold_score;   // Stop if score exceeds this
-    double stop_threshold_distance; // Stop if distance under this
-} ntrip_stream_parser_state_t;
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 /**
  * Initialize streaming parser state
@@ -63,21 +43,23 @@ void ntrip_stream_parser_init(
 }
 
 /**
- * Parse a single STR (station/stream) line from sourcetable
+ * Parse the fields of a single STR (station/stream) line
  *
  * Format: STR;mountpoint;identifier;format;format-details;carrier;nav-system;
  *         network;country;lat;lon;nmea;solution;generator;compression;auth;fee;bitrate
+ *
+ * @param host Caster host for station cache lookups, or NULL
+ * @return 1 if the line describes a usable mountpoint, 0 to skip it
  */
-static int parse_str_line(
-    ntrip_stream_parser_state_t* state,
-    const char* line
-) {
+static int parse_str_fields(const char* line, const char* host, ntrip_mountpoint_t* out) {
     ntrip_mountpoint_t mp;
     memset(&mp, 0, sizeof(mp));
 
-    // Parse CSV fields from STR line
-    char* line_copy = strdup(line);
-    if (!line_copy) return -1;
+    // Parse CSV fields from a stack copy (lines come from line_buffer, so they fit)
+    char line_copy[NTRIP_LINE_BUFFER_SIZE];
+    size_t line_length = strlen(line);
+    if (line_length >= sizeof(line_copy)) return 0;
+    memcpy(line_copy, line, line_length + 1);
 
     char* saveptr = NULL;
     char* token;
@@ -88,7 +70,6 @@ static int parse_str_line(
         switch (field) {
             case 0: // Type (should be "STR")
                 if (strcmp(token, "STR") != 0) {
-                    free(line_copy);
                     return 0; // Not a STR line, skip
                 }
                 break;
@@ -139,13 +120,37 @@ static int parse_str_line(
         field++;
     }
 
-    free(line_copy);
+    // A broadcast position also rescues lines whose STR position is missing
+    if (host && mp.mountpoint[0] != '\0') {
+        ntrip_atlas_station_position_lookup(host, mp.mountpoint, &mp.latitude, &mp.longitude);
+    }
 
     // Validate required fields
     if (mp.mountpoint[0] == '\0' || mp.latitude == 0.0 || mp.longitude == 0.0) {
         return 0; // Incomplete data
     }
 
+    *out = mp;
+    return 1;
+}
+
+/**
+ * Filter and score a parsed mountpoint against the search position
+ *
+ * @return 1 to stop (early termination), 0 to continue
+ */
+static int consider_mountpoint(
+    ntrip_stream_parser_state_t* state,
+    const ntrip_mountpoint_t* parsed
+) {
+    ntrip_mountpoint_t mp = *parsed;
+
+    // A position the station broadcast beats the sourcetable's rounded one
+    if (state->service) {
+        ntrip_atlas_station_position_lookup(state->service->base_url, mp.mountpoint,
+                                            &mp.latitude, &mp.longitude);
+    }
+
     // Calculate distance from user position
     mp.distance_km = ntrip_atlas_calculate_distance(
         state->user_lat, state->user_lon,
@@ -224,6 +229,31 @@ static int parse_str_line(
     return 0;
 }
 
+/**
+ * Handle a single STR line: score it, or store it for a coalesced fetch
+ */
+static int parse_str_line(
+    ntrip_stream_parser_state_t* state,
+    const char* line
+) {
+    ntrip_mountpoint_t mp;
+    if (!parse_str_fields(line, state->service ? state->service->base_url : NULL, &mp)) {
+        return 0;
+    }
+
+    if (state->collect) {
+        ntrip_fetch_flight_t* flight = state->collect;
+        if (flight->mountpoint_count < flight->capacity) {
+            flight->mountpoints[flight->mountpoint_count++] = mp;
+        } else {
+            flight->truncated = 1;
+        }
+        return 0; // Waiters score from their own positions, so read everything
+    }
+
+    return consider_mountpoint(state, &mp);
+}
+
 /**
  * Process incoming data chunk
  *
@@ -290,6 +320,135 @@ int ntrip_stream_parser_get_result(
     return 0;
 }
 
+/**
+ * NTRIP 2.0 Sourcetable Filtering
+ */
+
+// STR record fields the filter constrains (STR itself is field 0)
+#define STR_FIELD_LATITUDE  9
+#define STR_FIELD_LONGITUDE 10
+#define STR_FIELD_FEE       16
+#define STR_FIELD_BITRATE   17
+#define STR_FIELD_COUNT     18
+
+// Distance to window: km per degree of latitude on the haversine sphere,
+// widened so rounding to 0.01 degrees never cuts off an edge mountpoint
+#define FILTER_KM_PER_DEGREE 111.195
+#define FILTER_MARGIN        1.02
+#define FILTER_PAD_DEGREES   0.01
+
+typedef struct {
+    char* path;
+    size_t size;
+    size_t pos;
+    bool overflow;
+} path_writer_t;
+
+static void path_append(path_writer_t* writer, const char* text) {
+    size_t length = strlen(text);
+    if (writer->pos + length >= writer->size) {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(writer->path + writer->pos, text, length + 1);
+    writer->pos += length;
+}
+
+/**
+ * Text of one filter field, empty when it is unconstrained
+ */
+static void append_filter_field(
+    path_writer_t* writer,
+    int field,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria
+) {
+    char text[48] = "";
+    double reach = criteria->max_distance_km > 0
+                   ? criteria->max_distance_km / FILTER_KM_PER_DEGREE * FILTER_MARGIN + FILTER_PAD_DEGREES
+                   : 0;
+    double lat_min = user_lat - reach;
+    double lat_max = user_lat + reach;
+    bool lat_window = reach > 0 && lat_min > -90.0 && lat_max < 90.0;
+
+    switch (field) {
+        case STR_FIELD_LATITUDE:
+            if (lat_window) {
+                snprintf(text, sizeof(text), ">%.2f&<%.2f", lat_min, lat_max);
+            }
+            break;
+        case STR_FIELD_LONGITUDE:
+            if (lat_window) {
+                // Widest at the window edge nearest a pole
+                double edge = fabs(lat_min) > fabs(lat_max) ? fabs(lat_min) : fabs(lat_max);
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+                int32_t cos_edge;
+                ntrip_atlas_fixed_sin_cos(NTRIP_ATLAS_DEG_TO_MICRODEG(edge), NULL, &cos_edge);
+                double lon_reach = cos_edge > 0 ? reach * NTRIP_GEOMETRY_Q30_ONE / cos_edge : 360.0;
+#else
+                double lon_reach = reach / cos(edge * M_PI / 180.0);
+#endif
+                if (user_lon - lon_reach > -180.0 && user_lon + lon_reach < 180.0) {
+                    snprintf(text, sizeof(text), ">%.2f&<%.2f", user_lon - lon_reach, user_lon + lon_reach);
+                }
+            }
+            break;
+        case STR_FIELD_FEE:
+            if (criteria->free_only) {
+                strcpy(text, "N");
+            }
+            break;
+        case STR_FIELD_BITRATE:
+            if (criteria->min_bitrate > 0) {
+                snprintf(text, sizeof(text), ">%u", (unsigned)criteria->min_bitrate - 1);
+            }
+            break;
+    }
+    path_append(writer, text);
+}
+
+/**
+ * Sourcetable request path for a query
+ */
+size_t ntrip_stream_parser_build_path(
+    char* path,
+    size_t size,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria
+) {
+    if (!path || size < 2) {
+        return 0;
+    }
+    strcpy(path, "/");
+    if (!service || !service->sourcetable_filter || !criteria) {
+        return 1;
+    }
+
+    // "/?STR;f1;f2;..." matching STR fields by position, trailing empty fields dropped
+    path_writer_t writer = { path, size, 0, false };
+    path_append(&writer, "/?STR");
+    size_t last_constrained = writer.pos;
+    for (int field = 1; field < STR_FIELD_COUNT && !writer.overflow; field++) {
+        path_append(&writer, ";");
+        size_t start = writer.pos;
+        append_filter_field(&writer, field, user_lat, user_lon, criteria);
+        if (writer.pos > start) {
+            last_constrained = writer.pos;
+        }
+    }
+
+    if (writer.overflow || last_constrained == 5) {
+        // Too long, or nothing to filter on: the plain table then
+        strcpy(path, "/");
+        return 1;
+    }
+    path[last_constrained] = '\0';
+    return last_constrained;
+}
+
 /**
  * Streaming callback wrapper
  * This is the actual callback passed to http_stream()
@@ -318,17 +477,30 @@ int ntrip_query_service_streaming(
     ntrip_stream_parser_state_t state;
     ntrip_stream_parser_init(&state, user_lat, user_lon, service, criteria);
 
+    // Let NTRIP 2.0 casters drop non-matching mountpoints before sending
+    char path[NTRIP_SOURCETABLE_PATH_SIZE];
+    size_t path_length = ntrip_stream_parser_build_path(path, sizeof(path), service,
+                                                        user_lat, user_lon, criteria);
+
     // Start streaming HTTP request
     int ret = platform->http_stream(
         service->base_url,
         service->port,
         service->ssl,
-        "/",  // Sourcetable path
+        path,
         streaming_callback_wrapper,
         &state,
         10000  // 10 second timeout
     );
 
+    // A caster that rejected the filter gets asked for the plain table;
+    // an empty filtered table that ended normally is a real answer
+    if (path_length > 1 && (ret < 0 || (!state.has_result && !state.parsing_complete))) {
+        ntrip_stream_parser_init(&state, user_lat, user_lon, service, criteria);
+        ret = platform->http_stream(service->base_url, service->port, service->ssl, "/",
+                                    streaming_callback_wrapper, &state, 10000);
+    }
+
     if (ret < 0) {
         return ret;
     }
@@ -336,3 +508,231 @@ int ntrip_query_service_streaming(
     // Extract result
     return ntrip_stream_parser_get_result(&state, result);
 }
+
+/**
+ * Sourcetable Fetch Coalescing
+ */
+
+#define FETCH_IDLE     0
+#define FETCH_RUNNING  1
+#define FETCH_COMPLETE 2
+
+static void fetch_lock(ntrip_fetch_coalescer_t* coalescer) {
+    if (coalescer->sync.lock) coalescer->sync.lock(coalescer->sync.context);
+}
+
+static void fetch_unlock(ntrip_fetch_coalescer_t* coalescer) {
+    if (coalescer->sync.unlock) coalescer->sync.unlock(coalescer->sync.context);
+}
+
+/**
+ * Set up a coalescer over caller-provided mountpoint storage
+ */
+ntrip_atlas_error_t ntrip_atlas_fetch_coalescer_init(
+    ntrip_fetch_coalescer_t* coalescer,
+    const ntrip_platform_t* platform,
+    const ntrip_fetch_sync_t* sync,
+    ntrip_mountpoint_t* storage,
+    size_t flight_count,
+    size_t mountpoints_per_fetch,
+    uint32_t reuse_ms
+) {
+    if (!coalescer || !platform || !platform->http_stream || !storage ||
+        flight_count == 0 || flight_count > NTRIP_ATLAS_MAX_COALESCED_FETCHES ||
+        mountpoints_per_fetch == 0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    // Waiting needs all four hooks
+    if (sync && (!sync->lock || !sync->unlock || !sync->wait || !sync->broadcast)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    memset(coalescer, 0, sizeof(*coalescer));
+    coalescer->platform = platform;
+    if (sync) {
+        coalescer->sync = *sync;
+    }
+    coalescer->reuse_ms = platform->get_time_ms ? reuse_ms : 0;
+    coalescer->flight_count = flight_count;
+
+    for (size_t i = 0; i < flight_count; i++) {
+        coalescer->flights[i].mountpoints = storage + i * mountpoints_per_fetch;
+        coalescer->flights[i].capacity = mountpoints_per_fetch;
+    }
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Check if a flight is fetching or holds this service's sourcetable
+ */
+static bool flight_matches(const ntrip_fetch_flight_t* flight, const ntrip_service_config_t* service) {
+    return flight->state != FETCH_IDLE &&
+           flight->port == service->port &&
+           flight->ssl == service->ssl &&
+           strcmp(flight->host, service->base_url) == 0;
+}
+
+/**
+ * Check if a completed table may still answer new queries
+ */
+static bool flight_is_fresh(const ntrip_fetch_coalescer_t* coalescer, const ntrip_fetch_flight_t* flight) {
+    return flight->state == FETCH_COMPLETE && flight->status == 0 && coalescer->reuse_ms > 0 &&
+           (uint32_t)(coalescer->platform->get_time_ms() - flight->completed_ms) < coalescer->reuse_ms;
+}
+
+/**
+ * Find a flight nobody is using (lock held)
+ */
+static ntrip_fetch_flight_t* claim_free_flight(ntrip_fetch_coalescer_t* coalescer) {
+    ntrip_fetch_flight_t* claimed = NULL;
+    for (size_t i = 0; i < coalescer->flight_count; i++) {
+        ntrip_fetch_flight_t* flight = &coalescer->flights[i];
+        if (flight->state == FETCH_RUNNING || flight->readers > 0) {
+            continue;
+        }
+        // Prefer slots that hold nothing worth reusing
+        if (flight->state == FETCH_IDLE || !flight_is_fresh(coalescer, flight)) {
+            return flight;
+        }
+        if (!claimed || (uint32_t)(flight->completed_ms - claimed->completed_ms) > UINT32_MAX / 2) {
+            claimed = flight;  // Oldest fresh table
+        }
+    }
+    return claimed;
+}
+
+/**
+ * Stream a sourcetable into a flight's table (lock not held)
+ */
+static int fetch_into_flight(
+    ntrip_fetch_coalescer_t* coalescer,
+    ntrip_fetch_flight_t* flight,
+    const ntrip_service_config_t* service
+) {
+    ntrip_stream_parser_state_t state;
+    ntrip_stream_parser_init(&state, 0.0, 0.0, service, NULL);
+    state.collect = flight;
+
+    return coalescer->platform->http_stream(
+        service->base_url,
+        service->port,
+        service->ssl,
+        "/",  // Sourcetable path
+        streaming_callback_wrapper,
+        &state,
+        10000  // 10 second timeout
+    );
+}
+
+/**
+ * Score a shared table exactly as the streaming parser would have
+ */
+static int score_flight(
+    const ntrip_fetch_flight_t* flight,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria,
+    ntrip_mountpoint_t* result
+) {
+    if (flight->status < 0) {
+        return flight->status;
+    }
+
+    ntrip_stream_parser_state_t state;
+    ntrip_stream_parser_init(&state, user_lat, user_lon, service, criteria);
+    for (size_t i = 0; i < flight->mountpoint_count; i++) {
+        if (consider_mountpoint(&state, &flight->mountpoints[i]) != 0) {
+            break;
+        }
+    }
+
+    return ntrip_stream_parser_get_result(&state, result);
+}
+
+/**
+ * Query a service, sharing the sourcetable download with concurrent callers
+ */
+int ntrip_query_service_coalesced(
+    ntrip_fetch_coalescer_t* coalescer,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria,
+    ntrip_mountpoint_t* result
+) {
+    if (!coalescer || !coalescer->platform || !service || !result) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (strlen(service->base_url) >= sizeof(coalescer->flights[0].host)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    fetch_lock(coalescer);
+    coalescer->stats.queries++;
+
+    // A download in flight, or a table young enough to reuse
+    ntrip_fetch_flight_t* flight = NULL;
+    for (size_t i = 0; i < coalescer->flight_count; i++) {
+        ntrip_fetch_flight_t* candidate = &coalescer->flights[i];
+        if (flight_matches(candidate, service) &&
+            (candidate->state == FETCH_RUNNING || flight_is_fresh(coalescer, candidate))) {
+            flight = candidate;
+            break;
+        }
+    }
+
+    if (flight && flight->state == FETCH_RUNNING && coalescer->sync.wait) {
+        // Someone is already downloading this caster
+        coalescer->stats.coalesced++;
+        flight->readers++;
+        while (flight->state == FETCH_RUNNING) {
+            coalescer->sync.wait(coalescer->sync.context);
+        }
+    } else if (flight && flight->state == FETCH_COMPLETE) {
+        coalescer->stats.reused++;
+        flight->readers++;
+    } else {
+        flight = claim_free_flight(coalescer);
+        if (!flight) {
+            // Every slot busy (or a re-entrant query without hooks): fetch alone
+            coalescer->stats.uncoalesced++;
+            fetch_unlock(coalescer);
+            return ntrip_query_service_streaming(coalescer->platform, service, user_lat, user_lon, criteria, result);
+        }
+
+        strcpy(flight->host, service->base_url);
+        flight->port = service->port;
+        flight->ssl = service->ssl;
+        flight->state = FETCH_RUNNING;
+        flight->readers = 1;
+        flight->mountpoint_count = 0;
+        flight->truncated = 0;
+        coalescer->stats.fetches++;
+        fetch_unlock(coalescer);
+
+        int status = fetch_into_flight(coalescer, flight, service);
+
+        fetch_lock(coalescer);
+        flight->status = status < 0 ? status : 0;
+        flight->completed_ms = coalescer->platform->get_time_ms ? coalescer->platform->get_time_ms() : 0;
+        flight->state = FETCH_COMPLETE;
+        if (flight->truncated) {
+            coalescer->stats.truncated++;
+        }
+        if (coalescer->sync.broadcast) {
+            coalescer->sync.broadcast(coalescer->sync.context);
+        }
+    }
+    fetch_unlock(coalescer);
+
+    // The table is read-only while we hold a reader reference
+    int ret = score_flight(flight, service, user_lat, user_lon, criteria, result);
+
+    fetch_lock(coalescer);
+    flight->readers--;
+    fetch_unlock(coalescer);
+
+    return ret;
+}
@@ -20,17 +20,70 @@ extern "C" {
 #endif
 
 /**
- * Opaque parser state structure
- * Actual definition in .c file to hide implementation details
+ * Reset parser state for a new sourcetable
  */
-typedef struct ntrip_stream_parser_state_t ntrip_stream_parser_state_t;
+void ntrip_stream_parser_init(
+    ntrip_stream_parser_state_t* state,
+    double user_lat,
+    double user_lon,
+    const ntrip_service_config_t* service,
+    const ntrip_selection_criteria_t* criteria
+);
+
+/**
+ * Feed the next chunk of sourcetable body
+ * @return 1 once parsing can stop (end of table or early termination), 0 to continue
+ */
+int ntrip_stream_parser_process_chunk(
+    ntrip_stream_parser_state_t* state,
+    const char* chunk,
+    size_t len
+);
+
+/**
+ * Best mountpoint seen so far
+ * @return 0 on success, -1 if nothing matched
+ */
+int ntrip_stream_parser_get_result(
+    const ntrip_stream_parser_state_t* state,
+    ntrip_mountpoint_t* result
+);
+
+// Room for the longest filter path the builder emits
+#define NTRIP_SOURCETABLE_PATH_SIZE 128
+
+/**
+ * Sourcetable request path for a query
+ *
+ * "/" unless the service filters server-side (sourcetable_filter). Then
+ * the criteria and position become an NTRIP 2.0 filter query such as
+ * "/?STR;;;;;;;;;>49.10&<50.90;>8.40&<11.60;;;;;;N;>2399".
+ * The filter only loosens the client-side checks (the distance becomes a
+ * slightly larger lat/lon window). Formats stay client-side, since they
+ * may match format details rather than the format field. So parsing the
+ * filtered table gives
+ * the same answer as parsing the whole one. The exception is a station
+ * whose cached broadcast position is in range while its STR line is not.
+ *
+ * @return Path length (1 for the plain "/")
+ */
+size_t ntrip_stream_parser_build_path(
+    char* path,
+    size_t size,
+    const ntrip_service_config_t* service,
+    double user_lat,
+    double user_lon,
+    const ntrip_selection_criteria_t* criteria
+);
 
 /**
  * Query a single NTRIP service using streaming HTTP
  *
  * This is the primary interface for memory-efficient service discovery.
  * Streams sourcetable data and processes it line-by-line without buffering
- * the entire response.
+ * the entire response. Casters flagged sourcetable_filter are sent the
+ * filter from ntrip_stream_parser_build_path(), and asked again for the
+ * whole table if they reject it.
  *
  * @param platform   Platform abstraction with http_stream function
  * @param service    Service to query
@@ -0,0 +1,816 @@
+/**
+ * NTRIP Atlas - Tiered Database Image Format
+ *
+ * Platform-independent pieces of the tiered database image: header
+ * validation, the packed (v2) discovery index, the Tier 3 metadata record
+ * codec and its dictionary-based compression. Backends (mmapped file, flash partition) locate records
+ * with these and hand them to the tiered loader.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Metadata string fields in record order
+ */
+typedef struct {
+    size_t offset;
+    size_t size;
+} metadata_field_t;
+
+#define METADATA_FIELD(name) \
+    { offsetof(ntrip_service_metadata_t, name), sizeof(((ntrip_service_metadata_t*)0)->name) }
+
+static const metadata_field_t metadata_fields[] = {
+    METADATA_FIELD(provider_full),
+    METADATA_FIELD(country),
+    METADATA_FIELD(description),
+    METADATA_FIELD(website),
+    METADATA_FIELD(contact_email),
+    METADATA_FIELD(registration_url),
+    METADATA_FIELD(coverage_notes),
+};
+
+#define METADATA_FIELD_COUNT (sizeof(metadata_fields) / sizeof(metadata_fields[0]))
+
+/**
+ * Check that [offset, offset + length) lies within the image
+ */
+static bool section_in_bounds(uint64_t offset, uint64_t length, size_t image_size) {
+    return offset <= image_size && length <= image_size - offset;
+}
+
+/**
+ * Validate a tiered file header against the size of its image
+ */
+ntrip_atlas_error_t ntrip_atlas_validate_tiered_file_header(
+    const ntrip_tiered_file_header_t* header,
+    size_t image_size
+) {
+    if (!header || image_size < sizeof(ntrip_tiered_file_header_t)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (header->db.magic_number != NTRIP_ATLAS_DB_MAGIC_V1 ||
+        header->layout_magic != NTRIP_TIERED_FILE_MAGIC) {
+        return NTRIP_ATLAS_ERROR_INVALID_MAGIC;
+    }
+
+    // Record layouts are fixed per schema - a stride mismatch means a different build.
+    // A packed Tier 1 has no stride and runs up to the Tier 2 section.
+    bool packed_index = (header->db.feature_flags & NTRIP_DB_FEATURE_PACKED_INDEX) != 0;
+    if (header->tier1_stride != (packed_index ? 0 : sizeof(ntrip_service_index_t)) ||
+        header->tier2_stride != sizeof(ntrip_service_endpoints_t)) {
+        return NTRIP_ATLAS_ERROR_INCOMPATIBLE_VERSION;
+    }
+
+    uint64_t tier1_size = packed_index ?
+        (uint64_t)header->tier2_offset - header->tier1_offset :
+        (uint64_t)header->tier1_count * header->tier1_stride;
+    if (packed_index && header->tier2_offset < header->tier1_offset) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    uint64_t service_count = header->db.service_count;
+    if (!section_in_bounds(header->tier1_offset, tier1_size, image_size) ||
+        !section_in_bounds(header->tier2_offset,
+                           service_count * header->tier2_stride, image_size) ||
+        !section_in_bounds(header->tier3_index_offset,
+                           (service_count + 1) * sizeof(uint32_t), image_size) ||
+        !section_in_bounds(header->tier3_blob_offset, header->tier3_blob_size, image_size)) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Encode metadata as a Tier 3 record
+ */
+ntrip_atlas_error_t ntrip_atlas_encode_metadata_record(
+    const ntrip_service_metadata_t* metadata,
+    uint8_t* buffer,
+    size_t buffer_size,
+    size_t* record_size
+) {
+    if (!metadata || !record_size) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    size_t pos = sizeof(uint32_t);
+    if (buffer) {
+        if (buffer_size < pos) {
+            return NTRIP_ATLAS_ERROR_NO_MEMORY;
+        }
+        memcpy(buffer, &metadata->last_updated, sizeof(uint32_t));
+    }
+
+    for (size_t i = 0; i < METADATA_FIELD_COUNT; i++) {
+        const char* field = (const char*)metadata + metadata_fields[i].offset;
+        const char* nul = memchr(field, '\0', metadata_fields[i].size - 1);
+        size_t length = nul ? (size_t)(nul - field) : metadata_fields[i].size - 1;
+
+        if (buffer) {
+            if (buffer_size - pos < length + 1) {
+                return NTRIP_ATLAS_ERROR_NO_MEMORY;
+            }
+            memcpy(buffer + pos, field, length);
+            buffer[pos + length] = '\0';
+        }
+        pos += length + 1;
+    }
+
+    *record_size = pos;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Decode a Tier 3 record into metadata
+ */
+ntrip_atlas_error_t ntrip_atlas_decode_metadata_record(
+    const uint8_t* record,
+    size_t record_size,
+    ntrip_service_metadata_t* metadata
+) {
+    if (!record || !metadata) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (record_size < sizeof(uint32_t)) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    memset(metadata, 0, sizeof(*metadata));
+    memcpy(&metadata->last_updated, record, sizeof(uint32_t));
+
+    size_t pos = sizeof(uint32_t);
+    for (size_t i = 0; i < METADATA_FIELD_COUNT; i++) {
+        const uint8_t* start = record + pos;
+        const uint8_t* end = memchr(start, '\0', record_size - pos);
+        if (!end) {
+            return NTRIP_ATLAS_ERROR_LOAD_FAILED;  // Truncated record
+        }
+
+        // Overlong strings are truncated to the field, never overflow it
+        size_t length = (size_t)(end - start);
+        size_t field_size = metadata_fields[i].size;
+        if (length > field_size - 1) {
+            length = field_size - 1;
+        }
+        memcpy((char*)metadata + metadata_fields[i].offset, start, length);
+
+        pos += (size_t)(end - start) + 1;
+    }
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Compressed record tokens (byte aligned, LZ4/heatshrink style)
+ *   0lllllll                  literal run of l + 1 bytes follows
+ *   1lllllll dddddddd dddddddd copy l + LZ_MIN_MATCH bytes from distance d
+ * Distances reach back through the output into the shared dictionary,
+ * which logically precedes every record.
+ */
+#define LZ_MATCH_FLAG     0x80
+#define LZ_MIN_MATCH      4
+#define LZ_MAX_MATCH      (0x7F + LZ_MIN_MATCH)
+#define LZ_MAX_LITERALS   0x80
+#define LZ_MAX_DISTANCE   0xFFFF
+
+/**
+ * Byte at a position in the dictionary + record window
+ */
+static uint8_t window_byte(const uint8_t* dictionary, size_t dictionary_size,
+                           const uint8_t* data, size_t position) {
+    return position < dictionary_size ? dictionary[position] : data[position - dictionary_size];
+}
+
+/**
+ * Emit a pending literal run
+ */
+static bool flush_literals(const uint8_t* literals, size_t count,
+                           uint8_t* buffer, size_t buffer_size, size_t* pos) {
+    while (count > 0) {
+        size_t run = count < LZ_MAX_LITERALS ? count : LZ_MAX_LITERALS;
+        if (buffer_size - *pos < run + 1) {
+            return false;
+        }
+        buffer[(*pos)++] = (uint8_t)(run - 1);
+        memcpy(buffer + *pos, literals, run);
+        *pos += run;
+        literals += run;
+        count -= run;
+    }
+    return true;
+}
+
+/**
+ * Compress an encoded Tier 3 record against a shared dictionary
+ */
+ntrip_atlas_error_t ntrip_atlas_compress_metadata_record(
+    const uint8_t* record,
+    size_t record_size,
+    const uint8_t* dictionary,
+    size_t dictionary_size,
+    uint8_t* buffer,
+    size_t buffer_size,
+    size_t* compressed_size
+) {
+    if (!record || !buffer || !compressed_size || (!dictionary && dictionary_size > 0)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    size_t out = 0;
+    size_t literal_start = 0;
+    size_t pos = 0;
+
+    while (pos < record_size) {
+        // Greedy longest match; records are small, so a plain scan is enough
+        size_t here = dictionary_size + pos;
+        size_t first = here > LZ_MAX_DISTANCE ? here - LZ_MAX_DISTANCE : 0;
+        size_t best_length = 0, best_distance = 0;
+
+        for (size_t candidate = first; candidate < here; candidate++) {
+            size_t length = 0;
+            while (length < LZ_MAX_MATCH && pos + length < record_size &&
+                   window_byte(dictionary, dictionary_size, record, candidate + length) == record[pos + length]) {
+                length++;
+            }
+            if (length > best_length) {
+                best_length = length;
+                best_distance = here - candidate;
+            }
+        }
+
+        if (best_length < LZ_MIN_MATCH) {
+            pos++;
+            continue;
+        }
+
+        if (!flush_literals(record + literal_start, pos - literal_start, buffer, buffer_size, &out) ||
+            buffer_size - out < 3) {
+            return NTRIP_ATLAS_ERROR_NO_MEMORY;
+        }
+        buffer[out++] = (uint8_t)(LZ_MATCH_FLAG | (best_length - LZ_MIN_MATCH));
+        buffer[out++] = (uint8_t)(best_distance & 0xFF);
+        buffer[out++] = (uint8_t)(best_distance >> 8);
+
+        pos += best_length;
+        literal_start = pos;
+    }
+
+    if (!flush_literals(record + literal_start, pos - literal_start, buffer, buffer_size, &out)) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+
+    *compressed_size = out;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Decompress one Tier 3 record into a caller buffer
+ */
+ntrip_atlas_error_t ntrip_atlas_decompress_metadata_record(
+    const uint8_t* compressed,
+    size_t compressed_size,
+    const uint8_t* dictionary,
+    size_t dictionary_size,
+    uint8_t* record,
+    size_t record_capacity,
+    size_t* record_size
+) {
+    if (!compressed || !record || !record_size || (!dictionary && dictionary_size > 0)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    size_t in = 0, out = 0;
+    while (in < compressed_size) {
+        uint8_t token = compressed[in++];
+
+        if (!(token & LZ_MATCH_FLAG)) {
+            size_t run = (size_t)token + 1;
+            if (run > compressed_size - in) {
+                return NTRIP_ATLAS_ERROR_LOAD_FAILED;  // Truncated literals
+            }
+            if (run > record_capacity - out) {
+                return NTRIP_ATLAS_ERROR_NO_MEMORY;
+            }
+            memcpy(record + out, compressed + in, run);
+            in += run;
+            out += run;
+            continue;
+        }
+
+        if (compressed_size - in < 2) {
+            return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+        }
+        size_t length = (size_t)(token & 0x7F) + LZ_MIN_MATCH;
+        size_t distance = (size_t)compressed[in] | ((size_t)compressed[in + 1] << 8);
+        in += 2;
+
+        if (distance == 0 || distance > dictionary_size + out) {
+            return NTRIP_ATLAS_ERROR_LOAD_FAILED;  // Reaches before the dictionary
+        }
+        if (length > record_capacity - out) {
+            return NTRIP_ATLAS_ERROR_NO_MEMORY;
+        }
+
+        // Byte by byte: matches may overlap their own output
+        for (size_t i = 0; i < length; i++, out++) {
+            record[out] = window_byte(dictionary, dictionary_size, record,
+                                      dictionary_size + out - distance);
+        }
+    }
+
+    *record_size = out;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Dictionary candidate: a string repeated across records
+ */
+typedef struct {
+    const char* text;
+    size_t length;
+    size_t count;          // Records containing it
+    size_t last_record;    // Avoids counting a record twice
+} dictionary_candidate_t;
+
+// Candidate pieces per field: the whole value plus separator-bounded prefixes and suffixes
+#define DICT_PIECES_PER_FIELD 16
+#define DICT_SEPARATORS       " /.@,-"
+
+/**
+ * Candidate table with a hash index for deduplication
+ */
+typedef struct {
+    dictionary_candidate_t* candidates;
+    size_t count;
+    size_t capacity;
+    uint32_t* buckets;     // Candidate index + 1, 0 = empty
+    size_t bucket_mask;
+} dictionary_trainer_t;
+
+static uint32_t hash_piece(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void add_dictionary_candidate(dictionary_trainer_t* trainer,
+                                     const char* text, size_t length, size_t record) {
+    if (length < LZ_MIN_MATCH) {
+        return;
+    }
+
+    size_t bucket = hash_piece(text, length) & trainer->bucket_mask;
+    while (trainer->buckets[bucket]) {
+        dictionary_candidate_t* c = &trainer->candidates[trainer->buckets[bucket] - 1];
+        if (c->length == length && memcmp(c->text, text, length) == 0) {
+            if (c->last_record != record) {
+                c->count++;
+                c->last_record = record;
+            }
+            return;
+        }
+        bucket = (bucket + 1) & trainer->bucket_mask;
+    }
+
+    if (trainer->count == trainer->capacity) {
+        return;
+    }
+
+    dictionary_candidate_t* c = &trainer->candidates[trainer->count++];
+    c->text = text;
+    c->length = length;
+    c->count = 1;
+    c->last_record = record;
+    trainer->buckets[bucket] = (uint32_t)trainer->count;
+}
+
+/**
+ * Offer a field's pieces: whole value, then prefixes and suffixes split at separators
+ */
+static void add_field_candidates(dictionary_trainer_t* trainer, const char* field,
+                                 size_t length, bool terminated, size_t record) {
+    // Include the terminator so matches run on into the next field
+    size_t stored = terminated ? length + 1 : length;
+    add_dictionary_candidate(trainer, field, stored, record);
+
+    size_t pieces = 1;
+    for (size_t i = 1; i < length && pieces < DICT_PIECES_PER_FIELD; i++) {
+        if (strchr(DICT_SEPARATORS, field[i])) {
+            add_dictionary_candidate(trainer, field, i + 1, record);        // Through the separator
+            add_dictionary_candidate(trainer, field + i, stored - i, record); // From the separator on
+            pieces += 2;
+        }
+    }
+}
+
+/**
+ * Order candidates by bytes saved, most first
+ */
+static int compare_dictionary_candidates(const void* a, const void* b) {
+    const dictionary_candidate_t* ca = (const dictionary_candidate_t*)a;
+    const dictionary_candidate_t* cb = (const dictionary_candidate_t*)b;
+    size_t saved_a = (ca->count - 1) * ca->length;
+    size_t saved_b = (cb->count - 1) * cb->length;
+    if (saved_a != saved_b) {
+        return saved_a > saved_b ? -1 : 1;
+    }
+    // Input order breaks ties so the dictionary is reproducible
+    return ca->text < cb->text ? -1 : (ca->text > cb->text);
+}
+
+static bool dictionary_contains(const uint8_t* dictionary, size_t size, const char* text, size_t length) {
+    for (size_t i = 0; i + length <= size; i++) {
+        if (memcmp(dictionary + i, text, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Build a shared Tier 3 dictionary from the strings repeated across records
+ */
+ntrip_atlas_error_t ntrip_atlas_build_metadata_dictionary(
+    const ntrip_service_metadata_t* metadata,
+    size_t count,
+    uint8_t* dictionary,
+    size_t dictionary_capacity,
+    size_t* dictionary_size
+) {
+    if ((!metadata && count > 0) || (!dictionary && dictionary_capacity > 0) || !dictionary_size) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    *dictionary_size = 0;
+    if (count == 0 || dictionary_capacity == 0) {
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    dictionary_trainer_t trainer;
+    memset(&trainer, 0, sizeof(trainer));
+    trainer.capacity = count * METADATA_FIELD_COUNT * DICT_PIECES_PER_FIELD;
+    size_t bucket_count = 1;
+    while (bucket_count < trainer.capacity * 2) {
+        bucket_count <<= 1;
+    }
+    trainer.bucket_mask = bucket_count - 1;
+    trainer.candidates = malloc(trainer.capacity * sizeof(dictionary_candidate_t));
+    trainer.buckets = calloc(bucket_count, sizeof(uint32_t));
+    if (!trainer.candidates || !trainer.buckets) {
+        free(trainer.candidates);
+        free(trainer.buckets);
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+
+    for (size_t r = 0; r < count; r++) {
+        for (size_t f = 0; f < METADATA_FIELD_COUNT; f++) {
+            const char* field = (const char*)&metadata[r] + metadata_fields[f].offset;
+            const char* nul = memchr(field, '\0', metadata_fields[f].size - 1);
+            size_t length = nul ? (size_t)(nul - field) : metadata_fields[f].size - 1;
+            if (length > 0) {
+                add_field_candidates(&trainer, field, length, nul != NULL, r);
+            }
+        }
+    }
+    free(trainer.buckets);
+
+    dictionary_candidate_t* candidates = trainer.candidates;
+    size_t candidate_count = trainer.count;
+    qsort(candidates, candidate_count, sizeof(*candidates), compare_dictionary_candidates);
+
+    size_t size = 0;
+    for (size_t i = 0; i < candidate_count && candidates[i].count > 1; i++) {
+        const dictionary_candidate_t* c = &candidates[i];
+        if (c->length <= dictionary_capacity - size &&
+            !dictionary_contains(dictionary, size, c->text, c->length)) {
+            memcpy(dictionary + size, c->text, c->length);
+            size += c->length;
+        }
+    }
+
+    free(candidates);
+    *dictionary_size = size;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Packed discovery index attribute word
+ */
+#define PACKED_QUALITY_MASK      0x0007
+#define PACKED_NETWORK_SHIFT     3
+#define PACKED_NETWORK_MASK      0x0003
+#define PACKED_AUTH_SHIFT        5
+#define PACKED_AUTH_MASK         0x0003
+#define PACKED_REGISTRATION_BIT  0x0080
+#define PACKED_SSL_BIT           0x0100
+#define PACKED_PROVIDER_SHIFT    9
+#define PACKED_PROVIDER_MAX      0x7F
+
+#define PACKED_LAT_ORIGIN        (-9000)   // First delta is from the south pole
+#define PACKED_RECORD_FIXED      5         // lon + radius + attributes (service_index extra)
+
+/**
+ * Bounds-checked output (NULL buffer only measures)
+ */
+typedef struct {
+    uint8_t* buffer;
+    size_t size;
+    size_t pos;
+    bool overflow;
+} packed_writer_t;
+
+static void packed_put(packed_writer_t* w, const void* data, size_t length) {
+    if (w->buffer) {
+        if (w->pos > w->size || w->size - w->pos < length) {
+            w->overflow = true;
+        } else {
+            memcpy(w->buffer + w->pos, data, length);
+        }
+    }
+    w->pos += length;
+}
+
+static void packed_put_varint(packed_writer_t* w, uint32_t value) {
+    do {
+        uint8_t byte = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        if (value) byte |= 0x80;
+        packed_put(w, &byte, 1);
+    } while (value);
+}
+
+/**
+ * Latitude order for packing (ties by longitude, then original order)
+ */
+static bool packed_sorts_before(const ntrip_service_index_t* a, size_t slot_a,
+                                const ntrip_service_index_t* b, size_t slot_b) {
+    if (a->lat_center_deg100 != b->lat_center_deg100) return a->lat_center_deg100 < b->lat_center_deg100;
+    if (a->lon_center_deg100 != b->lon_center_deg100) return a->lon_center_deg100 < b->lon_center_deg100;
+    return slot_a < slot_b;
+}
+
+/**
+ * Pack a discovery index into the v2 encoding
+ */
+ntrip_atlas_error_t ntrip_atlas_pack_discovery_index(
+    const ntrip_service_index_t* index,
+    size_t count,
+    uint8_t* buffer,
+    size_t buffer_size,
+    size_t* packed_size
+) {
+    if ((!index && count > 0) || count > UINT16_MAX || !packed_size) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    // Provider pool and attribute range checks
+    char providers[PACKED_PROVIDER_MAX + 1][4];
+    size_t provider_count = 0;
+    uint32_t max_service_index = 0;
+    for (size_t i = 0; i < count; i++) {
+        const ntrip_service_index_t* s = &index[i];
+        if (s->service_index > max_service_index) max_service_index = s->service_index;
+        if (s->quality_rating > PACKED_QUALITY_MASK || s->network_type > PACKED_NETWORK_MASK ||
+            s->auth_method > PACKED_AUTH_MASK || s->service_index == NTRIP_SERVICE_INDEX_INVALID ||
+            s->lat_center_deg100 < PACKED_LAT_ORIGIN ||
+            s->lat_center_deg100 > -PACKED_LAT_ORIGIN) {
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
+
+        size_t p = 0;
+        while (p < provider_count && memcmp(providers[p], s->provider_short, 4) != 0) p++;
+        if (p == provider_count) {
+            if (provider_count > PACKED_PROVIDER_MAX) {
+                return NTRIP_ATLAS_ERROR_INVALID_PARAM;  // Too many distinct providers
+            }
+            memcpy(providers[provider_count++], s->provider_short, 4);
+        }
+    }
+
+    // Records go in latitude order so centers delta-encode (insertion sort, writer side)
+    uint16_t* order = malloc((count > 0 ? count : 1) * sizeof(uint16_t));
+    if (!order) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t j = i;
+        while (j > 0 && packed_sorts_before(&index[i], i, &index[order[j - 1]], order[j - 1])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (uint16_t)i;
+    }
+
+    // Narrowest index width that holds every service index
+    uint8_t index_bytes = max_service_index <= UINT8_MAX ? 1 :
+                          max_service_index <= UINT16_MAX ? 2 : 4;
+
+    packed_writer_t w = { buffer, buffer_size, 0, false };
+    ntrip_packed_index_header_t header = { (uint16_t)count, (uint8_t)provider_count, index_bytes };
+    packed_put(&w, &header, sizeof(header));
+    packed_put(&w, providers, provider_count * 4);
+
+    int32_t previous_lat = PACKED_LAT_ORIGIN;
+    for (size_t i = 0; i < count; i++) {
+        const ntrip_service_index_t* s = &index[order[i]];
+
+        size_t provider = 0;
+        while (memcmp(providers[provider], s->provider_short, 4) != 0) provider++;
+
+        uint16_t attributes = (uint16_t)(s->quality_rating |
+            (s->network_type << PACKED_NETWORK_SHIFT) |
+            (s->auth_method << PACKED_AUTH_SHIFT) |
+            (s->requires_registration ? PACKED_REGISTRATION_BIT : 0) |
+            (s->ssl_available ? PACKED_SSL_BIT : 0) |
+            (provider << PACKED_PROVIDER_SHIFT));
+
+        packed_put_varint(&w, (uint32_t)(s->lat_center_deg100 - previous_lat));
+        packed_put(&w, &s->lon_center_deg100, sizeof(int16_t));
+        packed_put(&w, &s->radius_km, 1);
+        uint32_t service_index = s->service_index;
+        packed_put(&w, &service_index, index_bytes);  // Little-endian low bytes
+        packed_put(&w, &attributes, sizeof(attributes));
+        previous_lat = s->lat_center_deg100;
+    }
+
+    free(order);
+
+    if (w.overflow) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    *packed_size = w.pos;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Start scanning a packed discovery index
+ */
+ntrip_atlas_error_t ntrip_atlas_packed_index_begin(
+    const uint8_t* packed,
+    size_t packed_size,
+    ntrip_packed_index_cursor_t* cursor
+) {
+    if (!packed || !cursor) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    ntrip_packed_index_header_t header;
+    if (packed_size < sizeof(header)) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+    memcpy(&header, packed, sizeof(header));
+
+    if (header.index_bytes == 0) {
+        header.index_bytes = 1;  // Written before the width field existed
+    }
+    if (header.index_bytes != 1 && header.index_bytes != 2 && header.index_bytes != 4) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+    if (header.index_bytes > sizeof(ntrip_service_idx_t)) {
+        return NTRIP_ATLAS_ERROR_INCOMPATIBLE_VERSION;  // Indices wider than this build
+    }
+
+    size_t pool_size = (size_t)header.provider_count * 4;
+    if (packed_size - sizeof(header) < pool_size) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->data = packed;
+    cursor->size = packed_size;
+    cursor->pos = sizeof(header) + pool_size;
+    cursor->providers = (const char*)packed + sizeof(header);
+    cursor->provider_count = header.provider_count;
+    cursor->index_bytes = header.index_bytes;
+    cursor->remaining = header.count;
+    cursor->lat_center_deg100 = PACKED_LAT_ORIGIN;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Advance to the next record, decoding only its center, radius and index
+ */
+ntrip_atlas_error_t ntrip_atlas_packed_index_next(ntrip_packed_index_cursor_t* cursor) {
+    if (!cursor || !cursor->data) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if (cursor->remaining == 0) {
+        return NTRIP_ATLAS_ERROR_NOT_FOUND;
+    }
+
+    uint32_t delta = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        if (cursor->pos >= cursor->size || shift > 14) {
+            return NTRIP_ATLAS_ERROR_LOAD_FAILED;  // Truncated or overlong varint
+        }
+        uint8_t byte = cursor->data[cursor->pos++];
+        delta |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+
+    int32_t lat = cursor->lat_center_deg100 + (int32_t)delta;
+    size_t record_size = PACKED_RECORD_FIXED + cursor->index_bytes;
+    if (lat > -PACKED_LAT_ORIGIN || cursor->size - cursor->pos < record_size) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    const uint8_t* record = cursor->data + cursor->pos;
+    uint32_t service_index = 0;
+    for (uint8_t b = 0; b < cursor->index_bytes; b++) {
+        service_index |= (uint32_t)record[3 + b] << (8 * b);
+    }
+    if (service_index >= NTRIP_SERVICE_INDEX_INVALID) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    cursor->lat_center_deg100 = (int16_t)lat;
+    memcpy(&cursor->lon_center_deg100, record, sizeof(int16_t));
+    cursor->radius_km = record[2];
+    cursor->service_index = (ntrip_service_idx_t)service_index;
+    cursor->attributes_pos = cursor->pos + 3 + cursor->index_bytes;
+
+    cursor->pos += record_size;
+    cursor->remaining--;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Fully decode the current record
+ */
+ntrip_atlas_error_t ntrip_atlas_packed_index_decode(
+    const ntrip_packed_index_cursor_t* cursor,
+    ntrip_service_index_t* entry
+) {
+    if (!cursor || !cursor->data || !cursor->attributes_pos || !entry) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    uint16_t attributes;
+    memcpy(&attributes, cursor->data + cursor->attributes_pos, sizeof(attributes));
+    size_t provider = attributes >> PACKED_PROVIDER_SHIFT;
+    if (provider >= cursor->provider_count) {
+        return NTRIP_ATLAS_ERROR_LOAD_FAILED;
+    }
+
+    memset(entry, 0, sizeof(*entry));
+    entry->service_index = cursor->service_index;
+    entry->lat_center_deg100 = cursor->lat_center_deg100;
+    entry->lon_center_deg100 = cursor->lon_center_deg100;
+    entry->radius_km = cursor->radius_km;
+    entry->quality_rating = (uint8_t)(attributes & PACKED_QUALITY_MASK);
+    entry->network_type = (uint8_t)((attributes >> PACKED_NETWORK_SHIFT) & PACKED_NETWORK_MASK);
+    entry->auth_method = (uint8_t)((attributes >> PACKED_AUTH_SHIFT) & PACKED_AUTH_MASK);
+    entry->requires_registration = (attributes & PACKED_REGISTRATION_BIT) ? 1 : 0;
+    entry->ssl_available = (attributes & PACKED_SSL_BIT) ? 1 : 0;
+    memcpy(entry->provider_short, cursor->providers + provider * 4, 4);
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Unpack a whole packed discovery index (latitude order)
+ */
+ntrip_atlas_error_t ntrip_atlas_unpack_discovery_index(
+    const uint8_t* packed,
+    size_t packed_size,
+    ntrip_service_index_t* index,
+    size_t capacity,
+    size_t* count
+) {
+    if (!index || !count) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    ntrip_packed_index_cursor_t cursor;
+    ntrip_atlas_error_t result = ntrip_atlas_packed_index_begin(packed, packed_size, &cursor);
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        return result;
+    }
+    if (cursor.remaining > capacity) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+
+    size_t n = 0;
+    while ((result = ntrip_atlas_packed_index_next(&cursor)) == NTRIP_ATLAS_SUCCESS) {
+        result = ntrip_atlas_packed_index_decode(&cursor, &index[n]);
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            return result;
+        }
+        n++;
+    }
+    if (result != NTRIP_ATLAS_ERROR_NOT_FOUND) {
+        return result;
+    }
+
+    *count = n;
+    return NTRIP_ATLAS_SUCCESS;
+}
@@ -7,364 +7,2024 @@
  * Licensed under MIT License
  */
 
+#define _USE_MATH_DEFINES  // For M_PI on Windows/MSVC
 #include "ntrip_atlas.h"
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <math.h>
 
-// Cache configuration
-#define ENDPOINT_CACHE_SIZE 4    // Keep 4 most recent endpoints
-#define METADATA_CACHE_SIZE 2    // Keep 2 most recent metadata entries
+// Ensure M_PI is defined on all platforms
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
-// Cache entry structure for endpoints
+// Cache slot flags
+#define CACHE_SLOT_VALID        0x01
+#define CACHE_SLOT_REFERENCED   0x02    // CLOCK second-chance bit
+
+// Prefetch configuration
+#define PREFETCH_QUEUE_SIZE     8       // Pending Tier 2 loads
+#define PREFETCH_FALLBACK_COUNT 3       // Runners-up queued by discovery
+
+// Tier 1 spatial grid: one cell per spatial tile at this level
+// (level 3 = 16×32 tiles of 11.25°, so a 255km service circle spans few cells)
+#define TIER1_GRID_LEVEL     3
+#define TIER1_GRID_LAT_CELLS (2 << TIER1_GRID_LEVEL)
+#define TIER1_GRID_LON_CELLS (4 << TIER1_GRID_LEVEL)
+#define TIER1_GRID_CELLS     (TIER1_GRID_LAT_CELLS * TIER1_GRID_LON_CELLS)
+
+// Tier 1 slots share the service index width; a discovery index may hold at
+// most TIER1_MAX_SERVICES entries so every slot stays below the sentinel
+typedef ntrip_service_idx_t tier1_slot_t;
+#define TIER1_INVALID_SLOT    NTRIP_SERVICE_INDEX_INVALID
+#define TIER1_MAX_SERVICES    ((size_t)NTRIP_SERVICE_INDEX_INVALID)
+
+// Service index -> Tier 1 slot table: direct over [0, highest index], unless
+// indices are so sparse the table would dwarf the index (linear scan instead)
+#define TIER1_SLOT_MAP_MIN    256     // Always worth a direct table up to this size
+#define TIER1_SLOT_MAP_SPARSE 4       // Table entries allowed per Tier 1 service
+
+// Largest Tier 2/3 cache, and the empty marker in its slot map
+#define TIERED_CACHE_MAX_SLOTS 256
+#define TIERED_CACHE_NO_SLOT   0xFFFF
+
+#define EARTH_RADIUS_KM       6371.0
+
+// Widens each circle's cell range to absorb floating-point rounding at cell edges
+#define TIER1_GRID_MARGIN_DEG 0.01
+
+/**
+ * Grid over Tier 1 coverage circles, built once when the index loads.
+ * Compressed rows: cell c holds slots cell_slots[cell_offsets[c]..cell_offsets[c+1]).
+ */
 typedef struct {
-    uint8_t service_index;
-    ntrip_service_endpoints_t endpoints;
-    uint32_t last_access_time;
-    bool valid;
-} endpoint_cache_entry_t;
+    uint32_t* cell_offsets;      // TIER1_GRID_CELLS + 1 entries
+    tier1_slot_t* cell_slots;    // Discovery index slots, grouped by cell
+    size_t assignment_count;
+    void* allocation;            // Single block holding both arrays
+} tier1_grid_t;
 
-// Cache entry structure for metadata
+/**
+ * Byte-budgeted cache of fixed-size payloads keyed by service index
+ *
+ * Eviction is CLOCK (second chance): hits set the referenced bit, and the
+ * hand clears bits as it sweeps until it finds an unreferenced victim.
+ * Borrowed slots are pinned and never evicted. Slot storage is allocated
+ * on first use and released by trimming once nothing is borrowed.
+ *
+ * Lookups go through an open-addressed table (linear probing, at most half
+ * full) from service index to slot. It is sized by capacity rather than by
+ * the index range, so it stays small with 16- and 32-bit service indices.
+ */
 typedef struct {
-    uint8_t service_index;
-    ntrip_service_metadata_t metadata;
-    uint32_t last_access_time;
-    bool valid;
-} metadata_cache_entry_t;
+    size_t payload_size;
+    size_t capacity;             // Slots, derived from the byte budget at init
+    size_t entries;
+    size_t hand;                 // CLOCK hand
+    uint8_t* payloads;           // capacity × payload_size
+    ntrip_service_idx_t* service_indices; // Service held by each slot
+    uint16_t* buckets;           // Open-addressed service index -> slot map
+    size_t bucket_mask;          // Bucket count - 1 (a power of two)
+    uint8_t* flags;              // CACHE_SLOT_* per slot
+    uint8_t* pins;               // Outstanding borrows per slot
+    size_t pinned_slots;
+    uint32_t epoch;              // Bumped when storage is freed; stale borrows are ignored
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+} tiered_cache_t;
 
 // Global tiered loading state
 static struct {
     // Current loading mode
     ntrip_loading_mode_t loading_mode;
 
-    // Platform interface for data loading
-    ntrip_tiered_platform_t platform;
+    // Platform interface for data loading
+    ntrip_tiered_platform_t platform;
+
+    // Tier 1: Discovery index (always loaded)
+    ntrip_service_index_t* discovery_index;
+    size_t service_count;
+
+    // Tier 1 lookup structures (built from the discovery index at load time)
+    tier1_grid_t grid;
+    tier1_slot_t* slot_by_service_index; // NULL = linear scan
+    size_t slot_map_size;
+
+    // Tier 2: Endpoints cache
+    tiered_cache_t endpoint_cache;
+
+    // Tier 2: Prefetch queue (FIFO of service indices awaiting a cooperative load)
+    ntrip_service_idx_t prefetch_queue[PREFETCH_QUEUE_SIZE];
+    size_t prefetch_head;
+    size_t prefetch_count;
+
+    // Tier 3: Metadata cache
+    tiered_cache_t metadata_cache;
+
+    // Workspace holding the tables above (NULL = heap), from workspace_mark up
+    ntrip_atlas_workspace_t* workspace;
+    size_t workspace_mark;
+
+    bool initialized;
+} g_tiered_state = {0};
+
+/**
+ * Allocate zeroed long-lived storage from the workspace, or the heap
+ */
+static void* tiered_alloc(size_t bytes) {
+    if (g_tiered_state.workspace) {
+        return ntrip_atlas_workspace_alloc(g_tiered_state.workspace, bytes);
+    }
+#ifdef NTRIP_ATLAS_STATIC_ALLOCATION
+    return NULL;
+#else
+    return calloc(1, bytes);
+#endif
+}
+
+/**
+ * Free storage from tiered_alloc() (workspace storage is reclaimed at re-init)
+ */
+static void tiered_free(void* ptr) {
+#ifndef NTRIP_ATLAS_STATIC_ALLOCATION
+    if (!g_tiered_state.workspace) {
+        free(ptr);
+    }
+#else
+    (void)ptr;
+#endif
+}
+
+/**
+ * Free slot storage unconditionally, invalidating any outstanding borrows
+ */
+static void tiered_cache_destroy(tiered_cache_t* cache) {
+    tiered_free(cache->payloads);
+    cache->payloads = NULL;
+    cache->service_indices = NULL;
+    cache->buckets = NULL;
+    cache->flags = NULL;
+    cache->pins = NULL;
+    cache->pinned_slots = 0;
+    cache->entries = 0;
+    cache->hand = 0;
+    cache->epoch++;
+}
+
+/**
+ * Slots that fit a byte budget
+ */
+static size_t tiered_cache_capacity(size_t payload_size, size_t budget_bytes) {
+    // Per-slot cost: payload plus service index and flags
+    size_t capacity = budget_bytes / (payload_size + sizeof(ntrip_service_idx_t) + 1);
+    if (capacity < 1) capacity = 1;
+    if (capacity > TIERED_CACHE_MAX_SLOTS) capacity = TIERED_CACHE_MAX_SLOTS;
+    return capacity;
+}
+
+/**
+ * Offset of the service index array within a cache's storage block
+ * (right after the payloads, rounded up so it is aligned for any payload size)
+ */
+static size_t tiered_cache_index_offset(size_t capacity, size_t payload_size) {
+    size_t payload_bytes = capacity * payload_size;
+    return (payload_bytes + sizeof(ntrip_service_idx_t) - 1) /
+           sizeof(ntrip_service_idx_t) * sizeof(ntrip_service_idx_t);
+}
+
+/**
+ * Buckets in a cache's slot map: a power of two at least twice the capacity
+ */
+static size_t tiered_cache_bucket_count(size_t capacity) {
+    size_t buckets = 2;
+    while (buckets < 2 * capacity) {
+        buckets <<= 1;
+    }
+    return buckets;
+}
+
+/**
+ * Offset of the slot map within a cache's storage block
+ */
+static size_t tiered_cache_bucket_offset(size_t capacity, size_t payload_size) {
+    size_t index_end = tiered_cache_index_offset(capacity, payload_size) +
+                       capacity * sizeof(ntrip_service_idx_t);
+    return (index_end + sizeof(uint16_t) - 1) / sizeof(uint16_t) * sizeof(uint16_t);
+}
+
+/**
+ * Size of a cache's storage block: payloads, service indices, slot map,
+ * flags and pins
+ */
+static size_t tiered_cache_block_bytes(size_t capacity, size_t payload_size) {
+    return tiered_cache_bucket_offset(capacity, payload_size) +
+           tiered_cache_bucket_count(capacity) * sizeof(uint16_t) + capacity * 2;
+}
+
+/**
+ * Home bucket of a service index (Fibonacci hashing)
+ */
+static size_t tiered_cache_home(const tiered_cache_t* cache, ntrip_service_idx_t service_index) {
+    return (size_t)(((uint32_t)service_index * 2654435761u) >> 16) & cache->bucket_mask;
+}
+
+/**
+ * Add a slot to the map under its service index
+ */
+static void tiered_cache_map(tiered_cache_t* cache, uint16_t slot) {
+    size_t bucket = tiered_cache_home(cache, cache->service_indices[slot]);
+    while (cache->buckets[bucket] != TIERED_CACHE_NO_SLOT) {
+        bucket = (bucket + 1) & cache->bucket_mask;
+    }
+    cache->buckets[bucket] = slot;
+}
+
+/**
+ * Remove a slot from the map, shifting later probes back over the hole so
+ * lookups never need tombstones
+ */
+static void tiered_cache_unmap(tiered_cache_t* cache, uint16_t slot) {
+    size_t hole = tiered_cache_home(cache, cache->service_indices[slot]);
+    while (cache->buckets[hole] != slot) {
+        hole = (hole + 1) & cache->bucket_mask;
+    }
+    cache->buckets[hole] = TIERED_CACHE_NO_SLOT;
+
+    for (size_t bucket = (hole + 1) & cache->bucket_mask;
+         cache->buckets[bucket] != TIERED_CACHE_NO_SLOT;
+         bucket = (bucket + 1) & cache->bucket_mask) {
+        // An entry may fill the hole if the hole lies between its home and here
+        size_t home = tiered_cache_home(cache, cache->service_indices[cache->buckets[bucket]]);
+        if (((bucket - home) & cache->bucket_mask) >= ((bucket - hole) & cache->bucket_mask)) {
+            cache->buckets[hole] = cache->buckets[bucket];
+            cache->buckets[bucket] = TIERED_CACHE_NO_SLOT;
+            hole = bucket;
+        }
+    }
+}
+
+/**
+ * Configure an empty cache for a byte budget (storage is allocated lazily)
+ */
+static void tiered_cache_configure(tiered_cache_t* cache, size_t payload_size, size_t budget_bytes) {
+    tiered_cache_destroy(cache);
+
+    uint32_t epoch = cache->epoch;
+    memset(cache, 0, sizeof(*cache));
+    cache->epoch = epoch;
+    cache->payload_size = payload_size;
+
+    cache->capacity = tiered_cache_capacity(payload_size, budget_bytes);
+}
+
+/**
+ * Drop all entries and release slot storage (capacity and counters are kept)
+ *
+ * Borrowed records must stay where they are, so while any slot is pinned
+ * only the unpinned entries are dropped and storage is kept.
+ */
+static void tiered_cache_release(tiered_cache_t* cache) {
+    if (cache->pinned_slots == 0 && !g_tiered_state.workspace) {
+        tiered_cache_destroy(cache);
+        return;
+    }
+    if (!cache->payloads) {
+        return;
+    }
+
+    for (size_t slot = 0; slot < cache->capacity; slot++) {
+        if ((cache->flags[slot] & CACHE_SLOT_VALID) && cache->pins[slot] == 0) {
+            tiered_cache_unmap(cache, (uint16_t)slot);
+            cache->flags[slot] = 0;
+            cache->entries--;
+        }
+    }
+}
+
+/**
+ * Find the slot holding a service (TIERED_CACHE_NO_SLOT if not cached)
+ */
+static uint16_t tiered_cache_find(const tiered_cache_t* cache, ntrip_service_idx_t service_index) {
+    if (!cache->payloads) {
+        return TIERED_CACHE_NO_SLOT;
+    }
+    for (size_t bucket = tiered_cache_home(cache, service_index);
+         cache->buckets[bucket] != TIERED_CACHE_NO_SLOT;
+         bucket = (bucket + 1) & cache->bucket_mask) {
+        if (cache->service_indices[cache->buckets[bucket]] == service_index) {
+            return cache->buckets[bucket];
+        }
+    }
+    return TIERED_CACHE_NO_SLOT;
+}
+
+/**
+ * Find a cached payload without touching its referenced bit or counters
+ */
+static const void* tiered_cache_peek(const tiered_cache_t* cache, ntrip_service_idx_t service_index) {
+    uint16_t slot = tiered_cache_find(cache, service_index);
+    if (slot == TIERED_CACHE_NO_SLOT) {
+        return NULL;
+    }
+    return cache->payloads + (size_t)slot * cache->payload_size;
+}
+
+/**
+ * Payload storage of a slot
+ */
+static void* tiered_cache_payload(const tiered_cache_t* cache, uint16_t slot) {
+    return cache->payloads + (size_t)slot * cache->payload_size;
+}
+
+/**
+ * Allocate slot storage for a configured cache
+ */
+static ntrip_atlas_error_t tiered_cache_allocate(tiered_cache_t* cache) {
+    size_t index_offset = tiered_cache_index_offset(cache->capacity, cache->payload_size);
+    size_t bucket_offset = tiered_cache_bucket_offset(cache->capacity, cache->payload_size);
+    size_t bucket_count = tiered_cache_bucket_count(cache->capacity);
+    uint8_t* block = tiered_alloc(tiered_cache_block_bytes(cache->capacity, cache->payload_size));
+    if (!block) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    cache->payloads = block;
+    cache->service_indices = (ntrip_service_idx_t*)(block + index_offset);
+    cache->buckets = (uint16_t*)(block + bucket_offset);
+    cache->bucket_mask = bucket_count - 1;
+    cache->flags = block + bucket_offset + bucket_count * sizeof(uint16_t);
+    cache->pins = cache->flags + cache->capacity;
+
+    for (size_t bucket = 0; bucket < bucket_count; bucket++) {
+        cache->buckets[bucket] = TIERED_CACHE_NO_SLOT;
+    }
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Reserve a slot for a new entry, evicting with CLOCK when full
+ *
+ * The slot is not visible in the map until tiered_cache_commit(), so the
+ * platform loader can write straight into it.
+ */
+static ntrip_atlas_error_t tiered_cache_reserve(tiered_cache_t* cache, uint16_t* slot_out) {
+    if (!cache->payloads) {
+        ntrip_atlas_error_t result = tiered_cache_allocate(cache);
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            return result;
+        }
+    }
+
+    // Each pass clears referenced bits, so two passes find a victim unless every slot is pinned
+    for (size_t step = 0; step < 2 * cache->capacity; step++) {
+        size_t candidate = cache->hand;
+        cache->hand = (cache->hand + 1) % cache->capacity;
+
+        uint8_t flags = cache->flags[candidate];
+        if (!(flags & CACHE_SLOT_VALID)) {
+            *slot_out = (uint16_t)candidate;
+            return NTRIP_ATLAS_SUCCESS;
+        }
+        if (cache->pins[candidate]) {
+            continue;
+        }
+        if (flags & CACHE_SLOT_REFERENCED) {
+            cache->flags[candidate] = flags & (uint8_t)~CACHE_SLOT_REFERENCED;
+            continue;
+        }
+
+        tiered_cache_unmap(cache, (uint16_t)candidate);
+        cache->flags[candidate] = 0;
+        cache->entries--;
+        cache->evictions++;
+        *slot_out = (uint16_t)candidate;
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    return NTRIP_ATLAS_ERROR_NO_MEMORY;  // Every slot is borrowed
+}
+
+/**
+ * Publish a reserved slot once its payload has been loaded
+ * @param referenced Enter with the second-chance bit set (false for prefetch)
+ */
+static void tiered_cache_commit(
+    tiered_cache_t* cache,
+    uint16_t slot,
+    ntrip_service_idx_t service_index,
+    bool referenced
+) {
+    cache->service_indices[slot] = service_index;
+    cache->flags[slot] = CACHE_SLOT_VALID | (referenced ? CACHE_SLOT_REFERENCED : 0);
+    cache->entries++;
+    tiered_cache_map(cache, slot);
+}
+
+/**
+ * Range of grid cells (inclusive) touched by a spherical cap
+ */
+typedef struct {
+    uint16_t lat_first, lat_last;
+    uint16_t lon_first, lon_last;   // lon_first > lon_last means wrap across ±180°
+} tier1_cell_range_t;
+
+static void get_cap_cell_range(
+    double lat,
+    double lon,
+    double radius_km,
+    tier1_cell_range_t* range
+) {
+    double radius_angle = radius_km / EARTH_RADIUS_KM;   // radians
+    double lat_span = radius_angle * 180.0 / M_PI + TIER1_GRID_MARGIN_DEG;
+
+    double lat_min = lat - lat_span;
+    double lat_max = lat + lat_span;
+    if (lat_min < -90.0) lat_min = -90.0;
+    if (lat_max > 90.0) lat_max = 90.0;
+
+    // Exact longitude half-width of a spherical cap: sin(dlon) = sin(r) / cos(lat).
+    // Caps reaching a pole cover every longitude.
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    // asin(s / c) = atan2(s, sqrt(c^2 - s^2)), all in Q30
+    double lon_span = 360.0;
+    if (radius_angle < M_PI / 2.0) {
+        int32_t sin_radius, cos_lat;
+        ntrip_atlas_fixed_sin_cos((int32_t)(radius_km * NTRIP_ATLAS_MICRODEG_PER_KM), &sin_radius, NULL);
+        ntrip_atlas_fixed_sin_cos(NTRIP_ATLAS_DEG_TO_MICRODEG(lat), NULL, &cos_lat);
+        if (sin_radius < cos_lat) {
+            uint64_t adjacent_sq = (uint64_t)((int64_t)cos_lat * cos_lat - (int64_t)sin_radius * sin_radius);
+            int32_t span_bam = ntrip_atlas_fixed_atan2(sin_radius, ntrip_atlas_fixed_isqrt64(adjacent_sq));
+            lon_span = span_bam * (360.0 / 4294967296.0) + TIER1_GRID_MARGIN_DEG;
+        }
+    }
+#else
+    double sin_radius = sin(radius_angle);
+    double cos_lat = cos(lat * M_PI / 180.0);
+    double lon_span = 360.0;
+    if (radius_angle < M_PI / 2.0 && sin_radius < cos_lat) {
+        lon_span = asin(sin_radius / cos_lat) * 180.0 / M_PI + TIER1_GRID_MARGIN_DEG;
+    }
+#endif
+
+    uint16_t tile_lat, tile_lon;
+    ntrip_atlas_lat_lon_to_tile(lat_min, 0.0, TIER1_GRID_LEVEL, &tile_lat, &tile_lon);
+    range->lat_first = tile_lat;
+    ntrip_atlas_lat_lon_to_tile(lat_max, 0.0, TIER1_GRID_LEVEL, &tile_lat, &tile_lon);
+    range->lat_last = tile_lat;
+
+    if (lon_span >= 180.0) {
+        range->lon_first = 0;
+        range->lon_last = TIER1_GRID_LON_CELLS - 1;
+        return;
+    }
+
+    // ±180° is the same meridian, so touching it wraps into the far edge cell
+    double lon_min = lon - lon_span;
+    double lon_max = lon + lon_span;
+    if (lon_min <= -180.0) lon_min += 360.0;
+    if (lon_max >= 180.0) lon_max -= 360.0;
+
+    ntrip_atlas_lat_lon_to_tile(0.0, lon_min, TIER1_GRID_LEVEL, &tile_lat, &tile_lon);
+    range->lon_first = tile_lon;
+    ntrip_atlas_lat_lon_to_tile(0.0, lon_max, TIER1_GRID_LEVEL, &tile_lat, &tile_lon);
+    range->lon_last = tile_lon;
+}
+
+/**
+ * Range of grid cells touched by a Tier 1 service's coverage circle
+ */
+static void get_tier1_service_cell_range(const ntrip_service_index_t* service, tier1_cell_range_t* range) {
+    get_cap_cell_range(service->lat_center_deg100 / 100.0,
+                       service->lon_center_deg100 / 100.0,
+                       service->radius_km, range);
+}
+
+/**
+ * Visit every cell in a range, handling longitude wrap
+ */
+#define FOR_EACH_RANGE_CELL(range, cell, body)                                        \
+    for (uint16_t lat_cell_ = (range).lat_first; lat_cell_ <= (range).lat_last; lat_cell_++) { \
+        uint16_t lon_cell_ = (range).lon_first;                                       \
+        for (;;) {                                                                    \
+            size_t cell = (size_t)lat_cell_ * TIER1_GRID_LON_CELLS + lon_cell_;       \
+            body                                                                      \
+            if (lon_cell_ == (range).lon_last) break;                                 \
+            lon_cell_ = (uint16_t)((lon_cell_ + 1) % TIER1_GRID_LON_CELLS);           \
+        }                                                                             \
+    }
+
+/**
+ * Release the Tier 1 grid
+ */
+static void free_tier1_grid(void) {
+    tiered_free(g_tiered_state.grid.allocation);
+    memset(&g_tiered_state.grid, 0, sizeof(g_tiered_state.grid));
+}
+
+/**
+ * Release the service-index-to-slot table
+ */
+static void free_tier1_slot_map(void) {
+    tiered_free(g_tiered_state.slot_by_service_index);
+    g_tiered_state.slot_by_service_index = NULL;
+    g_tiered_state.slot_map_size = 0;
+}
+
+/**
+ * Entries in the service-index-to-slot table (0 = too sparse, scan instead)
+ */
+static size_t tier1_slot_map_size(const ntrip_service_index_t* index, size_t service_count) {
+    size_t map_size = 0;
+    for (size_t slot = 0; slot < service_count; slot++) {
+        size_t service_index = index[slot].service_index;
+        if (service_index >= map_size) map_size = service_index + 1;
+    }
+    if (map_size > TIER1_SLOT_MAP_MIN && map_size / TIER1_SLOT_MAP_SPARSE > service_count) {
+        return 0;
+    }
+    return map_size;
+}
+
+/**
+ * Build the service-index-to-slot table, sized by the highest index in use
+ * Without it (sparse indices or no memory) lookups scan Tier 1 instead.
+ */
+static void build_tier1_slot_map(size_t service_count) {
+    free_tier1_slot_map();
+
+    size_t map_size = tier1_slot_map_size(g_tiered_state.discovery_index, service_count);
+    if (map_size == 0) {
+        return;
+    }
+
+    tier1_slot_t* map = tiered_alloc(map_size * sizeof(tier1_slot_t));
+    if (!map) {
+        return;
+    }
+    for (size_t i = 0; i < map_size; i++) {
+        map[i] = TIER1_INVALID_SLOT;
+    }
+    for (size_t slot = 0; slot < service_count; slot++) {
+        ntrip_service_idx_t service_index = g_tiered_state.discovery_index[slot].service_index;
+        if (map[service_index] == TIER1_INVALID_SLOT) {
+            map[service_index] = (tier1_slot_t)slot;
+        }
+    }
+
+    g_tiered_state.slot_by_service_index = map;
+    g_tiered_state.slot_map_size = map_size;
+}
+
+/**
+ * Build the service-index-to-slot table and the Tier 1 spatial grid
+ *
+ * Counting sort in two passes: count assignments per cell, prefix-sum into
+ * offsets, then fill. If the grid can't be allocated discovery falls back to
+ * a linear scan, so this never fails initialization.
+ */
+static void build_tier1_lookup(void) {
+    free_tier1_grid();
+
+    size_t service_count = g_tiered_state.service_count;
+    build_tier1_slot_map(service_count);
+
+    // Pass 1: count assignments per cell
+    uint32_t counts[TIER1_GRID_CELLS + 1];
+    memset(counts, 0, sizeof(counts));
+
+    size_t assignments = 0;
+    for (size_t slot = 0; slot < service_count; slot++) {
+        tier1_cell_range_t range;
+        get_tier1_service_cell_range(&g_tiered_state.discovery_index[slot], &range);
+        FOR_EACH_RANGE_CELL(range, cell, {
+            counts[cell + 1]++;
+            assignments++;
+        })
+    }
+
+    if (assignments == 0) {
+        return;
+    }
+
+    size_t offsets_bytes = (TIER1_GRID_CELLS + 1) * sizeof(uint32_t);
+    void* block = tiered_alloc(offsets_bytes + assignments * sizeof(tier1_slot_t));
+    if (!block) {
+        return;  // Linear scan fallback
+    }
+
+    tier1_grid_t* grid = &g_tiered_state.grid;
+    grid->allocation = block;
+    grid->cell_offsets = (uint32_t*)block;
+    grid->cell_slots = (tier1_slot_t*)((uint8_t*)block + offsets_bytes);
+    grid->assignment_count = assignments;
+
+    // Prefix sum: counts[c] becomes the write cursor for cell c
+    for (size_t c = 0; c < TIER1_GRID_CELLS; c++) {
+        counts[c + 1] += counts[c];
+    }
+    memcpy(grid->cell_offsets, counts, offsets_bytes);
+
+    // Pass 2: fill cells in slot order
+    for (size_t slot = 0; slot < service_count; slot++) {
+        tier1_cell_range_t range;
+        get_tier1_service_cell_range(&g_tiered_state.discovery_index[slot], &range);
+        FOR_EACH_RANGE_CELL(range, cell, {
+            grid->cell_slots[counts[cell]++] = (tier1_slot_t)slot;
+        })
+    }
+}
+
+/**
+ * Release everything tiered loading holds and attach the current workspace
+ *
+ * Tables built in the previous workspace are reclaimed together by releasing
+ * it back to the mark taken at the previous initialization.
+ */
+static void reset_tiered_storage(void) {
+    free_tier1_grid();
+    free_tier1_slot_map();
+    tiered_cache_destroy(&g_tiered_state.endpoint_cache);
+    tiered_cache_destroy(&g_tiered_state.metadata_cache);
+    g_tiered_state.discovery_index = NULL;
+    g_tiered_state.service_count = 0;
+    g_tiered_state.initialized = false;
+
+    if (g_tiered_state.workspace) {
+        ntrip_atlas_workspace_release(g_tiered_state.workspace, g_tiered_state.workspace_mark);
+    }
+    g_tiered_state.workspace = ntrip_atlas_get_workspace();
+    g_tiered_state.workspace_mark = ntrip_atlas_workspace_mark(g_tiered_state.workspace);
+}
+
+/**
+ * Initialize with tiered data loading for memory optimization
+ */
+ntrip_atlas_error_t ntrip_atlas_init_with_loading_mode(
+    ntrip_loading_mode_t mode,
+    const ntrip_tiered_platform_t* tiered_platform
+) {
+    if (mode == NTRIP_LOADING_TIERED &&
+        (!tiered_platform || !tiered_platform->load_discovery_index)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    g_tiered_state.loading_mode = mode;
+    reset_tiered_storage();
+
+    if (mode == NTRIP_LOADING_TIERED) {
+        // Copy platform interface
+        g_tiered_state.platform = *tiered_platform;
+
+        // Load Tier 1 discovery index
+        ntrip_atlas_error_t result = g_tiered_state.platform.load_discovery_index(
+            &g_tiered_state.discovery_index,
+            &g_tiered_state.service_count,
+            g_tiered_state.platform.platform_data
+        );
+
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            g_tiered_state.discovery_index = NULL;
+            g_tiered_state.service_count = 0;
+            return result;
+        }
+
+        // Every slot must stay below TIER1_INVALID_SLOT
+        if (g_tiered_state.service_count > TIER1_MAX_SERVICES) {
+            reset_tiered_storage();
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
+
+        // Size caches from the byte budgets (0 = compile-time default)
+        tiered_cache_configure(&g_tiered_state.endpoint_cache, sizeof(ntrip_service_endpoints_t),
+            tiered_platform->endpoint_cache_bytes ? tiered_platform->endpoint_cache_bytes
+                                                  : NTRIP_ATLAS_ENDPOINT_CACHE_BYTES);
+        tiered_cache_configure(&g_tiered_state.metadata_cache, sizeof(ntrip_service_metadata_t),
+            tiered_platform->metadata_cache_bytes ? tiered_platform->metadata_cache_bytes
+                                                  : NTRIP_ATLAS_METADATA_CACHE_BYTES);
+
+        // In a workspace, caches are placed up front rather than on first use,
+        // so later scratch can be released without stranding them
+        if (g_tiered_state.workspace) {
+            if (tiered_cache_allocate(&g_tiered_state.endpoint_cache) != NTRIP_ATLAS_SUCCESS ||
+                tiered_cache_allocate(&g_tiered_state.metadata_cache) != NTRIP_ATLAS_SUCCESS) {
+                reset_tiered_storage();
+                return NTRIP_ATLAS_ERROR_NO_MEMORY;
+            }
+        }
+
+        // Build spatial grid and index-to-slot table over Tier 1
+        build_tier1_lookup();
+        g_tiered_state.prefetch_head = 0;
+        g_tiered_state.prefetch_count = 0;
+
+        g_tiered_state.initialized = true;
+
+        return NTRIP_ATLAS_SUCCESS;
+    } else {
+        // Full loading mode - services come from the compiled-in database;
+        // there is no tiered data to load
+        g_tiered_state.initialized = true;
+        return NTRIP_ATLAS_SUCCESS;
+    }
+}
+
+/**
+ * Round a workspace request up to the workspace alignment
+ */
+static size_t workspace_round(size_t bytes) {
+    return (bytes + NTRIP_ATLAS_WORKSPACE_ALIGN - 1) /
+           NTRIP_ATLAS_WORKSPACE_ALIGN * NTRIP_ATLAS_WORKSPACE_ALIGN;
+}
+
+/**
+ * Bytes a workspace needs for a configuration
+ *
+ * Mirrors what initialization places in the workspace: both caches, the
+ * slot map and the grid, plus the loader's own share and sort scratch.
+ */
+size_t ntrip_atlas_workspace_required_bytes(const ntrip_atlas_workspace_config_t* config) {
+    if (!config) {
+        return 0;
+    }
+
+    size_t total = workspace_round(config->loader_bytes) +
+                   workspace_round(config->max_sort_services * NTRIP_ATLAS_SORT_KEY_BYTES);
+
+    if (config->discovery_index) {
+        size_t endpoint_capacity = tiered_cache_capacity(sizeof(ntrip_service_endpoints_t),
+            config->endpoint_cache_bytes ? config->endpoint_cache_bytes
+                                         : NTRIP_ATLAS_ENDPOINT_CACHE_BYTES);
+        size_t metadata_capacity = tiered_cache_capacity(sizeof(ntrip_service_metadata_t),
+            config->metadata_cache_bytes ? config->metadata_cache_bytes
+                                         : NTRIP_ATLAS_METADATA_CACHE_BYTES);
+        total += workspace_round(tiered_cache_block_bytes(endpoint_capacity,
+                                                          sizeof(ntrip_service_endpoints_t)));
+        total += workspace_round(tiered_cache_block_bytes(metadata_capacity,
+                                                          sizeof(ntrip_service_metadata_t)));
+
+        size_t service_count = config->discovery_count;
+        if (service_count > TIER1_MAX_SERVICES) {
+            return 0;  // Initialization would reject this index
+        }
+
+        size_t map_size = tier1_slot_map_size(config->discovery_index, service_count);
+        if (map_size > 0) {
+            total += workspace_round(map_size * sizeof(tier1_slot_t));
+        }
+
+        size_t assignments = 0;
+        for (size_t slot = 0; slot < service_count; slot++) {
+            tier1_cell_range_t range;
+            get_tier1_service_cell_range(&config->discovery_index[slot], &range);
+            FOR_EACH_RANGE_CELL(range, cell, {
+                (void)cell;
+                assignments++;
+            })
+        }
+        if (assignments > 0) {
+            total += workspace_round((TIER1_GRID_CELLS + 1) * sizeof(uint32_t) +
+                                     assignments * sizeof(tier1_slot_t));
+        }
+    }
+
+    return total;
+}
+
+/**
+ * Calculate distance between two coordinates using haversine formula
+ */
+static double calculate_distance_km(double lat1, double lon1, double lat2, double lon2) {
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    return ntrip_atlas_fixed_distance_m(NTRIP_ATLAS_DEG_TO_MICRODEG(lat1), NTRIP_ATLAS_DEG_TO_MICRODEG(lon1),
+                                        NTRIP_ATLAS_DEG_TO_MICRODEG(lat2), NTRIP_ATLAS_DEG_TO_MICRODEG(lon2)) / 1000.0;
+#else
+    const double R = 6371.0; // Earth's radius in km
+
+    double lat1_rad = lat1 * M_PI / 180.0;
+    double lat2_rad = lat2 * M_PI / 180.0;
+    double delta_lat = (lat2 - lat1) * M_PI / 180.0;
+    double delta_lon = (lon2 - lon1) * M_PI / 180.0;
+
+    double a = sin(delta_lat/2) * sin(delta_lat/2) +
+               cos(lat1_rad) * cos(lat2_rad) *
+               sin(delta_lon/2) * sin(delta_lon/2);
+    double c = 2 * atan2(sqrt(a), sqrt(1-a));
+
+    return R * c;
+#endif
+}
+
+/**
+ * Look up a service's Tier 1 record by service index (O(1) with the slot map)
+ */
+static const ntrip_service_index_t* find_tier1_service(ntrip_service_idx_t service_index) {
+    if (!g_tiered_state.slot_by_service_index) {
+        for (size_t slot = 0; slot < g_tiered_state.service_count; slot++) {
+            if (g_tiered_state.discovery_index[slot].service_index == service_index) {
+                return &g_tiered_state.discovery_index[slot];
+            }
+        }
+        return NULL;
+    }
+
+    if (service_index >= g_tiered_state.slot_map_size) {
+        return NULL;
+    }
+    tier1_slot_t slot = g_tiered_state.slot_by_service_index[service_index];
+    if (slot == TIER1_INVALID_SLOT || slot >= g_tiered_state.service_count) {
+        return NULL;
+    }
+    return &g_tiered_state.discovery_index[slot];
+}
+
+/**
+ * Check if a service is already waiting in the prefetch queue
+ */
+static bool is_prefetch_queued(ntrip_service_idx_t service_index) {
+    for (size_t i = 0; i < g_tiered_state.prefetch_count; i++) {
+        size_t pos = (g_tiered_state.prefetch_head + i) % PREFETCH_QUEUE_SIZE;
+        if (g_tiered_state.prefetch_queue[pos] == service_index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Queue a service for prefetch (no loading happens here)
+ * @return true if newly queued
+ */
+static bool enqueue_prefetch(ntrip_service_idx_t service_index) {
+    if (g_tiered_state.prefetch_count >= PREFETCH_QUEUE_SIZE ||
+        !find_tier1_service(service_index) ||
+        tiered_cache_peek(&g_tiered_state.endpoint_cache, service_index) ||
+        is_prefetch_queued(service_index)) {
+        return false;
+    }
+
+    size_t tail = (g_tiered_state.prefetch_head + g_tiered_state.prefetch_count) % PREFETCH_QUEUE_SIZE;
+    g_tiered_state.prefetch_queue[tail] = service_index;
+    g_tiered_state.prefetch_count++;
+    return true;
+}
+
+/**
+ * Score a Tier 1 service for a user at the given distance (0.0 - 1.0)
+ */
+static double score_tier1_service(const ntrip_service_index_t* service, double distance) {
+    // Calculate suitability score
+    double distance_score = (service->radius_km > 0) ?
+        (1.0 - (distance / service->radius_km)) : 1.0;
+    double quality_score = (double)service->quality_rating / 5.0;
+
+    // Prefer government networks, then commercial, then community
+    double network_score = 1.0;
+    switch (service->network_type) {
+        case NTRIP_NETWORK_GOVERNMENT: network_score = 1.0; break;
+        case NTRIP_NETWORK_COMMERCIAL: network_score = 0.8; break;
+        case NTRIP_NETWORK_COMMUNITY: network_score = 0.6; break;
+    }
+
+    // Combined score (distance 40%, quality 30%, network type 20%, auth 10%)
+    double auth_score = (service->auth_method == NTRIP_AUTH_NONE) ? 1.0 : 0.9;
+    return distance_score * 0.4 + quality_score * 0.3 +
+           network_score * 0.2 + auth_score * 0.1;
+}
+
+/**
+ * Best covering services seen so far, best first
+ */
+typedef struct {
+    size_t slot[1 + PREFETCH_FALLBACK_COUNT];
+    double score[1 + PREFETCH_FALLBACK_COUNT];
+    double distance[1 + PREFETCH_FALLBACK_COUNT];
+    size_t count;
+} tier1_ranking_t;
+
+/**
+ * Check if candidate a ranks ahead of b (ties: nearer, then lower slot)
+ */
+static bool tier1_ranks_ahead(double score_a, double distance_a, size_t slot_a,
+                              double score_b, double distance_b, size_t slot_b) {
+    if (score_a != score_b) return score_a > score_b;
+    if (distance_a != distance_b) return distance_a < distance_b;
+    return slot_a < slot_b;
+}
+
+/**
+ * Consider one Tier 1 slot as a candidate, keeping the top entries ranked
+ */
+static void consider_tier1_slot(
+    size_t slot,
+    double user_lat,
+    double user_lon,
+    tier1_ranking_t* ranking
+) {
+    const ntrip_service_index_t* service = &g_tiered_state.discovery_index[slot];
+
+    // Calculate distance from service center
+    double service_lat = (double)service->lat_center_deg100 / 100.0;
+    double service_lon = (double)service->lon_center_deg100 / 100.0;
+    double distance = calculate_distance_km(user_lat, user_lon, service_lat, service_lon);
+
+    // Check if user is within service coverage radius
+    if (distance > service->radius_km) {
+        return; // Outside coverage area
+    }
+
+    double score = score_tier1_service(service, distance);
+
+    // Insertion into the short ranked list
+    const size_t capacity = 1 + PREFETCH_FALLBACK_COUNT;
+    size_t pos = ranking->count;
+    while (pos > 0 && tier1_ranks_ahead(score, distance, slot,
+                                        ranking->score[pos - 1], ranking->distance[pos - 1],
+                                        ranking->slot[pos - 1])) {
+        pos--;
+    }
+    if (pos >= capacity) {
+        return;
+    }
+
+    size_t last = (ranking->count < capacity) ? ranking->count : capacity - 1;
+    for (size_t i = last; i > pos; i--) {
+        ranking->slot[i] = ranking->slot[i - 1];
+        ranking->score[i] = ranking->score[i - 1];
+        ranking->distance[i] = ranking->distance[i - 1];
+    }
+    ranking->slot[pos] = slot;
+    ranking->score[pos] = score;
+    ranking->distance[pos] = distance;
+    if (ranking->count < capacity) {
+        ranking->count++;
+    }
+}
+
+/**
+ * Fast discovery using only Tier 1 data (discovery index)
+ *
+ * Only services registered in the user's grid cell are scored; the linear
+ * scan remains as a fallback when the grid could not be built. The
+ * runners-up are queued for prefetch but not loaded here.
+ */
+ntrip_atlas_error_t ntrip_atlas_find_best_tiered(
+    ntrip_best_service_t* result,
+    double user_lat,
+    double user_lon
+) {
+    if (!g_tiered_state.initialized || !result) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    if (!g_tiered_state.discovery_index) {
+        return NTRIP_ATLAS_ERROR_NO_DISCOVERY_INDEX;
+    }
+
+    // Rank services using only Tier 1 data
+    tier1_ranking_t ranking;
+    ranking.count = 0;
+
+    const tier1_grid_t* grid = &g_tiered_state.grid;
+    uint16_t tile_lat, tile_lon;
+
+    if (grid->cell_offsets &&
+        ntrip_atlas_lat_lon_to_tile(user_lat, user_lon, TIER1_GRID_LEVEL,
+                                    &tile_lat, &tile_lon) == NTRIP_ATLAS_SUCCESS) {
+        size_t cell = (size_t)tile_lat * TIER1_GRID_LON_CELLS + tile_lon;
+        for (uint32_t i = grid->cell_offsets[cell]; i < grid->cell_offsets[cell + 1]; i++) {
+            consider_tier1_slot(grid->cell_slots[i], user_lat, user_lon,
+                                &ranking);
+        }
+    } else {
+        for (size_t i = 0; i < g_tiered_state.service_count; i++) {
+            consider_tier1_slot(i, user_lat, user_lon,
+                                &ranking);
+        }
+    }
+
+    if (ranking.count == 0) {
+        return NTRIP_ATLAS_ERROR_NO_SERVICES;
+    }
+
+    const ntrip_service_index_t* selected_service = &g_tiered_state.discovery_index[ranking.slot[0]];
+
+    // Load endpoints for selected service
+    ntrip_service_endpoints_t endpoints;
+    ntrip_atlas_error_t load_result = ntrip_atlas_load_service_endpoints(
+        selected_service->service_index, &endpoints
+    );
+
+    if (load_result != NTRIP_ATLAS_SUCCESS) {
+        return load_result;
+    }
+
+    // Queue runners-up so failover finds their endpoints already cached
+    for (size_t i = 1; i < ranking.count; i++) {
+        enqueue_prefetch(g_tiered_state.discovery_index[ranking.slot[i]].service_index);
+    }
+
+    // Fill result structure with Tier 1 and Tier 2 data
+    memset(result, 0, sizeof(*result));
+    strncpy(result->server, endpoints.hostname, sizeof(result->server) - 1);
+    result->ssl = selected_service->ssl_available;
+    result->port = (result->ssl && endpoints.ssl_port) ? endpoints.ssl_port : endpoints.port;
+    result->distance_km = ranking.distance[0];
+    result->quality_score = (uint8_t)(ranking.score[0] * 100);
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Discovery straight from a packed discovery index
+ *
+ * Records are sorted by latitude and no coverage radius exceeds 255 km, so
+ * the scan skips records south of the user's band and stops past it. Only
+ * covering records have their attributes decoded for scoring.
+ */
+ntrip_atlas_error_t ntrip_atlas_find_best_packed(
+    const uint8_t* packed,
+    size_t packed_size,
+    double user_lat,
+    double user_lon,
+    ntrip_service_index_t* best,
+    double* distance_km
+) {
+    if (!packed || !best) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    ntrip_packed_index_cursor_t cursor;
+    ntrip_atlas_error_t result = ntrip_atlas_packed_index_begin(packed, packed_size, &cursor);
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        return result;
+    }
+
+    // Meridian distance never exceeds great-circle distance
+    const double band_deg100 = (255.0 / EARTH_RADIUS_KM) * (180.0 / M_PI) * 100.0 + 1.0;
+    double user_lat_deg100 = user_lat * 100.0;
+
+    bool found = false;
+    double best_score = 0.0, best_distance = 0.0;
+
+    while ((result = ntrip_atlas_packed_index_next(&cursor)) == NTRIP_ATLAS_SUCCESS) {
+        if (cursor.lat_center_deg100 < user_lat_deg100 - band_deg100) {
+            continue;
+        }
+        if (cursor.lat_center_deg100 > user_lat_deg100 + band_deg100) {
+            break;
+        }
+
+        double distance = calculate_distance_km(user_lat, user_lon,
+                                                cursor.lat_center_deg100 / 100.0,
+                                                cursor.lon_center_deg100 / 100.0);
+        if (distance > cursor.radius_km) {
+            continue;
+        }
+
+        ntrip_service_index_t entry;
+        result = ntrip_atlas_packed_index_decode(&cursor, &entry);
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            return result;
+        }
+
+        // Earlier records win exact ties, as lower slots do in the tiered scan
+        double score = score_tier1_service(&entry, distance);
+        if (!found || tier1_ranks_ahead(score, distance, 1, best_score, best_distance, 0)) {
+            *best = entry;
+            best_score = score;
+            best_distance = distance;
+            found = true;
+        }
+    }
+
+    if (result != NTRIP_ATLAS_SUCCESS && result != NTRIP_ATLAS_ERROR_NOT_FOUND) {
+        return result;
+    }
+    if (!found) {
+        return NTRIP_ATLAS_ERROR_NO_SERVICES;
+    }
+
+    if (distance_km) *distance_km = best_distance;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Find a record in its tier's cache, loading it on a miss
+ *
+ * Misses are loaded by the platform straight into a reserved cache slot,
+ * so a record is copied at most once on its way in.
+ * @param count_access Update hit/miss counters (false for prefetch)
+ */
+static ntrip_atlas_error_t acquire_cached_record(
+    tiered_cache_t* cache,
+    ntrip_service_idx_t service_index,
+    bool referenced,
+    bool count_access,
+    uint16_t* slot_out
+) {
+    uint16_t slot = tiered_cache_find(cache, service_index);
+    if (slot != TIERED_CACHE_NO_SLOT) {
+        if (count_access) cache->hits++;
+        if (referenced) cache->flags[slot] |= CACHE_SLOT_REFERENCED;
+        *slot_out = slot;
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    if (count_access) cache->misses++;
+
+    // Only services present in the discovery index can be loaded
+    if (!find_tier1_service(service_index)) {
+        return NTRIP_ATLAS_ERROR_NOT_FOUND;
+    }
+
+    bool endpoints = (cache == &g_tiered_state.endpoint_cache);
+    if (endpoints ? !g_tiered_state.platform.load_service_endpoints
+                  : !g_tiered_state.platform.load_service_metadata) {
+        return NTRIP_ATLAS_ERROR_PLATFORM;
+    }
+
+    ntrip_atlas_error_t result = tiered_cache_reserve(cache, &slot);
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        return result;
+    }
+
+    void* payload = tiered_cache_payload(cache, slot);
+    if (endpoints) {
+        result = g_tiered_state.platform.load_service_endpoints(
+            service_index, (ntrip_service_endpoints_t*)payload, g_tiered_state.platform.platform_data);
+    } else {
+        result = g_tiered_state.platform.load_service_metadata(
+            service_index, (ntrip_service_metadata_t*)payload, g_tiered_state.platform.platform_data);
+    }
+
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        return result;  // Reserved slot stays free
+    }
+
+    tiered_cache_commit(cache, slot, service_index, referenced);
+    *slot_out = slot;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Copy a record out of its cache, bypassing the cache if no slot is free
+ */
+static ntrip_atlas_error_t load_cached_record(
+    tiered_cache_t* cache,
+    ntrip_service_idx_t service_index,
+    void* record
+) {
+    if (!g_tiered_state.initialized || !record) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    if (g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    uint16_t slot;
+    ntrip_atlas_error_t result = acquire_cached_record(cache, service_index, true, true, &slot);
+    if (result == NTRIP_ATLAS_SUCCESS) {
+        memcpy(record, tiered_cache_payload(cache, slot), cache->payload_size);
+        return NTRIP_ATLAS_SUCCESS;
+    }
+
+    // Caching is best effort - with every slot borrowed, load directly
+    if (result == NTRIP_ATLAS_ERROR_NO_MEMORY) {
+        void* platform_data = g_tiered_state.platform.platform_data;
+        if (cache == &g_tiered_state.endpoint_cache) {
+            return g_tiered_state.platform.load_service_endpoints(
+                service_index, (ntrip_service_endpoints_t*)record, platform_data);
+        }
+        return g_tiered_state.platform.load_service_metadata(
+            service_index, (ntrip_service_metadata_t*)record, platform_data);
+    }
+
+    return result;
+}
+
+/**
+ * Load service endpoints on demand (Tier 2)
+ */
+ntrip_atlas_error_t ntrip_atlas_load_service_endpoints(
+    ntrip_service_idx_t service_index,
+    ntrip_service_endpoints_t* endpoints
+) {
+    return load_cached_record(&g_tiered_state.endpoint_cache, service_index, endpoints);
+}
+
+/**
+ * Load service metadata on demand (Tier 3)
+ */
+ntrip_atlas_error_t ntrip_atlas_load_service_metadata(
+    ntrip_service_idx_t service_index,
+    ntrip_service_metadata_t* metadata
+) {
+    return load_cached_record(&g_tiered_state.metadata_cache, service_index, metadata);
+}
+
+/**
+ * Pin a cached record and hand out a pointer to it
+ */
+static ntrip_atlas_error_t borrow_cached_record(
+    tiered_cache_t* cache,
+    uint8_t tier,
+    ntrip_service_idx_t service_index,
+    const void** record,
+    ntrip_tiered_borrow_t* borrow
+) {
+    if (!g_tiered_state.initialized || !record || !borrow) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    memset(borrow, 0, sizeof(*borrow));
+    *record = NULL;
+
+    if (g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
+        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+    }
+
+    uint16_t slot;
+    ntrip_atlas_error_t result = acquire_cached_record(cache, service_index, true, true, &slot);
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        return result;
+    }
+
+    if (cache->pins[slot] == UINT8_MAX) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    if (cache->pins[slot]++ == 0) {
+        cache->pinned_slots++;
+    }
+
+    borrow->record = tiered_cache_payload(cache, slot);
+    borrow->epoch = cache->epoch;
+    borrow->slot = slot;
+    borrow->tier = tier;
+    *record = borrow->record;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Borrow cached service endpoints without copying (Tier 2)
+ */
+ntrip_atlas_error_t ntrip_atlas_borrow_service_endpoints(
+    ntrip_service_idx_t service_index,
+    const ntrip_service_endpoints_t** endpoints,
+    ntrip_tiered_borrow_t* borrow
+) {
+    return borrow_cached_record(&g_tiered_state.endpoint_cache, 2, service_index,
+                                (const void**)endpoints, borrow);
+}
+
+/**
+ * Borrow cached service metadata without copying (Tier 3)
+ */
+ntrip_atlas_error_t ntrip_atlas_borrow_service_metadata(
+    ntrip_service_idx_t service_index,
+    const ntrip_service_metadata_t** metadata,
+    ntrip_tiered_borrow_t* borrow
+) {
+    return borrow_cached_record(&g_tiered_state.metadata_cache, 3, service_index,
+                                (const void**)metadata, borrow);
+}
 
-    // Tier 1: Discovery index (always loaded)
-    ntrip_service_index_t* discovery_index;
-    size_t service_count;
+/**
+ * Release a borrowed record, unpinning its cache slot
+ */
+void ntrip_atlas_release_borrow(ntrip_tiered_borrow_t* borrow) {
+    if (!borrow || !borrow->record) {
+        return;
+    }
 
-    // Tier 2: Endpoints cache (LRU)
-    endpoint_cache_entry_t endpoint_cache[ENDPOINT_CACHE_SIZE];
-    uint32_t endpoint_cache_time;
+    tiered_cache_t* cache = (borrow->tier == 2) ? &g_tiered_state.endpoint_cache :
+                            (borrow->tier == 3) ? &g_tiered_state.metadata_cache : NULL;
 
-    // Tier 3: Metadata cache (LRU)
-    metadata_cache_entry_t metadata_cache[METADATA_CACHE_SIZE];
-    uint32_t metadata_cache_time;
+    // Borrows from before a re-initialization no longer own a pin
+    if (cache && borrow->epoch == cache->epoch &&
+        borrow->slot < cache->capacity && cache->pins && cache->pins[borrow->slot] > 0) {
+        if (--cache->pins[borrow->slot] == 0) {
+            cache->pinned_slots--;
+        }
+    }
 
-    bool initialized;
-} g_tiered_state = {0};
+    memset(borrow, 0, sizeof(*borrow));
+}
 
 /**
- * Get current time for cache management (simple counter)
+ * Queue endpoints for services likely to be needed soon
  */
-static uint32_t get_cache_time(void) {
-    return ++g_tiered_state.endpoint_cache_time; // Simple incrementing counter
+size_t ntrip_atlas_prefetch_endpoints(
+    const ntrip_service_idx_t* service_indices,
+    size_t count
+) {
+    if (!g_tiered_state.initialized || !service_indices ||
+        g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
+        return 0;
+    }
+
+    size_t queued = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (enqueue_prefetch(service_indices[i])) {
+            queued++;
+        }
+    }
+    return queued;
 }
 
 /**
- * Initialize with tiered data loading for memory optimization
+ * Queue endpoints for services whose coverage comes near a moving rover
+ *
+ * Walks the grid cells under a cap of radius_km around the position, which
+ * includes neighbouring cells once the rover nears a cell edge. The nearest
+ * coverage edges win when there are more candidates than queue space.
  */
-ntrip_atlas_error_t ntrip_atlas_init_with_loading_mode(
-    ntrip_loading_mode_t mode,
-    const ntrip_tiered_platform_t* tiered_platform
+size_t ntrip_atlas_prefetch_nearby(
+    double user_lat,
+    double user_lon,
+    double radius_km
 ) {
-    g_tiered_state.loading_mode = mode;
+    if (!g_tiered_state.initialized || !g_tiered_state.grid.cell_offsets ||
+        g_tiered_state.loading_mode != NTRIP_LOADING_TIERED ||
+        user_lat < -90.0 || user_lat > 90.0 || user_lon < -180.0 || user_lon > 180.0 ||
+        !(radius_km >= 0.0)) {
+        return 0;
+    }
 
-    if (mode == NTRIP_LOADING_TIERED) {
-        if (!tiered_platform || !tiered_platform->load_discovery_index) {
-            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
-        }
+    size_t space = PREFETCH_QUEUE_SIZE - g_tiered_state.prefetch_count;
+    ntrip_service_idx_t nearest[PREFETCH_QUEUE_SIZE];
+    double nearest_km[PREFETCH_QUEUE_SIZE];
+    size_t nearest_count = 0;
+
+    const tier1_grid_t* grid = &g_tiered_state.grid;
+    tier1_cell_range_t range;
+    get_cap_cell_range(user_lat, user_lon, radius_km, &range);
+
+    FOR_EACH_RANGE_CELL(range, cell, {
+        for (uint32_t i = grid->cell_offsets[cell]; i < grid->cell_offsets[cell + 1]; i++) {
+            const ntrip_service_index_t* service = &g_tiered_state.discovery_index[grid->cell_slots[i]];
+            ntrip_service_idx_t service_index = service->service_index;
+
+            double center_km = calculate_distance_km(user_lat, user_lon,
+                                                     service->lat_center_deg100 / 100.0,
+                                                     service->lon_center_deg100 / 100.0);
+            double edge_km = center_km > service->radius_km ? center_km - service->radius_km : 0.0;
+            if (edge_km > radius_km ||
+                tiered_cache_peek(&g_tiered_state.endpoint_cache, service_index) || is_prefetch_queued(service_index)) {
+                continue;
+            }
 
-        // Copy platform interface
-        g_tiered_state.platform = *tiered_platform;
+            // Services span several cells - skip ones already collected
+            bool duplicate = false;
+            for (size_t j = 0; j < nearest_count; j++) {
+                if (nearest[j] == service_index) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (duplicate) {
+                continue;
+            }
 
-        // Load Tier 1 discovery index
-        ntrip_atlas_error_t result = g_tiered_state.platform.load_discovery_index(
-            &g_tiered_state.discovery_index,
-            &g_tiered_state.service_count,
-            g_tiered_state.platform.platform_data
-        );
+            // Keep the nearest `space` candidates, sorted by edge distance
+            size_t pos = nearest_count;
+            while (pos > 0 && edge_km < nearest_km[pos - 1]) {
+                pos--;
+            }
+            if (pos >= space) {
+                continue;
+            }
+            size_t last = (nearest_count < space) ? nearest_count : space - 1;
+            for (size_t j = last; j > pos; j--) {
+                nearest[j] = nearest[j - 1];
+                nearest_km[j] = nearest_km[j - 1];
+            }
+            nearest[pos] = service_index;
+            nearest_km[pos] = edge_km;
+            if (nearest_count < space) {
+                nearest_count++;
+            }
+        }
+    })
 
-        if (result != NTRIP_ATLAS_SUCCESS) {
-            return result;
+    size_t queued = 0;
+    for (size_t i = 0; i < nearest_count; i++) {
+        if (enqueue_prefetch(nearest[i])) {
+            queued++;
         }
+    }
+    return queued;
+}
 
-        // Initialize caches
-        memset(g_tiered_state.endpoint_cache, 0, sizeof(g_tiered_state.endpoint_cache));
-        memset(g_tiered_state.metadata_cache, 0, sizeof(g_tiered_state.metadata_cache));
-        g_tiered_state.endpoint_cache_time = 0;
-        g_tiered_state.metadata_cache_time = 0;
+/**
+ * Load queued endpoints into the cache (cooperative loader)
+ *
+ * Prefetched entries enter without the CLOCK referenced bit, so warming
+ * the cache replaces unused prefetches before any endpoint that has been
+ * read since the hand last passed it.
+ */
+size_t ntrip_atlas_prefetch_step(size_t max_loads) {
+    if (!g_tiered_state.initialized ||
+        g_tiered_state.loading_mode != NTRIP_LOADING_TIERED ||
+        !g_tiered_state.platform.load_service_endpoints) {
+        return 0;
+    }
 
-        g_tiered_state.initialized = true;
+    size_t loaded = 0;
+    while (loaded < max_loads && g_tiered_state.prefetch_count > 0) {
+        ntrip_service_idx_t service_index = g_tiered_state.prefetch_queue[g_tiered_state.prefetch_head];
+        g_tiered_state.prefetch_head = (g_tiered_state.prefetch_head + 1) % PREFETCH_QUEUE_SIZE;
+        g_tiered_state.prefetch_count--;
 
-        return NTRIP_ATLAS_SUCCESS;
-    } else {
-        // Full loading mode - use traditional initialization
-        // Initialize all services in memory using standard approach
-        g_tiered_state.initialized = true;
-        return ntrip_atlas_init(platform);
+        // May have been loaded on demand since it was queued
+        if (tiered_cache_peek(&g_tiered_state.endpoint_cache, service_index)) {
+            continue;
+        }
+
+        uint16_t slot;
+        ntrip_atlas_error_t result = acquire_cached_record(
+            &g_tiered_state.endpoint_cache, service_index, false, false, &slot);
+        if (result == NTRIP_ATLAS_ERROR_NO_MEMORY) {
+            break;  // No cache slot available - stop warming
+        }
+        if (result != NTRIP_ATLAS_SUCCESS) {
+            continue;  // Dropped; an on-demand load will retry
+        }
+        loaded++;
     }
+
+    return loaded;
 }
 
 /**
- * Calculate distance between two coordinates using haversine formula
+ * Number of services waiting in the prefetch queue
  */
-static double calculate_distance_km(double lat1, double lon1, double lat2, double lon2) {
-    const double R = 6371.0; // Earth's radius in km
+size_t ntrip_atlas_prefetch_pending(void) {
+    return g_tiered_state.initialized ? g_tiered_state.prefetch_count : 0;
+}
 
-    double lat1_rad = lat1 * M_PI / 180.0;
-    double lat2_rad = lat2 * M_PI / 180.0;
-    double delta_lat = (lat2 - lat1) * M_PI / 180.0;
-    double delta_lon = (lon2 - lon1) * M_PI / 180.0;
+/**
+ * Route planning
+ *
+ * Segments are split into short pieces; a point on a piece is the
+ * normalized chord A + t(B - A), t in [0, 1]. Entry and exit of each
+ * coverage circle along a piece are roots of a quadratic in t. Between
+ * those events the covering set is fixed and only the distance term of
+ * the score moves, so the ranking is sampled every ROUTE_SAMPLE_KM and
+ * each change bisected down to ROUTE_HANDOVER_TOLERANCE_KM.
+ *
+ * A piece meeting more than ROUTE_MAX_CANDIDATES circles is halved until
+ * it fits; below ROUTE_MIN_PIECE_KM it keeps the candidates scoring best
+ * at its midpoint instead.
+ */
+#define ROUTE_MAX_PIECE_KM          50.0
+#define ROUTE_MIN_PIECE_KM          1.0
+#define ROUTE_SAMPLE_KM             1.0
+#define ROUTE_HANDOVER_TOLERANCE_KM 0.001
+#define ROUTE_MAX_CANDIDATES        32
+#define ROUTE_MAX_EVENTS            (2 * ROUTE_MAX_CANDIDATES + 2)
+#define ROUTE_LAT_MARGIN_DEG        0.5     // Great-circle bulge of a piece past its endpoints
+#define ROUTE_NO_SLOT               SIZE_MAX
 
-    double a = sin(delta_lat/2) * sin(delta_lat/2) +
-               cos(lat1_rad) * cos(lat2_rad) *
-               sin(delta_lon/2) * sin(delta_lon/2);
-    double c = 2 * atan2(sqrt(a), sqrt(1-a));
+typedef struct {
+    double x, y, z;
+} route_vec_t;
 
-    return R * c;
+typedef struct {
+    route_vec_t a;               // Start (unit vector)
+    route_vec_t d;               // End minus start
+    double length_km;
+    double start_km;             // Distance along the route at the piece start
+    uint16_t segment;
+    tier1_slot_t candidates[ROUTE_MAX_CANDIDATES];
+    double candidate_scores[ROUTE_MAX_CANDIDATES];      // At the midpoint, when capped
+    double candidate_distances[ROUTE_MAX_CANDIDATES];
+    size_t candidate_count;
+    double events[ROUTE_MAX_EVENTS];
+    size_t event_count;
+} route_piece_t;
+
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+// Route algebra stays in double; every transcendental goes through CORDIC
+#define ROUTE_Q30       1073741824.0
+#define ROUTE_ATAN2_Q60 1152921504606846976.0   // Arguments are at most ~1
+
+static route_vec_t route_vec_from_lat_lon(double lat, double lon) {
+    ntrip_unit_vector_t u;
+    ntrip_atlas_fixed_unit_vector(NTRIP_ATLAS_DEG_TO_MICRODEG(lat), NTRIP_ATLAS_DEG_TO_MICRODEG(lon), &u);
+    route_vec_t v = { u.x / ROUTE_Q30, u.y / ROUTE_Q30, u.z / ROUTE_Q30 };
+    return v;
 }
 
 /**
- * Fast discovery using only Tier 1 data (discovery index)
+ * atan2 in radians for arguments of magnitude <= 1
  */
-ntrip_atlas_error_t ntrip_atlas_find_best_tiered(
-    ntrip_best_service_t* result,
-    double user_lat,
-    double user_lon
-) {
-    if (!g_tiered_state.initialized || !result) {
-        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
-    }
+static double route_atan2(double y, double x) {
+    int32_t bam = ntrip_atlas_fixed_atan2((int64_t)(y * ROUTE_ATAN2_Q60), (int64_t)(x * ROUTE_ATAN2_Q60));
+    return bam * (M_PI / 2147483648.0);
+}
 
-    if (g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
-        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+/**
+ * Square root via the integer root, scaled by powers of 4 into [2^60, 2^62)
+ */
+static double route_sqrt(double value) {
+    if (value <= 0.0) {
+        return 0.0;
     }
-
-    if (!g_tiered_state.discovery_index) {
-        return NTRIP_ATLAS_ERROR_NO_DISCOVERY_INDEX;
+    double scale = 1.0;
+    while (value >= 4611686018427387904.0) {   // 2^62
+        value *= 0.25;
+        scale *= 2.0;
+    }
+    while (value < 1152921504606846976.0) {    // 2^60
+        value *= 4.0;
+        scale *= 0.5;
     }
+    return ntrip_atlas_fixed_isqrt64((uint64_t)value) * scale;
+}
 
-    // Find best service using only Tier 1 data
-    uint8_t best_service_index = 255; // Invalid index
-    double best_score = 0.0;
-    double best_distance = 99999.0;
+/**
+ * cos(r) of a coverage radius as 1 - 2 sin^2(r/2), which keeps the small
+ * 1 - cos(r) gap of a few-km circle well above Q30 resolution
+ */
+static double route_cos_radius(double radius_km) {
+    int32_t sin_half;
+    ntrip_atlas_fixed_sin_cos((int32_t)(radius_km * NTRIP_ATLAS_MICRODEG_PER_KM / 2.0), &sin_half, NULL);
+    double s = sin_half / ROUTE_Q30;
+    return 1.0 - 2.0 * s * s;
+}
+#else
+static route_vec_t route_vec_from_lat_lon(double lat, double lon) {
+    double lat_rad = lat * M_PI / 180.0;
+    double lon_rad = lon * M_PI / 180.0;
+    route_vec_t v = { cos(lat_rad) * cos(lon_rad), cos(lat_rad) * sin(lon_rad), sin(lat_rad) };
+    return v;
+}
 
-    for (size_t i = 0; i < g_tiered_state.service_count; i++) {
-        ntrip_service_index_t* service = &g_tiered_state.discovery_index[i];
+#define route_atan2(y, x)           atan2((y), (x))
+#define route_sqrt(value)           sqrt(value)
+#define route_cos_radius(radius_km) cos((radius_km) / EARTH_RADIUS_KM)
+#endif
 
-        // Calculate distance from service center
-        double service_lat = (double)service->lat_center_deg100 / 100.0;
-        double service_lon = (double)service->lon_center_deg100 / 100.0;
-        double distance = calculate_distance_km(user_lat, user_lon, service_lat, service_lon);
+static double route_dot(route_vec_t a, route_vec_t b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
 
-        // Check if user is within service coverage radius
-        if (distance > service->radius_km) {
-            continue; // Outside coverage area
-        }
+/**
+ * Unnormalized point at parameter t
+ */
+static route_vec_t route_piece_at(const route_piece_t* piece, double t) {
+    route_vec_t q = { piece->a.x + t * piece->d.x, piece->a.y + t * piece->d.y, piece->a.z + t * piece->d.z };
+    return q;
+}
 
-        // Calculate suitability score
-        double distance_score = (service->radius_km > 0) ?
-            (1.0 - (distance / service->radius_km)) : 1.0;
-        double quality_score = (double)service->quality_rating / 5.0;
+/**
+ * Unit vector at parameter t along the chord a + t * d
+ */
+static route_vec_t route_segment_point(route_vec_t a, route_vec_t d, double t) {
+    route_vec_t q = { a.x + t * d.x, a.y + t * d.y, a.z + t * d.z };
+    double length = route_sqrt(route_dot(q, q));
+    q.x /= length;
+    q.y /= length;
+    q.z /= length;
+    return q;
+}
 
-        // Prefer government networks, then commercial, then community
-        double network_score = 1.0;
-        switch (service->network_type) {
-            case NTRIP_NETWORK_GOVERNMENT: network_score = 1.0; break;
-            case NTRIP_NETWORK_COMMERCIAL: network_score = 0.8; break;
-            case NTRIP_NETWORK_COMMUNITY: network_score = 0.6; break;
-        }
+/**
+ * Great-circle angle between a unit vector and any nonzero vector
+ */
+static double route_angle(route_vec_t a, route_vec_t q) {
+    route_vec_t c = { a.y * q.z - a.z * q.y, a.z * q.x - a.x * q.z, a.x * q.y - a.y * q.x };
+    return route_atan2(route_sqrt(route_dot(c, c)), route_dot(a, q));
+}
 
-        // Combined score (distance 40%, quality 30%, network type 20%, auth 10%)
-        double auth_score = (service->auth_method == NTRIP_AUTH_NONE) ? 1.0 : 0.9;
-        double score = distance_score * 0.4 + quality_score * 0.3 +
-                      network_score * 0.2 + auth_score * 0.1;
+static void route_piece_lat_lon(const route_piece_t* piece, double t, double* lat, double* lon) {
+    route_vec_t q = route_piece_at(piece, t);
+    *lat = route_atan2(q.z, route_sqrt(q.x * q.x + q.y * q.y)) * 180.0 / M_PI;
+    *lon = route_atan2(q.y, q.x) * 180.0 / M_PI;
+}
 
-        // Update best if this service is better
-        if (score > best_score || (score == best_score && distance < best_distance)) {
-            best_service_index = service->service_index;
-            best_score = score;
-            best_distance = distance;
-        }
-    }
+static double route_piece_km(const route_piece_t* piece, double t) {
+    return piece->start_km + route_angle(piece->a, route_piece_at(piece, t)) * EARTH_RADIUS_KM;
+}
 
-    if (best_service_index == 255) {
-        return NTRIP_ATLAS_ERROR_NO_SERVICES;
+/**
+ * Add an event parameter strictly inside the piece
+ */
+static void route_add_event(route_piece_t* piece, double t) {
+    if (t > 0.0 && t < 1.0 && piece->event_count < ROUTE_MAX_EVENTS) {
+        piece->events[piece->event_count++] = t;
     }
+}
 
-    // Load endpoints for selected service
-    ntrip_service_endpoints_t endpoints;
-    ntrip_atlas_error_t load_result = ntrip_atlas_load_service_endpoints(
-        best_service_index, &endpoints
-    );
+/**
+ * Where a piece crosses a service's coverage circle
+ *
+ * Inside means Q.C >= cos(r)|Q|, i.e. Q.C >= 0 and
+ * (Q.C)^2 - cos^2(r)|Q|^2 >= 0, a quadratic in t. Its roots in (0, 1)
+ * become events when add_events is set.
+ * @return true if any part of the piece may be covered
+ */
+static bool route_add_circle_events(route_piece_t* piece, const ntrip_service_index_t* service,
+                                    bool add_events) {
+    route_vec_t c = route_vec_from_lat_lon(service->lat_center_deg100 / 100.0,
+                                           service->lon_center_deg100 / 100.0);
+    double cos_r = route_cos_radius(service->radius_km);
+    double cos_r2 = cos_r * cos_r;
+
+    double ac = route_dot(piece->a, c);
+    double dc = route_dot(piece->d, c);
+    double ad = route_dot(piece->a, piece->d);
+    double dd = route_dot(piece->d, piece->d);
+
+    double qa = dc * dc - cos_r2 * dd;
+    double qb = 2.0 * (ac * dc - cos_r2 * ad);
+    double qc = ac * ac - cos_r2;
+
+    // Inside at either end, or inside somewhere between two roots
+    bool covered = (ac >= 0.0 && qc >= 0.0) || (ac + dc >= 0.0 && qa + qb + qc >= 0.0);
+
+    if (fabs(qa) < 1e-15) {
+        if (qb != 0.0) {
+            double t = -qc / qb;
+            if (t > 0.0 && t < 1.0 && ac + dc * t >= 0.0) {
+                if (add_events) route_add_event(piece, t);
+                covered = true;
+            }
+        }
+        return covered;
+    }
 
-    if (load_result != NTRIP_ATLAS_SUCCESS) {
-        return load_result;
+    double disc = qb * qb - 4.0 * qa * qc;
+    if (disc < 0.0) {
+        return covered;
     }
 
-    // Populate result with Tier 1 and Tier 2 data
-    ntrip_service_index_t* selected_service = NULL;
-    for (size_t i = 0; i < g_tiered_state.service_count; i++) {
-        if (g_tiered_state.discovery_index[i].service_index == best_service_index) {
-            selected_service = &g_tiered_state.discovery_index[i];
-            break;
+    double root = route_sqrt(disc);
+    double t1 = (-qb - root) / (2.0 * qa);
+    double t2 = (-qb + root) / (2.0 * qa);
+    for (int i = 0; i < 2; i++) {
+        double t = i == 0 ? t1 : t2;
+        if (t > 0.0 && t < 1.0 && ac + dc * t >= 0.0) {
+            if (add_events) route_add_event(piece, t);
+            covered = true;
         }
     }
+    return covered;
+}
 
-    if (!selected_service) {
-        return NTRIP_ATLAS_ERROR_NO_SERVICES;
+/**
+ * Add a covering slot to a piece
+ *
+ * When the piece is full and keep_best is set, the slot replaces the
+ * candidate ranking lowest at (mid_lat, mid_lon) if it ranks ahead of it.
+ * @return false if the piece is full and keep_best is not set
+ */
+static bool route_add_candidate(route_piece_t* piece, size_t slot, bool keep_best,
+                                double mid_lat, double mid_lon) {
+    double score = 0.0;
+    double distance = 0.0;
+    if (keep_best) {
+        const ntrip_service_index_t* service = &g_tiered_state.discovery_index[slot];
+        distance = calculate_distance_km(mid_lat, mid_lon, service->lat_center_deg100 / 100.0,
+                                         service->lon_center_deg100 / 100.0);
+        score = score_tier1_service(service, distance);
     }
 
-    // Fill result structure
-    memset(result, 0, sizeof(*result));
-    strncpy(result->hostname, endpoints.hostname, sizeof(result->hostname) - 1);
-    result->port = endpoints.port;
-    result->ssl_available = selected_service->ssl_available;
-    result->auth_method = selected_service->auth_method;
-    result->distance_km = best_distance;
-    result->suitability_score = (uint8_t)(best_score * 100);
-    result->quality_rating = selected_service->quality_rating;
-    result->requires_registration = selected_service->requires_registration;
+    size_t pos = piece->candidate_count;
+    if (pos >= ROUTE_MAX_CANDIDATES) {
+        if (!keep_best) {
+            return false;
+        }
+        size_t worst = 0;
+        for (size_t i = 1; i < ROUTE_MAX_CANDIDATES; i++) {
+            if (tier1_ranks_ahead(piece->candidate_scores[worst], piece->candidate_distances[worst],
+                                  piece->candidates[worst], piece->candidate_scores[i],
+                                  piece->candidate_distances[i], piece->candidates[i])) {
+                worst = i;
+            }
+        }
+        if (!tier1_ranks_ahead(score, distance, slot, piece->candidate_scores[worst],
+                               piece->candidate_distances[worst], piece->candidates[worst])) {
+            return true;
+        }
+        pos = worst;
+    } else {
+        piece->candidate_count++;
+    }
 
-    return NTRIP_ATLAS_SUCCESS;
+    piece->candidates[pos] = (tier1_slot_t)slot;
+    piece->candidate_scores[pos] = score;
+    piece->candidate_distances[pos] = distance;
+    return true;
 }
 
 /**
- * Find endpoint cache entry or least recently used slot
+ * Collect the services whose coverage meets a piece, with their crossings
+ * @return NTRIP_ATLAS_ERROR_NO_MEMORY if more than ROUTE_MAX_CANDIDATES
+ *         meet the piece and keep_best is not set
  */
-static endpoint_cache_entry_t* find_endpoint_cache_slot(uint8_t service_index) {
-    uint32_t current_time = get_cache_time();
+static ntrip_atlas_error_t route_collect_candidates(route_piece_t* piece, double lat0, double lon0,
+                                                   double lat1, double lon1, bool keep_best) {
+    piece->candidate_count = 0;
+    piece->event_count = 0;
+
+    double mid_lat = 0.0, mid_lon = 0.0;
+    if (keep_best) {
+        route_piece_lat_lon(piece, 0.5, &mid_lat, &mid_lon);
+    }
 
-    // Look for existing entry
-    for (int i = 0; i < ENDPOINT_CACHE_SIZE; i++) {
-        if (g_tiered_state.endpoint_cache[i].valid &&
-            g_tiered_state.endpoint_cache[i].service_index == service_index) {
-            g_tiered_state.endpoint_cache[i].last_access_time = current_time;
-            return &g_tiered_state.endpoint_cache[i];
+    size_t service_count = g_tiered_state.service_count;
+
+    const tier1_grid_t* grid = &g_tiered_state.grid;
+    if (grid->cell_offsets) {
+        double lat_min = (lat0 < lat1 ? lat0 : lat1) - ROUTE_LAT_MARGIN_DEG;
+        double lat_max = (lat0 > lat1 ? lat0 : lat1) + ROUTE_LAT_MARGIN_DEG;
+        if (lat_min < -90.0) lat_min = -90.0;
+        if (lat_max > 90.0) lat_max = 90.0;
+
+        // Pieces are short, so the longer way round means the piece crosses ±180°
+        double west = lon0 < lon1 ? lon0 : lon1;
+        double east = lon0 < lon1 ? lon1 : lon0;
+        if (east - west > 180.0) {
+            double swap = west;
+            west = east;
+            east = swap;
         }
-    }
 
-    // Find empty slot
-    for (int i = 0; i < ENDPOINT_CACHE_SIZE; i++) {
-        if (!g_tiered_state.endpoint_cache[i].valid) {
-            return &g_tiered_state.endpoint_cache[i];
+        tier1_cell_range_t range;
+        uint16_t tile_lat, tile_lon;
+        ntrip_atlas_lat_lon_to_tile(lat_min, west, TIER1_GRID_LEVEL, &tile_lat, &tile_lon);
+        range.lat_first = tile_lat;
+        range.lon_first = tile_lon;
+        ntrip_atlas_lat_lon_to_tile(lat_max, east, TIER1_GRID_LEVEL, &tile_lat, &tile_lon);
+        range.lat_last = tile_lat;
+        range.lon_last = tile_lon;
+
+        FOR_EACH_RANGE_CELL(range, cell, {
+            for (uint32_t i = grid->cell_offsets[cell]; i < grid->cell_offsets[cell + 1]; i++) {
+                tier1_slot_t slot = grid->cell_slots[i];
+
+                // Circles span several cells - skip ones already collected
+                bool duplicate = false;
+                for (size_t j = 0; j < piece->candidate_count; j++) {
+                    if (piece->candidates[j] == slot) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (duplicate ||
+                    !route_add_circle_events(piece, &g_tiered_state.discovery_index[slot], false)) {
+                    continue;
+                }
+                if (!route_add_candidate(piece, slot, keep_best, mid_lat, mid_lon)) {
+                    return NTRIP_ATLAS_ERROR_NO_MEMORY;
+                }
+            }
+        })
+    } else {
+        for (size_t slot = 0; slot < service_count; slot++) {
+            if (!route_add_circle_events(piece, &g_tiered_state.discovery_index[slot], false)) {
+                continue;
+            }
+            if (!route_add_candidate(piece, slot, keep_best, mid_lat, mid_lon)) {
+                return NTRIP_ATLAS_ERROR_NO_MEMORY;
+            }
         }
     }
 
-    // Find least recently used slot
-    endpoint_cache_entry_t* lru_entry = &g_tiered_state.endpoint_cache[0];
-    for (int i = 1; i < ENDPOINT_CACHE_SIZE; i++) {
-        if (g_tiered_state.endpoint_cache[i].last_access_time < lru_entry->last_access_time) {
-            lru_entry = &g_tiered_state.endpoint_cache[i];
+    // Crossings of the candidates kept
+    for (size_t i = 0; i < piece->candidate_count; i++) {
+        route_add_circle_events(piece, &g_tiered_state.discovery_index[piece->candidates[i]], true);
+    }
+
+    // Sort events (few, so insertion sort)
+    for (size_t i = 1; i < piece->event_count; i++) {
+        double t = piece->events[i];
+        size_t j = i;
+        while (j > 0 && piece->events[j - 1] > t) {
+            piece->events[j] = piece->events[j - 1];
+            j--;
         }
+        piece->events[j] = t;
     }
 
-    return lru_entry;
+    return NTRIP_ATLAS_SUCCESS;
 }
 
 /**
- * Load service endpoints on demand (Tier 2)
+ * Slot find_best_tiered() would pick at parameter t (ROUTE_NO_SLOT if uncovered)
  */
-ntrip_atlas_error_t ntrip_atlas_load_service_endpoints(
-    uint8_t service_index,
-    ntrip_service_endpoints_t* endpoints
-) {
-    if (!g_tiered_state.initialized || !endpoints) {
-        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+static size_t route_winner_at(const route_piece_t* piece, double t) {
+    double lat, lon;
+    route_piece_lat_lon(piece, t, &lat, &lon);
+
+    tier1_ranking_t ranking;
+    ranking.count = 0;
+    for (size_t i = 0; i < piece->candidate_count; i++) {
+        consider_tier1_slot(piece->candidates[i], lat, lon, &ranking);
     }
+    return ranking.count > 0 ? ranking.slot[0] : ROUTE_NO_SLOT;
+}
 
-    if (g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
-        return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
+/**
+ * Narrow a change of winner between lo and hi down to the tolerance
+ * @return Parameter of the first point served by the new winner
+ */
+static double route_bisect(const route_piece_t* piece, double lo, double hi, size_t lo_winner) {
+    while ((hi - lo) * piece->length_km > ROUTE_HANDOVER_TOLERANCE_KM) {
+        double mid = 0.5 * (lo + hi);
+        if (route_winner_at(piece, mid) == lo_winner) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
     }
+    return hi;
+}
 
-    // Check cache first
-    endpoint_cache_entry_t* cache_entry = find_endpoint_cache_slot(service_index);
-    if (cache_entry->valid && cache_entry->service_index == service_index) {
-        // Cache hit
-        *endpoints = cache_entry->endpoints;
-        return NTRIP_ATLAS_SUCCESS;
+/**
+ * Start a new leg (counted even when it no longer fits)
+ */
+static void route_emit_leg(ntrip_route_plan_t* plan, const route_piece_t* piece, double t, size_t slot) {
+    if (plan->leg_count < plan->max_legs) {
+        ntrip_route_leg_t* leg = &plan->legs[plan->leg_count];
+        memset(leg, 0, sizeof(*leg));
+        leg->covered = slot != ROUTE_NO_SLOT;
+        if (leg->covered) {
+            leg->service_index = g_tiered_state.discovery_index[slot].service_index;
+        }
+        leg->segment = piece->segment;
+        route_piece_lat_lon(piece, t, &leg->start_latitude, &leg->start_longitude);
+        leg->start_km = route_piece_km(piece, t);
     }
+    plan->leg_count++;
+}
 
-    // Cache miss - load from platform
-    if (!g_tiered_state.platform.load_service_endpoints) {
-        return NTRIP_ATLAS_ERROR_PLATFORM;
+/**
+ * Walk one piece, emitting a leg at every change of winner
+ *
+ * Samples sit strictly inside the intervals between events, so every
+ * coverage boundary lies between two samples (or a sample and the piece
+ * end) and is found by bisection.
+ */
+static void route_walk_piece(const route_piece_t* piece, ntrip_route_plan_t* plan,
+                             size_t* current, bool* started) {
+    size_t previous = *current;
+    double previous_t = 0.0;
+    bool have_previous = false;
+
+    for (size_t k = 0; k <= piece->event_count; k++) {
+        double from = k == 0 ? 0.0 : piece->events[k - 1];
+        double to = k == piece->event_count ? 1.0 : piece->events[k];
+        if (to <= from) {
+            continue;
+        }
+
+        size_t samples = (size_t)ceil((to - from) * piece->length_km / ROUTE_SAMPLE_KM);
+        if (samples == 0) {
+            samples = 1;
+        }
+
+        for (size_t j = 0; j < samples; j++) {
+            double t = from + (to - from) * (j + 0.5) / samples;
+            size_t winner = route_winner_at(piece, t);
+
+            if (!*started) {
+                route_emit_leg(plan, piece, 0.0, winner);
+                *started = true;
+            } else if (winner != previous) {
+                // A change before the first sample may belong to the previous
+                // piece's last half sample; then hand over at the piece boundary
+                double handover = 0.0;
+                if (have_previous) {
+                    handover = route_bisect(piece, previous_t, t, previous);
+                } else if (route_winner_at(piece, 0.0) == previous) {
+                    handover = route_bisect(piece, 0.0, t, previous);
+                }
+                route_emit_leg(plan, piece, handover, winner);
+            }
+
+            previous = winner;
+            previous_t = t;
+            have_previous = true;
+        }
     }
 
-    ntrip_atlas_error_t result = g_tiered_state.platform.load_service_endpoints(
-        service_index, endpoints, g_tiered_state.platform.platform_data
-    );
+    // A change after the last sample belongs to this piece, not the next
+    if (have_previous) {
+        size_t winner = route_winner_at(piece, 1.0);
+        if (winner != previous) {
+            route_emit_leg(plan, piece, route_bisect(piece, previous_t, 1.0, previous), winner);
+            previous = winner;
+        }
+    }
 
-    if (result == NTRIP_ATLAS_SUCCESS) {
-        // Store in cache
-        cache_entry->service_index = service_index;
-        cache_entry->endpoints = *endpoints;
-        cache_entry->last_access_time = get_cache_time();
-        cache_entry->valid = true;
+    *current = previous;
+}
+
+/**
+ * Plan the piece from one unit vector to another, halving it while more
+ * circles meet it than a piece holds
+ */
+static void route_plan_piece(route_piece_t* piece, route_vec_t from, route_vec_t to, uint16_t segment,
+                             ntrip_route_plan_t* plan, size_t* current, bool* started) {
+    piece->a = from;
+    piece->d.x = to.x - from.x;
+    piece->d.y = to.y - from.y;
+    piece->d.z = to.z - from.z;
+    piece->length_km = route_angle(from, to) * EARTH_RADIUS_KM;
+    piece->start_km = plan->total_km;
+    piece->segment = segment;
+
+    double lat0, lon0, lat1, lon1;
+    route_piece_lat_lon(piece, 0.0, &lat0, &lon0);
+    route_piece_lat_lon(piece, 1.0, &lat1, &lon1);
+    bool keep_best = piece->length_km <= ROUTE_MIN_PIECE_KM;
+    if (route_collect_candidates(piece, lat0, lon0, lat1, lon1, keep_best) != NTRIP_ATLAS_SUCCESS) {
+        route_vec_t mid = route_segment_point(from, piece->d, 0.5);
+        route_plan_piece(piece, from, mid, segment, plan, current, started);
+        route_plan_piece(piece, mid, to, segment, plan, current, started);
+        return;
     }
 
-    return result;
+    route_walk_piece(piece, plan, current, started);
+    plan->total_km += piece->length_km;
 }
 
 /**
- * Load service metadata on demand (Tier 3)
+ * Plan casters and handover points along a route in one call
  */
-ntrip_atlas_error_t ntrip_atlas_load_service_metadata(
-    uint8_t service_index,
-    ntrip_service_metadata_t* metadata
+ntrip_atlas_error_t ntrip_atlas_plan_route(
+    const ntrip_route_point_t* points,
+    size_t point_count,
+    ntrip_route_plan_t* plan
 ) {
-    if (!g_tiered_state.initialized || !metadata) {
+    if (!points || point_count < 2 || point_count - 1 > UINT16_MAX || !plan ||
+        (!plan->legs && plan->max_legs > 0)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    for (size_t i = 0; i < point_count; i++) {
+        if (points[i].latitude < -90.0 || points[i].latitude > 90.0 ||
+            points[i].longitude < -180.0 || points[i].longitude > 180.0) {
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
+    }
+    if (!g_tiered_state.initialized) {
         return NTRIP_ATLAS_ERROR_INVALID_PARAM;
     }
-
     if (g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
         return NTRIP_ATLAS_ERROR_MISSING_FEATURE;
     }
+    if (!g_tiered_state.discovery_index) {
+        return NTRIP_ATLAS_ERROR_NO_DISCOVERY_INDEX;
+    }
 
-    // Check cache first (similar to endpoints, but simpler since smaller cache)
-    for (int i = 0; i < METADATA_CACHE_SIZE; i++) {
-        if (g_tiered_state.metadata_cache[i].valid &&
-            g_tiered_state.metadata_cache[i].service_index == service_index) {
-            *metadata = g_tiered_state.metadata_cache[i].metadata;
-            g_tiered_state.metadata_cache[i].last_access_time = get_cache_time();
-            return NTRIP_ATLAS_SUCCESS;
+    plan->leg_count = 0;
+    plan->total_km = 0.0;
+    plan->prefetch_queued = 0;
+
+    route_piece_t piece;
+    size_t current = ROUTE_NO_SLOT;
+    bool started = false;
+
+    for (size_t s = 0; s + 1 < point_count; s++) {
+        route_vec_t a = route_vec_from_lat_lon(points[s].latitude, points[s].longitude);
+        route_vec_t b = route_vec_from_lat_lon(points[s + 1].latitude, points[s + 1].longitude);
+        double segment_km = route_angle(a, b) * EARTH_RADIUS_KM;
+        if (segment_km <= 0.0) {
+            continue;
         }
-    }
 
-    // Cache miss - load from platform
-    if (!g_tiered_state.platform.load_service_metadata) {
-        return NTRIP_ATLAS_ERROR_PLATFORM;
-    }
+        // Antipodal endpoints have no unique great circle
+        route_vec_t d = { b.x - a.x, b.y - a.y, b.z - a.z };
+        if (route_dot(d, d) > 4.0 - 1e-12) {
+            return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+        }
 
-    ntrip_atlas_error_t result = g_tiered_state.platform.load_service_metadata(
-        service_index, metadata, g_tiered_state.platform.platform_data
-    );
+        size_t piece_count = (size_t)ceil(segment_km / ROUTE_MAX_PIECE_KM);
 
-    if (result == NTRIP_ATLAS_SUCCESS) {
-        // Find cache slot (LRU replacement)
-        int cache_slot = 0;
-        uint32_t oldest_time = g_tiered_state.metadata_cache[0].last_access_time;
-
-        for (int i = 0; i < METADATA_CACHE_SIZE; i++) {
-            if (!g_tiered_state.metadata_cache[i].valid) {
-                cache_slot = i;
-                break;
-            }
-            if (g_tiered_state.metadata_cache[i].last_access_time < oldest_time) {
-                oldest_time = g_tiered_state.metadata_cache[i].last_access_time;
-                cache_slot = i;
-            }
+        for (size_t p = 0; p < piece_count; p++) {
+            route_vec_t from = route_segment_point(a, d, (double)p / piece_count);
+            route_vec_t to = route_segment_point(a, d, (double)(p + 1) / piece_count);
+            route_plan_piece(&piece, from, to, (uint16_t)s, plan, &current, &started);
         }
+    }
 
-        // Store in cache
-        g_tiered_state.metadata_cache[cache_slot].service_index = service_index;
-        g_tiered_state.metadata_cache[cache_slot].metadata = *metadata;
-        g_tiered_state.metadata_cache[cache_slot].last_access_time = get_cache_time();
-        g_tiered_state.metadata_cache[cache_slot].valid = true;
+    // Queue endpoints in route order for the cooperative loader
+    size_t stored = plan->leg_count < plan->max_legs ? plan->leg_count : plan->max_legs;
+    for (size_t i = 0; i < stored; i++) {
+        if (plan->legs[i].covered && enqueue_prefetch(plan->legs[i].service_index)) {
+            plan->prefetch_queued++;
+        }
     }
 
-    return result;
+    return plan->leg_count > plan->max_legs ? NTRIP_ATLAS_ERROR_NO_MEMORY : NTRIP_ATLAS_SUCCESS;
 }
 
 /**
@@ -382,33 +2042,59 @@ ntrip_atlas_error_t ntrip_atlas_get_tiered_memory_stats(
         return NTRIP_ATLAS_ERROR_NO_DISCOVERY_INDEX;
     }
 
-    // Calculate Tier 1 usage (discovery index always loaded)
+    // Calculate Tier 1 usage (discovery index always loaded, plus lookup grid)
     if (tier1_bytes) {
-        *tier1_bytes = g_tiered_state.service_count * sizeof(ntrip_service_index_t);
+        *tier1_bytes = g_tiered_state.service_count * sizeof(ntrip_service_index_t) +
+                       g_tiered_state.slot_map_size * sizeof(tier1_slot_t);
+        if (g_tiered_state.grid.cell_offsets) {
+            *tier1_bytes += (TIER1_GRID_CELLS + 1) * sizeof(uint32_t) +
+                            g_tiered_state.grid.assignment_count * sizeof(tier1_slot_t);
+        }
     }
 
     // Calculate Tier 2 usage (cached endpoints)
     if (tier2_bytes) {
-        size_t cached_endpoints = 0;
-        for (int i = 0; i < ENDPOINT_CACHE_SIZE; i++) {
-            if (g_tiered_state.endpoint_cache[i].valid) {
-                cached_endpoints++;
-            }
-        }
-        *tier2_bytes = cached_endpoints * sizeof(ntrip_service_endpoints_t);
+        *tier2_bytes = g_tiered_state.endpoint_cache.entries * sizeof(ntrip_service_endpoints_t);
     }
 
     // Calculate Tier 3 usage (cached metadata)
     if (tier3_bytes) {
-        size_t cached_metadata = 0;
-        for (int i = 0; i < METADATA_CACHE_SIZE; i++) {
-            if (g_tiered_state.metadata_cache[i].valid) {
-                cached_metadata++;
-            }
-        }
-        *tier3_bytes = cached_metadata * sizeof(ntrip_service_metadata_t);
+        *tier3_bytes = g_tiered_state.metadata_cache.entries * sizeof(ntrip_service_metadata_t);
+    }
+
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Copy one cache's counters into the public stats structure
+ */
+static void fill_cache_stats(const tiered_cache_t* cache, ntrip_tiered_cache_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->evictions = cache->evictions;
+    stats->entries = (uint16_t)cache->entries;
+    stats->capacity = (uint16_t)cache->capacity;
+    stats->pinned = (uint16_t)cache->pinned_slots;
+}
+
+/**
+ * Get hit/miss/eviction counters for the Tier 2 and Tier 3 caches
+ */
+ntrip_atlas_error_t ntrip_atlas_get_tiered_cache_stats(
+    ntrip_tiered_cache_stats_t* endpoint_stats,
+    ntrip_tiered_cache_stats_t* metadata_stats
+) {
+    if (!g_tiered_state.initialized || g_tiered_state.loading_mode != NTRIP_LOADING_TIERED) {
+        if (endpoint_stats) memset(endpoint_stats, 0, sizeof(*endpoint_stats));
+        if (metadata_stats) memset(metadata_stats, 0, sizeof(*metadata_stats));
+        return NTRIP_ATLAS_ERROR_NO_DISCOVERY_INDEX;
     }
 
+    fill_cache_stats(&g_tiered_state.endpoint_cache, endpoint_stats);
+    fill_cache_stats(&g_tiered_state.metadata_cache, metadata_stats);
     return NTRIP_ATLAS_SUCCESS;
 }
 
@@ -420,9 +2106,11 @@ void ntrip_atlas_trim_caches(void) {
         return;
     }
 
-    // Clear all cached endpoints and metadata
-    memset(g_tiered_state.endpoint_cache, 0, sizeof(g_tiered_state.endpoint_cache));
-    memset(g_tiered_state.metadata_cache, 0, sizeof(g_tiered_state.metadata_cache));
+    // Free cached endpoints and metadata, and drop pending prefetches
+    tiered_cache_release(&g_tiered_state.endpoint_cache);
+    tiered_cache_release(&g_tiered_state.metadata_cache);
+    g_tiered_state.prefetch_head = 0;
+    g_tiered_state.prefetch_count = 0;
 
     // Note: We preserve Tier 1 discovery index as it's essential for operation
 }
@@ -445,8 +2133,10 @@ void ntrip_atlas_print_tiered_stats(void) {
     printf("  Services: %zu\n", g_tiered_state.service_count);
     printf("  Memory usage:\n");
     printf("    Tier 1 (Discovery): %zu bytes\n", tier1_bytes);
-    printf("    Tier 2 (Endpoints): %zu bytes (%d cached)\n", tier2_bytes, ENDPOINT_CACHE_SIZE);
-    printf("    Tier 3 (Metadata): %zu bytes (%d cached)\n", tier3_bytes, METADATA_CACHE_SIZE);
+    printf("    Tier 2 (Endpoints): %zu bytes (%zu/%zu cached)\n", tier2_bytes,
+           g_tiered_state.endpoint_cache.entries, g_tiered_state.endpoint_cache.capacity);
+    printf("    Tier 3 (Metadata): %zu bytes (%zu/%zu cached)\n", tier3_bytes,
+           g_tiered_state.metadata_cache.entries, g_tiered_state.metadata_cache.capacity);
     printf("    Total: %zu bytes\n", tier1_bytes + tier2_bytes + tier3_bytes);
 
     if (g_tiered_state.service_count > 0) {
@@ -454,7 +2144,8 @@ void ntrip_atlas_print_tiered_stats(void) {
             (sizeof(ntrip_service_index_t) + sizeof(ntrip_service_endpoints_t) +
              sizeof(ntrip_service_metadata_t));
         size_t current_size = tier1_bytes + tier2_bytes + tier3_bytes;
-        double reduction = ((double)(traditional_size - current_size) / traditional_size) * 100.0;
+        // Negative when caches and lookup tables outweigh loading everything
+        double reduction = ((double)traditional_size - (double)current_size) / traditional_size * 100.0;
 
         printf("  Memory reduction: %.1f%% (vs traditional %zu bytes)\n",
                reduction, traditional_size);
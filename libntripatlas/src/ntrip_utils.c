@@ -7,13 +7,24 @@
  * Licensed under MIT License
  */
 
+#define _USE_MATH_DEFINES  // For M_PI on Windows/MSVC
 #include "ntrip_atlas.h"
 #include <math.h>
 #include <string.h>
 
+// Ensure M_PI is defined on all platforms
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 // Earth's radius in kilometers
 #define EARTH_RADIUS_KM 6371.0
 
+// WGS84 ellipsoid
+#define WGS84_A 6378137.0
+#define WGS84_F (1.0 / 298.257223563)
+#define WGS84_E2 (WGS84_F * (2.0 - WGS84_F))
+
 /**
  * Calculate distance between two coordinates using Haversine formula
  *
@@ -24,6 +35,10 @@
  * @return     Distance in kilometers
  */
 double ntrip_atlas_calculate_distance(double lat1, double lon1, double lat2, double lon2) {
+#if NTRIP_ATLAS_FIXED_POINT_GEOMETRY
+    return ntrip_atlas_fixed_distance_m(NTRIP_ATLAS_DEG_TO_MICRODEG(lat1), NTRIP_ATLAS_DEG_TO_MICRODEG(lon1),
+                                        NTRIP_ATLAS_DEG_TO_MICRODEG(lat2), NTRIP_ATLAS_DEG_TO_MICRODEG(lon2)) / 1000.0;
+#else
     // Convert degrees to radians
     double lat1_rad = lat1 * M_PI / 180.0;
     double lon1_rad = lon1 * M_PI / 180.0;
@@ -41,6 +56,45 @@ double ntrip_atlas_calculate_distance(double lat1, double lon1, double lat2, dou
     double c = 2.0 * atan2(sqrt(a), sqrt(1.0 - a));
 
     return EARTH_RADIUS_KM * c;
+#endif
+}
+
+/**
+ * Convert WGS84 ECEF coordinates to geodetic ones
+ *
+ * Fixed-point iteration on latitude; from a surface point it settles to
+ * well under a millimetre in five rounds. Stable at the poles, where the
+ * distance from the axis is zero.
+ */
+void ntrip_atlas_ecef_to_geodetic(
+    double x,
+    double y,
+    double z,
+    double* latitude,
+    double* longitude,
+    double* height
+) {
+    double p = sqrt(x * x + y * y);
+    double lat = atan2(z, p * (1.0 - WGS84_E2));
+    double n = WGS84_A;
+
+    for (int i = 0; i < 5; i++) {
+        double sin_lat = sin(lat);
+        n = WGS84_A / sqrt(1.0 - WGS84_E2 * sin_lat * sin_lat);
+        lat = atan2(z + WGS84_E2 * n * sin_lat, p);
+    }
+
+    if (latitude) {
+        *latitude = lat * 180.0 / M_PI;
+    }
+    if (longitude) {
+        *longitude = atan2(y, x) * 180.0 / M_PI;
+    }
+    if (height) {
+        double sin_lat = sin(lat);
+        n = WGS84_A / sqrt(1.0 - WGS84_E2 * sin_lat * sin_lat);
+        *height = p * cos(lat) + z * sin_lat - WGS84_A * WGS84_A / n;
+    }
 }
 
 /**
@@ -79,6 +133,8 @@ const char* ntrip_atlas_error_string(ntrip_atlas_error_t error) {
             return "Service failed";
         case NTRIP_ATLAS_ERROR_ALL_SERVICES_FAILED:
             return "All services failed";
+        case NTRIP_ATLAS_ERROR_WOULD_BLOCK:
+            return "Operation would block";
         default:
             return "Unknown error";
     }
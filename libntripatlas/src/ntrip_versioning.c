@@ -15,7 +15,9 @@
 #define CURRENT_SUPPORTED_FEATURES ( \
     NTRIP_DB_FEATURE_COMPACT_FAILURES | \
     NTRIP_DB_FEATURE_GEOGRAPHIC_INDEX | \
-    NTRIP_DB_FEATURE_EXTENDED_AUTH \
+    NTRIP_DB_FEATURE_EXTENDED_AUTH | \
+    NTRIP_DB_FEATURE_COMPRESSED_METADATA | \
+    NTRIP_DB_FEATURE_PACKED_INDEX \
 )
 
 /**
@@ -144,7 +146,7 @@ void ntrip_atlas_print_version_info(void) {
            info.tiered_loading_support ? "TieredLoad " : "",
            (info.supported_features & NTRIP_DB_FEATURE_EXPERIMENTAL) ? "Experimental " : "");
     printf("Memory optimization: %s\n",
-           info.compact_failure_support ? "93% reduction (80→6 bytes/service)" : "Standard");
+           info.compact_failure_support ? "94% reduction (80→5 bytes/service)" : "Standard");
 }
 
 /**
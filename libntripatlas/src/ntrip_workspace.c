@@ -0,0 +1,92 @@
+/**
+ * NTRIP Atlas - Caller-Provided Workspace
+ *
+ * Stack-style arena over a buffer the caller sizes once. Long-lived tables
+ * sit at the bottom; transient scratch is taken above them and released
+ * back to a mark before the call that took it returns.
+ *
+ * Licensed under MIT License
+ */
+
+#include "ntrip_atlas.h"
+#include <string.h>
+
+// Workspace tiered loading takes its tables from (NULL = heap). Per-call
+// scratch such as sort keys uses a workspace passed to that call instead,
+// so concurrent callers never share an arena.
+static ntrip_atlas_workspace_t* g_workspace = NULL;
+
+/**
+ * Initialize a workspace over a caller-provided buffer
+ */
+ntrip_atlas_error_t ntrip_atlas_workspace_init(
+    ntrip_atlas_workspace_t* workspace,
+    void* buffer,
+    size_t size
+) {
+    if (!workspace || (!buffer && size > 0)) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+    if ((uintptr_t)buffer % NTRIP_ATLAS_WORKSPACE_ALIGN != 0) {
+        return NTRIP_ATLAS_ERROR_INVALID_PARAM;
+    }
+
+    workspace->base = (uint8_t*)buffer;
+    workspace->size = size;
+    workspace->used = 0;
+    workspace->high_water = 0;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+/**
+ * Take zeroed, aligned bytes from a workspace
+ */
+void* ntrip_atlas_workspace_alloc(ntrip_atlas_workspace_t* workspace, size_t bytes) {
+    if (!workspace || !workspace->base) {
+        return NULL;
+    }
+
+    size_t start = (workspace->used + NTRIP_ATLAS_WORKSPACE_ALIGN - 1) /
+                   NTRIP_ATLAS_WORKSPACE_ALIGN * NTRIP_ATLAS_WORKSPACE_ALIGN;
+    if (start > workspace->size || bytes > workspace->size - start) {
+        return NULL;
+    }
+
+    workspace->used = start + bytes;
+    if (workspace->used > workspace->high_water) {
+        workspace->high_water = workspace->used;
+    }
+
+    memset(workspace->base + start, 0, bytes);
+    return workspace->base + start;
+}
+
+/**
+ * Current allocation position
+ */
+size_t ntrip_atlas_workspace_mark(const ntrip_atlas_workspace_t* workspace) {
+    return workspace ? workspace->used : 0;
+}
+
+/**
+ * Return everything allocated since a mark
+ */
+void ntrip_atlas_workspace_release(ntrip_atlas_workspace_t* workspace, size_t mark) {
+    if (workspace && mark <= workspace->used) {
+        workspace->used = mark;
+    }
+}
+
+/**
+ * Attach the workspace tiered loading draws from
+ */
+void ntrip_atlas_set_workspace(ntrip_atlas_workspace_t* workspace) {
+    g_workspace = workspace;
+}
+
+/**
+ * Currently attached workspace
+ */
+ntrip_atlas_workspace_t* ntrip_atlas_get_workspace(void) {
+    return g_workspace;
+}
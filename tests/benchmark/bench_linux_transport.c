@@ -0,0 +1,154 @@
+/**
+ * Linux Transport Benchmark
+ *
+ * Compares ntrip_platform_linux.http_stream (libcurl unless built with
+ * NTRIP_ATLAS_LINUX_NATIVE_HTTP) with the native epoll client against a
+ * loopback caster: time to first body byte per request, and CPU time of
+ * the calling thread per stream for a small and a large sourcetable.
+ * Loopback hides network latency, so differences are client overhead.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#define ITERATIONS 200
+#define SMALL_BODY 4096
+#define LARGE_BODY (512 * 1024)
+
+static int g_listen_fd;
+static uint16_t g_port;
+static char g_body[LARGE_BODY];
+
+static double now_us(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Serve one response per connection; the path picks the body size
+static void* serve(void* arg) {
+    (void)arg;
+    for (;;) {
+        int fd = accept(g_listen_fd, NULL, NULL);
+        if (fd < 0) break;
+
+        char request[512];
+        size_t length = 0;
+        request[0] = '\0';
+        while (length < sizeof(request) - 1 && !strstr(request, "\r\n\r\n")) {
+            ssize_t n = recv(fd, request + length, sizeof(request) - 1 - length, 0);
+            if (n <= 0) break;
+            length += (size_t)n;
+            request[length] = '\0';
+        }
+
+        size_t body = strncmp(request, "GET /large ", 11) == 0 ? LARGE_BODY : SMALL_BODY;
+        char header[128];
+        int header_length = snprintf(header, sizeof(header),
+                                     "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\n\r\n", body);
+        send(fd, header, (size_t)header_length, MSG_NOSIGNAL);
+        for (size_t pos = 0; pos < body; ) {
+            ssize_t n = send(fd, g_body + pos, body - pos, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            pos += (size_t)n;
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+typedef struct {
+    double started_us;
+    double first_byte_us;
+    size_t received;
+} bench_request_t;
+
+static int on_body(const char* chunk, size_t len, void* context) {
+    (void)chunk;
+    bench_request_t* request = (bench_request_t*)context;
+    if (request->received == 0) {
+        request->first_byte_us = now_us(CLOCK_MONOTONIC) - request->started_us;
+    }
+    request->received += len;
+    return 0;
+}
+
+typedef int (*http_stream_fn)(const char*, uint16_t, uint8_t, const char*,
+                              ntrip_stream_callback_t, void*, uint32_t);
+
+static void run(const char* name, http_stream_fn http_stream, const char* path, size_t expected) {
+    double first_byte_total = 0;
+    double cpu_start = now_us(CLOCK_THREAD_CPUTIME_ID);
+    double wall_start = now_us(CLOCK_MONOTONIC);
+    int failures = 0;
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        bench_request_t request = { .started_us = now_us(CLOCK_MONOTONIC) };
+        int ret = http_stream("127.0.0.1", g_port, 0, path, on_body, &request, 5000);
+        if (ret != NTRIP_ATLAS_SUCCESS || request.received != expected) {
+            failures++;
+        }
+        first_byte_total += request.first_byte_us;
+    }
+
+    double cpu_us = (now_us(CLOCK_THREAD_CPUTIME_ID) - cpu_start) / ITERATIONS;
+    double wall_us = (now_us(CLOCK_MONOTONIC) - wall_start) / ITERATIONS;
+    printf("  %-8s %-7s first byte %8.1f us   cpu/stream %8.1f us   wall/stream %8.1f us%s\n",
+           name, path + 1, first_byte_total / ITERATIONS, cpu_us, wall_us,
+           failures ? "   (FAILURES)" : "");
+}
+
+int main() {
+    printf("Linux Transport Benchmark\n");
+    printf("=========================\n\n");
+
+    for (size_t i = 0; i < sizeof(g_body); i++) {
+        g_body[i] = (char)('A' + i % 26);
+    }
+
+    g_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    if (bind(g_listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(g_listen_fd, 16) != 0 ||
+        getsockname(g_listen_fd, (struct sockaddr*)&address, &address_length) != 0) {
+        printf("Could not start loopback caster\n");
+        return 1;
+    }
+    g_port = ntohs(address.sin_port);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, serve, NULL);
+
+#ifdef NTRIP_ATLAS_LINUX_NATIVE_HTTP
+    const char* platform_name = "platform";
+    printf("Built without libcurl: platform http_stream is the native client\n\n");
+#else
+    const char* platform_name = "curl";
+#endif
+
+    printf("%d sequential requests each, averages:\n", ITERATIONS);
+    run(platform_name, ntrip_platform_linux.http_stream, "/small", SMALL_BODY);
+    run("native", ntrip_platform_linux_native_http_stream, "/small", SMALL_BODY);
+    run(platform_name, ntrip_platform_linux.http_stream, "/large", LARGE_BODY);
+    run("native", ntrip_platform_linux_native_http_stream, "/large", LARGE_BODY);
+
+    shutdown(g_listen_fd, SHUT_RDWR);
+    pthread_join(thread, NULL);
+    close(g_listen_fd);
+    return 0;
+}
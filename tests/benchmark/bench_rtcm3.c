@@ -0,0 +1,140 @@
+/**
+ * RTCM3 Frame Scanner Benchmark
+ *
+ * Feeds a synthetic correction stream (MSM-sized frames of mixed types)
+ * through ntrip_atlas_rtcm3_feed in relay-sized chunks and reports MB/s
+ * next to a bitwise CRC-24Q over the same bytes, the per-byte scan the
+ * scanner replaces. Build with -DNTRIP_ATLAS_CRC24Q_SLICES=1 to see the
+ * single-table variant used on ESP32.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#define STREAM_SIZE (8 * 1024 * 1024)
+#define PASSES 8
+
+static uint8_t g_stream[STREAM_SIZE];
+static size_t g_stream_len;
+static volatile uint32_t g_sink;
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t crc24q_bitwise(const uint8_t* data, size_t len) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint32_t)data[i] << 16;
+        for (int bit = 0; bit < 8; bit++) {
+            crc <<= 1;
+            if (crc & 0x1000000) crc ^= 0x1864CFB;
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+// Frames of 100-400 payload bytes, like MSM4/MSM7 at 1 Hz
+static uint32_t build_stream(void) {
+    static const uint16_t types[] = {1005, 1074, 1084, 1094, 1124, 1230};
+    uint32_t frames = 0;
+    srand(1);
+    g_stream_len = 0;
+    for (;;) {
+        uint16_t length = (uint16_t)(100 + rand() % 301);
+        size_t total = 3 + (size_t)length + 3;
+        if (g_stream_len + total > sizeof(g_stream)) break;
+
+        uint8_t* frame = g_stream + g_stream_len;
+        uint16_t type = types[frames % (sizeof(types) / sizeof(types[0]))];
+        frame[0] = NTRIP_RTCM3_PREAMBLE;
+        frame[1] = (uint8_t)(length >> 8);
+        frame[2] = (uint8_t)length;
+        frame[3] = (uint8_t)(type >> 4);
+        frame[4] = (uint8_t)(type << 4);
+        for (uint16_t i = 2; i < length; i++) {
+            frame[3 + i] = (uint8_t)rand();
+        }
+        uint32_t crc = crc24q_bitwise(frame, 3 + (size_t)length);
+        frame[3 + length] = (uint8_t)(crc >> 16);
+        frame[4 + length] = (uint8_t)(crc >> 8);
+        frame[5 + length] = (uint8_t)crc;
+
+        g_stream_len += total;
+        frames++;
+    }
+    return frames;
+}
+
+static void report(const char* name, double seconds, size_t bytes) {
+    printf("  %-28s %8.1f MB/s\n", name, bytes / seconds / 1e6);
+}
+
+static void bench_feed(size_t chunk, uint32_t expected_frames) {
+    ntrip_rtcm3_framer_t framer;
+    double best = 1e9;
+
+    for (int pass = 0; pass < PASSES; pass++) {
+        ntrip_atlas_rtcm3_init(&framer);
+        double start = now_s();
+        for (size_t pos = 0; pos < g_stream_len; pos += chunk) {
+            size_t len = g_stream_len - pos < chunk ? g_stream_len - pos : chunk;
+            ntrip_atlas_rtcm3_feed(&framer, g_stream + pos, len);
+        }
+        double seconds = now_s() - start;
+        if (seconds < best) best = seconds;
+    }
+
+    char name[64];
+    if (chunk >= g_stream_len) {
+        snprintf(name, sizeof(name), "feed, whole buffer");
+    } else {
+        snprintf(name, sizeof(name), "feed, %zu-byte chunks", chunk);
+    }
+    report(name, best, g_stream_len);
+    if (framer.frames != expected_frames || framer.crc_errors != 0) {
+        printf("    unexpected result: %u frames, %u CRC errors\n",
+               framer.frames, framer.crc_errors);
+    }
+}
+
+int main() {
+    printf("RTCM3 Frame Scanner Benchmark\n");
+    printf("=============================\n\n");
+
+    uint32_t frames = build_stream();
+    printf("%u frames, %zu bytes, CRC-24Q slices: %d (best of %d passes)\n\n",
+           frames, g_stream_len, NTRIP_ATLAS_CRC24Q_SLICES, PASSES);
+
+    double best = 1e9;
+    for (int pass = 0; pass < PASSES; pass++) {
+        double start = now_s();
+        g_sink = crc24q_bitwise(g_stream, g_stream_len);
+        double seconds = now_s() - start;
+        if (seconds < best) best = seconds;
+    }
+    report("bitwise CRC-24Q", best, g_stream_len);
+
+    best = 1e9;
+    for (int pass = 0; pass < PASSES; pass++) {
+        double start = now_s();
+        g_sink = ntrip_atlas_crc24q(0, g_stream, g_stream_len);
+        double seconds = now_s() - start;
+        if (seconds < best) best = seconds;
+    }
+    report("ntrip_atlas_crc24q", best, g_stream_len);
+
+    bench_feed(1460, frames);
+    bench_feed(16384, frames);
+    bench_feed(g_stream_len, frames);
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * Library Link Check
+ *
+ * Linked against the built libntripatlas (see ENABLE_TESTING in
+ * libntripatlas/CMakeLists.txt). Takes the address of at least one public
+ * function from every module, so a source missing from the library's
+ * source list fails here at link time instead of in a consumer.
+ */
+
+#include <stdio.h>
+
+#include "ntrip_atlas.h"
+
+#ifdef NTRIP_LINK_CHECK_PROVIDER_STUB
+// Provider table normally emitted with the generated service database
+const char* get_provider_name(uint8_t provider_index) {
+    (void)provider_index;
+    return "Unknown";
+}
+#endif
+
+typedef void (*any_function_t)(void);
+
+int main() {
+    static const any_function_t functions[] = {
+        // Discovery, HTTP and sourcetable parsing
+        (any_function_t)ntrip_atlas_discovery_begin,
+        (any_function_t)ntrip_atlas_http_stream_begin,
+        (any_function_t)ntrip_atlas_fetch_coalescer_init,
+        // Probing, RTCM3 and station positions
+        (any_function_t)ntrip_atlas_test_service,
+        (any_function_t)ntrip_atlas_rtcm3_feed,
+        (any_function_t)ntrip_atlas_station_position_lookup,
+        // Failure tracking, blacklists and credentials
+        (any_function_t)ntrip_atlas_get_service_index,
+        (any_function_t)ntrip_atlas_record_compact_failure,
+        (any_function_t)ntrip_atlas_record_compact_success,
+        (any_function_t)ntrip_atlas_blacklist_service_region,
+        (any_function_t)ntrip_atlas_init_credential_store,
+        (any_function_t)ntrip_atlas_set_payment_priority,
+        // Service selection and geometry
+        (any_function_t)ntrip_atlas_compress_service,
+        (any_function_t)ntrip_atlas_filter_and_sort_nearest_services,
+        (any_function_t)ntrip_atlas_find_services_spatial_geographic,
+        (any_function_t)ntrip_atlas_find_ranked_services_cached,
+        (any_function_t)ntrip_atlas_compute_service_geometry,
+        (any_function_t)ntrip_atlas_encode_tile_key,
+        (any_function_t)ntrip_atlas_fixed_sin_cos,
+        (any_function_t)ntrip_atlas_tracker_init,
+        // Tiered loading and workspaces
+        (any_function_t)ntrip_atlas_plan_route,
+        (any_function_t)ntrip_atlas_workspace_init,
+        // Tiered database format and versioning
+        (any_function_t)ntrip_atlas_validate_tiered_file_header,
+        (any_function_t)ntrip_atlas_create_database_header,
+        (any_function_t)ntrip_atlas_check_database_compatibility,
+        (any_function_t)ntrip_atlas_pack_discovery_index,
+        (any_function_t)ntrip_atlas_unpack_discovery_index,
+        (any_function_t)ntrip_atlas_encode_metadata_record,
+        (any_function_t)ntrip_atlas_decode_metadata_record,
+        (any_function_t)ntrip_atlas_compress_metadata_record,
+        (any_function_t)ntrip_atlas_decompress_metadata_record,
+        (any_function_t)ntrip_atlas_build_metadata_dictionary,
+        // Utilities
+        (any_function_t)ntrip_atlas_format_gga,
+        (any_function_t)ntrip_atlas_calculate_distance,
+#if defined(__linux__) || defined(__APPLE__)
+        (any_function_t)ntrip_atlas_tiered_file_open,
+#endif
+    };
+
+    size_t count = sizeof(functions) / sizeof(functions[0]);
+    for (size_t i = 0; i < count; i++) {
+        if (!functions[i]) {
+            printf("❌ Function %zu unresolved\n", i);
+            return 1;
+        }
+    }
+    printf("✅ %s: %zu functions resolved\n", ntrip_atlas_get_version(), count);
+    return 0;
+}
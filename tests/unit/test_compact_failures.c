@@ -2,7 +2,7 @@
  * Compact Failure Tracking Unit Tests
  *
  * Tests the memory-optimized failure tracking system that reduces
- * storage from 80 bytes to 6 bytes per service (93% reduction).
+ * storage from 80 bytes to 5 bytes per service (94% reduction).
  */
 
 #include <stdio.h>
@@ -63,9 +63,10 @@ bool test_memory_optimization() {
     printf("  Full failure structure: %zu bytes\n", full_failure_size);
     printf("  Compact failure structure: %zu bytes\n", compact_failure_size);
 
-    // Verify 6-byte target achieved
-    if (compact_failure_size != 6) {
-        printf("  ❌ Compact structure should be 6 bytes, got %zu\n", compact_failure_size);
+    // Verify 5-byte target achieved (plus any extra service index width)
+    size_t expected_size = 4 + sizeof(ntrip_service_idx_t);
+    if (compact_failure_size != expected_size) {
+        printf("  ❌ Compact structure should be %zu bytes, got %zu\n", expected_size, compact_failure_size);
         return false;
     }
 
@@ -80,7 +81,7 @@ bool test_memory_optimization() {
     printf("    Compact implementation: %zu bytes\n", compact_total);
     printf("    Savings: %zu bytes (%.1f%% reduction)\n", savings, savings_percent);
 
-    // Verify we achieve target 93% reduction
+    // Verify we achieve target 94% reduction
     if (savings_percent < 90.0) {
         printf("  ❌ Expected >90%% reduction, got %.1f%%\n", savings_percent);
         return false;
@@ -104,7 +105,7 @@ bool test_service_mapping() {
     }
 
     // Test service ID to index mapping
-    uint8_t index = ntrip_atlas_get_service_index("rtk2go");
+    ntrip_service_idx_t index = ntrip_atlas_get_service_index("rtk2go");
     if (index != 0) {
         printf("  ❌ rtk2go should map to index 0, got %u\n", index);
         return false;
@@ -118,8 +119,8 @@ bool test_service_mapping() {
 
     // Test unknown service
     index = ntrip_atlas_get_service_index("unknown-service");
-    if (index != 255) {
-        printf("  ❌ Unknown service should return 255, got %u\n", index);
+    if (index != NTRIP_SERVICE_INDEX_INVALID) {
+        printf("  ❌ Unknown service should return an invalid index, got %u\n", (unsigned)index);
         return false;
     }
 
@@ -131,7 +132,7 @@ bool test_service_mapping() {
 bool test_failure_recording() {
     printf("Testing failure recording and blocking...\n");
 
-    uint8_t rtk2go_index = ntrip_atlas_get_service_index("rtk2go");
+    ntrip_service_idx_t rtk2go_index = ntrip_atlas_get_service_index("rtk2go");
 
     // Initially should not be blocked
     if (ntrip_atlas_is_compact_service_blocked(rtk2go_index)) {
@@ -182,7 +183,7 @@ bool test_failure_recording() {
 bool test_exponential_backoff() {
     printf("Testing exponential backoff progression...\n");
 
-    uint8_t test_index = ntrip_atlas_get_service_index("pointone-polaris");
+    ntrip_service_idx_t test_index = ntrip_atlas_get_service_index("pointone-polaris");
 
     // Record multiple failures and check backoff progression
     uint32_t previous_retry_hours = 0;
@@ -224,7 +225,7 @@ bool test_exponential_backoff() {
 bool test_structure_conversion() {
     printf("Testing compact to full structure conversion...\n");
 
-    uint8_t test_index = ntrip_atlas_get_service_index("australia-ga");
+    ntrip_service_idx_t test_index = ntrip_atlas_get_service_index("australia-ga");
 
     // Record a failure
     ntrip_atlas_record_compact_failure(test_index);
@@ -266,8 +267,8 @@ bool test_discovery_integration() {
     printf("Testing discovery integration (skip blocked services)...\n");
 
     // Reset service states (might be blocked from previous tests)
-    uint8_t polaris_index = ntrip_atlas_get_service_index("pointone-polaris");
-    uint8_t australia_index = ntrip_atlas_get_service_index("australia-ga");
+    ntrip_service_idx_t polaris_index = ntrip_atlas_get_service_index("pointone-polaris");
+    ntrip_service_idx_t australia_index = ntrip_atlas_get_service_index("australia-ga");
     ntrip_atlas_record_compact_success(polaris_index);
     ntrip_atlas_record_compact_success(australia_index);
 
@@ -280,8 +281,8 @@ bool test_discovery_integration() {
     };
 
     // Block some services
-    uint8_t rtk2go_index = ntrip_atlas_get_service_index("rtk2go");
-    uint8_t euref_index = ntrip_atlas_get_service_index("euref-ip");
+    ntrip_service_idx_t rtk2go_index = ntrip_atlas_get_service_index("rtk2go");
+    ntrip_service_idx_t euref_index = ntrip_atlas_get_service_index("euref-ip");
 
     ntrip_atlas_record_compact_failure(rtk2go_index);
     ntrip_atlas_record_compact_failure(euref_index);
@@ -343,21 +344,21 @@ bool test_edge_cases() {
     printf("Testing edge cases and error conditions...\n");
 
     // Test invalid service index
-    bool blocked = ntrip_atlas_is_compact_service_blocked(255);
+    bool blocked = ntrip_atlas_is_compact_service_blocked(NTRIP_SERVICE_INDEX_INVALID);
     if (blocked) {
         printf("  ❌ Invalid service index should not be blocked\n");
         return false;
     }
 
     // Test invalid parameters
-    ntrip_atlas_error_t result = ntrip_atlas_record_compact_failure(255);
+    ntrip_atlas_error_t result = ntrip_atlas_record_compact_failure(NTRIP_SERVICE_INDEX_INVALID);
     if (result == NTRIP_ATLAS_SUCCESS) {
         printf("  ❌ Should fail with invalid service index\n");
         return false;
     }
 
     // Test failure count saturation (saturates at 15)
-    uint8_t test_index = ntrip_atlas_get_service_index("finland-finnref");
+    ntrip_service_idx_t test_index = ntrip_atlas_get_service_index("finland-finnref");
 
     // Record 20 failures (more than 15)
     for (int i = 0; i < 20; i++) {
@@ -379,6 +380,50 @@ bool test_edge_cases() {
     return true;
 }
 
+// Test failure tracking over caller-provided storage
+bool test_caller_provided_storage() {
+    printf("Testing caller-provided failure storage...\n");
+
+    static const ntrip_service_index_entry_t small_mapping[] = {
+        {"rtk2go", 0},
+        {"euref-ip", 2},
+    };
+    ntrip_compact_failure_t storage[3];
+
+    // Every mapped index must fit in the caller's table
+    ntrip_atlas_error_t result = ntrip_atlas_init_compact_failure_tracking_with_storage(
+        small_mapping, 2, storage, 2);
+    if (result != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Mapping beyond capacity should be rejected\n");
+        return false;
+    }
+
+    result = ntrip_atlas_init_compact_failure_tracking_with_storage(
+        small_mapping, 2, storage, 3);
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Failed to initialize on caller storage\n");
+        return false;
+    }
+
+    ntrip_service_idx_t euref_index = ntrip_atlas_get_service_index("euref-ip");
+    if (ntrip_atlas_record_compact_failure(euref_index) != NTRIP_ATLAS_SUCCESS ||
+        storage[2].failure_count != 1) {
+        printf("  ❌ Failure not recorded in caller storage\n");
+        return false;
+    }
+
+    if (ntrip_atlas_record_compact_failure(3) == NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Index beyond capacity should be rejected\n");
+        return false;
+    }
+
+    // Restore the built-in table for the remaining tests
+    ntrip_atlas_init_compact_failure_tracking(test_service_index, TEST_SERVICE_COUNT);
+
+    printf("  ✅ Caller-provided storage working correctly\n");
+    return true;
+}
+
 int main() {
     printf("Compact Failure Tracking Tests\n");
     printf("==============================\n\n");
@@ -394,6 +439,7 @@ int main() {
         {"Structure conversion", test_structure_conversion},
         {"Discovery integration", test_discovery_integration},
         {"Edge cases", test_edge_cases},
+        {"Caller-provided storage", test_caller_provided_storage},
     };
 
     int passed = 0;
@@ -413,9 +459,9 @@ int main() {
 
     if (passed == total) {
         printf("🎉 All compact failure tests passed!\n");
-        printf("Memory optimization successfully reduces storage by 93%% (80→6 bytes per service)\n");
+        printf("Memory optimization successfully reduces storage by 94%% (80→5 bytes per service)\n");
         printf("Ready for ESP32 deployment with %zu services using only %zu bytes\n",
-               TEST_SERVICE_COUNT, TEST_SERVICE_COUNT * 6);
+               TEST_SERVICE_COUNT, TEST_SERVICE_COUNT * sizeof(ntrip_compact_failure_t));
         return 0;
     } else {
         printf("💥 Some compact failure tests failed!\n");
@@ -0,0 +1,722 @@
+/**
+ * Non-Blocking Discovery Unit Tests
+ *
+ * Drives several discoveries side by side over a scripted transport that
+ * refuses every other call, checking each finds the same mountpoint as a
+ * blocking ntrip_query_service_streaming(). Also covers response status
+ * handling, step budgets, timeouts and cancellation, and runs the Linux
+ * socket transport against a loopback caster from a poll() loop.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+#include "../../libntripatlas/src/ntrip_stream_parser.h"
+
+#define CASTER_COUNT 4
+#define TABLE_MOUNTPOINTS 200
+#define FAKE_CONNECTIONS 8
+#define LOOPBACK_DISCOVERIES 8
+
+static char g_tables[CASTER_COUNT][TABLE_MOUNTPOINTS * 160 + 256];
+static const char* g_override_response = NULL;  // Replaces every table when set
+static uint32_t g_now_ms = 1000;
+
+static uint32_t rng_state = 69;
+
+static double random_unit(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return (rng_state >> 8) / 16777216.0;
+}
+
+// One sourcetable per caster, each over its own part of Europe
+static void build_tables(void) {
+    const char* formats[] = { "RTCM 3.2", "RTCM 3.1", "RTCM 2.3", "RTCM3" };
+    const char* systems[] = { "GPS+GLO+GAL", "GPS", "GPS+GLO", "GLO" };
+    for (int c = 0; c < CASTER_COUNT; c++) {
+        char* table = g_tables[c];
+        size_t pos = (size_t)sprintf(table, "SOURCETABLE 200 OK\r\nServer: Caster %d\r\nContent-Type: text/plain\r\n\r\n", c);
+        for (int i = 0; i < TABLE_MOUNTPOINTS; i++) {
+            double lat = 44.0 + c * 2.0 + random_unit() * 6.0;
+            double lon = c * 4.0 + random_unit() * 8.0;
+            pos += (size_t)sprintf(table + pos,
+                                   "STR;C%dMP%03d;Site %d;%s;1004(1),1005(10);2;%s;NET;DEU;%.4f;%.4f;%d;0;Receiver;none;%s;%s;%d\r\n",
+                                   c, i, i, formats[(i + c) % 4], systems[(i / 4) % 4], lat, lon, i % 2,
+                                   (i % 3) ? "B" : "N", (i % 5) ? "N" : "Y", 1200 + (i % 7) * 1000);
+        }
+        strcpy(table + pos, "ENDSOURCETABLE\r\n");
+    }
+}
+
+static const char* response_for_host(const char* host) {
+    if (g_override_response) {
+        return g_override_response;
+    }
+    int caster = host[strlen(host) - 1] - '0';
+    return (caster >= 0 && caster < CASTER_COUNT) ? g_tables[caster] : NULL;
+}
+
+/**
+ * Scripted transport: accepts a few bytes at a time and refuses every
+ * other call, so each discovery has to resume many times
+ */
+typedef struct {
+    bool open;
+    const char* response;
+    size_t length;
+    size_t pos;
+    size_t chunk;
+    bool refuse_next;
+    char request[256];
+    size_t request_len;
+} fake_connection_t;
+
+static fake_connection_t g_connections[FAKE_CONNECTIONS];
+static size_t g_fake_chunk = 37;
+static bool g_fake_refuse = true;
+static int g_send_error = 0;
+static int g_would_blocks = 0;
+
+static int fake_connect(const char* host, uint16_t port, uint8_t ssl, void** connection) {
+    (void)port; (void)ssl;
+    const char* response = response_for_host(host);
+    if (!response) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+    for (int i = 0; i < FAKE_CONNECTIONS; i++) {
+        if (!g_connections[i].open) {
+            fake_connection_t* conn = &g_connections[i];
+            memset(conn, 0, sizeof(*conn));
+            conn->open = true;
+            conn->response = response;
+            conn->length = strlen(response);
+            conn->chunk = g_fake_chunk;
+            conn->refuse_next = g_fake_refuse;
+            *connection = conn;
+            return NTRIP_ATLAS_SUCCESS;
+        }
+    }
+    return NTRIP_ATLAS_ERROR_NO_MEMORY;
+}
+
+static bool refuse(fake_connection_t* conn) {
+    if (!g_fake_refuse) {
+        return false;
+    }
+    conn->refuse_next = !conn->refuse_next;
+    if (!conn->refuse_next) {
+        g_would_blocks++;
+        return true;
+    }
+    return false;
+}
+
+static int fake_send(void* connection, const char* data, size_t len) {
+    fake_connection_t* conn = (fake_connection_t*)connection;
+    if (g_send_error) {
+        return g_send_error;
+    }
+    if (refuse(conn)) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    size_t n = len < 5 ? len : 5;
+    if (conn->request_len + n < sizeof(conn->request)) {
+        memcpy(conn->request + conn->request_len, data, n);
+        conn->request_len += n;
+    }
+    return (int)n;
+}
+
+static int fake_recv(void* connection, char* buffer, size_t max_len) {
+    fake_connection_t* conn = (fake_connection_t*)connection;
+    if (refuse(conn)) {
+        return NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    size_t n = conn->length - conn->pos;
+    if (n > conn->chunk) n = conn->chunk;
+    if (n > max_len) n = max_len;
+    memcpy(buffer, conn->response + conn->pos, n);
+    conn->pos += n;
+    return (int)n;
+}
+
+static void fake_close(void* connection) {
+    ((fake_connection_t*)connection)->open = false;
+}
+
+static const ntrip_nb_transport_t g_fake_transport = {
+    .connect = fake_connect,
+    .send = fake_send,
+    .recv = fake_recv,
+    .poll_fd = NULL,
+    .close = fake_close
+};
+
+// Blocking counterpart delivering the same bytes, for reference answers
+static int fake_http_stream(const char* host, uint16_t port, uint8_t ssl, const char* path,
+                            ntrip_stream_callback_t on_data, void* user_context, uint32_t timeout_ms) {
+    (void)port; (void)ssl; (void)path; (void)timeout_ms;
+    const char* response = response_for_host(host);
+    size_t length = strlen(response);
+    for (size_t pos = 0; pos < length; pos += 64) {
+        size_t chunk = length - pos < 64 ? length - pos : 64;
+        if (on_data(response + pos, chunk, user_context) != 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+static uint32_t fake_get_time_ms(void) {
+    return g_now_ms;
+}
+
+static const ntrip_platform_t g_platform = {
+    .interface_version = 2,
+    .http_stream = fake_http_stream,
+    .get_time_ms = fake_get_time_ms,
+    .nb_transport = &g_fake_transport
+};
+
+static ntrip_service_config_t make_service(const char* host) {
+    ntrip_service_config_t service;
+    memset(&service, 0, sizeof(service));
+    strncpy(service.provider, "Test", sizeof(service.provider) - 1);
+    strncpy(service.base_url, host, sizeof(service.base_url) - 1);
+    service.port = 2101;
+    service.quality_rating = 4;
+    return service;
+}
+
+static void reset_fake(void) {
+    memset(g_connections, 0, sizeof(g_connections));
+    g_override_response = NULL;
+    g_fake_chunk = 37;
+    g_fake_refuse = true;
+    g_send_error = 0;
+    g_would_blocks = 0;
+    g_now_ms = 1000;
+}
+
+static int open_connections(void) {
+    int open = 0;
+    for (int i = 0; i < FAKE_CONNECTIONS; i++) {
+        if (g_connections[i].open) open++;
+    }
+    return open;
+}
+
+static bool same_result(const ntrip_mountpoint_t* a, const ntrip_mountpoint_t* b) {
+    return strcmp(a->mountpoint, b->mountpoint) == 0 &&
+           a->suitability_score == b->suitability_score &&
+           a->distance_km == b->distance_km;
+}
+
+// Run one discovery to completion
+static ntrip_atlas_error_t run_discovery(const ntrip_platform_t* platform, const ntrip_service_config_t* service,
+                                         double lat, double lon, const ntrip_selection_criteria_t* criteria,
+                                         ntrip_mountpoint_t* result) {
+    ntrip_discovery_t discovery;
+    ntrip_atlas_error_t ret = ntrip_atlas_discovery_begin(&discovery, platform, service, lat, lon, criteria);
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        return ret;
+    }
+    for (int i = 0; i < 100000 && ntrip_atlas_discovery_step(&discovery) == NTRIP_ATLAS_ERROR_WOULD_BLOCK; i++) {
+    }
+    return ntrip_atlas_discovery_end(&discovery, result);
+}
+
+// Test interleaved discoveries answer exactly like blocking queries
+bool test_interleaved_matches_streaming() {
+    printf("Testing interleaved discoveries against blocking queries...\n");
+    reset_fake();
+
+    ntrip_service_config_t services[CASTER_COUNT];
+    static ntrip_discovery_t discoveries[CASTER_COUNT];
+    const double lats[CASTER_COUNT] = { 47.0, 49.5, 51.0, 53.5 };
+    const double lons[CASTER_COUNT] = { 3.0, 7.5, 11.0, 17.0 };
+    ntrip_selection_criteria_t criteria = {0};
+    criteria.free_only = 1;
+    criteria.min_bitrate = 3000;
+
+    for (int pass = 0; pass < 2; pass++) {
+        const ntrip_selection_criteria_t* active = pass ? &criteria : NULL;
+        for (int c = 0; c < CASTER_COUNT; c++) {
+            char host[32];
+            snprintf(host, sizeof(host), "caster%d", c);
+            services[c] = make_service(host);
+            if (ntrip_atlas_discovery_begin(&discoveries[c], &g_platform, &services[c],
+                                            lats[c], lons[c], active) != NTRIP_ATLAS_SUCCESS) {
+                printf("  ❌ Begin failed for %s\n", host);
+                return false;
+            }
+        }
+
+        // Round-robin like a main loop would, never waiting on one caster
+        int running = CASTER_COUNT;
+        int rounds = 0;
+        bool done[CASTER_COUNT] = { false };
+        while (running > 0 && rounds < 100000) {
+            rounds++;
+            for (int c = 0; c < CASTER_COUNT; c++) {
+                if (done[c]) continue;
+                ntrip_atlas_error_t ret = ntrip_atlas_discovery_step(&discoveries[c]);
+                if (ret != NTRIP_ATLAS_ERROR_WOULD_BLOCK) {
+                    if (ret != NTRIP_ATLAS_SUCCESS) {
+                        printf("  ❌ Step failed for caster %d: %d\n", c, ret);
+                        return false;
+                    }
+                    done[c] = true;
+                    running--;
+                }
+            }
+        }
+        if (running > 0 || rounds < 10) {
+            printf("  ❌ %d discoveries unfinished after %d rounds\n", running, rounds);
+            return false;
+        }
+
+        for (int c = 0; c < CASTER_COUNT; c++) {
+            fake_connection_t* conn = (fake_connection_t*)discoveries[c].stream.connection;
+            if (conn) {
+                printf("  ❌ Connection left open after finishing\n");
+                return false;
+            }
+
+            ntrip_mountpoint_t found, expected;
+            if (ntrip_atlas_discovery_end(&discoveries[c], &found) != NTRIP_ATLAS_SUCCESS ||
+                ntrip_query_service_streaming(&g_platform, &services[c], lats[c], lons[c], active, &expected) != 0) {
+                printf("  ❌ No result for caster %d\n", c);
+                return false;
+            }
+            if (!same_result(&found, &expected) || found.service != &services[c]) {
+                printf("  ❌ Caster %d: %s vs %s\n", c, found.mountpoint, expected.mountpoint);
+                return false;
+            }
+            if (active && (found.fee_required || found.bitrate < 3000)) {
+                printf("  ❌ Criteria not applied\n");
+                return false;
+            }
+        }
+    }
+
+    // The request went out whole despite 5-byte partial sends
+    g_override_response = g_tables[0];
+    ntrip_discovery_t discovery;
+    ntrip_atlas_discovery_begin(&discovery, &g_platform, &services[2], 50.0, 10.0, NULL);
+    while (ntrip_atlas_discovery_step(&discovery) == NTRIP_ATLAS_ERROR_WOULD_BLOCK &&
+           discovery.stream.state == NTRIP_NB_STREAM_SENDING) {
+    }
+    fake_connection_t* conn = (fake_connection_t*)discovery.stream.connection;
+    bool request_ok = conn && strncmp(conn->request, "GET / HTTP/1.1\r\nHost: caster2:2101\r\n", 36) == 0 &&
+                      strstr(conn->request, "User-Agent: NTRIP ") != NULL &&
+                      strcmp(conn->request + conn->request_len - 4, "\r\n\r\n") == 0;
+    ntrip_atlas_discovery_end(&discovery, NULL);
+    if (!request_ok) {
+        printf("  ❌ Malformed request\n");
+        return false;
+    }
+
+    printf("  ✅ %d casters interleaved, %d would-block returns\n", CASTER_COUNT, g_would_blocks);
+    return true;
+}
+
+// Test status lines and early endings map to the right errors
+bool test_response_status() {
+    printf("Testing response status handling...\n");
+    reset_fake();
+    ntrip_service_config_t service = make_service("caster0");
+    ntrip_mountpoint_t result;
+
+    struct {
+        const char* response;
+        ntrip_atlas_error_t expected;
+    } cases[] = {
+        { "HTTP/1.1 200 OK\r\nContent-Type: gnss/sourcetable\r\n\r\n"
+          "STR;NTRIP2;Site;RTCM 3.2;1004;2;GPS;NET;DEU;50.01;10.01;0;0;R;none;N;N;9600\r\n"
+          "ENDSOURCETABLE\r\n", NTRIP_ATLAS_SUCCESS },
+        { "SOURCETABLE 200 OK\n\nSTR;LFONLY;Site;RTCM 3.2;1004;2;GPS;NET;DEU;50.01;10.01;0;0;R;none;N;N;9600\n", NTRIP_ATLAS_SUCCESS },
+        { "ICY 200 OK\r\n\r\nSTR;ICY;Site;RTCM 3.2;1004;2;GPS;NET;DEU;50.01;10.01;0;0;R;none;N;N;9600\r\n", NTRIP_ATLAS_SUCCESS },
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+          "1f\r\nSTR;CHUNKED;Site;RTCM 3.2;1004;\r\n"
+          "3F;ext=1\r\n2;GPS;NET;DEU;50.01;10.01;0;0;R;none;N;N;9600\r\nENDSOURCETABLE\r\n\r\n"
+          "0\r\n\r\n", NTRIP_ATLAS_SUCCESS },
+        { "HTTP/1.1 401 Unauthorized\r\n\r\n", NTRIP_ATLAS_ERROR_AUTH_FAILED },
+        { "HTTP/1.0 404 Not Found\r\n\r\n", NTRIP_ATLAS_ERROR_NOT_FOUND },
+        { "HTTP/1.1 503 Service Unavailable\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "garbage\r\n\r\nSTR;X;Site;RTCM 3.2;1004;2;GPS;NET;DEU;50.01;10.01;0;0;R;none;N;N;9600\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "SOURCETABLE 200 OK\r\nServer: cut", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "SOURCETABLE 200 OK\r\n\r\nENDSOURCETABLE\r\n", NTRIP_ATLAS_ERROR_NO_SERVICES },
+    };
+    const char* expected_mountpoints[] = { "NTRIP2", "LFONLY", "ICY", "CHUNKED" };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        g_override_response = cases[i].response;
+        for (int chunk = 1; chunk <= 64; chunk *= 4) {
+            g_fake_chunk = (size_t)chunk;
+            memset(&result, 0, sizeof(result));
+            ntrip_atlas_error_t ret = run_discovery(&g_platform, &service, 50.0, 10.0, NULL, &result);
+            if (ret != cases[i].expected) {
+                printf("  ❌ Case %zu (chunk %d): %d, expected %d\n", i, chunk, ret, cases[i].expected);
+                return false;
+            }
+            if (i < 4 && strcmp(result.mountpoint, expected_mountpoints[i]) != 0) {
+                printf("  ❌ Case %zu parsed %s\n", i, result.mountpoint);
+                return false;
+            }
+        }
+    }
+
+    // Transport errors end the discovery with their own code
+    g_override_response = NULL;
+    g_send_error = NTRIP_ATLAS_ERROR_NO_NETWORK;
+    if (run_discovery(&g_platform, &service, 50.0, 10.0, NULL, &result) != NTRIP_ATLAS_ERROR_NO_NETWORK ||
+        open_connections() != 0) {
+        printf("  ❌ Send error not reported\n");
+        return false;
+    }
+
+    printf("  ✅ Status lines and early endings handled\n");
+    return true;
+}
+
+// Test per-step read budget, timeout and cancellation
+bool test_budget_timeout_cancel() {
+    printf("Testing step budget, timeout and cancellation...\n");
+    reset_fake();
+    g_fake_refuse = false;
+    g_fake_chunk = 100000;
+    ntrip_service_config_t service = make_service("caster1");
+
+    // Far from every mountpoint so nothing terminates the table early
+    ntrip_discovery_t discovery;
+    ntrip_atlas_discovery_begin(&discovery, &g_platform, &service, 0.0, -60.0, NULL);
+    int steps = 0;
+    ntrip_atlas_error_t ret;
+    do {
+        ret = ntrip_atlas_discovery_step(&discovery);
+        steps++;
+        if (ret == NTRIP_ATLAS_ERROR_WOULD_BLOCK &&
+            discovery.stream.bytes_received != (size_t)steps * NTRIP_ATLAS_NB_STEP_BYTES) {
+            printf("  ❌ Step %d read %zu bytes in total\n", steps, discovery.stream.bytes_received);
+            return false;
+        }
+    } while (ret == NTRIP_ATLAS_ERROR_WOULD_BLOCK && steps < 1000);
+    size_t table_length = strlen(g_tables[1]);
+    if (ret != NTRIP_ATLAS_SUCCESS || discovery.stream.bytes_received != table_length ||
+        steps != (int)((table_length + NTRIP_ATLAS_NB_STEP_BYTES - 1) / NTRIP_ATLAS_NB_STEP_BYTES)) {
+        printf("  ❌ %d steps for %zu bytes\n", steps, table_length);
+        return false;
+    }
+    if (ntrip_atlas_discovery_step(&discovery) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Finished discovery did not keep its status\n");
+        return false;
+    }
+    ntrip_atlas_discovery_end(&discovery, NULL);
+
+    // A caster that stops talking times out
+    g_fake_refuse = true;
+    ntrip_atlas_discovery_begin(&discovery, &g_platform, &service, 50.0, 10.0, NULL);
+    ntrip_atlas_discovery_step(&discovery);
+    g_now_ms += NTRIP_ATLAS_DISCOVERY_TIMEOUT_MS + 1;
+    ret = ntrip_atlas_discovery_step(&discovery);
+    if (ret != NTRIP_ATLAS_ERROR_TIMEOUT || open_connections() != 0 ||
+        ntrip_atlas_discovery_end(&discovery, NULL) != NTRIP_ATLAS_ERROR_TIMEOUT) {
+        printf("  ❌ Timeout not reported: %d\n", ret);
+        return false;
+    }
+
+    // Ending early closes the connection and keeps what was parsed so far
+    g_now_ms = 1000;
+    g_fake_refuse = false;
+    ntrip_atlas_discovery_begin(&discovery, &g_platform, &service, 0.0, -60.0, NULL);
+    ntrip_atlas_discovery_step(&discovery);
+    ntrip_mountpoint_t partial;
+    if (ntrip_atlas_discovery_end(&discovery, &partial) != NTRIP_ATLAS_SUCCESS ||
+        open_connections() != 0 || strncmp(partial.mountpoint, "C1MP", 4) != 0) {
+        printf("  ❌ Cancellation lost the partial result\n");
+        return false;
+    }
+    if (ntrip_atlas_discovery_end(&discovery, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Double end accepted\n");
+        return false;
+    }
+
+    printf("  ✅ %d bounded steps for %zu bytes\n", steps, table_length);
+    return true;
+}
+
+// Test platforms without a transport and invalid use
+bool test_missing_feature_and_params() {
+    printf("Testing missing transport and invalid parameters...\n");
+    reset_fake();
+    ntrip_service_config_t service = make_service("caster0");
+    ntrip_discovery_t discovery;
+    memset(&discovery, 0, sizeof(discovery));
+
+    ntrip_platform_t blocking_only = g_platform;
+    blocking_only.nb_transport = NULL;
+    if (ntrip_atlas_discovery_begin(&discovery, &blocking_only, &service, 50.0, 10.0, NULL) !=
+        NTRIP_ATLAS_ERROR_MISSING_FEATURE) {
+        printf("  ❌ Platform without transport accepted\n");
+        return false;
+    }
+
+    if (ntrip_atlas_discovery_begin(NULL, &g_platform, &service, 50.0, 10.0, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_discovery_begin(&discovery, NULL, &service, 50.0, 10.0, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_discovery_begin(&discovery, &g_platform, NULL, 50.0, 10.0, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ NULL parameters accepted\n");
+        return false;
+    }
+
+    // Connect failures come back from begin with nothing to end
+    ntrip_service_config_t unknown = make_service("nowhere");
+    if (ntrip_atlas_discovery_begin(&discovery, &g_platform, &unknown, 50.0, 10.0, NULL) != NTRIP_ATLAS_ERROR_NO_NETWORK ||
+        ntrip_atlas_discovery_step(&discovery) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_discovery_end(&discovery, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Connect failure not reported by begin\n");
+        return false;
+    }
+
+    bool want_write = true;
+    if (ntrip_atlas_discovery_poll_fd(NULL, &want_write) != -1 || want_write) {
+        printf("  ❌ poll_fd on NULL discovery\n");
+        return false;
+    }
+    ntrip_atlas_discovery_begin(&discovery, &g_platform, &service, 50.0, 10.0, NULL);
+    if (ntrip_atlas_discovery_poll_fd(&discovery, &want_write) != -1 || !want_write) {
+        printf("  ❌ Transport without descriptors should report -1 and want write\n");
+        return false;
+    }
+    ntrip_atlas_discovery_end(&discovery, NULL);
+
+    printf("  ✅ Missing transport and invalid use rejected\n");
+    return true;
+}
+
+/**
+ * Loopback caster for the Linux socket transport
+ */
+typedef struct {
+    int listen_fd;
+    int connections;
+} loopback_server_t;
+
+static void* serve_loopback(void* arg) {
+    loopback_server_t* server = (loopback_server_t*)arg;
+    for (int i = 0; i < server->connections; i++) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) break;
+
+        // Read the request up to its blank line
+        char request[512];
+        size_t length = 0;
+        while (length < sizeof(request) - 1) {
+            ssize_t n = recv(fd, request + length, sizeof(request) - 1 - length, 0);
+            if (n <= 0) break;
+            length += (size_t)n;
+            request[length] = '\0';
+            if (strstr(request, "\r\n\r\n")) break;
+        }
+
+        // Every connection is the same host, so serve the tables in turn
+        const char* table = g_tables[i % CASTER_COUNT];
+        size_t table_length = strlen(table);
+        for (size_t pos = 0; pos < table_length; ) {
+            size_t piece = table_length - pos < 1500 ? table_length - pos : 1500;
+            ssize_t n = send(fd, table + pos, piece, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            pos += (size_t)n;
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+// Test the Linux socket transport from a poll() loop
+bool test_linux_socket_loopback() {
+    printf("Testing Linux sockets against a loopback caster...\n");
+    reset_fake();
+
+    loopback_server_t server = { .connections = LOOPBACK_DISCOVERIES };
+    server.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    if (server.listen_fd < 0 ||
+        bind(server.listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(server.listen_fd, LOOPBACK_DISCOVERIES) != 0 ||
+        getsockname(server.listen_fd, (struct sockaddr*)&address, &address_length) != 0) {
+        printf("  ❌ Could not start loopback caster\n");
+        return false;
+    }
+    uint16_t port = ntohs(address.sin_port);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, serve_loopback, &server);
+
+    ntrip_platform_t platform = g_platform;
+    platform.nb_transport = &ntrip_platform_linux_nb_transport;
+    platform.get_time_ms = NULL;
+
+    ntrip_service_config_t service = make_service("127.0.0.1");
+    service.port = port;
+    static ntrip_discovery_t discoveries[LOOPBACK_DISCOVERIES];
+    bool done[LOOPBACK_DISCOVERIES] = { false };
+    ntrip_atlas_error_t status[LOOPBACK_DISCOVERIES];
+    for (int i = 0; i < LOOPBACK_DISCOVERIES; i++) {
+        if (ntrip_atlas_discovery_begin(&discoveries[i], &platform, &service, 50.0, 10.0, NULL) != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Begin failed\n");
+            return false;
+        }
+    }
+
+    int running = LOOPBACK_DISCOVERIES;
+    int polls = 0;
+    while (running > 0 && polls < 10000) {
+        struct pollfd fds[LOOPBACK_DISCOVERIES];
+        int owner[LOOPBACK_DISCOVERIES];
+        nfds_t count = 0;
+        for (int i = 0; i < LOOPBACK_DISCOVERIES; i++) {
+            if (done[i]) continue;
+            bool want_write;
+            fds[count].fd = ntrip_atlas_discovery_poll_fd(&discoveries[i], &want_write);
+            fds[count].events = want_write ? POLLOUT : POLLIN;
+            owner[count++] = i;
+        }
+        if (poll(fds, count, 5000) <= 0) {
+            break;
+        }
+        polls++;
+        for (nfds_t f = 0; f < count; f++) {
+            if (!fds[f].revents) continue;
+            int i = owner[f];
+            ntrip_atlas_error_t ret = ntrip_atlas_discovery_step(&discoveries[i]);
+            if (ret != NTRIP_ATLAS_ERROR_WOULD_BLOCK) {
+                status[i] = ret;
+                done[i] = true;
+                running--;
+            }
+        }
+    }
+
+    bool ok = running == 0;
+    int found_tables = 0;
+    for (int i = 0; i < LOOPBACK_DISCOVERIES && ok; i++) {
+        ntrip_mountpoint_t found;
+        if (status[i] != NTRIP_ATLAS_SUCCESS || ntrip_atlas_discovery_end(&discoveries[i], &found) != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Discovery %d ended with %d\n", i, status[i]);
+            ok = false;
+            break;
+        }
+
+        // Connections are served in accept order, so match against any table
+        for (int c = 0; c < CASTER_COUNT; c++) {
+            char host[32];
+            snprintf(host, sizeof(host), "caster%d", c);
+            ntrip_service_config_t reference_service = make_service(host);
+            ntrip_mountpoint_t expected;
+            if (ntrip_query_service_streaming(&g_platform, &reference_service, 50.0, 10.0, NULL, &expected) == 0 &&
+                same_result(&found, &expected)) {
+                found_tables |= 1 << c;
+                break;
+            }
+        }
+    }
+    if (!ok) {
+        for (int i = 0; i < LOOPBACK_DISCOVERIES; i++) {
+            if (!done[i]) ntrip_atlas_discovery_end(&discoveries[i], NULL);
+        }
+    }
+    pthread_join(thread, NULL);
+    close(server.listen_fd);
+    if (!ok) {
+        printf("  ❌ %d discoveries unfinished after %d polls\n", running, polls);
+        return false;
+    }
+    if (found_tables != (1 << CASTER_COUNT) - 1) {
+        printf("  ❌ Results did not match the served tables (mask %x)\n", found_tables);
+        return false;
+    }
+
+    // Nothing listens on the closed port any more
+    ntrip_discovery_t refused;
+    ntrip_atlas_error_t ret = ntrip_atlas_discovery_begin(&refused, &platform, &service, 50.0, 10.0, NULL);
+    if (ret == NTRIP_ATLAS_SUCCESS) {
+        for (int i = 0; i < 1000 && (ret = ntrip_atlas_discovery_step(&refused)) == NTRIP_ATLAS_ERROR_WOULD_BLOCK; i++) {
+            bool want_write;
+            struct pollfd pfd = { .fd = ntrip_atlas_discovery_poll_fd(&refused, &want_write), .events = POLLOUT };
+            poll(&pfd, 1, 100);
+        }
+        ntrip_atlas_discovery_end(&refused, NULL);
+    }
+    if (ret != NTRIP_ATLAS_ERROR_NO_NETWORK) {
+        printf("  ❌ Refused connection reported %d\n", ret);
+        return false;
+    }
+
+    service.ssl = 1;
+    if (ntrip_atlas_discovery_begin(&refused, &platform, &service, 50.0, 10.0, NULL) != NTRIP_ATLAS_ERROR_MISSING_FEATURE) {
+        printf("  ❌ TLS should be reported as unsupported\n");
+        return false;
+    }
+
+    printf("  ✅ %d concurrent discoveries in %d polls\n", LOOPBACK_DISCOVERIES, polls);
+    return true;
+}
+
+int main() {
+    printf("Discovery Tests\n");
+    printf("===============\n\n");
+
+    build_tables();
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Interleaved matches streaming", test_interleaved_matches_streaming},
+        {"Response status", test_response_status},
+        {"Budget, timeout and cancel", test_budget_timeout_cancel},
+        {"Missing feature and parameters", test_missing_feature_and_params},
+        {"Linux socket loopback", test_linux_socket_loopback},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All discovery tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some discovery tests failed!\n");
+        return 1;
+    }
+}
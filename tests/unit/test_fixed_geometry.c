@@ -0,0 +1,251 @@
+/**
+ * Fixed-Point Geometry Unit Tests
+ *
+ * Checks the integer-only backend used on FPU-less targets against libm:
+ * CORDIC sin/cos and atan2, the integer square root, chord distances and
+ * the integer coverage check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Reference haversine distance (m)
+static double reference_distance_m(double lat1, double lon1, double lat2, double lon2) {
+    double p1 = lat1 * M_PI / 180.0, p2 = lat2 * M_PI / 180.0;
+    double dlat = p2 - p1, dlon = (lon2 - lon1) * M_PI / 180.0;
+    double a = sin(dlat / 2) * sin(dlat / 2) + cos(p1) * cos(p2) * sin(dlon / 2) * sin(dlon / 2);
+    return 6371000.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
+// Test sin/cos against libm over several turns
+bool test_sin_cos() {
+    printf("Testing CORDIC sin/cos...\n");
+
+    int32_t max_error = 0;
+    for (int32_t angle = -360000000; angle <= 360000000; angle += 99991) {
+        int32_t s, c;
+        ntrip_atlas_fixed_sin_cos(angle, &s, &c);
+
+        double radians = angle * 1e-6 * M_PI / 180.0;
+        int32_t es = abs(s - (int32_t)lround(sin(radians) * 1073741824.0));
+        int32_t ec = abs(c - (int32_t)lround(cos(radians) * 1073741824.0));
+        if (es > max_error) max_error = es;
+        if (ec > max_error) max_error = ec;
+    }
+
+    printf("  Max error: %d Q30 LSB\n", max_error);
+    if (max_error > 32) {
+        printf("  ❌ sin/cos error too large\n");
+        return false;
+    }
+
+    printf("  ✅ sin/cos within %d LSB of libm\n", max_error);
+    return true;
+}
+
+// Test atan2 in every quadrant and for tiny and huge inputs
+bool test_atan2() {
+    printf("Testing CORDIC atan2...\n");
+
+    const struct { int64_t y, x; } cases[] = {
+        {1, 0}, {0, 1}, {0, -1}, {-1, 0}, {1, 1}, {-1, -1}, {3, -4},
+        {-5, 12}, {1000000007LL, 1}, {1LL << 60, 1LL << 59}, {7, 1LL << 40},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        double expected = atan2((double)cases[i].y, (double)cases[i].x) / (2 * M_PI) * 4294967296.0;
+        int32_t got = ntrip_atlas_fixed_atan2(cases[i].y, cases[i].x);
+
+        // Compare modulo one turn so ±180° agree
+        int32_t error = (int32_t)((uint32_t)got - (uint32_t)(int64_t)llround(expected));
+        if (abs(error) > 64) {
+            printf("  ❌ atan2(%lld, %lld) = %d, expected %.0f\n",
+                   (long long)cases[i].y, (long long)cases[i].x, got, expected);
+            return false;
+        }
+    }
+
+    printf("  ✅ atan2 matches libm in all quadrants\n");
+    return true;
+}
+
+// Test integer square root is the exact floor
+bool test_isqrt() {
+    printf("Testing integer square root...\n");
+
+    const uint64_t values[] = {0, 1, 2, 3, 4, 15, 16, 17, 1ULL << 60, (1ULL << 60) - 1,
+                               4294967295ULL * 4294967295ULL, UINT64_MAX};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint64_t r = ntrip_atlas_fixed_isqrt64(values[i]);
+        bool floor_ok = r * r <= values[i];
+        bool next_ok = r == UINT32_MAX || (r + 1) * (r + 1) > values[i];
+        if (!floor_ok || !next_ok) {
+            printf("  ❌ isqrt(%llu) = %llu\n", (unsigned long long)values[i], (unsigned long long)r);
+            return false;
+        }
+    }
+
+    srand(64);
+    for (int i = 0; i < 10000; i++) {
+        uint64_t v = ((uint64_t)rand() << 33) ^ ((uint64_t)rand() << 11) ^ (uint64_t)rand();
+        uint64_t r = ntrip_atlas_fixed_isqrt64(v);
+        if (r * r > v || (r + 1) * (r + 1) <= v) {
+            printf("  ❌ isqrt(%llu) = %llu\n", (unsigned long long)v, (unsigned long long)r);
+            return false;
+        }
+    }
+
+    printf("  ✅ isqrt exact\n");
+    return true;
+}
+
+// Test distances against haversine, short range and global
+bool test_distance() {
+    printf("Testing fixed-point distance...\n");
+
+    double max_short = 0.0, max_long = 0.0;
+    srand(1005);
+    for (int i = 0; i < 20000; i++) {
+        double lat1 = rand() / (double)RAND_MAX * 170.0 - 85.0;
+        double lon1 = rand() / (double)RAND_MAX * 360.0 - 180.0;
+        bool local = i % 2 == 0;
+        double lat2 = local ? lat1 + (rand() / (double)RAND_MAX - 0.5) * 0.5
+                            : rand() / (double)RAND_MAX * 170.0 - 85.0;
+        double lon2 = local ? lon1 + (rand() / (double)RAND_MAX - 0.5) * 0.5
+                            : rand() / (double)RAND_MAX * 360.0 - 180.0;
+
+        uint32_t got = ntrip_atlas_fixed_distance_m(
+            NTRIP_ATLAS_DEG_TO_MICRODEG(lat1), NTRIP_ATLAS_DEG_TO_MICRODEG(lon1),
+            NTRIP_ATLAS_DEG_TO_MICRODEG(lat2), NTRIP_ATLAS_DEG_TO_MICRODEG(lon2));
+        double error = fabs(got - reference_distance_m(lat1, lon1, lat2, lon2));
+
+        if (local && error > max_short) max_short = error;
+        if (!local && error > max_long) max_long = error;
+    }
+
+    printf("  Max error: %.2f m (< 30 km), %.2f m (global)\n", max_short, max_long);
+    if (max_short > 2.0 || max_long > 20.0) {
+        printf("  ❌ Distance error too large\n");
+        return false;
+    }
+
+    if (ntrip_atlas_fixed_distance_m(52000000, 13000000, 52000000, 13000000) != 0) {
+        printf("  ❌ Same point should be 0 m\n");
+        return false;
+    }
+
+    uint32_t antipode = ntrip_atlas_fixed_distance_m(0, 0, 0, 180000000);
+    if (fabs(antipode - M_PI * 6371000.0) > 20.0) {
+        printf("  ❌ Antipode %u m\n", antipode);
+        return false;
+    }
+
+    printf("  ✅ Distances match haversine\n");
+    return true;
+}
+
+// Test meters to binary angle conversion
+bool test_meters_to_angle() {
+    printf("Testing meters to angle...\n");
+
+    double expected = 1000.0 / (2 * M_PI * 6371000.0) * 4294967296.0;
+    if (fabs(ntrip_atlas_fixed_meters_to_angle(1000) - expected) > 1.0) {
+        printf("  ❌ 1 km angle %u, expected %.1f\n", ntrip_atlas_fixed_meters_to_angle(1000), expected);
+        return false;
+    }
+    if (ntrip_atlas_fixed_meters_to_angle(UINT32_MAX) != 0x80000000U) {
+        printf("  ❌ Angle should clamp at half a turn\n");
+        return false;
+    }
+
+    printf("  ✅ Conversion correct\n");
+    return true;
+}
+
+// Test integer coverage check rounds the same way as the double path
+bool test_coverage() {
+    printf("Testing integer coverage check...\n");
+
+    ntrip_service_compact_t service = {0};
+    service.lat_min_deg100 = 4700;
+    service.lat_max_deg100 = 5500;
+    service.lon_min_deg100 = -1000;
+    service.lon_max_deg100 = 1500;
+
+    const struct { int32_t lat, lon; bool inside; } cases[] = {
+        {52000000, 10000000, true},
+        {46996000, 0, true},          // Rounds up to 47.00
+        {46994000, 0, false},         // Rounds down to 46.99
+        {55004999, 15004999, true},
+        {55005000, 0, false},
+        {50000000, -10004999, true},
+        {50000000, -10005000, false},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (ntrip_atlas_fixed_is_within_coverage(&service, cases[i].lat, cases[i].lon) != cases[i].inside) {
+            printf("  ❌ (%d, %d) should be %s\n", cases[i].lat, cases[i].lon,
+                   cases[i].inside ? "inside" : "outside");
+            return false;
+        }
+    }
+
+    if (ntrip_atlas_fixed_is_within_coverage(NULL, 0, 0)) {
+        printf("  ❌ NULL service should not cover\n");
+        return false;
+    }
+
+    printf("  ✅ Coverage boundaries correct\n");
+    return true;
+}
+
+int main() {
+    printf("Fixed-Point Geometry Tests\n");
+    printf("==========================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Sin/cos", test_sin_cos},
+        {"Atan2", test_atan2},
+        {"Integer square root", test_isqrt},
+        {"Distance", test_distance},
+        {"Meters to angle", test_meters_to_angle},
+        {"Coverage", test_coverage},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All fixed-point geometry tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some fixed-point geometry tests failed!\n");
+        return 1;
+    }
+}
@@ -14,6 +14,16 @@
 // Include the header
 #include "../../libntripatlas/include/ntrip_atlas.h"
 
+// Service indices standing in for entries of the service table
+#define SVC_POINT_ONE       3
+#define SVC_RTK2GO          7
+#define SVC_GEOSCIENCE_AU   12
+#define SVC_MASS_DOT        20
+#define SVC_FINLAND_NLS     31
+#define SVC_BKG_EUREF       42
+#define SVC_TEST            55
+#define SVC_GRID_TEST       60
+
 // Test initialization of geographic blacklisting system
 bool test_blacklist_initialization() {
     printf("Testing blacklist system initialization...\n");
@@ -52,7 +62,7 @@ bool test_add_blacklist_regions() {
 
     // Add blacklist for Point One in Antarctica (no coverage expected)
     ntrip_atlas_error_t result = ntrip_atlas_blacklist_service_region(
-        "Point One Navigation", -85.0, 0.0, "No coverage in Antarctica"
+        SVC_POINT_ONE, -85.0, 0.0, "No coverage in Antarctica"
     );
 
     if (result != NTRIP_ATLAS_SUCCESS) {
@@ -61,25 +71,25 @@ bool test_add_blacklist_regions() {
     }
 
     // Verify region is blacklisted
-    if (!ntrip_atlas_is_service_geographically_blacklisted("Point One Navigation", -85.0, 0.0)) {
+    if (!ntrip_atlas_is_service_geographically_blacklisted(SVC_POINT_ONE, -85.0, 0.0)) {
         printf("  ❌ Region should be blacklisted but isn't\n");
         return false;
     }
 
     // Verify nearby location is also blacklisted (same grid square)
-    if (!ntrip_atlas_is_service_geographically_blacklisted("Point One Navigation", -85.2, 0.3)) {
+    if (!ntrip_atlas_is_service_geographically_blacklisted(SVC_POINT_ONE, -85.2, 0.3)) {
         printf("  ❌ Nearby location in same grid should be blacklisted\n");
         return false;
     }
 
     // Verify different region is not blacklisted
-    if (ntrip_atlas_is_service_geographically_blacklisted("Point One Navigation", 40.0, -74.0)) {
+    if (ntrip_atlas_is_service_geographically_blacklisted(SVC_POINT_ONE, 40.0, -74.0)) {
         printf("  ❌ New York region should not be blacklisted\n");
         return false;
     }
 
     // Verify different service is not affected
-    if (ntrip_atlas_is_service_geographically_blacklisted("RTK2go Community", -85.0, 0.0)) {
+    if (ntrip_atlas_is_service_geographically_blacklisted(SVC_RTK2GO, -85.0, 0.0)) {
         printf("  ❌ Different service should not be blacklisted\n");
         return false;
     }
@@ -95,7 +105,7 @@ bool test_multiple_blacklist_regions() {
     ntrip_atlas_clear_all_geographic_blacklists();
 
     // Add multiple regions for Geoscience Australia (should only cover Australia)
-    const char* provider = "Geoscience Australia";
+    ntrip_service_idx_t provider = SVC_GEOSCIENCE_AU;
     struct {
         double lat, lon;
         const char* reason;
@@ -151,7 +161,7 @@ bool test_remove_blacklist_regions() {
 
     ntrip_atlas_clear_all_geographic_blacklists();
 
-    const char* provider = "Massachusetts DOT";
+    ntrip_service_idx_t provider = SVC_MASS_DOT;
 
     // Add blacklist region
     ntrip_atlas_blacklist_service_region(provider, 60.0, 2.0, "No coverage in Scandinavia");
@@ -192,8 +202,8 @@ bool test_clear_service_blacklists() {
 
     ntrip_atlas_clear_all_geographic_blacklists();
 
-    const char* provider1 = "Finland NLS";
-    const char* provider2 = "BKG EUREF-IP";
+    ntrip_service_idx_t provider1 = SVC_FINLAND_NLS;
+    ntrip_service_idx_t provider2 = SVC_BKG_EUREF;
 
     // Add blacklists for both services
     ntrip_atlas_blacklist_service_region(provider1, -40.0, 175.0, "No coverage in New Zealand");
@@ -238,7 +248,7 @@ bool test_blacklist_capacity() {
 
     ntrip_atlas_clear_all_geographic_blacklists();
 
-    const char* provider = "Test Service";
+    ntrip_service_idx_t provider = SVC_TEST;
 
     // Add maximum number of blacklist entries (8 per service)
     for (int i = 0; i < 8; i++) {
@@ -272,20 +282,118 @@ bool test_blacklist_capacity() {
         return false;
     }
 
-    // One of the old entries should have been replaced
-    // (We can't predict which one due to time-based LRU, but the system should still function)
+    // The oldest entry makes room, the rest survive
+    if (ntrip_atlas_is_service_geographically_blacklisted(provider, 0.0, 0.0)) {
+        printf("  ❌ Oldest entry should have been replaced\n");
+        return false;
+    }
+    for (int i = 1; i < 8; i++) {
+        if (!ntrip_atlas_is_service_geographically_blacklisted(provider, i * 10.0, i * 10.0)) {
+            printf("  ❌ Entry %d should still be blacklisted\n", i);
+            return false;
+        }
+    }
 
     printf("  ✅ Blacklist capacity limits working correctly\n");
     return true;
 }
 
+// Test the region pool shared by all services
+bool test_shared_pool_capacity() {
+    printf("Testing shared blacklist pool...\n");
+
+    ntrip_atlas_clear_all_geographic_blacklists();
+
+    // Fill the pool with two regions per service
+    size_t services = NTRIP_GEO_BLACKLIST_MAX_ENTRIES / 2;
+    for (size_t i = 0; i < NTRIP_GEO_BLACKLIST_MAX_ENTRIES; i++) {
+        ntrip_service_idx_t service = (ntrip_service_idx_t)(i % services);
+        double lat = (double)(i / services) * 10.0;
+        if (ntrip_atlas_blacklist_service_region(service, lat, 0.0, "Pool entry") != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Failed to add pool entry %zu\n", i);
+            return false;
+        }
+    }
+
+    ntrip_geo_blacklist_stats_t stats;
+    ntrip_atlas_get_geographic_blacklist_stats(&stats);
+    if (stats.services_with_blacklists != services ||
+        stats.total_blacklisted_regions != NTRIP_GEO_BLACKLIST_MAX_ENTRIES) {
+        printf("  ❌ Expected %zu services with %d regions, got %u with %u\n",
+               services, NTRIP_GEO_BLACKLIST_MAX_ENTRIES,
+               stats.services_with_blacklists, stats.total_blacklisted_regions);
+        return false;
+    }
+
+    // A full pool gives up its oldest region, whichever service owns it
+    ntrip_atlas_blacklist_service_region(SVC_TEST, 50.0, 50.0, "Overflow entry");
+    if (ntrip_atlas_is_service_geographically_blacklisted(0, 0.0, 0.0) ||
+        !ntrip_atlas_is_service_geographically_blacklisted(0, 10.0, 0.0) ||
+        !ntrip_atlas_is_service_geographically_blacklisted(SVC_TEST, 50.0, 50.0)) {
+        printf("  ❌ Full pool should replace only its oldest region\n");
+        return false;
+    }
+
+    ntrip_atlas_get_geographic_blacklist_stats(&stats);
+    if (stats.total_blacklisted_regions != NTRIP_GEO_BLACKLIST_MAX_ENTRIES) {
+        printf("  ❌ Pool should stay full, got %u regions\n", stats.total_blacklisted_regions);
+        return false;
+    }
+
+    printf("  ✅ Shared blacklist pool working correctly\n");
+    return true;
+}
+
+// Test that only real changes move the blacklist generation
+bool test_generation_tracks_changes() {
+    printf("Testing blacklist generation...\n");
+
+    ntrip_atlas_clear_all_geographic_blacklists();
+    ntrip_service_idx_t provider = SVC_TEST;
+
+    // Nothing to clear or remove
+    uint32_t generation = ntrip_atlas_get_geographic_blacklist_generation();
+    ntrip_atlas_clear_all_geographic_blacklists();
+    ntrip_atlas_clear_service_geographic_blacklist(provider);
+    ntrip_atlas_remove_geographic_blacklist(provider, 10.0, 10.0);
+    ntrip_atlas_init_geographic_blacklist();
+    if (ntrip_atlas_get_geographic_blacklist_generation() != generation) {
+        printf("  ❌ No-op calls should not change the generation\n");
+        return false;
+    }
+
+    ntrip_atlas_blacklist_service_region(provider, 10.0, 10.0, "No coverage");
+    if (ntrip_atlas_get_geographic_blacklist_generation() == generation) {
+        printf("  ❌ Adding a region should change the generation\n");
+        return false;
+    }
+
+    // Re-adding the same region only refreshes it
+    generation = ntrip_atlas_get_geographic_blacklist_generation();
+    ntrip_atlas_blacklist_service_region(provider, 10.5, 10.5, "Still no coverage");
+    ntrip_atlas_clear_service_geographic_blacklist(SVC_GRID_TEST);
+    if (ntrip_atlas_get_geographic_blacklist_generation() != generation) {
+        printf("  ❌ Refreshing a region should not change the generation\n");
+        return false;
+    }
+
+    ntrip_atlas_clear_service_geographic_blacklist(provider);
+    if (ntrip_atlas_get_geographic_blacklist_generation() == generation) {
+        printf("  ❌ Clearing a service's regions should change the generation\n");
+        return false;
+    }
+
+    printf("  ✅ Blacklist generation working correctly\n");
+    return true;
+}
+
 // Test geographic grid precision
 bool test_geographic_grid_precision() {
     printf("Testing geographic grid precision...\n");
 
     ntrip_atlas_clear_all_geographic_blacklists();
 
-    const char* provider = "Grid Test Service";
+    ntrip_service_idx_t provider = SVC_GRID_TEST;
 
     // Add blacklist at specific coordinate
     ntrip_atlas_blacklist_service_region(provider, 40.123, -74.567, "Precise location");
@@ -326,14 +434,15 @@ bool test_geographic_grid_precision() {
 bool test_error_handling() {
     printf("Testing error handling...\n");
 
-    // Test with NULL parameters
-    if (ntrip_atlas_blacklist_service_region(NULL, 0.0, 0.0, "test") == NTRIP_ATLAS_SUCCESS) {
-        printf("  ❌ Should fail with NULL provider\n");
+    // Test with invalid parameters
+    if (ntrip_atlas_blacklist_service_region(NTRIP_SERVICE_INDEX_INVALID, 0.0, 0.0, "test") ==
+        NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Should fail with invalid service index\n");
         return false;
     }
 
-    if (ntrip_atlas_is_service_geographically_blacklisted(NULL, 0.0, 0.0)) {
-        printf("  ❌ Should return false with NULL provider\n");
+    if (ntrip_atlas_is_service_geographically_blacklisted(NTRIP_SERVICE_INDEX_INVALID, 0.0, 0.0)) {
+        printf("  ❌ Should return false with invalid service index\n");
         return false;
     }
 
@@ -363,6 +472,8 @@ int main() {
         {"Remove blacklist regions", test_remove_blacklist_regions},
         {"Clear service blacklists", test_clear_service_blacklists},
         {"Blacklist capacity limits", test_blacklist_capacity},
+        {"Shared blacklist pool", test_shared_pool_capacity},
+        {"Blacklist generation", test_generation_tracks_changes},
         {"Geographic grid precision", test_geographic_grid_precision},
         {"Error handling", test_error_handling},
     };
@@ -14,6 +14,10 @@
 // Include the header
 #include "../../libntripatlas/include/ntrip_atlas.h"
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 // Helper function to create test service
 ntrip_service_compact_t create_test_service(const char* hostname,
                                           double lat_min, double lat_max,
@@ -110,6 +114,99 @@ bool test_distance_calculations() {
     return true;
 }
 
+// Brute-force distance to box boundary by dense sampling (reference)
+static double sampled_distance_to_box(double lat, double lon,
+                                      double lat_min, double lat_max,
+                                      double lon_min, double lon_max) {
+    double best = INFINITY;
+    for (int i = 0; i <= 2000; i++) {
+        double t = i / 2000.0;
+        double edge_lat = lat_min + (lat_max - lat_min) * t;
+        double edge_lon = lon_min + (lon_max - lon_min) * t;
+        double candidates[4][2] = {
+            {edge_lat, lon_min}, {edge_lat, lon_max},
+            {lat_min, edge_lon}, {lat_max, edge_lon}
+        };
+        for (int c = 0; c < 4; c++) {
+            double p1 = lat * M_PI / 180.0, p2 = candidates[c][0] * M_PI / 180.0;
+            double dlat = p2 - p1, dlon = (candidates[c][1] - lon) * M_PI / 180.0;
+            double a = sin(dlat / 2) * sin(dlat / 2) +
+                       cos(p1) * cos(p2) * sin(dlon / 2) * sin(dlon / 2);
+            double d = 6371.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+            if (d < best) best = d;
+        }
+    }
+    return best;
+}
+
+// Test exact distance to coverage edge
+bool test_coverage_edge_distance() {
+    printf("Testing exact distance to coverage edge...\\n");
+
+    ntrip_service_compact_t service = create_test_service("edge.test.com",
+                                                        40.0, 41.0, -75.0, -73.0);
+
+    struct {
+        double lat, lon;
+        const char* description;
+    } points[] = {
+        {42.0, -74.0, "Due north (1° of latitude)"},
+        {39.0, -74.0, "Due south"},
+        {40.5, -72.0, "Due east"},
+        {40.5, -76.0, "Due west"},
+        {42.0, -72.0, "Northeast diagonal"},
+        {60.0, -40.0, "Far northeast (Greenland)"},
+        {40.5, 100.0, "Opposite hemisphere"},
+        {-40.0, -74.0, "Southern hemisphere, same meridian"},
+    };
+
+    for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        double exact = ntrip_atlas_calculate_distance_to_coverage_edge(
+            &service, points[i].lat, points[i].lon
+        );
+        double reference = sampled_distance_to_box(points[i].lat, points[i].lon,
+                                                   40.0, 41.0, -75.0, -73.0);
+
+        if (fabs(exact - reference) > 0.5) {
+            printf("  ❌ %s: expected %.2f km, got %.2f km\\n",
+                   points[i].description, reference, exact);
+            return false;
+        }
+    }
+
+    // Inside coverage is zero
+    if (ntrip_atlas_calculate_distance_to_coverage_edge(&service, 40.5, -74.0) != 0.0) {
+        printf("  ❌ Distance from inside coverage should be 0\\n");
+        return false;
+    }
+
+    // Batch calculation: bounds reject far services, exact for the rest
+    ntrip_service_compact_t services[] = {
+        service,
+        create_test_service("far.test.com", -45.0, -10.0, 110.0, 160.0),
+        create_test_service("near.test.com", 41.5, 42.5, -75.0, -73.0),
+    };
+    ntrip_service_geometry_t geometry[3];
+    for (size_t i = 0; i < 3; i++) {
+        ntrip_atlas_compute_service_geometry(&services[i], &geometry[i]);
+    }
+
+    double distances[3];
+    size_t within = ntrip_atlas_calculate_coverage_edge_distances(
+        services, geometry, 3, 40.5, -74.0, 200.0, distances
+    );
+
+    if (within != 2 || distances[0] != 0.0 || !isinf(distances[1]) ||
+        fabs(distances[2] - 111.2) > 0.5) {
+        printf("  ❌ Batch distances wrong: count %zu, [%.1f, %.1f, %.1f]\\n",
+               within, distances[0], distances[1], distances[2]);
+        return false;
+    }
+
+    printf("  ✅ Coverage edge distance exact within 0.5 km\\n");
+    return true;
+}
+
 // Test service filtering by coverage
 bool test_service_filtering() {
     printf("Testing service filtering by coverage...\\n");
@@ -193,6 +290,116 @@ bool test_distance_sorting() {
     return true;
 }
 
+// Test partial sort returning only the nearest services
+bool test_nearest_service_selection() {
+    printf("Testing nearest service selection...\\n");
+
+    // 40 services (exceeds the on-stack key buffer) spread along a meridian
+    ntrip_service_compact_t services[40];
+    size_t service_count = sizeof(services) / sizeof(services[0]);
+    for (size_t i = 0; i < service_count; i++) {
+        // Interleave near and far services so input order is not distance order
+        double lat = (i % 2 == 0) ? 10.0 + i : -10.0 - i;
+        char hostname[32];
+        snprintf(hostname, sizeof(hostname), "svc%zu.test.com", i);
+        services[i] = create_test_service(hostname, lat - 0.5, lat + 0.5, 20.0, 21.0);
+    }
+
+    // Centers at 10, -11, 12, -13... degrees: nearest three are svc0, svc1, svc2
+    size_t count = ntrip_atlas_filter_and_sort_nearest_services(
+        services, service_count, 0.0, 20.5, 20000.0, 3
+    );
+
+    if (count != 3) {
+        printf("  ❌ Expected 3 nearest services, got %zu\\n", count);
+        return false;
+    }
+
+    const char* expected[] = {"svc0.test.com", "svc1.test.com", "svc2.test.com"};
+    for (size_t i = 0; i < 3; i++) {
+        if (strcmp(services[i].hostname, expected[i]) != 0) {
+            printf("  ❌ Rank %zu: expected %s, got %s\\n", i, expected[i], services[i].hostname);
+            return false;
+        }
+    }
+
+    // Full sort over the same set must be non-decreasing in distance
+    count = ntrip_atlas_filter_and_sort_services_by_location(
+        services, service_count, 0.0, 20.5, 20000.0
+    );
+    if (count != service_count) {
+        printf("  ❌ Expected %zu services after full sort, got %zu\\n", service_count, count);
+        return false;
+    }
+    for (size_t i = 1; i < count; i++) {
+        double prev = ntrip_atlas_calculate_distance_to_service_center(&services[i - 1], 0.0, 20.5);
+        double curr = ntrip_atlas_calculate_distance_to_service_center(&services[i], 0.0, 20.5);
+        if (curr < prev) {
+            printf("  ❌ Services out of order at rank %zu (%.1f km < %.1f km)\\n", i, curr, prev);
+            return false;
+        }
+    }
+
+    printf("  ✅ Nearest service selection working correctly\\n");
+    return true;
+}
+
+// Test that ranking without room for sort keys matches the keyed path
+bool test_nearest_selection_without_key_storage() {
+    printf("Testing nearest selection without key storage...\\n");
+
+    // 48 services, several sharing a center, so ties are exercised too
+    ntrip_service_compact_t services[48];
+    size_t service_count = sizeof(services) / sizeof(services[0]);
+    for (size_t i = 0; i < service_count; i++) {
+        double lat = (double)((i * 7) % 17) - 8.0;
+        char hostname[32];
+        snprintf(hostname, sizeof(hostname), "svc%zu.test.com", i);
+        services[i] = create_test_service(hostname, lat - 0.5, lat + 0.5, 20.0, 21.0);
+    }
+
+    // Too small for any keys: the selection path runs instead of the heap
+    uint64_t buffer[1];
+    ntrip_atlas_workspace_t workspace;
+    ntrip_atlas_workspace_init(&workspace, buffer, sizeof(buffer));
+
+    const size_t wanted[] = {1, 5, 48};
+    for (size_t w = 0; w < sizeof(wanted) / sizeof(wanted[0]); w++) {
+        ntrip_service_compact_t keyed[48];
+        ntrip_service_compact_t selected[48];
+        memcpy(keyed, services, sizeof(services));
+        memcpy(selected, services, sizeof(services));
+
+        size_t keyed_count = ntrip_atlas_filter_and_sort_nearest_services(
+            keyed, service_count, 0.0, 20.5, 20000.0, wanted[w]
+        );
+        size_t selected_count = ntrip_atlas_filter_and_sort_nearest_services_in(
+            selected, NULL, service_count, 0.0, 20.5, 20000.0, wanted[w], &workspace
+        );
+
+        if (keyed_count != wanted[w] || selected_count != keyed_count) {
+            printf("  ❌ Wanted %zu: keyed %zu, selected %zu\\n",
+                   wanted[w], keyed_count, selected_count);
+            return false;
+        }
+        for (size_t i = 0; i < keyed_count; i++) {
+            if (strcmp(keyed[i].hostname, selected[i].hostname) != 0) {
+                printf("  ❌ Wanted %zu, rank %zu: keyed %s, selected %s\\n",
+                       wanted[w], i, keyed[i].hostname, selected[i].hostname);
+                return false;
+            }
+        }
+    }
+
+    if (workspace.used != 0) {
+        printf("  ❌ Workspace left %zu bytes drawn\\n", workspace.used);
+        return false;
+    }
+
+    printf("  ✅ Selection without keys matches the keyed ranking\\n");
+    return true;
+}
+
 // Test coverage statistics
 bool test_coverage_statistics() {
     printf("Testing coverage statistics...\\n");
@@ -324,8 +531,11 @@ int main() {
     } tests[] = {
         {"Coverage detection", test_coverage_detection},
         {"Distance calculations", test_distance_calculations},
+        {"Coverage edge distance", test_coverage_edge_distance},
         {"Service filtering by coverage", test_service_filtering},
         {"Distance-based sorting", test_distance_sorting},
+        {"Nearest service selection", test_nearest_service_selection},
+        {"Nearest selection without key storage", test_nearest_selection_without_key_storage},
         {"Coverage statistics", test_coverage_statistics},
         {"Edge cases and error handling", test_edge_cases},
         {"Coordinate precision", test_coordinate_precision},
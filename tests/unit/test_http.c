@@ -0,0 +1,345 @@
+/**
+ * HTTP/NTRIP Response Parser Unit Tests
+ *
+ * Tests status lines for NTRIP 1.0 and 2.0 casters, body framing by
+ * Content-Length, chunked encoding and connection close at every split
+ * point of the input, zero-copy delivery, malformed framing and the
+ * shared request format.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+// Body collector for the feed callback
+typedef struct {
+    char data[4096];
+    size_t len;
+    int calls;
+    int stop_after;              // Stop after this many calls (0 = never)
+    const char* input_start;     // Buffer being fed, for zero-copy checks
+    const char* input_end;
+    bool outside_input;
+} body_t;
+
+static int collect_body(const char* chunk, size_t len, void* context) {
+    body_t* body = (body_t*)context;
+    if (body->input_start && (chunk < body->input_start || chunk + len > body->input_end)) {
+        body->outside_input = true;
+    }
+    if (body->len + len < sizeof(body->data)) {
+        memcpy(body->data + body->len, chunk, len);
+    }
+    body->len += len;
+    body->calls++;
+    return body->stop_after && body->calls >= body->stop_after;
+}
+
+/**
+ * Feed a response in pieces split at the given offsets, then close
+ *
+ * @return Result of the first feed that did not ask for more, else of finish()
+ */
+static int feed_split(const char* response, size_t length, size_t split_a, size_t split_b,
+                      ntrip_http_response_t* parser, body_t* body) {
+    ntrip_atlas_http_response_init(parser);
+    memset(body, 0, sizeof(*body));
+    size_t bounds[4] = { 0, split_a, split_b, length };
+    for (int i = 0; i < 3; i++) {
+        int ret = ntrip_atlas_http_response_feed(parser, response + bounds[i], bounds[i + 1] - bounds[i],
+                                                 collect_body, body);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return ntrip_atlas_http_response_finish(parser);
+}
+
+// Test status lines of each caster generation
+bool test_status_lines() {
+    printf("Testing status lines...\n");
+
+    struct {
+        const char* response;
+        int expected;
+        ntrip_http_protocol_t protocol;
+        uint16_t status_code;
+    } cases[] = {
+        { "HTTP/1.1 200 OK\r\n\r\n", NTRIP_ATLAS_SUCCESS, NTRIP_HTTP_PROTOCOL_HTTP, 200 },
+        { "HTTP/1.0 200\r\n\r\n", NTRIP_ATLAS_SUCCESS, NTRIP_HTTP_PROTOCOL_HTTP, 200 },
+        { "SOURCETABLE 200 OK\r\n\r\n", NTRIP_ATLAS_SUCCESS, NTRIP_HTTP_PROTOCOL_SOURCETABLE, 200 },
+        { "ICY 200 OK\r\n", NTRIP_ATLAS_SUCCESS, NTRIP_HTTP_PROTOCOL_ICY, 200 },
+        { "HTTP/1.1 401 Unauthorized\r\n\r\n", NTRIP_ATLAS_ERROR_AUTH_FAILED, NTRIP_HTTP_PROTOCOL_HTTP, 401 },
+        { "HTTP/1.1 404 Not Found\r\n\r\n", NTRIP_ATLAS_ERROR_NOT_FOUND, NTRIP_HTTP_PROTOCOL_HTTP, 404 },
+        { "HTTP/1.1 302 Found\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE, NTRIP_HTTP_PROTOCOL_HTTP, 302 },
+        { "HTTP/1.1 20 OK\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE, NTRIP_HTTP_PROTOCOL_HTTP, 0 },
+        { "HTTP/2 200\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE, NTRIP_HTTP_PROTOCOL_HTTP, 0 },
+        { "ERROR - Bad Password\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE, NTRIP_HTTP_PROTOCOL_HTTP, 0 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ntrip_http_response_t parser;
+        body_t body;
+        size_t length = strlen(cases[i].response);
+        int ret = feed_split(cases[i].response, length, length, length, &parser, &body);
+        if (ret != cases[i].expected || parser.status_code != cases[i].status_code ||
+            (ret == NTRIP_ATLAS_SUCCESS && parser.protocol != cases[i].protocol)) {
+            printf("  ❌ \"%.20s\": %d (status %u, protocol %d)\n",
+                   cases[i].response, ret, parser.status_code, parser.protocol);
+            return false;
+        }
+    }
+
+    printf("  ✅ %zu status lines classified\n", sizeof(cases) / sizeof(cases[0]));
+    return true;
+}
+
+// Test every framing decodes the same body wherever the input is split
+bool test_body_framing_any_split() {
+    printf("Testing body framing at every split point...\n");
+
+    const char* table = "STR;MP1;A;RTCM 3.2;1004;2;GPS;NET;DEU;50.0;10.0;0;0;R;none;N;N;9600\r\nENDSOURCETABLE\r\n";
+    char responses[5][1024];
+    snprintf(responses[0], sizeof(responses[0]),
+             "SOURCETABLE 200 OK\r\nServer: NTRIP Caster\r\nContent-Type: text/plain\r\nContent-Length: %zu\r\n\r\n%s"
+             "NOT PART OF THE BODY", strlen(table), table);
+    snprintf(responses[1], sizeof(responses[1]),
+             "HTTP/1.1 200 OK\r\nTRANSFER-ENCODING: Chunked\r\nContent-Length: 3\r\n\r\n"
+             "10;name=value\r\n%.16s\r\n%x\r\n%s\r\n0\r\nX-Trailer: 1\r\n\r\nNOT PART OF THE BODY",
+             table, (unsigned)strlen(table + 16), table + 16);
+    snprintf(responses[2], sizeof(responses[2]), "HTTP/1.0 200 OK\nContent-Type: gnss/sourcetable\n\n%s", table);
+    snprintf(responses[3], sizeof(responses[3]), "ICY 200 OK\r\n%s", table);
+    snprintf(responses[4], sizeof(responses[4]),
+             "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\nNOT PART OF THE BODY");
+    const int expected_results[5] = { 1, 1, NTRIP_ATLAS_SUCCESS, NTRIP_ATLAS_SUCCESS, 1 };
+
+    int splits = 0;
+    for (int r = 0; r < 5; r++) {
+        const char* expected_body = r == 4 ? "" : table;
+        size_t length = strlen(responses[r]);
+        for (size_t a = 0; a <= length; a++) {
+            for (size_t b = a; b <= length; b += (b < a + 8 || b + 8 > length) ? 1 : 7) {
+                ntrip_http_response_t parser;
+                body_t body;
+                int ret = feed_split(responses[r], length, a, b, &parser, &body);
+                if (ret != expected_results[r] || body.len != strlen(expected_body) ||
+                    memcmp(body.data, expected_body, body.len) != 0) {
+                    printf("  ❌ Response %d split at %zu/%zu: result %d, %zu body bytes\n",
+                           r, a, b, ret, body.len);
+                    return false;
+                }
+                if (parser.body_bytes != body.len || parser.state != NTRIP_HTTP_DONE) {
+                    printf("  ❌ Response %d not finished cleanly\n", r);
+                    return false;
+                }
+                splits++;
+            }
+        }
+
+        // Byte at a time, like the old per-read() parsers
+        ntrip_http_response_t parser;
+        body_t body;
+        memset(&body, 0, sizeof(body));
+        ntrip_atlas_http_response_init(&parser);
+        int ret = 0;
+        for (size_t i = 0; i < length && ret == 0; i++) {
+            ret = ntrip_atlas_http_response_feed(&parser, responses[r] + i, 1, collect_body, &body);
+        }
+        if (ret == 0) {
+            ret = ntrip_atlas_http_response_finish(&parser);
+        }
+        if (ret != expected_results[r] || body.len != strlen(expected_body)) {
+            printf("  ❌ Response %d fed bytewise: result %d\n", r, ret);
+            return false;
+        }
+    }
+
+    printf("  ✅ %d split combinations decoded identically\n", splits);
+    return true;
+}
+
+// Test body spans point into the caller's buffer and stopping sticks
+bool test_zero_copy_and_stop() {
+    printf("Testing zero-copy delivery and stop...\n");
+
+    const char* response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n";
+    size_t length = strlen(response);
+
+    ntrip_http_response_t parser;
+    body_t body;
+    memset(&body, 0, sizeof(body));
+    body.input_start = response;
+    body.input_end = response + length;
+    ntrip_atlas_http_response_init(&parser);
+    int ret = ntrip_atlas_http_response_feed(&parser, response, length, collect_body, &body);
+    if (ret != 1 || body.outside_input || body.calls != 2 || body.len != 11 ||
+        memcmp(body.data, "hello world", 11) != 0) {
+        printf("  ❌ Body copied or split unexpectedly (%d calls)\n", body.calls);
+        return false;
+    }
+
+    // A callback asking to stop ends the response there
+    memset(&body, 0, sizeof(body));
+    body.stop_after = 1;
+    ntrip_atlas_http_response_init(&parser);
+    ret = ntrip_atlas_http_response_feed(&parser, response, length, collect_body, &body);
+    if (ret != 1 || body.calls != 1 ||
+        ntrip_atlas_http_response_feed(&parser, response, length, collect_body, &body) != 1 ||
+        body.calls != 1 || ntrip_atlas_http_response_finish(&parser) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Stop request not honoured\n");
+        return false;
+    }
+
+    // No callback just skips the body
+    ntrip_atlas_http_response_init(&parser);
+    if (ntrip_atlas_http_response_feed(&parser, response, length, NULL, NULL) != 1 || parser.body_bytes != 11) {
+        printf("  ❌ Body not skipped without a callback\n");
+        return false;
+    }
+
+    printf("  ✅ Spans delivered in place\n");
+    return true;
+}
+
+// Test malformed framing and truncated responses
+bool test_malformed_framing() {
+    printf("Testing malformed and truncated responses...\n");
+
+    char long_header[600];
+    snprintf(long_header, sizeof(long_header), "HTTP/1.1 200 OK\r\nX-Long: %0*d\r\nContent-Length: 4\r\n\r\nbody", 400, 0);
+
+    struct {
+        const char* response;
+        int expected;
+    } cases[] = {
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabcX\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n123456789\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nContent-Length: 12a\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nContent-Length: 99999999999\r\n\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nshort", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhel", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "SOURCETABLE 200 OK\r\nServer: cut", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "", NTRIP_ATLAS_ERROR_INVALID_RESPONSE },
+        { "HTTP/1.1 200 OK\r\n\r\nuntil close", NTRIP_ATLAS_SUCCESS },
+        { long_header, 1 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        ntrip_http_response_t parser;
+        body_t body;
+        size_t length = strlen(cases[i].response);
+        int ret = feed_split(cases[i].response, length, length / 2, length, &parser, &body);
+        if (ret != cases[i].expected) {
+            printf("  ❌ Case %zu: %d, expected %d\n", i, ret, cases[i].expected);
+            return false;
+        }
+    }
+
+    ntrip_http_response_t parser;
+    ntrip_atlas_http_response_init(&parser);
+    if (ntrip_atlas_http_response_feed(NULL, "x", 1, NULL, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_http_response_feed(&parser, NULL, 1, NULL, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_http_response_feed(&parser, NULL, 0, NULL, NULL) != 0 ||
+        ntrip_atlas_http_response_finish(NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Invalid parameters accepted\n");
+        return false;
+    }
+
+    printf("  ✅ %zu malformed or truncated responses handled\n", sizeof(cases) / sizeof(cases[0]));
+    return true;
+}
+
+// Test the request every transport sends
+bool test_format_request() {
+    printf("Testing request formatting...\n");
+
+    char request[NTRIP_ATLAS_HTTP_REQUEST_SIZE];
+    int length = ntrip_atlas_http_format_request(request, sizeof(request), "rtk2go.com", 2101, NULL);
+    const char* expected = "GET / HTTP/1.1\r\n"
+                           "Host: rtk2go.com:2101\r\n"
+                           "Ntrip-Version: Ntrip/2.0\r\n"
+                           "User-Agent: NTRIP NTRIP-Atlas/1.0\r\n"
+                           "Connection: close\r\n"
+                           "\r\n";
+    if (length != (int)strlen(expected) || strcmp(request, expected) != 0) {
+        printf("  ❌ Unexpected request:\n%s\n", request);
+        return false;
+    }
+
+    length = ntrip_atlas_http_format_request(request, sizeof(request), "caster.example", 80, "/MOUNT");
+    if (length < 0 || strncmp(request, "GET /MOUNT HTTP/1.1\r\nHost: caster.example\r\n", 43) != 0) {
+        printf("  ❌ Default port or path not handled\n");
+        return false;
+    }
+
+    // Longest host and path still fit the documented size
+    char host[NTRIP_ATLAS_MAX_URL_LEN];
+    char path[NTRIP_ATLAS_MAX_URL_LEN];
+    memset(host, 'h', sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    memset(path, 'p', sizeof(path) - 1);
+    path[0] = '/';
+    path[sizeof(path) - 1] = '\0';
+    if (ntrip_atlas_http_format_request(request, sizeof(request), host, 65535, path) < 0) {
+        printf("  ❌ Longest request does not fit NTRIP_ATLAS_HTTP_REQUEST_SIZE\n");
+        return false;
+    }
+
+    if (ntrip_atlas_http_format_request(request, 32, "rtk2go.com", 2101, "/") != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_http_format_request(request, sizeof(request), NULL, 2101, "/") != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_http_format_request(request, sizeof(request), "", 2101, "/") != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Invalid request parameters accepted\n");
+        return false;
+    }
+
+    printf("  ✅ %d-byte sourcetable request\n", (int)strlen(expected));
+    return true;
+}
+
+int main() {
+    printf("HTTP Response Parser Tests\n");
+    printf("==========================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Status lines", test_status_lines},
+        {"Body framing at any split", test_body_framing_any_split},
+        {"Zero-copy and stop", test_zero_copy_and_stop},
+        {"Malformed framing", test_malformed_framing},
+        {"Request format", test_format_request},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All HTTP parser tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some HTTP parser tests failed!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,588 @@
+/**
+ * Linux Native Transport Unit Tests
+ *
+ * Runs the libcurl-free http_stream and the epoll stream driver against a
+ * loopback caster: Content-Length, chunked and close-delimited bodies,
+ * error statuses, timeouts, and many streams on one thread. With OpenSSL
+ * available the same caster is served over TLS through the socket
+ * transport's TLS hooks.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509v3.h>
+#endif
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#define MAX_SERVED 96
+#define CONCURRENT_STREAMS 64
+#define BIG_BODY_SIZE (256 * 1024)
+
+/**
+ * Loopback caster: one thread per connection, response chosen by path
+ */
+typedef struct {
+    int listen_fd;
+    uint16_t port;
+    int connections;
+    bool tls;
+    pthread_t accept_thread;
+    pthread_t handlers[MAX_SERVED];
+    int handler_count;
+} loopback_server_t;
+
+typedef struct {
+    int fd;
+    bool tls;
+} loopback_client_t;
+
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+static SSL_CTX* g_server_ctx = NULL;
+static char g_cert_file[64];
+static char g_other_cert_file[64];
+#endif
+
+static char body_byte(size_t i) {
+    return (char)('a' + (i * 7 + i / 13) % 26);
+}
+
+/**
+ * Connection abstraction over plain TCP or server-side TLS
+ */
+typedef struct {
+    int fd;
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+    SSL* ssl;
+#endif
+} server_conn_t;
+
+static int conn_recv(server_conn_t* conn, char* buffer, size_t len) {
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+    if (conn->ssl) return SSL_read(conn->ssl, buffer, (int)len);
+#endif
+    return (int)recv(conn->fd, buffer, len, 0);
+}
+
+static bool conn_send(server_conn_t* conn, const char* data, size_t len) {
+    while (len > 0) {
+        int n;
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+        if (conn->ssl) n = SSL_write(conn->ssl, data, (int)len);
+        else
+#endif
+        n = (int)send(conn->fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool conn_puts(server_conn_t* conn, const char* text) {
+    return conn_send(conn, text, strlen(text));
+}
+
+static bool conn_printf(server_conn_t* conn, const char* format, size_t value) {
+    char text[256];
+    int length = snprintf(text, sizeof(text), format, value);
+    return conn_send(conn, text, (size_t)length);
+}
+
+static void send_body(server_conn_t* conn, size_t size, size_t piece) {
+    char buffer[4096];
+    for (size_t pos = 0; pos < size; ) {
+        size_t n = size - pos < piece ? size - pos : piece;
+        for (size_t i = 0; i < n; i++) buffer[i] = body_byte(pos + i);
+        if (!conn_send(conn, buffer, n)) return;
+        pos += n;
+    }
+}
+
+static void* handle_client(void* arg) {
+    loopback_client_t client = *(loopback_client_t*)arg;
+    free(arg);
+
+    server_conn_t conn = { .fd = client.fd };
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+    conn.ssl = NULL;
+    if (client.tls) {
+        conn.ssl = SSL_new(g_server_ctx);
+        SSL_set_fd(conn.ssl, client.fd);
+        if (SSL_accept(conn.ssl) != 1) {
+            SSL_free(conn.ssl);
+            close(client.fd);
+            return NULL;
+        }
+    }
+#endif
+
+    char request[512];
+    size_t length = 0;
+    request[0] = '\0';
+    while (length < sizeof(request) - 1 && !strstr(request, "\r\n\r\n")) {
+        int n = conn_recv(&conn, request + length, sizeof(request) - 1 - length);
+        if (n <= 0) break;
+        length += (size_t)n;
+        request[length] = '\0';
+    }
+
+    if (strncmp(request, "GET /length ", 12) == 0) {
+        conn_printf(&conn, "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\n\r\n", 5000);
+        send_body(&conn, 5000, 1000);
+    } else if (strncmp(request, "GET /chunked ", 13) == 0) {
+        conn_puts(&conn, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+        for (size_t pos = 0; pos < 3000; pos += 1000) {
+            char buffer[1000];
+            for (size_t i = 0; i < sizeof(buffer); i++) buffer[i] = body_byte(pos + i);
+            conn_printf(&conn, "%zx\r\n", sizeof(buffer));
+            conn_send(&conn, buffer, sizeof(buffer));
+            conn_puts(&conn, "\r\n");
+        }
+        conn_puts(&conn, "0\r\n\r\n");
+    } else if (strncmp(request, "GET /close ", 11) == 0) {
+        conn_puts(&conn, "SOURCETABLE 200 OK\r\n\r\n");
+        send_body(&conn, 4000, 700);
+    } else if (strncmp(request, "GET /big ", 9) == 0) {
+        conn_printf(&conn, "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\n\r\n", BIG_BODY_SIZE);
+        send_body(&conn, BIG_BODY_SIZE, 4096);
+    } else if (strncmp(request, "GET /auth ", 10) == 0) {
+        conn_puts(&conn, "HTTP/1.1 401 Unauthorized\r\nContent-Length: 0\r\n\r\n");
+    } else if (strncmp(request, "GET /stall ", 11) == 0) {
+        // Headers, then nothing until the client gives up
+        conn_puts(&conn, "HTTP/1.1 200 OK\r\nContent-Length: 100\r\n\r\n");
+        char sink[64];
+        while (conn_recv(&conn, sink, sizeof(sink)) > 0) {
+        }
+    }
+
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+    if (conn.ssl) {
+        SSL_shutdown(conn.ssl);
+        SSL_free(conn.ssl);
+    }
+#endif
+    close(client.fd);
+    return NULL;
+}
+
+static void* accept_loop(void* arg) {
+    loopback_server_t* server = (loopback_server_t*)arg;
+    while (server->handler_count < server->connections) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) break;
+        loopback_client_t* client = malloc(sizeof(loopback_client_t));
+        client->fd = fd;
+        client->tls = server->tls;
+        pthread_create(&server->handlers[server->handler_count++], NULL, handle_client, client);
+    }
+    return NULL;
+}
+
+static bool server_start(loopback_server_t* server, int connections, bool tls) {
+    memset(server, 0, sizeof(*server));
+    server->connections = connections;
+    server->tls = tls;
+    server->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    if (server->listen_fd < 0 ||
+        bind(server->listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(server->listen_fd, MAX_SERVED) != 0 ||
+        getsockname(server->listen_fd, (struct sockaddr*)&address, &address_length) != 0) {
+        printf("  ❌ Could not start loopback caster\n");
+        return false;
+    }
+    server->port = ntohs(address.sin_port);
+    pthread_create(&server->accept_thread, NULL, accept_loop, server);
+    return true;
+}
+
+static void server_stop(loopback_server_t* server) {
+    // Unblock accept() if fewer clients came than expected
+    shutdown(server->listen_fd, SHUT_RDWR);
+    pthread_join(server->accept_thread, NULL);
+    for (int i = 0; i < server->handler_count; i++) {
+        pthread_join(server->handlers[i], NULL);
+    }
+    close(server->listen_fd);
+}
+
+/**
+ * Body collector: checks every byte against the served pattern
+ */
+typedef struct {
+    size_t received;
+    bool mismatch;
+    int stop_after;               // Stop after this many callbacks (0 = never)
+    int calls;
+} body_check_t;
+
+static int check_body(const char* chunk, size_t len, void* context) {
+    body_check_t* check = (body_check_t*)context;
+    for (size_t i = 0; i < len; i++) {
+        if (chunk[i] != body_byte(check->received + i)) {
+            check->mismatch = true;
+        }
+    }
+    check->received += len;
+    check->calls++;
+    return check->stop_after && check->calls >= check->stop_after;
+}
+
+// Test the blocking native http_stream on each body framing
+bool test_native_http_stream() {
+    printf("Testing native http_stream against a loopback caster...\n");
+
+    loopback_server_t server;
+    if (!server_start(&server, 5, false)) return false;
+
+    struct {
+        const char* path;
+        int expected_status;
+        size_t expected_bytes;
+        int stop_after;
+    } cases[] = {
+        { "/length", NTRIP_ATLAS_SUCCESS, 5000, 0 },
+        { "/chunked", NTRIP_ATLAS_SUCCESS, 3000, 0 },
+        { "/close", NTRIP_ATLAS_SUCCESS, 4000, 0 },
+        { "/auth", NTRIP_ATLAS_ERROR_AUTH_FAILED, 0, 0 },
+        { "/big", NTRIP_ATLAS_SUCCESS, 0, 1 },
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        body_check_t check = { .stop_after = cases[i].stop_after };
+        int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", server.port, 0, cases[i].path,
+                                                          check_body, &check, 5000);
+        bool size_ok = cases[i].stop_after ? check.calls == 1 : check.received == cases[i].expected_bytes;
+        if (ret != cases[i].expected_status || !size_ok || check.mismatch) {
+            printf("  ❌ %s: status %d, %zu bytes%s\n", cases[i].path, ret, check.received,
+                   check.mismatch ? ", corrupted" : "");
+            ok = false;
+        }
+    }
+    server_stop(&server);
+    if (!ok) return false;
+
+    // Nothing listens on the closed port
+    body_check_t check = {0};
+    int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", server.port, 0, "/length",
+                                                      check_body, &check, 2000);
+    if (ret != NTRIP_ATLAS_ERROR_NO_NETWORK) {
+        printf("  ❌ Refused connection reported %d\n", ret);
+        return false;
+    }
+
+    printf("  ✅ Length, chunked, close-delimited, 401 and early stop handled\n");
+    return true;
+}
+
+// Test that a stalled caster runs into the stream timeout
+bool test_native_timeout() {
+    printf("Testing timeout on a stalled caster...\n");
+
+    loopback_server_t server;
+    if (!server_start(&server, 1, false)) return false;
+
+    body_check_t check = {0};
+    int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", server.port, 0, "/stall",
+                                                      check_body, &check, 300);
+    server_stop(&server);
+
+    if (ret != NTRIP_ATLAS_ERROR_TIMEOUT) {
+        printf("  ❌ Stalled caster reported %d\n", ret);
+        return false;
+    }
+
+    printf("  ✅ Stalled caster timed out\n");
+    return true;
+}
+
+static uint32_t test_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec * 1000) + (ts.tv_nsec / 1000000));
+}
+
+// Test many streams on one thread through the epoll driver
+bool test_run_streams_concurrent() {
+    printf("Testing %d concurrent streams on one epoll thread...\n", CONCURRENT_STREAMS);
+
+    loopback_server_t server;
+    if (!server_start(&server, CONCURRENT_STREAMS, false)) return false;
+
+    ntrip_platform_t platform = {0};
+    platform.interface_version = 2;
+    platform.get_time_ms = test_time_ms;
+    platform.nb_transport = &ntrip_platform_linux_nb_transport;
+
+    static ntrip_http_stream_t streams[CONCURRENT_STREAMS];
+    static body_check_t checks[CONCURRENT_STREAMS];
+    ntrip_http_stream_t* list[CONCURRENT_STREAMS];
+    const char* paths[] = { "/length", "/chunked", "/close", "/big" };
+    const size_t sizes[] = { 5000, 3000, 4000, BIG_BODY_SIZE };
+
+    bool ok = true;
+    for (int i = 0; i < CONCURRENT_STREAMS; i++) {
+        memset(&checks[i], 0, sizeof(checks[i]));
+        list[i] = &streams[i];
+        if (ntrip_atlas_http_stream_begin(&streams[i], &platform, "127.0.0.1", server.port, 0,
+                                          paths[i % 4], check_body, &checks[i], 10000) != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Begin %d failed\n", i);
+            ok = false;
+        }
+    }
+
+    ntrip_atlas_error_t ret = ok ? ntrip_platform_linux_run_streams(list, CONCURRENT_STREAMS, 20000)
+                                 : NTRIP_ATLAS_ERROR_PLATFORM;
+    if (ret != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ run_streams returned %d\n", ret);
+        ok = false;
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < CONCURRENT_STREAMS; i++) {
+        ntrip_atlas_error_t status = ntrip_atlas_http_stream_end(&streams[i]);
+        if (ok && (status != NTRIP_ATLAS_SUCCESS || checks[i].received != sizes[i % 4] || checks[i].mismatch)) {
+            printf("  ❌ Stream %d: status %d, %zu bytes\n", i, status, checks[i].received);
+            ok = false;
+        }
+        total += checks[i].received;
+    }
+    server_stop(&server);
+    if (!ok) return false;
+
+    if (ntrip_platform_linux_run_streams(NULL, 1, 0) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_platform_linux_run_streams(NULL, 0, 0) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Parameter checks failed\n");
+        return false;
+    }
+
+    printf("  ✅ %d streams, %zu bytes, all intact\n", CONCURRENT_STREAMS, total);
+    return true;
+}
+
+// Test that SSL casters need TLS hooks
+bool test_tls_requires_hooks() {
+    printf("Testing SSL without TLS hooks...\n");
+
+    ntrip_platform_linux_set_tls(NULL);
+    body_check_t check = {0};
+    int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", 2101, 1, "/", check_body, &check, 1000);
+    if (ret != NTRIP_ATLAS_ERROR_MISSING_FEATURE) {
+        printf("  ❌ SSL without hooks reported %d\n", ret);
+        return false;
+    }
+
+    printf("  ✅ Reported as missing feature\n");
+    return true;
+}
+
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+
+/**
+ * Self-signed certificate for 127.0.0.1, written to a PEM file
+ */
+static bool make_certificate(const char* path, EVP_PKEY** key_out, X509** cert_out) {
+    EVP_PKEY_CTX* kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+    EVP_PKEY* key = NULL;
+    if (!kctx || EVP_PKEY_keygen_init(kctx) != 1 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1) != 1 ||
+        EVP_PKEY_keygen(kctx, &key) != 1) {
+        EVP_PKEY_CTX_free(kctx);
+        return false;
+    }
+    EVP_PKEY_CTX_free(kctx);
+
+    X509* cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), -60);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"127.0.0.1", -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+
+    X509V3_CTX v3;
+    X509V3_set_ctx_nodb(&v3);
+    X509V3_set_ctx(&v3, cert, cert, NULL, NULL, 0);
+    X509_EXTENSION* san = X509V3_EXT_conf_nid(NULL, &v3, NID_subject_alt_name, "IP:127.0.0.1");
+    X509_EXTENSION* basic = X509V3_EXT_conf_nid(NULL, &v3, NID_basic_constraints, "critical,CA:TRUE");
+    X509_add_ext(cert, san, -1);
+    X509_add_ext(cert, basic, -1);
+    X509_EXTENSION_free(san);
+    X509_EXTENSION_free(basic);
+    X509_sign(cert, key, EVP_sha256());
+
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    PEM_write_X509(f, cert);
+    fclose(f);
+
+    *key_out = key;
+    *cert_out = cert;
+    return true;
+}
+
+// Test TLS casters through the OpenSSL hooks
+bool test_openssl_loopback() {
+    printf("Testing TLS through the OpenSSL hooks...\n");
+
+    snprintf(g_cert_file, sizeof(g_cert_file), "/tmp/ntrip_tls_cert_%d.pem", (int)getpid());
+    snprintf(g_other_cert_file, sizeof(g_other_cert_file), "/tmp/ntrip_tls_other_%d.pem", (int)getpid());
+    EVP_PKEY* key;
+    X509* cert;
+    EVP_PKEY* other_key;
+    X509* other_cert;
+    if (!make_certificate(g_cert_file, &key, &cert) ||
+        !make_certificate(g_other_cert_file, &other_key, &other_cert)) {
+        printf("  ❌ Could not create certificates\n");
+        return false;
+    }
+    g_server_ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(g_server_ctx, cert);
+    SSL_CTX_use_PrivateKey(g_server_ctx, key);
+
+    loopback_server_t server;
+    if (!server_start(&server, 8, true)) return false;
+
+    bool ok = true;
+    ntrip_platform_linux_set_tls(&ntrip_platform_linux_openssl_tls);
+
+    // Verified against our own certificate, every framing
+    if (ntrip_platform_linux_openssl_init(g_cert_file, true) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ OpenSSL init failed\n");
+        ok = false;
+    }
+    const char* paths[] = { "/length", "/chunked", "/close", "/big" };
+    const size_t sizes[] = { 5000, 3000, 4000, BIG_BODY_SIZE };
+    for (int i = 0; i < 4 && ok; i++) {
+        body_check_t check = {0};
+        int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", server.port, 1, paths[i],
+                                                          check_body, &check, 5000);
+        if (ret != NTRIP_ATLAS_SUCCESS || check.received != sizes[i] || check.mismatch) {
+            printf("  ❌ TLS %s: status %d, %zu bytes\n", paths[i], ret, check.received);
+            ok = false;
+        }
+    }
+
+    // Concurrent TLS handshakes on one thread
+    ntrip_platform_t platform = {0};
+    platform.interface_version = 2;
+    platform.get_time_ms = test_time_ms;
+    platform.nb_transport = &ntrip_platform_linux_nb_transport;
+    ntrip_http_stream_t streams[2];
+    body_check_t checks[2] = {{0}};
+    ntrip_http_stream_t* list[2] = { &streams[0], &streams[1] };
+    for (int i = 0; i < 2 && ok; i++) {
+        ok = ntrip_atlas_http_stream_begin(&streams[i], &platform, "127.0.0.1", server.port, 1,
+                                           paths[i * 3], check_body, &checks[i], 5000) == NTRIP_ATLAS_SUCCESS;
+    }
+    if (ok) {
+        ntrip_platform_linux_run_streams(list, 2, 10000);
+        for (int i = 0; i < 2; i++) {
+            ntrip_atlas_error_t status = ntrip_atlas_http_stream_end(&streams[i]);
+            if (status != NTRIP_ATLAS_SUCCESS || checks[i].received != sizes[i * 3]) {
+                printf("  ❌ Concurrent TLS stream %d: status %d, %zu bytes\n", i, status, checks[i].received);
+                ok = false;
+            }
+        }
+    }
+
+    // A certificate from an untrusted issuer fails the handshake
+    if (ok && ntrip_platform_linux_openssl_init(g_other_cert_file, true) == NTRIP_ATLAS_SUCCESS) {
+        body_check_t check = {0};
+        int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", server.port, 1, "/length",
+                                                          check_body, &check, 5000);
+        if (ret != NTRIP_ATLAS_ERROR_NO_NETWORK || check.received != 0) {
+            printf("  ❌ Untrusted certificate reported %d\n", ret);
+            ok = false;
+        }
+    }
+
+    // Unverified mode accepts it
+    if (ok && ntrip_platform_linux_openssl_init(NULL, false) == NTRIP_ATLAS_SUCCESS) {
+        body_check_t check = {0};
+        int ret = ntrip_platform_linux_native_http_stream("127.0.0.1", server.port, 1, "/length",
+                                                          check_body, &check, 5000);
+        if (ret != NTRIP_ATLAS_SUCCESS || check.received != 5000) {
+            printf("  ❌ Unverified TLS reported %d\n", ret);
+            ok = false;
+        }
+    }
+
+    ntrip_platform_linux_set_tls(NULL);
+    server_stop(&server);
+    SSL_CTX_free(g_server_ctx);
+    X509_free(cert);
+    X509_free(other_cert);
+    EVP_PKEY_free(key);
+    EVP_PKEY_free(other_key);
+    remove(g_cert_file);
+    remove(g_other_cert_file);
+    if (!ok) return false;
+
+    printf("  ✅ Verified, concurrent, untrusted and unverified TLS handled\n");
+    return true;
+}
+
+#endif // NTRIP_ATLAS_USE_OPENSSL
+
+int main() {
+    printf("Linux Native Transport Tests\n");
+    printf("============================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Native http_stream", test_native_http_stream},
+        {"Native timeout", test_native_timeout},
+        {"Concurrent streams on epoll", test_run_streams_concurrent},
+        {"TLS requires hooks", test_tls_requires_hooks},
+#ifdef NTRIP_ATLAS_USE_OPENSSL
+        {"OpenSSL loopback", test_openssl_loopback},
+#endif
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All Linux transport tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some Linux transport tests failed!\n");
+        return 1;
+    }
+}
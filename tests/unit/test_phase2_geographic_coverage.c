@@ -20,8 +20,8 @@ extern const ntrip_service_compact_t* get_sample_services(size_t* count);
 extern ntrip_atlas_error_t ntrip_atlas_init_spatial_index(void);
 extern ntrip_atlas_error_t ntrip_atlas_lat_lon_to_tile(double lat, double lon, uint8_t level, uint16_t* tile_lat, uint16_t* tile_lon);
 extern ntrip_tile_key_t ntrip_atlas_encode_tile_key(uint8_t level, uint16_t lat_tile, uint16_t lon_tile);
-extern ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(ntrip_tile_key_t tile_key, uint8_t service_index);
-extern size_t ntrip_atlas_find_services_by_location_fast(double lat, double lon, uint8_t* service_indices, size_t max_services);
+extern ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(ntrip_tile_key_t tile_key, ntrip_service_idx_t service_index);
+extern size_t ntrip_atlas_find_services_by_location_fast(double lat, double lon, ntrip_service_idx_t* service_indices, size_t max_services);
 
 // Helper to populate spatial index (from Phase 2)
 extern ntrip_atlas_error_t assign_service_to_level(const ntrip_service_compact_t* service, uint8_t service_index, uint8_t level);
@@ -64,7 +64,7 @@ static ntrip_atlas_error_t setup_spatial_index_with_services(void) {
             for (uint16_t lat_tile = min_lat_tile; lat_tile <= max_lat_tile; lat_tile++) {
                 for (uint16_t lon_tile = min_lon_tile; lon_tile <= max_lon_tile; lon_tile++) {
                     ntrip_tile_key_t tile_key = ntrip_atlas_encode_tile_key(level, lat_tile, lon_tile);
-                    ntrip_atlas_add_service_to_tile(tile_key, (uint8_t)i);
+                    ntrip_atlas_add_service_to_tile(tile_key, (ntrip_service_idx_t)i);
                 }
             }
         }
@@ -76,7 +76,7 @@ static ntrip_atlas_error_t setup_spatial_index_with_services(void) {
 /**
  * Helper function to check if a service index is found in results
  */
-static bool service_found_in_results(uint8_t target_service, uint8_t* found_services, size_t count) {
+static bool service_found_in_results(ntrip_service_idx_t target_service, ntrip_service_idx_t* found_services, size_t count) {
     for (size_t i = 0; i < count; i++) {
         if (found_services[i] == target_service) {
             return true;
@@ -150,7 +150,7 @@ bool test_australia_coverage_validation(void) {
 
     bool all_passed = true;
     for (size_t i = 0; i < sizeof(test_locations) / sizeof(test_locations[0]); i++) {
-        uint8_t found_services[16];
+        ntrip_service_idx_t found_services[16];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             test_locations[i].lat,
             test_locations[i].lon,
@@ -234,7 +234,7 @@ bool test_massachusetts_coverage_validation(void) {
 
     bool all_passed = true;
     for (size_t i = 0; i < sizeof(test_locations) / sizeof(test_locations[0]); i++) {
-        uint8_t found_services[16];
+        ntrip_service_idx_t found_services[16];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             test_locations[i].lat,
             test_locations[i].lon,
@@ -319,7 +319,7 @@ bool test_europe_coverage_validation(void) {
 
     bool all_passed = true;
     for (size_t i = 0; i < sizeof(test_locations) / sizeof(test_locations[0]); i++) {
-        uint8_t found_services[16];
+        ntrip_service_idx_t found_services[16];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             test_locations[i].lat,
             test_locations[i].lon,
@@ -391,7 +391,7 @@ bool test_global_services_validation(void) {
 
     bool all_passed = true;
     for (size_t i = 0; i < sizeof(global_test_locations) / sizeof(global_test_locations[0]); i++) {
-        uint8_t found_services[16];
+        ntrip_service_idx_t found_services[16];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             global_test_locations[i].lat,
             global_test_locations[i].lon,
@@ -444,7 +444,7 @@ bool test_coordinate_boundary_edge_cases(void) {
 
     bool all_passed = true;
     for (size_t i = 0; i < sizeof(edge_cases) / sizeof(edge_cases[0]); i++) {
-        uint8_t found_services[16];
+        ntrip_service_idx_t found_services[16];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             edge_cases[i].lat,
             edge_cases[i].lon,
@@ -0,0 +1,305 @@
+/**
+ * RTCM3 Frame Scanner Unit Tests
+ *
+ * Checks the table-driven CRC-24Q against known values and a bitwise
+ * reference, then scans a synthetic correction stream cut into every
+ * chunk size from 1 to 64 bytes: frame and per-type counts must match
+ * scanning it whole. Also covers corrupted frames, false preambles,
+ * type slot overflow and rates.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#define STREAM_FRAMES 300
+
+// RTCM 1005 example frame from RTCM 10403, CRC 0x360B98
+static const uint8_t g_frame_1005[] = {
+    0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98, 0x0E, 0xDE, 0xEF, 0x34,
+    0xB4, 0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98, 0x6F, 0x33, 0x36, 0x0B, 0x98
+};
+
+static const uint16_t g_types[] = { 1004, 1005, 1012, 1033, 1074, 1084, 1094, 1230 };
+#define TYPE_COUNT (sizeof(g_types) / sizeof(g_types[0]))
+
+static uint8_t g_stream[STREAM_FRAMES * 200 + 4096];
+static size_t g_stream_len;
+static uint32_t g_expected_types[TYPE_COUNT];
+static uint64_t g_expected_frame_bytes;
+
+static uint32_t rng_state = 74;
+
+static uint32_t random_u32(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+// Bitwise CRC-24Q as in RTCM 10403
+static uint32_t reference_crc24q(const uint8_t* data, size_t len) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint32_t)data[i] << 16;
+        for (int bit = 0; bit < 8; bit++) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= 0x1864CFB;
+            }
+        }
+    }
+    return crc & 0xFFFFFF;
+}
+
+static size_t write_frame(uint8_t* out, uint16_t message_type, uint16_t length) {
+    out[0] = NTRIP_RTCM3_PREAMBLE;
+    out[1] = (uint8_t)(length >> 8);
+    out[2] = (uint8_t)length;
+    for (uint16_t i = 0; i < length; i++) {
+        out[3 + i] = (uint8_t)random_u32();
+    }
+    if (length >= 2) {
+        out[3] = (uint8_t)(message_type >> 4);
+        out[4] = (uint8_t)((message_type << 4) | (out[4] & 0x0F));
+    }
+    uint32_t crc = reference_crc24q(out, 3 + length);
+    out[3 + length] = (uint8_t)(crc >> 16);
+    out[4 + length] = (uint8_t)(crc >> 8);
+    out[5 + length] = (uint8_t)crc;
+    return 6 + length;
+}
+
+// Frames of assorted types and lengths, with noise between some of them
+static void build_stream(void) {
+    g_stream_len = 0;
+    for (int i = 0; i < STREAM_FRAMES; i++) {
+        if (i % 7 == 3) {
+            // Noise with preamble bytes the reserved bits give away; a
+            // plausible false header could hide frames split across chunks
+            for (int n = 0; n < 5; n++) {
+                g_stream[g_stream_len++] = (n % 2) ? NTRIP_RTCM3_PREAMBLE : (uint8_t)(0xF0 | random_u32());
+            }
+        }
+        size_t t = random_u32() % TYPE_COUNT;
+        uint16_t length = (uint16_t)(2 + random_u32() % 180);
+        size_t written = write_frame(g_stream + g_stream_len, g_types[t], length);
+        g_stream_len += written;
+        g_expected_types[t]++;
+        g_expected_frame_bytes += written;
+    }
+}
+
+// Test CRC-24Q against known values and the bitwise reference
+bool test_crc24q() {
+    printf("Testing CRC-24Q...\n");
+
+    if (ntrip_atlas_crc24q(0, (const uint8_t*)"123456789", 9) != 0xCDE703) {
+        printf("  ❌ Check value wrong: %06X\n", (unsigned)ntrip_atlas_crc24q(0, (const uint8_t*)"123456789", 9));
+        return false;
+    }
+    if (ntrip_atlas_crc24q(0, g_frame_1005, sizeof(g_frame_1005) - 3) != 0x360B98 ||
+        ntrip_atlas_crc24q(0, g_frame_1005, sizeof(g_frame_1005)) != 0) {
+        printf("  ❌ RTCM 1005 example frame CRC wrong\n");
+        return false;
+    }
+
+    // Every length and alignment, whole and continued from a split point
+    uint8_t buffer[160];
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)random_u32();
+    }
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len + offset <= sizeof(buffer); len++) {
+            uint32_t expected = reference_crc24q(buffer + offset, len);
+            size_t split = len / 3;
+            uint32_t continued = ntrip_atlas_crc24q(ntrip_atlas_crc24q(0, buffer + offset, split),
+                                                    buffer + offset + split, len - split);
+            if (ntrip_atlas_crc24q(0, buffer + offset, len) != expected || continued != expected) {
+                printf("  ❌ Mismatch at offset %zu length %zu\n", offset, len);
+                return false;
+            }
+        }
+    }
+
+    printf("  ✅ Check value, RTCM example and %d-slice tables match\n", NTRIP_ATLAS_CRC24Q_SLICES);
+    return true;
+}
+
+static bool check_counts(const ntrip_rtcm3_framer_t* framer, const char* label) {
+    if (framer->frames != STREAM_FRAMES || framer->crc_errors != 0 ||
+        framer->frame_bytes != g_expected_frame_bytes || framer->bytes != g_stream_len) {
+        printf("  ❌ %s: %u frames, %u CRC errors\n", label,
+               (unsigned)framer->frames, (unsigned)framer->crc_errors);
+        return false;
+    }
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        if (ntrip_atlas_rtcm3_type_count(framer, g_types[t]) != g_expected_types[t]) {
+            printf("  ❌ %s: type %u counted %u, expected %u\n", label, g_types[t],
+                   (unsigned)ntrip_atlas_rtcm3_type_count(framer, g_types[t]),
+                   (unsigned)g_expected_types[t]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Test that chunk boundaries never change the result
+bool test_any_chunking() {
+    printf("Testing frames split at every chunk size...\n");
+
+    ntrip_rtcm3_framer_t framer;
+    ntrip_atlas_rtcm3_init(&framer);
+    if (ntrip_atlas_rtcm3_feed(&framer, g_stream, g_stream_len) != STREAM_FRAMES ||
+        !check_counts(&framer, "Whole stream")) {
+        return false;
+    }
+
+    for (size_t chunk = 1; chunk <= 64; chunk++) {
+        ntrip_atlas_rtcm3_init(&framer);
+        uint32_t reported = 0;
+        for (size_t pos = 0; pos < g_stream_len; pos += chunk) {
+            size_t len = g_stream_len - pos < chunk ? g_stream_len - pos : chunk;
+            reported += ntrip_atlas_rtcm3_feed(&framer, g_stream + pos, len);
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "Chunks of %zu", chunk);
+        if (reported != STREAM_FRAMES || !check_counts(&framer, label)) {
+            return false;
+        }
+    }
+
+    printf("  ✅ %d frames, %zu types counted identically for chunks of 1-64 bytes\n",
+           STREAM_FRAMES, TYPE_COUNT);
+    return true;
+}
+
+// Test corrupted frames and false preambles
+bool test_corruption_and_resync() {
+    printf("Testing corrupted frames and resync...\n");
+    uint8_t buffer[512];
+    size_t len = 0;
+
+    // A false preamble whose claimed length swallows a real frame
+    buffer[len++] = NTRIP_RTCM3_PREAMBLE;
+    buffer[len++] = 0x00;
+    buffer[len++] = 0x40;
+    len += write_frame(buffer + len, 1077, 40);
+    len += write_frame(buffer + len, 1087, 40);
+    size_t corrupt_at = len + 10;
+    len += write_frame(buffer + len, 1097, 40);
+    buffer[corrupt_at] ^= 0x01;
+    len += write_frame(buffer + len, 1127, 40);
+    memset(buffer + len, 0, 64);  // Lets the false frame's claimed length fit
+    len += 64;
+
+    ntrip_rtcm3_framer_t framer;
+    ntrip_atlas_rtcm3_init(&framer);
+    ntrip_atlas_rtcm3_feed(&framer, buffer, len);
+    if (framer.frames != 3 || framer.crc_errors != 1 ||
+        ntrip_atlas_rtcm3_type_count(&framer, 1077) != 1 ||
+        ntrip_atlas_rtcm3_type_count(&framer, 1097) != 0) {
+        printf("  ❌ Whole buffer: %u frames, %u CRC errors\n",
+               (unsigned)framer.frames, (unsigned)framer.crc_errors);
+        return false;
+    }
+
+    // Split byte by byte a corrupted frame still costs only itself
+    ntrip_atlas_rtcm3_init(&framer);
+    for (size_t i = 3 + 46; i < len; i++) {
+        ntrip_atlas_rtcm3_feed(&framer, buffer + i, 1);
+    }
+    if (framer.frames != 2 || framer.crc_errors != 1 ||
+        ntrip_atlas_rtcm3_type_count(&framer, 1127) != 1) {
+        printf("  ❌ Byte by byte: %u frames, %u CRC errors\n",
+               (unsigned)framer.frames, (unsigned)framer.crc_errors);
+        return false;
+    }
+
+    if (ntrip_atlas_rtcm3_feed(NULL, buffer, len) != 0 || ntrip_atlas_rtcm3_feed(&framer, NULL, 5) != 0) {
+        printf("  ❌ NULL arguments accepted\n");
+        return false;
+    }
+
+    printf("  ✅ False preamble rescanned, corrupted frame skipped\n");
+    return true;
+}
+
+// Test type slot overflow and rates
+bool test_type_slots_and_rates() {
+    printf("Testing type slots and rates...\n");
+
+    static uint8_t buffer[(NTRIP_ATLAS_RTCM3_TYPE_SLOTS + 4) * 16];
+    size_t len = 0;
+    for (uint16_t t = 0; t < NTRIP_ATLAS_RTCM3_TYPE_SLOTS + 4; t++) {
+        len += write_frame(buffer + len, (uint16_t)(4001 + t), 8);
+    }
+
+    ntrip_rtcm3_framer_t framer;
+    ntrip_atlas_rtcm3_init(&framer);
+    ntrip_atlas_rtcm3_feed(&framer, buffer, len);
+    if (framer.frames != NTRIP_ATLAS_RTCM3_TYPE_SLOTS + 4 || framer.untracked_frames != 4 ||
+        framer.type_count != NTRIP_ATLAS_RTCM3_TYPE_SLOTS ||
+        ntrip_atlas_rtcm3_type_count(&framer, 4001) != 1) {
+        printf("  ❌ %u frames, %u untracked\n", (unsigned)framer.frames, (unsigned)framer.untracked_frames);
+        return false;
+    }
+
+    double bytes_per_second, frames_per_second;
+    ntrip_atlas_rtcm3_rates(&framer, 2000, &bytes_per_second, &frames_per_second);
+    if (bytes_per_second != len / 2.0 || frames_per_second != framer.frames / 2.0) {
+        printf("  ❌ Rates %.1f B/s, %.1f frames/s\n", bytes_per_second, frames_per_second);
+        return false;
+    }
+    ntrip_atlas_rtcm3_rates(&framer, 0, &bytes_per_second, NULL);
+    if (bytes_per_second != 0.0) {
+        printf("  ❌ Zero time should give zero rate\n");
+        return false;
+    }
+
+    printf("  ✅ %d slots, overflow counted, rates from elapsed time\n", NTRIP_ATLAS_RTCM3_TYPE_SLOTS);
+    return true;
+}
+
+int main() {
+    printf("RTCM3 Frame Scanner Tests\n");
+    printf("=========================\n\n");
+
+    build_stream();
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"CRC-24Q", test_crc24q},
+        {"Any chunking", test_any_chunking},
+        {"Corruption and resync", test_corruption_and_resync},
+        {"Type slots and rates", test_type_slots_and_rates},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All RTCM3 scanner tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some RTCM3 scanner tests failed!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,407 @@
+/**
+ * Per-Tile Selection Cache Unit Tests
+ *
+ * Checks cached ranked lookups against an uncached reference, repeat
+ * lookups becoming cache hits, negative caching of empty tiles, and
+ * automatic invalidation when failures, blacklist entries, credentials or
+ * the spatial index change.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#define SERVICE_COUNT 40
+
+static ntrip_service_compact_t g_services[SERVICE_COUNT];
+static ntrip_service_index_entry_t g_mapping[SERVICE_COUNT];
+static ntrip_compact_failure_t g_failures[SERVICE_COUNT];
+
+// Provider table normally emitted by the service generator
+const char* get_provider_name(uint8_t provider_index) {
+    static const char* providers[] = { "Free Network", "Paid Network A", "Paid Network B" };
+    return provider_index < 3 ? providers[provider_index] : "Unknown";
+}
+
+static uint32_t rng_state = 67;
+
+static double random_unit(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return (rng_state >> 8) / 16777216.0;
+}
+
+// Add a service to every tile its coverage box touches, at every level
+static void index_service(size_t i) {
+    const ntrip_service_compact_t* service = &g_services[i];
+    for (uint8_t level = 0; level <= NTRIP_SPATIAL_FINEST_LEVEL; level++) {
+        uint16_t lat_first, lat_last, lon_first, lon_last;
+        ntrip_atlas_lat_lon_to_tile(service->lat_min_deg100 / 100.0, service->lon_min_deg100 / 100.0,
+                                    level, &lat_first, &lon_first);
+        ntrip_atlas_lat_lon_to_tile(service->lat_max_deg100 / 100.0, service->lon_max_deg100 / 100.0,
+                                    level, &lat_last, &lon_last);
+        for (uint16_t lat_tile = lat_first; lat_tile <= lat_last; lat_tile++) {
+            for (uint16_t lon_tile = lon_first; lon_tile <= lon_last; lon_tile++) {
+                ntrip_atlas_add_service_to_tile(
+                    ntrip_atlas_encode_tile_key(level, lat_tile, lon_tile), (ntrip_service_idx_t)i);
+            }
+        }
+    }
+}
+
+// Random regional casters over central Europe, a third of them paid
+static void setup_services() {
+    rng_state = 67;
+    for (size_t i = 0; i < SERVICE_COUNT; i++) {
+        ntrip_service_compact_t* service = &g_services[i];
+        memset(service, 0, sizeof(*service));
+        snprintf(service->hostname, sizeof(service->hostname), "caster%zu.test.com", i);
+        service->port = 2101;
+
+        double lat = 44.0 + random_unit() * 10.0;
+        double lon = 2.0 + random_unit() * 16.0;
+        double half = 0.5 + random_unit() * 2.0;
+        service->lat_min_deg100 = (int16_t)round((lat - half) * 100);
+        service->lat_max_deg100 = (int16_t)round((lat + half) * 100);
+        service->lon_min_deg100 = (int16_t)round((lon - half) * 100);
+        service->lon_max_deg100 = (int16_t)round((lon + half) * 100);
+        service->quality_rating = (uint8_t)(1 + random_unit() * 5);
+        service->network_type = (uint8_t)(random_unit() * 3);
+
+        bool paid = i % 3 == 1;
+        service->provider_index = paid ? (uint8_t)(1 + i % 2) : 0;
+        service->flags = paid ? (NTRIP_FLAG_PAID_SERVICE | NTRIP_FLAG_AUTH_DIGEST)
+                              : (i % 2 ? NTRIP_FLAG_AUTH_BASIC : NTRIP_FLAG_FREE_ACCESS);
+
+        snprintf(g_mapping[i].service_id, sizeof(g_mapping[i].service_id), "caster%zu", i);
+        g_mapping[i].service_index = (ntrip_service_idx_t)i;
+    }
+
+    ntrip_atlas_init_spatial_index();
+    for (size_t i = 0; i < SERVICE_COUNT; i++) {
+        index_service(i);
+    }
+
+    ntrip_atlas_init_compact_failure_tracking_with_storage(g_mapping, SERVICE_COUNT, g_failures, SERVICE_COUNT);
+    ntrip_atlas_init_geographic_blacklist();
+    ntrip_atlas_clear_all_geographic_blacklists();
+    ntrip_atlas_selection_cache_clear();
+}
+
+// Uncached reference: every filter applied to every service, then sorted
+static size_t reference_ranked(double lat, double lon, const ntrip_selection_criteria_t* criteria,
+                               const ntrip_credential_store_t* credentials,
+                               ntrip_service_idx_t* ranked, size_t max_ranked) {
+    double scores[SERVICE_COUNT];
+    uint8_t qualities[SERVICE_COUNT];
+    bool preferred[SERVICE_COUNT];
+    ntrip_service_idx_t found[SERVICE_COUNT];
+    size_t count = 0;
+
+    for (size_t i = 0; i < SERVICE_COUNT; i++) {
+        const ntrip_service_compact_t* service = &g_services[i];
+        if (!ntrip_atlas_is_location_within_service_coverage(service, lat, lon)) continue;
+        if (!ntrip_atlas_is_service_usable(service, credentials)) continue;
+        if (ntrip_atlas_is_compact_service_blocked((ntrip_service_idx_t)i)) continue;
+
+        if (ntrip_atlas_is_service_geographically_blacklisted((ntrip_service_idx_t)i, lat, lon)) continue;
+
+        if (criteria) {
+            if (criteria->free_only && (service->flags & NTRIP_FLAG_PAID_SERVICE)) continue;
+            if (service->quality_rating < criteria->min_quality_rating) continue;
+            int auth = (service->flags & NTRIP_FLAG_AUTH_DIGEST) ? 2 : (service->flags & NTRIP_FLAG_AUTH_BASIC) ? 1 : 0;
+            if (criteria->max_auth != NTRIP_AUTH_NONE && auth > (int)criteria->max_auth) continue;
+            if (criteria->max_distance_km > 0 &&
+                ntrip_atlas_calculate_distance_to_service_center(service, lat, lon) > criteria->max_distance_km) continue;
+        }
+
+        found[count] = (ntrip_service_idx_t)i;
+        scores[count] = ntrip_atlas_score_service_spatial_geographic(service, lat, lon);
+        qualities[count] = service->quality_rating;
+        preferred[count] = criteria && service->network_type == criteria->preferred_network;
+        count++;
+    }
+
+    // Score, then preferred network, then quality
+    for (size_t i = 1; i < count; i++) {
+        for (size_t j = i; j > 0; j--) {
+            bool ahead = scores[j] > scores[j - 1] ||
+                         (scores[j] == scores[j - 1] &&
+                          (preferred[j] > preferred[j - 1] ||
+                           (preferred[j] == preferred[j - 1] && qualities[j] > qualities[j - 1])));
+            if (!ahead) break;
+            double s = scores[j]; scores[j] = scores[j - 1]; scores[j - 1] = s;
+            uint8_t q = qualities[j]; qualities[j] = qualities[j - 1]; qualities[j - 1] = q;
+            bool p = preferred[j]; preferred[j] = preferred[j - 1]; preferred[j - 1] = p;
+            ntrip_service_idx_t f = found[j]; found[j] = found[j - 1]; found[j - 1] = f;
+        }
+    }
+
+    size_t written = count < max_ranked ? count : max_ranked;
+    memcpy(ranked, found, written * sizeof(ntrip_service_idx_t));
+    return written;
+}
+
+// Compare a cached lookup against the reference at one position
+static bool check_position(double lat, double lon, const ntrip_selection_criteria_t* criteria,
+                           const ntrip_credential_store_t* credentials) {
+    ntrip_service_idx_t cached[8], expected[8];
+    size_t cached_count = ntrip_atlas_find_ranked_services_cached(
+        lat, lon, g_services, SERVICE_COUNT, criteria, credentials, cached, 8);
+    size_t expected_count = reference_ranked(lat, lon, criteria, credentials, expected, 8);
+
+    if (cached_count != expected_count ||
+        memcmp(cached, expected, cached_count * sizeof(ntrip_service_idx_t)) != 0) {
+        printf("  ❌ (%.3f, %.3f): cached %zu services, reference %zu\n", lat, lon, cached_count, expected_count);
+        for (size_t i = 0; i < cached_count || i < expected_count; i++) {
+            printf("     %zu: cached %d, reference %d\n", i,
+                   i < cached_count ? (int)cached[i] : -1, i < expected_count ? (int)expected[i] : -1);
+        }
+        return false;
+    }
+    return true;
+}
+
+// Test cached rankings match the uncached reference for several criteria
+bool test_matches_reference() {
+    printf("Testing cached rankings against uncached reference...\n");
+    setup_services();
+
+    ntrip_credential_store_t credentials;
+    ntrip_atlas_init_credential_store(&credentials);
+    ntrip_atlas_add_credential(&credentials, "Paid Network A", "user", "pass");
+
+    ntrip_selection_criteria_t free_only = {0};
+    free_only.free_only = 1;
+    ntrip_selection_criteria_t strict = {0};
+    strict.min_quality_rating = 3;
+    strict.max_auth = NTRIP_AUTH_BASIC;
+    strict.max_distance_km = 120.0;
+    strict.preferred_network = NTRIP_NETWORK_COMMUNITY;
+
+    const ntrip_selection_criteria_t* criteria[] = { NULL, &free_only, &strict };
+    const ntrip_credential_store_t* stores[] = { NULL, &credentials };
+
+    rng_state = 1067;
+    for (int i = 0; i < 3000; i++) {
+        double lat = 43.0 + random_unit() * 12.0;
+        double lon = 1.0 + random_unit() * 18.0;
+        for (size_t c = 0; c < 3; c++) {
+            if (!check_position(lat, lon, criteria[c], stores[i % 2])) {
+                return false;
+            }
+        }
+    }
+
+    printf("  ✅ 9000 cached lookups match the reference\n");
+    return true;
+}
+
+// Test a stationary rover only builds its tile once
+bool test_repeat_lookups_hit() {
+    printf("Testing repeat lookups...\n");
+    setup_services();
+
+    ntrip_selection_cache_stats_t before, after;
+    ntrip_atlas_get_selection_cache_stats(&before);
+
+    ntrip_service_idx_t ranked[8];
+    for (int i = 0; i < 100; i++) {
+        // Position jitter of a few metres stays inside the tile
+        double lat = 49.0 + (i % 7) * 1e-5;
+        double lon = 9.0 + (i % 5) * 1e-5;
+        ntrip_atlas_find_ranked_services_cached(lat, lon, g_services, SERVICE_COUNT, NULL, NULL, ranked, 8);
+    }
+
+    ntrip_atlas_get_selection_cache_stats(&after);
+    uint32_t misses = after.misses - before.misses;
+    uint32_t hits = after.hits - before.hits;
+    printf("  100 lookups: %u misses, %u hits\n", misses, hits);
+    if (misses != 1 || hits != 99) {
+        printf("  ❌ Expected one miss then hits\n");
+        return false;
+    }
+
+    // Different criteria are a different key
+    ntrip_selection_criteria_t criteria = {0};
+    criteria.free_only = 1;
+    ntrip_atlas_find_ranked_services_cached(49.0, 9.0, g_services, SERVICE_COUNT, &criteria, NULL, ranked, 8);
+    ntrip_atlas_get_selection_cache_stats(&before);
+    if (before.misses != after.misses + 1) {
+        printf("  ❌ New criteria should miss\n");
+        return false;
+    }
+
+    printf("  ✅ Repeat lookups served from cache\n");
+    return true;
+}
+
+// Test tiles without candidates are cached as empty
+bool test_negative_cache() {
+    printf("Testing negative cache...\n");
+    setup_services();
+
+    ntrip_selection_cache_stats_t before, after;
+    ntrip_atlas_get_selection_cache_stats(&before);
+
+    ntrip_service_idx_t ranked[8];
+    for (int i = 0; i < 10; i++) {
+        if (ntrip_atlas_find_ranked_services_cached(-40.0, -30.0 + i * 1e-4, g_services, SERVICE_COUNT,
+                                                    NULL, NULL, ranked, 8) != 0) {
+            printf("  ❌ Mid-Atlantic should have no services\n");
+            return false;
+        }
+    }
+
+    ntrip_atlas_get_selection_cache_stats(&after);
+    if (after.misses - before.misses != 1 || after.negative_hits - before.negative_hits != 9) {
+        printf("  ❌ Expected one miss and 9 negative hits, got %u and %u\n",
+               after.misses - before.misses, after.negative_hits - before.negative_hits);
+        return false;
+    }
+
+    printf("  ✅ Empty tile answered from cache\n");
+    return true;
+}
+
+// Test failures, blacklist entries, credentials and index changes invalidate entries
+bool test_invalidation() {
+    printf("Testing automatic invalidation...\n");
+    setup_services();
+
+    ntrip_credential_store_t credentials;
+    ntrip_atlas_init_credential_store(&credentials);
+
+    // A position with several candidates
+    double lat = 0, lon = 0;
+    ntrip_service_idx_t ranked[8];
+    size_t count = 0;
+    rng_state = 99;
+    while (count < 3) {
+        lat = 45.0 + random_unit() * 8.0;
+        lon = 4.0 + random_unit() * 12.0;
+        count = ntrip_atlas_find_ranked_services_cached(lat, lon, g_services, SERVICE_COUNT,
+                                                        NULL, &credentials, ranked, 8);
+    }
+    ntrip_service_idx_t top = ranked[0];
+
+    ntrip_selection_cache_stats_t before, after;
+    ntrip_atlas_get_selection_cache_stats(&before);
+
+    // Failure backoff removes the top service, success restores it
+    ntrip_atlas_record_compact_failure(top);
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+    ntrip_atlas_find_ranked_services_cached(lat, lon, g_services, SERVICE_COUNT, NULL, &credentials, ranked, 8);
+    if (ranked[0] == top) {
+        printf("  ❌ Failed service still ranked first\n");
+        return false;
+    }
+    ntrip_atlas_record_compact_success(top);
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+
+    // Blacklisting the top service's region removes it here
+    ntrip_atlas_blacklist_service_region(top, lat, lon, "No coverage");
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+    ntrip_atlas_clear_service_geographic_blacklist(top);
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+
+    // New credentials unlock paid services
+    ntrip_atlas_add_credential(&credentials, "Paid Network A", "user", "pass");
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+    ntrip_atlas_add_credential(&credentials, "Paid Network B", "user", "pass");
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+
+    ntrip_atlas_get_selection_cache_stats(&after);
+    if (after.stale - before.stale < 6) {
+        printf("  ❌ Expected every change to invalidate, saw %u stale entries\n", after.stale - before.stale);
+        return false;
+    }
+
+    // A rebuilt index is a new generation too
+    g_services[top].quality_rating = 5;
+    g_services[top].lat_min_deg100 -= 100;
+    index_service(top);
+    if (!check_position(lat, lon, NULL, &credentials)) return false;
+
+    printf("  ✅ Entries invalidated on every state change\n");
+    return true;
+}
+
+// Test bad input and small output buffers
+bool test_limits() {
+    printf("Testing limits...\n");
+    setup_services();
+
+    ntrip_service_idx_t ranked[8];
+    if (ntrip_atlas_find_ranked_services_cached(49.0, 9.0, NULL, SERVICE_COUNT, NULL, NULL, ranked, 8) != 0 ||
+        ntrip_atlas_find_ranked_services_cached(49.0, 9.0, g_services, SERVICE_COUNT, NULL, NULL, NULL, 8) != 0 ||
+        ntrip_atlas_find_ranked_services_cached(95.0, 9.0, g_services, SERVICE_COUNT, NULL, NULL, ranked, 8) != 0) {
+        printf("  ❌ Bad input should return no services\n");
+        return false;
+    }
+
+    // A short buffer holds the best services in order
+    ntrip_service_idx_t full[8], top[2];
+    size_t full_count = ntrip_atlas_find_ranked_services_cached(49.0, 9.0, g_services, SERVICE_COUNT,
+                                                                NULL, NULL, full, 8);
+    size_t top_count = ntrip_atlas_find_ranked_services_cached(49.0, 9.0, g_services, SERVICE_COUNT,
+                                                               NULL, NULL, top, 2);
+    if (full_count < 2 || top_count != 2 || top[0] != full[0] || top[1] != full[1]) {
+        printf("  ❌ Truncated ranking differs\n");
+        return false;
+    }
+
+    ntrip_selection_cache_stats_t stats;
+    if (ntrip_atlas_get_selection_cache_stats(NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_get_selection_cache_stats(&stats) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Stats parameter handling\n");
+        return false;
+    }
+
+    printf("  ✅ Limits enforced\n");
+    return true;
+}
+
+int main() {
+    printf("Selection Cache Tests\n");
+    printf("=====================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Matches reference", test_matches_reference},
+        {"Repeat lookups hit", test_repeat_lookups_hit},
+        {"Negative cache", test_negative_cache},
+        {"Invalidation", test_invalidation},
+        {"Limits", test_limits},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All selection cache tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some selection cache tests failed!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,293 @@
+/**
+ * Precomputed Service Geometry Unit Tests
+ *
+ * Tests the fixed-point unit vector representation of service coverage
+ * centers, bounding radius computation and the integer pruning test used
+ * to skip services that cannot beat the current best.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Reference haversine distance (km)
+static double reference_distance(double lat1, double lon1, double lat2, double lon2) {
+    double p1 = lat1 * M_PI / 180.0, p2 = lat2 * M_PI / 180.0;
+    double dlat = p2 - p1, dlon = (lon2 - lon1) * M_PI / 180.0;
+    double a = sin(dlat / 2) * sin(dlat / 2) + cos(p1) * cos(p2) * sin(dlon / 2) * sin(dlon / 2);
+    return 6371.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
+// Helper function to create test service from degree bounds
+static ntrip_service_compact_t create_test_service(double lat_min, double lat_max,
+                                                   double lon_min, double lon_max) {
+    ntrip_service_compact_t service = {0};
+    strncpy(service.hostname, "geometry.test.com", sizeof(service.hostname) - 1);
+    service.port = 2101;
+    service.lat_min_deg100 = (int16_t)round(lat_min * 100);
+    service.lat_max_deg100 = (int16_t)round(lat_max * 100);
+    service.lon_min_deg100 = (int16_t)round(lon_min * 100);
+    service.lon_max_deg100 = (int16_t)round(lon_max * 100);
+    return service;
+}
+
+// Test structure size stays flash-friendly
+bool test_structure_size() {
+    printf("Testing geometry structure size...\n");
+
+    printf("  ntrip_service_geometry_t: %zu bytes\n", sizeof(ntrip_service_geometry_t));
+    if (sizeof(ntrip_service_geometry_t) != 24) {
+        printf("  ❌ Expected 24 bytes, got %zu\n", sizeof(ntrip_service_geometry_t));
+        return false;
+    }
+
+    printf("  ✅ Geometry structure size correct\n");
+    return true;
+}
+
+// Test runtime geometry matches the generator (yaml_to_c.py) output
+bool test_matches_generator() {
+    printf("Testing runtime geometry matches generator output...\n");
+
+    // Values from compute_service_geometry(4000, 4100, -7500, -7300) in yaml_to_c.py
+    ntrip_service_compact_t service = create_test_service(40.0, 41.0, -75.0, -73.0);
+    ntrip_service_geometry_t geometry;
+
+    if (ntrip_atlas_compute_service_geometry(&service, &geometry) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Failed to compute geometry\n");
+        return false;
+    }
+
+    if (abs(geometry.center.x - 225052302) > 1 ||
+        abs(geometry.center.y - (-784850650)) > 1 ||
+        abs(geometry.center.z - 697339532) > 1) {
+        printf("  ❌ Center mismatch: {%d, %d, %d}\n",
+               geometry.center.x, geometry.center.y, geometry.center.z);
+        return false;
+    }
+
+    if (geometry.radius_km != 103) {
+        printf("  ❌ Expected radius 103 km, got %u km\n", geometry.radius_km);
+        return false;
+    }
+
+    printf("  ✅ Runtime geometry matches generator\n");
+    return true;
+}
+
+// Test center distance against haversine
+bool test_center_distance() {
+    printf("Testing center distance accuracy...\n");
+
+    ntrip_service_compact_t service = create_test_service(40.0, 41.0, -75.0, -73.0);
+    ntrip_service_geometry_t geometry;
+    ntrip_atlas_compute_service_geometry(&service, &geometry);
+
+    struct {
+        double lat, lon;
+        const char* description;
+    } points[] = {
+        {40.5, -74.0, "At center"},
+        {40.51, -74.0, "1km north of center"},
+        {42.0, -74.0, "North of coverage"},
+        {51.5, -0.1, "London"},
+        {-33.9, 151.2, "Sydney (near antipodal)"},
+    };
+
+    for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        ntrip_unit_vector_t user;
+        ntrip_atlas_lat_lon_to_unit_vector(points[i].lat, points[i].lon, &user);
+
+        double fast = ntrip_atlas_geometry_distance_to_center(&geometry, &user);
+        double reference = reference_distance(points[i].lat, points[i].lon, 40.5, -74.0);
+
+        if (fabs(fast - reference) > 0.01) {
+            printf("  ❌ %s: expected %.3f km, got %.3f km\n",
+                   points[i].description, reference, fast);
+            return false;
+        }
+    }
+
+    printf("  ✅ Center distance matches haversine within 10m\n");
+    return true;
+}
+
+// Test bounding radius encloses the whole coverage box
+bool test_radius_encloses_box() {
+    printf("Testing bounding radius encloses coverage...\n");
+
+    struct { double lat_min, lat_max, lon_min, lon_max; } boxes[] = {
+        {40.0, 41.0, -75.0, -73.0},     // Small state network
+        {-45.0, -10.0, 110.0, 160.0},   // Australia
+        {47.0, 55.0, 5.0, 15.0},        // Germany
+        {60.0, 85.0, -170.0, -10.0},    // Wide high-latitude box
+    };
+
+    for (size_t b = 0; b < sizeof(boxes) / sizeof(boxes[0]); b++) {
+        ntrip_service_compact_t service = create_test_service(
+            boxes[b].lat_min, boxes[b].lat_max, boxes[b].lon_min, boxes[b].lon_max);
+        ntrip_service_geometry_t geometry;
+        ntrip_atlas_compute_service_geometry(&service, &geometry);
+
+        double lat_c = (boxes[b].lat_min + boxes[b].lat_max) / 2.0;
+        double lon_c = (boxes[b].lon_min + boxes[b].lon_max) / 2.0;
+
+        // Sample a grid over the box, including edges
+        for (int i = 0; i <= 20; i++) {
+            for (int j = 0; j <= 20; j++) {
+                double lat = boxes[b].lat_min + (boxes[b].lat_max - boxes[b].lat_min) * i / 20.0;
+                double lon = boxes[b].lon_min + (boxes[b].lon_max - boxes[b].lon_min) * j / 20.0;
+                double d = reference_distance(lat_c, lon_c, lat, lon);
+                if (d > geometry.radius_km) {
+                    printf("  ❌ Box %zu: point (%.2f, %.2f) at %.1f km outside radius %u km\n",
+                           b, lat, lon, d, geometry.radius_km);
+                    return false;
+                }
+            }
+        }
+    }
+
+    printf("  ✅ Bounding radius encloses all sampled coverage points\n");
+    return true;
+}
+
+// Test integer pruning is conservative and tight
+bool test_pruning_bound() {
+    printf("Testing pruning bound...\n");
+
+    ntrip_service_compact_t service = create_test_service(40.0, 41.0, -75.0, -73.0);
+    ntrip_service_geometry_t geometry;
+    ntrip_atlas_compute_service_geometry(&service, &geometry);
+
+    ntrip_distance_bound_t bound;
+    if (ntrip_atlas_make_distance_bound(100.0, &bound) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Failed to make distance bound\n");
+        return false;
+    }
+
+    // Sweep user positions north of the service; prune must match
+    // (center distance - radius <= 100km) except within 1km of the boundary
+    for (double lat = 40.5; lat < 46.0; lat += 0.05) {
+        ntrip_unit_vector_t user;
+        ntrip_atlas_lat_lon_to_unit_vector(lat, -74.0, &user);
+
+        double center_km = ntrip_atlas_geometry_distance_to_center(&geometry, &user);
+        double gap_km = center_km - geometry.radius_km - bound.distance_km;
+        bool may_be_within = ntrip_atlas_geometry_may_be_within(&geometry, &user, &bound);
+
+        if (gap_km <= 0.0 && !may_be_within) {
+            printf("  ❌ Lat %.2f: pruned a service that could qualify (gap %.2f km)\n", lat, gap_km);
+            return false;
+        }
+        if (gap_km > 1.0 && may_be_within) {
+            printf("  ❌ Lat %.2f: failed to prune service %.2f km beyond bound\n", lat, gap_km);
+            return false;
+        }
+    }
+
+    // Huge bounds can never prune
+    ntrip_atlas_make_distance_bound(25000.0, &bound);
+    ntrip_unit_vector_t antipode;
+    ntrip_atlas_lat_lon_to_unit_vector(-40.5, 106.0, &antipode);
+    if (!ntrip_atlas_geometry_may_be_within(&geometry, &antipode, &bound)) {
+        printf("  ❌ Bound beyond half circumference should never prune\n");
+        return false;
+    }
+
+    printf("  ✅ Pruning bound is conservative and tight\n");
+    return true;
+}
+
+// Test edge cases and error handling
+bool test_edge_cases() {
+    printf("Testing edge cases and error handling...\n");
+
+    ntrip_service_geometry_t geometry;
+    if (ntrip_atlas_compute_service_geometry(NULL, &geometry) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Should reject NULL service\n");
+        return false;
+    }
+
+    if (!isinf(ntrip_atlas_geometry_distance_to_center(NULL, NULL))) {
+        printf("  ❌ Should return infinity with NULL geometry\n");
+        return false;
+    }
+
+    // Antipodal components differ by 2^31, past int32 range
+    ntrip_service_compact_t equator = create_test_service(-1.0, 1.0, -91.0, -89.0);
+    ntrip_atlas_compute_service_geometry(&equator, &geometry);
+    ntrip_unit_vector_t antipode;
+    ntrip_atlas_lat_lon_to_unit_vector(0.0, 90.0, &antipode);
+    double antipode_km = ntrip_atlas_geometry_distance_to_center(&geometry, &antipode);
+    if (fabs(antipode_km - reference_distance(0.0, -90.0, 0.0, 90.0)) > 1.0) {
+        printf("  ❌ Antipode should be half the globe away, got %.3f km\n", antipode_km);
+        return false;
+    }
+
+    ntrip_distance_bound_t bound;
+    if (ntrip_atlas_make_distance_bound(-1.0, &bound) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Should reject negative distance bound\n");
+        return false;
+    }
+
+    // Global coverage gets the maximum radius
+    ntrip_service_compact_t global = create_test_service(-90.0, 90.0, -180.0, 180.0);
+    ntrip_atlas_compute_service_geometry(&global, &geometry);
+    if (geometry.radius_km < 20015) {
+        printf("  ❌ Global service radius should span the globe, got %u km\n", geometry.radius_km);
+        return false;
+    }
+
+    printf("  ✅ Edge cases handled correctly\n");
+    return true;
+}
+
+int main() {
+    printf("Service Geometry Tests\n");
+    printf("======================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Structure size", test_structure_size},
+        {"Generator parity", test_matches_generator},
+        {"Center distance", test_center_distance},
+        {"Radius encloses box", test_radius_encloses_box},
+        {"Pruning bound", test_pruning_bound},
+        {"Edge cases", test_edge_cases},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All service geometry tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some service geometry tests failed!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,452 @@
+/**
+ * Stream Health Probe Unit Tests
+ *
+ * Probes mountpoints over a scripted transport on a fake clock: the
+ * request carries credentials and GGA, RTCM3 frames split across receive
+ * chunks are checked with CRC-24Q, timings come out in order, and the
+ * outcome lands in compact failure tracking. Also probes a loopback
+ * caster through the Linux socket transport with ntrip_atlas_test_service().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+// RTCM 1005 example frame from RTCM 10403, CRC 0x360B98
+static const uint8_t g_frame_1005[] = {
+    0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98, 0x0E, 0xDE, 0xEF, 0x34,
+    0xB4, 0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98, 0x6F, 0x33, 0x36, 0x0B, 0x98
+};
+
+static char g_response[1024];
+static size_t g_response_len;
+static size_t g_response_pos;
+static bool g_close_at_end;
+static char g_request[1024];
+static size_t g_request_len;
+static uint32_t g_now_ms = 1000;
+static bool g_open;
+
+static void set_response(const char* header, const uint8_t* body, size_t body_len) {
+    g_response_len = strlen(header);
+    memcpy(g_response, header, g_response_len);
+    if (body_len > 0) {
+        memcpy(g_response + g_response_len, body, body_len);
+    }
+    g_response_len += body_len;
+    g_response_pos = 0;
+    g_request_len = 0;
+    g_close_at_end = false;
+}
+
+static int fake_connect(const char* host, uint16_t port, uint8_t ssl, void** connection) {
+    (void)port; (void)ssl;
+    if (strcmp(host, "caster.example") != 0) {
+        return NTRIP_ATLAS_ERROR_NO_NETWORK;
+    }
+    g_open = true;
+    *connection = &g_open;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+static int fake_send(void* connection, const char* data, size_t len) {
+    (void)connection;
+    g_now_ms += 5;
+    if (g_request_len + len < sizeof(g_request)) {
+        memcpy(g_request + g_request_len, data, len);
+        g_request_len += len;
+        g_request[g_request_len] = '\0';
+    }
+    return (int)len;
+}
+
+// Ten bytes per call, so frames straddle chunks; then silence or close
+static int fake_recv(void* connection, char* buffer, size_t max_len) {
+    (void)connection;
+    if (g_response_pos >= g_response_len) {
+        g_now_ms += 50;
+        return g_close_at_end ? 0 : NTRIP_ATLAS_ERROR_WOULD_BLOCK;
+    }
+    g_now_ms += 10;
+    size_t n = g_response_len - g_response_pos;
+    if (n > 10) n = 10;
+    if (n > max_len) n = max_len;
+    memcpy(buffer, g_response + g_response_pos, n);
+    g_response_pos += n;
+    return (int)n;
+}
+
+static void fake_close(void* connection) {
+    *(bool*)connection = false;
+}
+
+static const ntrip_nb_transport_t g_fake_transport = {
+    .connect = fake_connect,
+    .send = fake_send,
+    .recv = fake_recv,
+    .poll_fd = NULL,
+    .close = fake_close
+};
+
+static uint32_t fake_get_time_ms(void) {
+    return g_now_ms;
+}
+
+static const ntrip_platform_t g_platform = {
+    .interface_version = 2,
+    .get_time_ms = fake_get_time_ms,
+    .nb_transport = &g_fake_transport
+};
+
+static ntrip_service_config_t g_config = { .provider = "ProbeNet" };
+
+static const ntrip_service_index_entry_t g_mapping[] = {
+    { "ProbeNet", 0 }
+};
+
+static ntrip_best_service_t make_best(const char* format, uint8_t nmea_required) {
+    ntrip_best_service_t best;
+    memset(&best, 0, sizeof(best));
+    strcpy(best.server, "caster.example");
+    best.port = 2101;
+    strcpy(best.mountpoint, "MOUNT1");
+    strcpy(best.username, "user");
+    strcpy(best.password, "pass");
+    strcpy(best.format, format);
+    best.nmea_required = nmea_required;
+    best.mountpoint_latitude = 50.1;
+    best.mountpoint_longitude = 8.7;
+    best.service_info = &g_config;
+    return best;
+}
+
+// Test the request a probe sends
+bool test_request_format() {
+    printf("Testing probe request...\n");
+
+    set_response("ICY 200 OK\r\n", g_frame_1005, sizeof(g_frame_1005));
+    ntrip_best_service_t best = make_best("RTCM 3.2", 1);
+    ntrip_probe_stats_t stats;
+    ntrip_atlas_test_service(&g_platform, &best, 1000, &stats);
+
+    const char* headers_end = strstr(g_request, "\r\n\r\n");
+    if (strncmp(g_request, "GET /MOUNT1 HTTP/1.1\r\n", 22) != 0 ||
+        !strstr(g_request, "Host: caster.example:2101\r\n") ||
+        !strstr(g_request, "Authorization: Basic dXNlcjpwYXNz\r\n") ||
+        !strstr(g_request, "Ntrip-GGA: $GPGGA,") || !headers_end) {
+        printf("  ❌ Missing headers:\n%s\n", g_request);
+        return false;
+    }
+
+    // The sentence follows the headers for NTRIP 1.0 casters
+    const char* sentence = headers_end + 4;
+    if (strncmp(sentence, "$GPGGA,", 7) != 0 || strstr(sentence, "\r\n") != g_request + g_request_len - 2 ||
+        strstr(g_request, "Ntrip-GGA: ") > headers_end) {
+        printf("  ❌ GGA after the headers missing or malformed\n");
+        return false;
+    }
+
+    best = make_best("RTCM 3.2", 0);
+    best.username[0] = '\0';
+    set_response("ICY 200 OK\r\n", g_frame_1005, sizeof(g_frame_1005));
+    ntrip_atlas_test_service(&g_platform, &best, 1000, &stats);
+    if (strstr(g_request, "GGA") || strstr(g_request, "Authorization") ||
+        strcmp(g_request + g_request_len - 4, "\r\n\r\n") != 0) {
+        printf("  ❌ Public mountpoint request carries extras:\n%s\n", g_request);
+        return false;
+    }
+
+    printf("  ✅ Credentials and GGA in header and stream\n");
+    return true;
+}
+
+// Test timings and frame counts on a healthy stream
+bool test_healthy_stream() {
+    printf("Testing healthy RTCM3 stream...\n");
+
+    // Three frames, a corrupted one, then another good one
+    uint8_t body[5 * sizeof(g_frame_1005) + 4];
+    size_t pos = 0;
+    memcpy(body + pos, "\x01\x02\xD3\x7F", 4);  // Noise, including a false preamble
+    pos += 4;
+    for (int i = 0; i < 5; i++) {
+        memcpy(body + pos, g_frame_1005, sizeof(g_frame_1005));
+        if (i == 3) {
+            body[pos + 10] ^= 0x40;
+        }
+        pos += sizeof(g_frame_1005);
+    }
+    set_response("ICY 200 OK\r\n", body, pos);
+
+    ntrip_atlas_init_compact_failure_tracking(g_mapping, 1);
+    ntrip_atlas_record_compact_failure(0);
+
+    ntrip_best_service_t best = make_best("RTCM 3.2", 0);
+    ntrip_probe_stats_t stats;
+    ntrip_atlas_error_t ret = ntrip_atlas_test_service(&g_platform, &best, 2000, &stats);
+    if (ret != NTRIP_ATLAS_SUCCESS || stats.status != NTRIP_ATLAS_SUCCESS || g_open) {
+        printf("  ❌ Probe returned %d\n", ret);
+        return false;
+    }
+    if (stats.frames != 4 || stats.crc_errors != 1 || stats.bytes != pos) {
+        printf("  ❌ Counted %u frames, %u CRC errors, %u bytes\n",
+               (unsigned)stats.frames, (unsigned)stats.crc_errors, (unsigned)stats.bytes);
+        return false;
+    }
+    if (stats.connect_ms != 5 || stats.first_byte_ms <= stats.connect_ms ||
+        stats.first_frame_ms <= stats.first_byte_ms || stats.elapsed_ms != 2000) {
+        printf("  ❌ Timings out of order: connect %u, first byte %u, first frame %u, elapsed %u\n",
+               (unsigned)stats.connect_ms, (unsigned)stats.first_byte_ms,
+               (unsigned)stats.first_frame_ms, (unsigned)stats.elapsed_ms);
+        return false;
+    }
+    double expected_rate = 4 * 1000.0 / (2000 - stats.first_frame_ms);
+    if (stats.message_rate < expected_rate - 1e-9 || stats.message_rate > expected_rate + 1e-9) {
+        printf("  ❌ Message rate %.3f, expected %.3f\n", stats.message_rate, expected_rate);
+        return false;
+    }
+    if (ntrip_atlas_is_compact_service_blocked(0)) {
+        printf("  ❌ Success did not clear the earlier failure\n");
+        return false;
+    }
+
+    // The 1005 frames arrive split across receives; their position is cached
+    double lat = 0.0, lon = 0.0;
+    if (!stats.station_position ||
+        !ntrip_atlas_station_position_lookup("caster.example", "MOUNT1", &lat, &lon) ||
+        fabs(lat - 38.8047594) > 1e-6 || fabs(lon + 77.0647736) > 1e-6) {
+        printf("  ❌ Station position not recorded (%.7f, %.7f)\n", lat, lon);
+        return false;
+    }
+
+    printf("  ✅ 4 frames, first after %u ms, %.2f msg/s\n",
+           (unsigned)stats.first_frame_ms, stats.message_rate);
+    return true;
+}
+
+// Test streams that never deliver a valid frame
+bool test_unhealthy_streams() {
+    printf("Testing silent, garbage and rejected streams...\n");
+    ntrip_atlas_init_compact_failure_tracking(g_mapping, 1);
+    ntrip_best_service_t best = make_best("RTCM 3.2", 0);
+    ntrip_probe_stats_t stats;
+
+    set_response("ICY 200 OK\r\n", NULL, 0);
+    if (ntrip_atlas_test_service(&g_platform, &best, 500, &stats) != NTRIP_ATLAS_ERROR_TIMEOUT ||
+        stats.first_byte_ms == NTRIP_ATLAS_PROBE_NOT_REACHED ||
+        stats.first_frame_ms != NTRIP_ATLAS_PROBE_NOT_REACHED || stats.message_rate != 0.0) {
+        printf("  ❌ Silent stream reported %d\n", stats.status);
+        return false;
+    }
+    if (!ntrip_atlas_is_compact_service_blocked(0)) {
+        printf("  ❌ Silent stream not recorded as a failure\n");
+        return false;
+    }
+
+    ntrip_atlas_init_compact_failure_tracking(g_mapping, 1);
+    const uint8_t text[] = "$GPGSV,this is not RTCM\r\n";
+    set_response("ICY 200 OK\r\n", text, sizeof(text) - 1);
+    g_close_at_end = true;
+    if (ntrip_atlas_test_service(&g_platform, &best, 500, &stats) != NTRIP_ATLAS_ERROR_INVALID_RESPONSE ||
+        !ntrip_atlas_is_compact_service_blocked(0)) {
+        printf("  ❌ Garbage stream reported %d\n", stats.status);
+        return false;
+    }
+
+    // Bad credentials are the user's problem, not the caster's
+    ntrip_atlas_init_compact_failure_tracking(g_mapping, 1);
+    set_response("HTTP/1.1 401 Unauthorized\r\nContent-Length: 0\r\n\r\n", NULL, 0);
+    if (ntrip_atlas_test_service(&g_platform, &best, 500, &stats) != NTRIP_ATLAS_ERROR_AUTH_FAILED ||
+        ntrip_atlas_is_compact_service_blocked(0)) {
+        printf("  ❌ Rejected credentials reported %d or blocked the service\n", stats.status);
+        return false;
+    }
+
+    strcpy(best.server, "unreachable.example");
+    if (ntrip_atlas_test_service(&g_platform, &best, 500, &stats) != NTRIP_ATLAS_ERROR_NO_NETWORK ||
+        stats.connect_ms != NTRIP_ATLAS_PROBE_NOT_REACHED || !ntrip_atlas_is_compact_service_blocked(0)) {
+        printf("  ❌ Unreachable caster reported %d\n", stats.status);
+        return false;
+    }
+
+    printf("  ✅ Timeout, invalid data, auth and connect failures\n");
+    return true;
+}
+
+// Test non-RTCM3 formats, cancellation and parameters
+bool test_other_formats_and_cancel() {
+    printf("Testing other formats, cancel and parameters...\n");
+    ntrip_atlas_init_compact_failure_tracking(g_mapping, 1);
+    ntrip_probe_stats_t stats;
+
+    const uint8_t cmr[] = { 0x02, 0x00, 0x93, 0x31, 0x10, 0x20, 0x30, 0x03 };
+    set_response("ICY 200 OK\r\n", cmr, sizeof(cmr));
+    ntrip_best_service_t best = make_best("CMR+", 0);
+    if (ntrip_atlas_test_service(&g_platform, &best, 500, &stats) != NTRIP_ATLAS_SUCCESS ||
+        stats.frames != 0 || stats.bytes != sizeof(cmr)) {
+        printf("  ❌ CMR+ stream reported %d\n", stats.status);
+        return false;
+    }
+
+    // Cancelling before any data says nothing about the caster
+    set_response("ICY 200 OK\r\n", g_frame_1005, sizeof(g_frame_1005));
+    best = make_best("RTCM 3.2", 0);
+    ntrip_service_probe_t probe;
+    if (ntrip_atlas_probe_begin(&probe, &g_platform, &best, 500) != NTRIP_ATLAS_SUCCESS ||
+        ntrip_atlas_probe_end(&probe, &stats) != NTRIP_ATLAS_ERROR_TIMEOUT ||
+        ntrip_atlas_is_compact_service_blocked(0) || g_open) {
+        printf("  ❌ Cancelled probe reported %d\n", stats.status);
+        return false;
+    }
+
+    ntrip_platform_t no_clock = g_platform;
+    no_clock.get_time_ms = NULL;
+    if (ntrip_atlas_probe_begin(&probe, &no_clock, &best, 0) != NTRIP_ATLAS_ERROR_MISSING_FEATURE ||
+        ntrip_atlas_probe_begin(NULL, &g_platform, &best, 0) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_probe_begin(&probe, &g_platform, NULL, 0) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Bad parameters accepted\n");
+        return false;
+    }
+
+    printf("  ✅ CMR+ counts as data, cancel is not a failure\n");
+    return true;
+}
+
+typedef struct {
+    int listen_fd;
+    int frames;
+} loopback_caster_t;
+
+// Serve one mountpoint connection: ICY header, then a frame every 20 ms
+static void* serve_loopback(void* arg) {
+    loopback_caster_t* caster = (loopback_caster_t*)arg;
+    int fd = accept(caster->listen_fd, NULL, NULL);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    char request[1024];
+    size_t length = 0;
+    request[0] = '\0';
+    while (length < sizeof(request) - 1 && !strstr(request, "\r\n\r\n")) {
+        ssize_t n = recv(fd, request + length, sizeof(request) - 1 - length, 0);
+        if (n <= 0) break;
+        length += (size_t)n;
+        request[length] = '\0';
+    }
+
+    send(fd, "ICY 200 OK\r\n", 12, MSG_NOSIGNAL);
+    struct timespec pause = { 0, 20 * 1000000L };
+    for (int i = 0; i < caster->frames; i++) {
+        if (send(fd, g_frame_1005, sizeof(g_frame_1005), MSG_NOSIGNAL) <= 0) break;
+        nanosleep(&pause, NULL);
+    }
+    close(fd);
+    return NULL;
+}
+
+static uint32_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// Test the blocking probe over Linux sockets
+bool test_linux_loopback_probe() {
+    printf("Testing blocking probe against a loopback caster...\n");
+
+    loopback_caster_t caster = { .frames = 100 };
+    caster.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    if (caster.listen_fd < 0 ||
+        bind(caster.listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(caster.listen_fd, 1) != 0 ||
+        getsockname(caster.listen_fd, (struct sockaddr*)&address, &address_length) != 0) {
+        printf("  ❌ Could not start loopback caster\n");
+        return false;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, serve_loopback, &caster);
+
+    ntrip_platform_t platform = {
+        .interface_version = 2,
+        .get_time_ms = monotonic_ms,
+        .nb_transport = &ntrip_platform_linux_nb_transport
+    };
+    ntrip_best_service_t best = make_best("RTCM 3.2", 1);
+    strcpy(best.server, "127.0.0.1");
+    best.port = ntohs(address.sin_port);
+
+    ntrip_probe_stats_t stats;
+    ntrip_atlas_error_t ret = ntrip_atlas_test_service(&platform, &best, 300, &stats);
+    pthread_join(thread, NULL);
+    close(caster.listen_fd);
+
+    if (ret != NTRIP_ATLAS_SUCCESS || stats.frames < 5 || stats.crc_errors != 0 ||
+        stats.connect_ms == NTRIP_ATLAS_PROBE_NOT_REACHED || stats.first_frame_ms > 300 ||
+        stats.elapsed_ms < 290) {
+        printf("  ❌ Probe returned %d with %u frames after %u ms\n",
+               ret, (unsigned)stats.frames, (unsigned)stats.elapsed_ms);
+        return false;
+    }
+
+    printf("  ✅ %u frames, first after %u ms, %.1f msg/s\n",
+           (unsigned)stats.frames, (unsigned)stats.first_frame_ms, stats.message_rate);
+    return true;
+}
+
+int main() {
+    printf("Service Probe Tests\n");
+    printf("===================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Request format", test_request_format},
+        {"Healthy stream", test_healthy_stream},
+        {"Unhealthy streams", test_unhealthy_streams},
+        {"Other formats and cancel", test_other_formats_and_cancel},
+        {"Linux loopback probe", test_linux_loopback_probe},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All service probe tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some service probe tests failed!\n");
+        return 1;
+    }
+}
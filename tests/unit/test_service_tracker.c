@@ -0,0 +1,342 @@
+/**
+ * Movement-Aware Service Tracker Unit Tests
+ *
+ * Tests incremental reselection for a moving rover: cached tile
+ * candidates, the reselect distance trigger, hysteresis against boundary
+ * flapping and forced switches when coverage ends.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#define SERVICE_NORTH   0
+#define SERVICE_SOUTH   1
+#define SERVICE_EAST    2
+
+static ntrip_service_compact_t g_services[3];
+
+// Helper function to create test service from degree bounds
+static ntrip_service_compact_t create_test_service(const char* hostname, double lat_min, double lat_max,
+                                                   double lon_min, double lon_max, uint8_t quality) {
+    ntrip_service_compact_t service = {0};
+    strncpy(service.hostname, hostname, sizeof(service.hostname) - 1);
+    service.port = 2101;
+    service.lat_min_deg100 = (int16_t)round(lat_min * 100);
+    service.lat_max_deg100 = (int16_t)round(lat_max * 100);
+    service.lon_min_deg100 = (int16_t)round(lon_min * 100);
+    service.lon_max_deg100 = (int16_t)round(lon_max * 100);
+    service.quality_rating = quality;
+    return service;
+}
+
+// Two casters meeting along 49.0-49.5°N, and a weaker one to the east
+static void setup_services() {
+    g_services[SERVICE_NORTH] = create_test_service("north.test.com", 49.0, 51.0, 9.0, 13.0, 4);
+    g_services[SERVICE_SOUTH] = create_test_service("south.test.com", 47.0, 49.5, 9.0, 13.0, 4);
+    g_services[SERVICE_EAST] = create_test_service("east.test.com", 49.0, 51.0, 12.5, 16.0, 2);
+
+    ntrip_atlas_init_spatial_index();
+    for (size_t i = 0; i < 3; i++) {
+        const ntrip_service_compact_t* service = &g_services[i];
+        for (uint8_t level = 0; level <= NTRIP_SPATIAL_FINEST_LEVEL; level++) {
+            uint16_t lat_first, lat_last, lon_first, lon_last;
+            ntrip_atlas_lat_lon_to_tile(service->lat_min_deg100 / 100.0, service->lon_min_deg100 / 100.0,
+                                        level, &lat_first, &lon_first);
+            ntrip_atlas_lat_lon_to_tile(service->lat_max_deg100 / 100.0, service->lon_max_deg100 / 100.0,
+                                        level, &lat_last, &lon_last);
+            for (uint16_t lat_tile = lat_first; lat_tile <= lat_last; lat_tile++) {
+                for (uint16_t lon_tile = lon_first; lon_tile <= lon_last; lon_tile++) {
+                    ntrip_atlas_add_service_to_tile(
+                        ntrip_atlas_encode_tile_key(level, lat_tile, lon_tile), (ntrip_service_idx_t)i);
+                }
+            }
+        }
+    }
+}
+
+// Index of the service ntrip_atlas_find_best_service_spatial_geographic() picks
+static int reference_best(double lat, double lon) {
+    ntrip_service_compact_t best;
+    if (ntrip_atlas_find_best_service_spatial_geographic(lat, lon, g_services, 3, &best) != NTRIP_ATLAS_SUCCESS) {
+        return -1;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(best.hostname, g_services[i].hostname) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Test first selection matches the single-shot lookup
+bool test_initial_selection() {
+    printf("Testing initial selection...\n");
+
+    const double positions[][2] = { {50.5, 11.0}, {48.0, 10.0}, {50.0, 15.5}, {49.2, 11.0} };
+
+    for (size_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        ntrip_service_tracker_t tracker;
+        ntrip_atlas_tracker_init(&tracker, g_services, 3, NULL);
+
+        ntrip_tracker_event_t event;
+        if (ntrip_atlas_tracker_update(&tracker, positions[i][0], positions[i][1], &event) != NTRIP_ATLAS_SUCCESS ||
+            event != NTRIP_TRACKER_SELECTED) {
+            printf("  ❌ No selection at (%.2f, %.2f)\n", positions[i][0], positions[i][1]);
+            return false;
+        }
+
+        ntrip_service_idx_t current;
+        ntrip_atlas_tracker_get_current(&tracker, &current);
+        if ((int)current != reference_best(positions[i][0], positions[i][1])) {
+            printf("  ❌ Picked %u at (%.2f, %.2f), single-shot lookup picks %d\n",
+                   (unsigned)current, positions[i][0], positions[i][1],
+                   reference_best(positions[i][0], positions[i][1]));
+            return false;
+        }
+    }
+
+    printf("  ✅ Matches ntrip_atlas_find_best_service_spatial_geographic()\n");
+    return true;
+}
+
+// Test steady-state updates do no index work
+bool test_steady_state() {
+    printf("Testing steady-state updates...\n");
+
+    ntrip_service_tracker_t tracker;
+    ntrip_atlas_tracker_init(&tracker, g_services, 3, NULL);
+
+    // Tractor working a 1 km field inside the north caster
+    for (int i = 0; i < 500; i++) {
+        double lat = 50.5 + 0.004 * sin(i * 0.1);
+        double lon = 11.0 + 0.006 * cos(i * 0.1);
+        ntrip_tracker_event_t event;
+        ntrip_atlas_tracker_update(&tracker, lat, lon, &event);
+        if (i > 0 && event != NTRIP_TRACKER_UNCHANGED) {
+            printf("  ❌ Update %d changed selection\n", i);
+            return false;
+        }
+    }
+
+    printf("  Updates: %u, tile lookups: %u, evaluations: %u\n",
+           tracker.stats.updates, tracker.stats.tile_lookups, tracker.stats.evaluations);
+    if (tracker.stats.tile_lookups != 1 || tracker.stats.evaluations != 1) {
+        printf("  ❌ Expected one lookup and one evaluation\n");
+        return false;
+    }
+
+    printf("  ✅ No reselection work in steady state\n");
+    return true;
+}
+
+// Test hysteresis stops flapping across a coverage boundary
+bool test_no_flapping() {
+    printf("Testing hysteresis at a boundary...\n");
+
+    // Re-score on every outward step so only hysteresis holds the selection
+    ntrip_tracker_config_t config = ntrip_atlas_get_default_tracker_config();
+    config.reselect_distance_km = 0.0;
+    config.switch_margin = 15.0;
+
+    ntrip_service_tracker_t tracker;
+    ntrip_atlas_tracker_init(&tracker, g_services, 3, &config);
+
+    int reference_flips = 0;
+    int previous = -1;
+    for (int i = 0; i < 40; i++) {
+        double lat = (i % 2) ? 49.2 : 49.05;
+        int best = reference_best(lat, 11.0);
+        if (previous >= 0 && best != previous) {
+            reference_flips++;
+        }
+        previous = best;
+
+        ntrip_atlas_tracker_update(&tracker, lat, 11.0, NULL);
+    }
+
+    printf("  Single-shot flips: %d, tracker switches: %u, evaluations: %u\n",
+           reference_flips, tracker.stats.switches, tracker.stats.evaluations);
+    if (reference_flips < 30) {
+        printf("  ❌ Scenario does not exercise the boundary\n");
+        return false;
+    }
+    if (tracker.stats.switches != 0) {
+        printf("  ❌ Tracker flapped\n");
+        return false;
+    }
+    if (tracker.stats.evaluations < 20) {
+        printf("  ❌ Expected re-scoring on outward steps\n");
+        return false;
+    }
+
+    printf("  ✅ Selection held across the boundary\n");
+    return true;
+}
+
+// Test a challenger must win several evaluations in a row
+bool test_confirmation() {
+    printf("Testing switch confirmation...\n");
+
+    ntrip_tracker_config_t config = ntrip_atlas_get_default_tracker_config();
+    config.reselect_distance_km = 0.0;
+    config.switch_margin = 0.0;
+    config.confirm_evaluations = 3;
+
+    ntrip_service_tracker_t tracker;
+    ntrip_atlas_tracker_init(&tracker, g_services, 3, &config);
+
+    ntrip_tracker_event_t event;
+    ntrip_atlas_tracker_update(&tracker, 49.05, 11.0, &event);
+    ntrip_service_idx_t current;
+    ntrip_atlas_tracker_get_current(&tracker, &current);
+    if (event != NTRIP_TRACKER_SELECTED || current != SERVICE_SOUTH) {
+        printf("  ❌ Expected south caster first\n");
+        return false;
+    }
+
+    // North now leads on every update; the third consecutive win switches
+    const double track[] = { 49.3, 49.32, 49.34 };
+    for (int i = 0; i < 3; i++) {
+        ntrip_atlas_tracker_update(&tracker, track[i], 11.0, &event);
+        ntrip_tracker_event_t expected = i < 2 ? NTRIP_TRACKER_UNCHANGED : NTRIP_TRACKER_SWITCHED;
+        if (event != expected) {
+            printf("  ❌ Step %d: event %d, expected %d\n", i, event, expected);
+            return false;
+        }
+    }
+
+    ntrip_atlas_tracker_get_current(&tracker, &current);
+    if (current != SERVICE_NORTH) {
+        printf("  ❌ Expected north caster after confirmation\n");
+        return false;
+    }
+
+    printf("  ✅ Switched after %u confirmations\n", config.confirm_evaluations);
+    return true;
+}
+
+// Test leaving coverage switches at once, and leaving all coverage reports loss
+bool test_forced_switch_and_loss() {
+    printf("Testing forced switch and loss...\n");
+
+    ntrip_service_tracker_t tracker;
+    ntrip_atlas_tracker_init(&tracker, g_services, 3, NULL);
+
+    ntrip_tracker_event_t event;
+    ntrip_atlas_tracker_update(&tracker, 48.0, 11.0, &event);
+
+    // Leave the south box: no confirmation wait
+    ntrip_atlas_tracker_update(&tracker, 50.0, 11.0, &event);
+    ntrip_service_idx_t current;
+    ntrip_atlas_tracker_get_current(&tracker, &current);
+    if (event != NTRIP_TRACKER_SWITCHED || current != SERVICE_NORTH) {
+        printf("  ❌ Expected immediate switch to north, got event %d\n", event);
+        return false;
+    }
+
+    // Drive out of every box
+    ntrip_atlas_tracker_update(&tracker, 0.0, 0.0, &event);
+    if (event != NTRIP_TRACKER_LOST ||
+        ntrip_atlas_tracker_get_current(&tracker, &current) != NTRIP_ATLAS_ERROR_NO_SERVICES) {
+        printf("  ❌ Expected loss of coverage\n");
+        return false;
+    }
+
+    // And back in
+    ntrip_atlas_tracker_update(&tracker, 48.0, 11.0, &event);
+    if (event != NTRIP_TRACKER_SELECTED) {
+        printf("  ❌ Expected reselection on return\n");
+        return false;
+    }
+
+    printf("  ✅ Coverage edges handled\n");
+    return true;
+}
+
+// Test parameter validation and reset
+bool test_edge_cases() {
+    printf("Testing edge cases...\n");
+
+    ntrip_service_tracker_t tracker;
+    if (ntrip_atlas_tracker_init(NULL, g_services, 3, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_tracker_init(&tracker, NULL, 3, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_tracker_init(&tracker, g_services, 0, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Bad init parameters accepted\n");
+        return false;
+    }
+
+    ntrip_atlas_tracker_init(&tracker, g_services, 3, NULL);
+    if (ntrip_atlas_tracker_update(&tracker, 91.0, 0.0, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Out-of-range position accepted\n");
+        return false;
+    }
+
+    ntrip_atlas_tracker_update(&tracker, 50.5, 11.0, NULL);
+    ntrip_atlas_tracker_reset(&tracker);
+
+    ntrip_service_idx_t current;
+    if (ntrip_atlas_tracker_get_current(&tracker, &current) != NTRIP_ATLAS_ERROR_NO_SERVICES) {
+        printf("  ❌ Reset kept the selection\n");
+        return false;
+    }
+
+    ntrip_tracker_event_t event;
+    uint32_t lookups = tracker.stats.tile_lookups;
+    ntrip_atlas_tracker_update(&tracker, 50.5, 11.0, &event);
+    if (event != NTRIP_TRACKER_SELECTED || tracker.stats.tile_lookups != lookups + 1) {
+        printf("  ❌ Reset should force a fresh lookup\n");
+        return false;
+    }
+
+    printf("  ✅ Edge cases handled\n");
+    return true;
+}
+
+int main() {
+    printf("Service Tracker Tests\n");
+    printf("=====================\n\n");
+
+    setup_services();
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Initial selection", test_initial_selection},
+        {"Steady state", test_steady_state},
+        {"No flapping", test_no_flapping},
+        {"Confirmation", test_confirmation},
+        {"Forced switch and loss", test_forced_switch_and_loss},
+        {"Edge cases", test_edge_cases},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All service tracker tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some service tracker tests failed!\n");
+        return 1;
+    }
+}
@@ -63,7 +63,7 @@ void populate_spatial_index() {
             for (uint16_t lat_tile = min_lat_tile; lat_tile <= max_lat_tile; lat_tile++) {
                 for (uint16_t lon_tile = min_lon_tile; lon_tile <= max_lon_tile; lon_tile++) {
                     ntrip_tile_key_t tile_key = ntrip_atlas_encode_tile_key(level, lat_tile, lon_tile);
-                    ntrip_atlas_add_service_to_tile(tile_key, (uint8_t)i);
+                    ntrip_atlas_add_service_to_tile(tile_key, (ntrip_service_idx_t)i);
                 }
             }
         }
@@ -121,13 +121,13 @@ void test_german_problem_fix() {
         printf("📍 %s (%.4f°, %.4f°):\n", test->location, test->lat, test->lon);
 
         // Test 1: Original spatial indexing (shows the problem)
-        uint8_t spatial_services[8];
+        ntrip_service_idx_t spatial_services[8];
         size_t spatial_count = ntrip_atlas_find_services_by_location_fast(
             test->lat, test->lon, spatial_services, 8
         );
 
         // Test 2: New integrated function (shows the fix)
-        uint8_t verified_services[8];
+        ntrip_service_idx_t verified_services[8];
         size_t verified_count = ntrip_atlas_find_services_spatial_geographic(
             test->lat, test->lon, services, service_count, verified_services, 8
         );
@@ -151,7 +151,7 @@ void test_german_problem_fix() {
         // Check for specific service types in verified results
         bool found_european = false, found_massachusetts = false, found_australian = false;
         for (size_t j = 0; j < verified_count; j++) {
-            uint8_t service_idx = verified_services[j];
+            ntrip_service_idx_t service_idx = verified_services[j];
             if (service_idx < service_count) {
                 const ntrip_service_compact_t* service = &services[service_idx];
 
@@ -175,7 +175,7 @@ void test_german_problem_fix() {
         if (verified_count > 0) {
             printf("    Verified services: ");
             for (size_t j = 0; j < verified_count; j++) {
-                uint8_t service_idx = verified_services[j];
+                ntrip_service_idx_t service_idx = verified_services[j];
                 if (service_idx < service_count) {
                     printf("%s ", services[service_idx].hostname);
                 }
@@ -233,13 +233,13 @@ void test_performance_comparison() {
         printf("📍 %s:\n", locations[i].location);
 
         // Method 1: Spatial indexing only
-        uint8_t spatial_results[8];
+        ntrip_service_idx_t spatial_results[8];
         size_t spatial_count = ntrip_atlas_find_services_by_location_fast(
             locations[i].lat, locations[i].lon, spatial_results, 8
         );
 
         // Method 2: Integrated spatial + geographic
-        uint8_t integrated_results[8];
+        ntrip_service_idx_t integrated_results[8];
         size_t integrated_count = ntrip_atlas_find_services_spatial_geographic(
             locations[i].lat, locations[i].lon, services, service_count,
             integrated_results, 8
@@ -328,7 +328,7 @@ bool test_fast_service_lookup() {
     ntrip_tile_key_t sf_tile = ntrip_atlas_encode_tile_key(3, sf_lat_tile, sf_lon_tile);
 
     // Add services to San Francisco area
-    uint8_t sf_services[] = {5, 8, 12, 15};
+    ntrip_service_idx_t sf_services[] = {5, 8, 12, 15};
     for (size_t i = 0; i < sizeof(sf_services) / sizeof(sf_services[0]); i++) {
         result = ntrip_atlas_add_service_to_tile(sf_tile, sf_services[i]);
         if (result != NTRIP_ATLAS_SUCCESS) {
@@ -353,7 +353,7 @@ bool test_fast_service_lookup() {
     }
 
     // Test lookup in San Francisco area
-    uint8_t found_services[10];
+    ntrip_service_idx_t found_services[10];
     size_t found_count = ntrip_atlas_find_services_by_location_fast(
         37.7749, -122.4194,  // San Francisco
         found_services, 10
@@ -436,7 +436,7 @@ bool test_hierarchical_fallback() {
 
     // Search at a location within that coarse tile
     // Should find the service via hierarchical fallback
-    uint8_t found_services[5];
+    ntrip_service_idx_t found_services[5];
     size_t found_count = ntrip_atlas_find_services_by_location_fast(
         45.5, 90.5,  // Within the same level 1 tile as (45.0, 90.0)
         found_services, 5
@@ -578,7 +578,7 @@ bool test_performance_characteristics() {
     };
 
     for (size_t i = 0; i < sizeof(lookup_tests) / sizeof(lookup_tests[0]); i++) {
-        uint8_t found_services[10];
+        ntrip_service_idx_t found_services[10];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             lookup_tests[i].lat,
             lookup_tests[i].lon,
@@ -614,6 +614,70 @@ bool test_performance_characteristics() {
     return true;
 }
 
+// Test spatial index on caller-provided storage
+bool test_caller_provided_storage() {
+    printf("Testing caller-provided spatial index storage...\\n");
+
+    static uint32_t storage[(NTRIP_SPATIAL_INDEX_STORAGE_SIZE(4, 8) + 3) / 4];
+
+    // Storage smaller than the requested capacity is rejected
+    ntrip_atlas_error_t result = ntrip_atlas_init_spatial_index_with_storage(
+        storage, sizeof(storage), 8, 8);
+    if (result != NTRIP_ATLAS_ERROR_NO_MEMORY) {
+        printf("  ❌ Undersized storage not rejected (error %d)\\n", result);
+        return false;
+    }
+
+    result = ntrip_atlas_init_spatial_index_with_storage(storage, sizeof(storage), 4, 8);
+    if (result != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Failed to initialize on caller storage (error %d)\\n", result);
+        return false;
+    }
+
+    // Fill the assignment pool across two tiles, inserting the later key first
+    ntrip_tile_key_t tile_a = ntrip_atlas_encode_tile_key(2, 5, 5);
+    ntrip_tile_key_t tile_b = ntrip_atlas_encode_tile_key(2, 9, 9);
+    for (ntrip_service_idx_t i = 0; i < 4; i++) {
+        if (ntrip_atlas_add_service_to_tile(tile_b, (ntrip_service_idx_t)(20 + i)) != NTRIP_ATLAS_SUCCESS ||
+            ntrip_atlas_add_service_to_tile(tile_a, (ntrip_service_idx_t)(10 + i)) != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Failed to add service %d\\n", i);
+            return false;
+        }
+    }
+
+    result = ntrip_atlas_add_service_to_tile(tile_a, 99);
+    if (result != NTRIP_ATLAS_ERROR_SPATIAL_INDEX_FULL) {
+        printf("  ❌ Full assignment pool not reported (error %d)\\n", result);
+        return false;
+    }
+
+    // Lookups see each tile's own services after the pool was shifted
+    double lat_min, lat_max, lon_min, lon_max;
+    ntrip_atlas_tile_to_lat_lon_bounds(2, 5, 5, &lat_min, &lat_max, &lon_min, &lon_max);
+
+    ntrip_service_idx_t found[8];
+    size_t count = ntrip_atlas_find_services_by_location_fast(
+        (lat_min + lat_max) / 2.0, (lon_min + lon_max) / 2.0, found, 8);
+    if (count != 4 || found[0] != 10 || found[3] != 13) {
+        printf("  ❌ Expected services 10-13, got %zu services\\n", count);
+        return false;
+    }
+
+    ntrip_spatial_index_stats_t stats;
+    ntrip_atlas_get_spatial_index_stats(&stats);
+    if (stats.memory_used_bytes != sizeof(storage)) {
+        printf("  ❌ Expected %zu bytes reported, got %zu\\n",
+               sizeof(storage), stats.memory_used_bytes);
+        return false;
+    }
+
+    // Restore the built-in storage for the remaining tests
+    ntrip_atlas_init_spatial_index();
+
+    printf("  ✅ Caller-provided storage working correctly\\n");
+    return true;
+}
+
 int main() {
     printf("Spatial Indexing Tests\\n");
     printf("=====================\\n\\n");
@@ -630,6 +694,7 @@ int main() {
         {"Hierarchical fallback", test_hierarchical_fallback},
         {"Edge cases", test_edge_cases},
         {"Performance characteristics", test_performance_characteristics},
+        {"Caller-provided storage", test_caller_provided_storage},
     };
 
     int passed = 0;
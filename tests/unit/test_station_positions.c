@@ -0,0 +1,396 @@
+/**
+ * Station Position Unit Tests
+ *
+ * Decodes antenna reference points from RTCM 1005/1006 (the RTCM 10403
+ * example and synthetic 1006 frames split at every byte), converts ECEF
+ * to WGS84 geodetic coordinates at round-trip precision, and checks the
+ * per-mountpoint cache and that the sourcetable ranker scores distances
+ * from cached broadcast positions instead of rounded STR lat/lon.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+#include "../../libntripatlas/src/ntrip_stream_parser.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// RTCM 1005 example frame from RTCM 10403, CRC 0x360B98
+static const uint8_t g_frame_1005[] = {
+    0xD3, 0x00, 0x13, 0x3E, 0xD7, 0xD3, 0x02, 0x02, 0x98, 0x0E, 0xDE, 0xEF, 0x34,
+    0xB4, 0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98, 0x6F, 0x33, 0x36, 0x0B, 0x98
+};
+
+static void set_bits(uint8_t* data, size_t pos, unsigned len, uint64_t value) {
+    for (unsigned i = 0; i < len; i++, pos++) {
+        uint8_t bit = (uint8_t)((value >> (len - 1 - i)) & 1);
+        data[pos / 8] = (uint8_t)((data[pos / 8] & ~(0x80 >> (pos % 8))) | (bit << (7 - pos % 8)));
+    }
+}
+
+// WGS84 geodetic to ECEF, the forward direction of the code under test
+static void geodetic_to_ecef(double lat, double lon, double height, double ecef[3]) {
+    const double a = 6378137.0;
+    const double f = 1.0 / 298.257223563;
+    const double e2 = f * (2.0 - f);
+    double phi = lat * M_PI / 180.0;
+    double lambda = lon * M_PI / 180.0;
+    double n = a / sqrt(1.0 - e2 * sin(phi) * sin(phi));
+
+    ecef[0] = (n + height) * cos(phi) * cos(lambda);
+    ecef[1] = (n + height) * cos(phi) * sin(lambda);
+    ecef[2] = (n * (1.0 - e2) + height) * sin(phi);
+}
+
+// Complete 1006 frame for a position; returns the frame length
+static size_t build_1006(uint8_t* frame, uint16_t station_id, const double ecef[3], double antenna_height) {
+    uint8_t* payload = frame + 3;
+    memset(frame, 0, 3 + NTRIP_RTCM3_STATION_PAYLOAD + 3);
+    frame[0] = NTRIP_RTCM3_PREAMBLE;
+    frame[2] = NTRIP_RTCM3_STATION_PAYLOAD;
+
+    set_bits(payload, 0, 12, 1006);
+    set_bits(payload, 12, 12, station_id);
+    set_bits(payload, 30, 4, 0xF);                // GPS, GLONASS, Galileo, reference station
+    set_bits(payload, 34, 38, (uint64_t)llround(ecef[0] * 10000.0));
+    set_bits(payload, 74, 38, (uint64_t)llround(ecef[1] * 10000.0));
+    set_bits(payload, 114, 38, (uint64_t)llround(ecef[2] * 10000.0));
+    set_bits(payload, 152, 16, (uint64_t)llround(antenna_height * 10000.0));
+
+    size_t len = 3 + NTRIP_RTCM3_STATION_PAYLOAD;
+    uint32_t crc = ntrip_atlas_crc24q(0, frame, len);
+    frame[len] = (uint8_t)(crc >> 16);
+    frame[len + 1] = (uint8_t)(crc >> 8);
+    frame[len + 2] = (uint8_t)crc;
+    return len + 3;
+}
+
+// Test decoding 1005/1006 payloads
+bool test_decode_station() {
+    printf("Testing 1005/1006 decoding...\n");
+
+    ntrip_rtcm3_station_t station;
+    ntrip_atlas_error_t ret = ntrip_atlas_rtcm3_decode_station(g_frame_1005 + 3, 19, &station);
+    if (ret != NTRIP_ATLAS_SUCCESS || station.message_type != 1005 || station.station_id != 2003 ||
+        fabs(station.ecef_x - 1114104.5999) > 1e-6 || fabs(station.ecef_y + 4850729.7108) > 1e-6 ||
+        fabs(station.ecef_z - 3975521.4643) > 1e-6 || station.antenna_height != 0.0) {
+        printf("  ❌ Example 1005 decoded as %d: station %u, %.4f %.4f %.4f\n", ret,
+               (unsigned)station.station_id, station.ecef_x, station.ecef_y, station.ecef_z);
+        return false;
+    }
+
+    // Negative coordinates in all three axes, and the antenna height
+    double ecef[3];
+    geodetic_to_ecef(-33.8688, -151.2093, 58.0, ecef);
+    uint8_t frame[64];
+    build_1006(frame, 4095, ecef, 1.5432);
+    ret = ntrip_atlas_rtcm3_decode_station(frame + 3, NTRIP_RTCM3_STATION_PAYLOAD, &station);
+    if (ret != NTRIP_ATLAS_SUCCESS || station.message_type != 1006 || station.station_id != 4095 ||
+        fabs(station.ecef_x - ecef[0]) > 6e-5 || fabs(station.ecef_y - ecef[1]) > 6e-5 ||
+        fabs(station.ecef_z - ecef[2]) > 6e-5 || fabs(station.antenna_height - 1.5432) > 1e-9) {
+        printf("  ❌ 1006 decoded as %d: %.4f %.4f %.4f height %.4f\n", ret,
+               station.ecef_x, station.ecef_y, station.ecef_z, station.antenna_height);
+        return false;
+    }
+
+    // Truncated 1006, other messages and bad arguments
+    uint8_t msm[21] = { 0x43, 0x20 };  // 1074
+    if (ntrip_atlas_rtcm3_decode_station(frame + 3, 19, &station) != NTRIP_ATLAS_ERROR_INVALID_RESPONSE ||
+        ntrip_atlas_rtcm3_decode_station(msm, sizeof(msm), &station) != NTRIP_ATLAS_ERROR_INVALID_RESPONSE ||
+        ntrip_atlas_rtcm3_decode_station(msm, 1, &station) != NTRIP_ATLAS_ERROR_INVALID_RESPONSE ||
+        ntrip_atlas_rtcm3_decode_station(NULL, 19, &station) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_rtcm3_decode_station(msm, 19, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Invalid payloads accepted\n");
+        return false;
+    }
+
+    printf("  ✅ Example 1005, negative 1006 with height, invalid input rejected\n");
+    return true;
+}
+
+// Test the scanner picks up station messages split anywhere
+bool test_framer_station() {
+    printf("Testing station messages in split frames...\n");
+
+    double ecef[3];
+    geodetic_to_ecef(47.3769, 8.5417, 408.0, ecef);
+    uint8_t stream[128];
+    size_t len = 0;
+    memcpy(stream, g_frame_1005, sizeof(g_frame_1005));
+    len += sizeof(g_frame_1005);
+    len += build_1006(stream + len, 77, ecef, 0.25);
+
+    for (size_t split = 1; split < len; split++) {
+        ntrip_rtcm3_framer_t framer;
+        ntrip_atlas_rtcm3_init(&framer);
+
+        ntrip_atlas_rtcm3_feed(&framer, stream, split);
+        if (split >= sizeof(g_frame_1005) && split < len &&
+            (!framer.has_station || framer.station.station_id != 2003)) {
+            printf("  ❌ Split %zu: 1005 not decoded before the 1006\n", split);
+            return false;
+        }
+        ntrip_atlas_rtcm3_feed(&framer, stream + split, len - split);
+
+        if (framer.frames != 2 || !framer.has_station || framer.station.message_type != 1006 ||
+            framer.station.station_id != 77 || fabs(framer.station.ecef_x - ecef[0]) > 6e-5 ||
+            fabs(framer.station.ecef_z - ecef[2]) > 6e-5 ||
+            fabs(framer.station.antenna_height - 0.25) > 1e-9) {
+            printf("  ❌ Split %zu: %u frames, station %u type %u\n", split,
+                   (unsigned)framer.frames, (unsigned)framer.station.station_id,
+                   (unsigned)framer.station.message_type);
+            return false;
+        }
+    }
+
+    // A corrupted station frame must not replace the last good one
+    uint8_t bad[64];
+    size_t bad_len = build_1006(bad, 99, ecef, 0.0);
+    bad[10] ^= 0x01;
+    ntrip_rtcm3_framer_t framer;
+    ntrip_atlas_rtcm3_init(&framer);
+    ntrip_atlas_rtcm3_feed(&framer, g_frame_1005, sizeof(g_frame_1005));
+    for (size_t i = 0; i < bad_len; i++) {
+        ntrip_atlas_rtcm3_feed(&framer, bad + i, 1);
+    }
+    if (framer.crc_errors != 1 || framer.station.station_id != 2003) {
+        printf("  ❌ Corrupted 1006 used (station %u)\n", (unsigned)framer.station.station_id);
+        return false;
+    }
+
+    printf("  ✅ 1005 then 1006 decoded at every split, corrupted frame ignored\n");
+    return true;
+}
+
+// Test ECEF to geodetic conversion
+bool test_ecef_to_geodetic() {
+    printf("Testing ECEF to geodetic conversion...\n");
+
+    double lat, lon, height;
+    ntrip_atlas_ecef_to_geodetic(1114104.5999, -4850729.7108, 3975521.4643, &lat, &lon, &height);
+    if (fabs(lat - 38.8047594) > 1e-7 || fabs(lon + 77.0647736) > 1e-7 || fabs(height - 114.561) > 1e-3) {
+        printf("  ❌ Example station at %.8f, %.8f, %.4f m\n", lat, lon, height);
+        return false;
+    }
+
+    // Round trips from the poles to the equator, below and above the ellipsoid
+    double worst_deg = 0.0, worst_m = 0.0;
+    for (double test_lat = -90.0; test_lat <= 90.0; test_lat += 7.5) {
+        for (double test_lon = -180.0; test_lon < 180.0; test_lon += 22.5) {
+            for (double test_height = -400.0; test_height <= 9000.0; test_height += 4700.0) {
+                double ecef[3];
+                geodetic_to_ecef(test_lat, test_lon, test_height, ecef);
+                ntrip_atlas_ecef_to_geodetic(ecef[0], ecef[1], ecef[2], &lat, &lon, &height);
+
+                double lat_error = fabs(lat - test_lat);
+                double lon_error = fabs(test_lat) < 90.0 ? fabs(remainder(lon - test_lon, 360.0)) : 0.0;
+                if (lat_error > worst_deg) worst_deg = lat_error;
+                if (lon_error > worst_deg) worst_deg = lon_error;
+                if (fabs(height - test_height) > worst_m) worst_m = fabs(height - test_height);
+            }
+        }
+    }
+    if (worst_deg > 1e-9 || worst_m > 1e-4) {
+        printf("  ❌ Round trip off by %.2e degrees, %.2e m\n", worst_deg, worst_m);
+        return false;
+    }
+
+    // Height is optional
+    ntrip_atlas_ecef_to_geodetic(0.0, 0.0, 6356752.3142, &lat, &lon, NULL);
+    if (fabs(lat - 90.0) > 1e-9) {
+        printf("  ❌ North pole at latitude %.9f\n", lat);
+        return false;
+    }
+
+    printf("  ✅ Example station, round trips within %.1e degrees and %.1e m\n", worst_deg, worst_m);
+    return true;
+}
+
+// Test recording, lookup and eviction
+bool test_position_cache() {
+    printf("Testing station position cache...\n");
+    ntrip_atlas_station_positions_clear();
+
+    ntrip_rtcm3_station_t station;
+    ntrip_atlas_rtcm3_decode_station(g_frame_1005 + 3, 19, &station);
+
+    double lat = 0.0, lon = 0.0;
+    if (ntrip_atlas_station_position_lookup("caster.one", "USNO", &lat, &lon) ||
+        ntrip_atlas_station_position_record("caster.one", "USNO", &station) != NTRIP_ATLAS_SUCCESS ||
+        !ntrip_atlas_station_position_lookup("caster.one", "USNO", &lat, &lon) ||
+        fabs(lat - 38.8047594) > 1e-7 || fabs(lon + 77.0647736) > 1e-7) {
+        printf("  ❌ Recorded position not found (%.7f, %.7f)\n", lat, lon);
+        return false;
+    }
+
+    // Mountpoint names are only unique per caster
+    if (ntrip_atlas_station_position_lookup("caster.two", "USNO", NULL, NULL) ||
+        ntrip_atlas_station_position_lookup("caster.one", "USNO2", NULL, NULL)) {
+        printf("  ❌ Position served for another caster or mountpoint\n");
+        return false;
+    }
+
+    // Zeros and positions off the Earth are refused
+    ntrip_rtcm3_station_t zero;
+    memset(&zero, 0, sizeof(zero));
+    ntrip_rtcm3_station_t far = station;
+    far.ecef_z *= 3.0;
+    if (ntrip_atlas_station_position_record("caster.one", "ZERO", &zero) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_station_position_record("caster.one", "FAR", &far) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_station_position_record(NULL, "USNO", &station) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_station_position_record("caster.one", "", &station) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_station_position_lookup("caster.one", "ZERO", NULL, NULL)) {
+        printf("  ❌ Implausible position accepted\n");
+        return false;
+    }
+
+    // Filling the cache evicts the least recently used entry, not USNO
+    char name[16];
+    for (int i = 0; i < NTRIP_ATLAS_STATION_CACHE_ENTRIES; i++) {
+        snprintf(name, sizeof(name), "MP%02d", i);
+        ntrip_atlas_station_position_record("caster.one", name, &station);
+        ntrip_atlas_station_position_lookup("caster.one", "USNO", NULL, NULL);
+    }
+    if (!ntrip_atlas_station_position_lookup("caster.one", "USNO", NULL, NULL) ||
+        ntrip_atlas_station_position_lookup("caster.one", "MP00", NULL, NULL) ||
+        !ntrip_atlas_station_position_lookup("caster.one", name, NULL, NULL)) {
+        printf("  ❌ Eviction did not drop the least recently used entry\n");
+        return false;
+    }
+
+    ntrip_atlas_station_positions_clear();
+    if (ntrip_atlas_station_position_lookup("caster.one", "USNO", NULL, NULL)) {
+        printf("  ❌ Clear kept entries\n");
+        return false;
+    }
+
+    printf("  ✅ Per caster and mountpoint, junk refused, LRU eviction, clear\n");
+    return true;
+}
+
+static int rank(const ntrip_service_config_t* service, ntrip_mountpoint_t* best) {
+    static const char table[] =
+        "SOURCETABLE 200 OK\r\n\r\n"
+        "STR;NEAR;Near;RTCM 3.2;1005(10);2;GPS;NET;DEU;48.50;11.50;0;0;R;none;N;N;9600\r\n"
+        "STR;MID;Mid;RTCM 3.2;1005(10);2;GPS;NET;DEU;48.20;11.10;0;0;R;none;N;N;9600\r\n"
+        "STR;LOST;Lost;RTCM 3.2;1005(10);2;GPS;NET;DEU;0.00;0.00;0;0;R;none;N;N;9600\r\n"
+        "ENDSOURCETABLE\r\n";
+
+    ntrip_stream_parser_state_t state;
+    ntrip_stream_parser_init(&state, 48.0, 11.0, service, NULL);
+    ntrip_stream_parser_process_chunk(&state, table, strlen(table));
+    return ntrip_stream_parser_get_result(&state, best);
+}
+
+// Test the ranker scores from broadcast positions
+bool test_ranking_prefers_broadcast() {
+    printf("Testing ranking with broadcast positions...\n");
+    ntrip_atlas_station_positions_clear();
+
+    ntrip_service_config_t service;
+    memset(&service, 0, sizeof(service));
+    strcpy(service.provider, "Net");
+    strcpy(service.base_url, "caster.one");
+
+    // The sourcetable puts NEAR 67 km away, so MID at 23 km wins
+    ntrip_mountpoint_t best;
+    if (rank(&service, &best) != 0 || strcmp(best.mountpoint, "MID") != 0) {
+        printf("  ❌ Expected MID from sourcetable positions, got %s\n", best.mountpoint);
+        return false;
+    }
+
+    // NEAR's 1006 puts it 2.7 km away
+    double ecef[3];
+    uint8_t frame[64];
+    geodetic_to_ecef(48.02, 11.02, 520.0, ecef);
+    size_t len = build_1006(frame, 12, ecef, 0.0);
+    ntrip_rtcm3_framer_t framer;
+    ntrip_atlas_rtcm3_init(&framer);
+    ntrip_atlas_rtcm3_feed(&framer, frame, len);
+    if (!framer.has_station ||
+        ntrip_atlas_station_position_record("caster.two", "NEAR", &framer.station) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Could not record NEAR\n");
+        return false;
+    }
+
+    // Recorded for another caster: no change
+    if (rank(&service, &best) != 0 || strcmp(best.mountpoint, "MID") != 0) {
+        printf("  ❌ Another caster's position was used\n");
+        return false;
+    }
+
+    ntrip_atlas_station_position_record("caster.one", "NEAR", &framer.station);
+    if (rank(&service, &best) != 0 || strcmp(best.mountpoint, "NEAR") != 0 ||
+        fabs(best.latitude - 48.02) > 1e-6 || fabs(best.longitude - 11.02) > 1e-6 ||
+        best.distance_km > 3.0) {
+        printf("  ❌ Got %s at %.6f, %.6f, %.1f km\n", best.mountpoint,
+               best.latitude, best.longitude, best.distance_km);
+        return false;
+    }
+
+    // LOST has no STR position at all; a broadcast one brings it back
+    double near_km = best.distance_km;
+    ntrip_atlas_station_positions_clear();
+    geodetic_to_ecef(48.01, 11.01, 520.0, ecef);
+    build_1006(frame, 13, ecef, 0.0);
+    ntrip_atlas_rtcm3_init(&framer);
+    ntrip_atlas_rtcm3_feed(&framer, frame, len);
+    ntrip_atlas_station_position_record("caster.one", "LOST", &framer.station);
+    if (rank(&service, &best) != 0 || strcmp(best.mountpoint, "LOST") != 0 ||
+        fabs(best.latitude - 48.01) > 1e-6 || best.distance_km > 2.0) {
+        printf("  ❌ Line without STR position not ranked (got %s)\n", best.mountpoint);
+        return false;
+    }
+
+    printf("  ✅ NEAR wins at %.2f km, LOST at %.2f km once broadcast positions are cached\n",
+           near_km, best.distance_km);
+    ntrip_atlas_station_positions_clear();
+    return true;
+}
+
+int main() {
+    printf("Station Position Tests\n");
+    printf("======================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Decode 1005/1006", test_decode_station},
+        {"Station messages in split frames", test_framer_station},
+        {"ECEF to geodetic", test_ecef_to_geodetic},
+        {"Position cache", test_position_cache},
+        {"Ranking prefers broadcast positions", test_ranking_prefers_broadcast},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All station position tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some station position tests failed!\n");
+        return 1;
+    }
+}
@@ -0,0 +1,637 @@
+/**
+ * Sourcetable Streaming Parser Unit Tests
+ *
+ * Tests STR line parsing across arbitrary chunk boundaries and the fetch
+ * coalescer: shared tables must give the same answers as a private
+ * stream, concurrent callers must share one download, failures must reach
+ * every waiter, and full slot tables must fall back to fetching alone.
+ * Also covers NTRIP 2.0 server-side sourcetable filter requests.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+#include "../../libntripatlas/src/ntrip_stream_parser.h"
+
+#define TABLE_MOUNTPOINTS 200
+#define THREAD_COUNT 16
+
+static char g_sourcetable[TABLE_MOUNTPOINTS * 160 + 256];
+static size_t g_chunk_size = 7;
+static int g_stream_calls = 0;
+static int g_stream_status = 0;
+static uint32_t g_now_ms = 1000;
+
+// Fake-network hooks for the concurrency and re-entrancy tests
+static int g_waiting = 0;
+static int g_expected_waiters = 0;
+static ntrip_fetch_coalescer_t* g_reentrant_coalescer = NULL;
+static const ntrip_service_config_t* g_reentrant_service = NULL;
+static int g_reentrant_result = 1;
+
+// Sourcetable filter hooks: last requested path, and how the caster treats filters
+static char g_last_path[256];
+static bool g_caster_filters = false;
+static bool g_caster_rejects_filter = false;
+static size_t g_bytes_served = 0;
+static char g_filtered_table[sizeof(g_sourcetable)];
+
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_cond = PTHREAD_COND_INITIALIZER;
+
+static uint32_t rng_state = 68;
+
+static double random_unit(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return (rng_state >> 8) / 16777216.0;
+}
+
+// Sourcetable with mountpoints spread over Europe and mixed properties
+static void build_sourcetable(void) {
+    rng_state = 68;
+    size_t pos = (size_t)sprintf(g_sourcetable, "SOURCETABLE 200 OK\r\nServer: Test Caster\r\n\r\n"
+                                 "CAS;caster.test.com;2101;Test;Test;0;DEU;50.00;10.00;0.0.0.0;0;http://test\r\n");
+    const char* formats[] = { "RTCM 3.2", "RTCM 3.1", "RTCM 2.3", "RTCM3" };
+    const char* systems[] = { "GPS+GLO+GAL", "GPS", "GPS+GLO", "GLO" };
+    for (int i = 0; i < TABLE_MOUNTPOINTS; i++) {
+        double lat = 44.0 + random_unit() * 12.0;
+        double lon = 0.0 + random_unit() * 20.0;
+        pos += (size_t)sprintf(g_sourcetable + pos,
+                               "STR;MP%03d;Site %d;%s;%s;2;%s;NET;DEU;%.4f;%.4f;%d;0;Receiver;none;%s;%s;%d\r\n",
+                               i, i, formats[i % 4], (i % 3) ? "1004(1),1005(10)" : "1077(1),1087(1),MSM7", systems[(i / 4) % 4], lat, lon, i % 2,
+                               (i % 3) ? "B" : "N", (i % 5) ? "N" : "Y", 1200 + (i % 7) * 1000);
+    }
+    strcpy(g_sourcetable + pos, "ENDSOURCETABLE\r\n");
+}
+
+// Copy field index of a ';'-separated record, keeping empty fields
+static void field_at(const char* record, int index, char* out, size_t size) {
+    for (int i = 0; i < index && record; i++) {
+        record = strchr(record, ';');
+        if (record) record++;
+    }
+    size_t length = 0;
+    while (record && record[length] && record[length] != ';' && record[length] != '\r' && length < size - 1) {
+        out[length] = record[length];
+        length++;
+    }
+    out[length] = '\0';
+}
+
+// The subset of NTRIP 2.0 filter syntax the library emits: "*text*"
+// (percent-encoded), ">a&<b", ">n" and exact matches
+static bool field_matches(const char* value, const char* filter) {
+    if (filter[0] == '\0') return true;
+    if (filter[0] == '*') {
+        char text[64];
+        size_t length = 0;
+        for (const char* c = filter + 1; *c && *c != '*' && length < sizeof(text) - 1; c++) {
+            if (*c == '%') {
+                unsigned byte;
+                sscanf(c + 1, "%2x", &byte);
+                text[length++] = (char)byte;
+                c += 2;
+            } else {
+                text[length++] = *c;
+            }
+        }
+        text[length] = '\0';
+        return strstr(value, text) != NULL;
+    }
+    if (filter[0] == '>') {
+        double number = atof(value);
+        const char* upper = strstr(filter, "&<");
+        return number > atof(filter + 1) && (!upper || number < atof(upper + 2));
+    }
+    return strcmp(value, filter) == 0;
+}
+
+// Keep the STR lines matching a "/?STR;..." query
+static void filter_sourcetable(const char* query) {
+    size_t pos = 0;
+    for (const char* line = g_sourcetable; *line; ) {
+        const char* end = strstr(line, "\r\n");
+        end = end ? end + 2 : line + strlen(line);
+        bool keep = true;
+        if (strncmp(line, "STR;", 4) == 0) {
+            for (int field = 1; field < 18 && keep; field++) {
+                char value[128], filter[64];
+                field_at(line, field, value, sizeof(value));
+                field_at(query, field, filter, sizeof(filter));
+                keep = field_matches(value, filter);
+            }
+        }
+        if (keep) {
+            memcpy(g_filtered_table + pos, line, (size_t)(end - line));
+            pos += (size_t)(end - line);
+        }
+        line = end;
+    }
+    g_filtered_table[pos] = '\0';
+}
+
+// Fake http_stream delivering the sourcetable in small chunks
+static int fake_http_stream(const char* host, uint16_t port, uint8_t ssl, const char* path,
+                            ntrip_stream_callback_t on_data, void* user_context, uint32_t timeout_ms) {
+    (void)host; (void)port; (void)ssl; (void)path; (void)timeout_ms;
+
+    pthread_mutex_lock(&g_mutex);
+    g_stream_calls++;
+    // Hold the download open until every other caller is waiting on it
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 5;
+    while (g_waiting < g_expected_waiters) {
+        if (pthread_cond_timedwait(&g_cond, &g_mutex, &deadline) != 0) break;
+    }
+    pthread_mutex_unlock(&g_mutex);
+
+    if (g_reentrant_coalescer) {
+        ntrip_fetch_coalescer_t* coalescer = g_reentrant_coalescer;
+        g_reentrant_coalescer = NULL;
+        ntrip_mountpoint_t inner;
+        g_reentrant_result = ntrip_query_service_coalesced(coalescer, g_reentrant_service, 50.0, 10.0, NULL, &inner);
+    }
+
+    if (g_stream_status < 0) {
+        return g_stream_status;
+    }
+
+    snprintf(g_last_path, sizeof(g_last_path), "%s", path);
+    const char* table = g_sourcetable;
+    if (strncmp(path, "/?STR", 5) == 0) {
+        if (g_caster_rejects_filter) {
+            return NTRIP_ATLAS_ERROR_NOT_FOUND;
+        }
+        if (g_caster_filters) {
+            filter_sourcetable(path + 5);
+            table = g_filtered_table;
+        }
+    }
+
+    size_t length = strlen(table);
+    g_bytes_served += length;
+    for (size_t pos = 0; pos < length; pos += g_chunk_size) {
+        size_t chunk = length - pos < g_chunk_size ? length - pos : g_chunk_size;
+        if (on_data(table + pos, chunk, user_context) != 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+static uint32_t fake_get_time_ms(void) {
+    return g_now_ms;
+}
+
+static const ntrip_platform_t g_platform = {
+    .interface_version = 2,
+    .http_stream = fake_http_stream,
+    .get_time_ms = fake_get_time_ms
+};
+
+// Test hooks: the shared mutex plus a count of waiting callers
+static void test_lock(void* context) { (void)context; pthread_mutex_lock(&g_mutex); }
+static void test_unlock(void* context) { (void)context; pthread_mutex_unlock(&g_mutex); }
+static void test_broadcast(void* context) { (void)context; pthread_cond_broadcast(&g_cond); }
+static void test_wait(void* context) {
+    (void)context;
+    g_waiting++;
+    pthread_cond_broadcast(&g_cond);
+    pthread_cond_wait(&g_cond, &g_mutex);
+    g_waiting--;
+}
+
+static const ntrip_fetch_sync_t g_sync = {
+    .context = NULL,
+    .lock = test_lock,
+    .unlock = test_unlock,
+    .wait = test_wait,
+    .broadcast = test_broadcast
+};
+
+static ntrip_service_config_t make_service(const char* host) {
+    ntrip_service_config_t service;
+    memset(&service, 0, sizeof(service));
+    strncpy(service.provider, "Test", sizeof(service.provider) - 1);
+    strncpy(service.base_url, host, sizeof(service.base_url) - 1);
+    service.port = 2101;
+    service.quality_rating = 4;
+    return service;
+}
+
+static void reset_fake(void) {
+    g_chunk_size = 7;
+    g_stream_calls = 0;
+    g_stream_status = 0;
+    g_waiting = 0;
+    g_expected_waiters = 0;
+    g_reentrant_coalescer = NULL;
+    g_caster_filters = false;
+    g_caster_rejects_filter = false;
+    g_bytes_served = 0;
+}
+
+static bool same_result(const ntrip_mountpoint_t* a, const ntrip_mountpoint_t* b) {
+    return strcmp(a->mountpoint, b->mountpoint) == 0 &&
+           a->suitability_score == b->suitability_score &&
+           a->distance_km == b->distance_km;
+}
+
+// Test parsing is independent of chunk boundaries and honours criteria
+bool test_streaming_parse() {
+    printf("Testing streaming sourcetable parse...\n");
+    reset_fake();
+    ntrip_service_config_t service = make_service("caster.test.com");
+
+    ntrip_mountpoint_t whole, bytewise;
+    g_chunk_size = sizeof(g_sourcetable);
+    if (ntrip_query_service_streaming(&g_platform, &service, 50.0, 10.0, NULL, &whole) != 0) {
+        printf("  ❌ Query failed\n");
+        return false;
+    }
+    g_chunk_size = 1;
+    ntrip_query_service_streaming(&g_platform, &service, 50.0, 10.0, NULL, &bytewise);
+    if (!same_result(&whole, &bytewise)) {
+        printf("  ❌ %s vs %s depending on chunking\n", whole.mountpoint, bytewise.mountpoint);
+        return false;
+    }
+
+    ntrip_selection_criteria_t criteria = {0};
+    criteria.free_only = 1;
+    criteria.min_bitrate = 5000;
+    ntrip_mountpoint_t filtered;
+    if (ntrip_query_service_streaming(&g_platform, &service, 50.0, 10.0, &criteria, &filtered) != 0 ||
+        filtered.fee_required || filtered.bitrate < 5000) {
+        printf("  ❌ Criteria not applied\n");
+        return false;
+    }
+
+    printf("  ✅ Best %s (score %u, %.1f km)\n", whole.mountpoint, whole.suitability_score, whole.distance_km);
+    return true;
+}
+
+// Test shared tables answer exactly like private streams
+bool test_coalesced_matches_streaming() {
+    printf("Testing coalesced answers against private streams...\n");
+    reset_fake();
+    ntrip_service_config_t service = make_service("caster.test.com");
+
+    static ntrip_mountpoint_t storage[2 * TABLE_MOUNTPOINTS];
+    ntrip_fetch_coalescer_t coalescer;
+    ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, NULL, storage, 2, TABLE_MOUNTPOINTS, 60000);
+
+    ntrip_selection_criteria_t rtcm3 = {0};
+    strcpy(rtcm3.required_formats, "RTCM 3");
+    rtcm3.max_distance_km = 150.0;
+    const ntrip_selection_criteria_t* criteria[] = { NULL, &rtcm3 };
+
+    rng_state = 1068;
+    for (int i = 0; i < 500; i++) {
+        double lat = 43.0 + random_unit() * 14.0;
+        double lon = -1.0 + random_unit() * 22.0;
+        const ntrip_selection_criteria_t* c = criteria[i % 2];
+
+        ntrip_mountpoint_t shared, own;
+        int shared_ret = ntrip_query_service_coalesced(&coalescer, &service, lat, lon, c, &shared);
+        int own_ret = ntrip_query_service_streaming(&g_platform, &service, lat, lon, c, &own);
+        if (shared_ret != own_ret || (own_ret == 0 && !same_result(&shared, &own))) {
+            printf("  ❌ (%.3f, %.3f): shared %s, private %s\n", lat, lon,
+                   shared_ret == 0 ? shared.mountpoint : "-", own_ret == 0 ? own.mountpoint : "-");
+            return false;
+        }
+    }
+
+    if (coalescer.stats.fetches != 1 || coalescer.stats.reused != 499) {
+        printf("  ❌ Expected 1 fetch and 499 reuses, got %u and %u\n",
+               coalescer.stats.fetches, coalescer.stats.reused);
+        return false;
+    }
+
+    // Past the reuse window the table is downloaded again
+    g_now_ms += 60000;
+    ntrip_mountpoint_t result;
+    ntrip_query_service_coalesced(&coalescer, &service, 50.0, 10.0, NULL, &result);
+    if (coalescer.stats.fetches != 2) {
+        printf("  ❌ Stale table reused\n");
+        return false;
+    }
+
+    printf("  ✅ 500 shared answers identical, one download\n");
+    return true;
+}
+
+typedef struct {
+    ntrip_fetch_coalescer_t* coalescer;
+    const ntrip_service_config_t* service;
+    double lat, lon;
+    int ret;
+    ntrip_mountpoint_t result;
+} query_job_t;
+
+static void* run_query(void* arg) {
+    query_job_t* job = (query_job_t*)arg;
+    job->ret = ntrip_query_service_coalesced(job->coalescer, job->service, job->lat, job->lon, NULL, &job->result);
+    return NULL;
+}
+
+// Run THREAD_COUNT concurrent queries against one caster
+static bool run_concurrent(ntrip_fetch_coalescer_t* coalescer, const ntrip_service_config_t* service,
+                           query_job_t* jobs) {
+    pthread_t threads[THREAD_COUNT];
+    g_expected_waiters = THREAD_COUNT - 1;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        jobs[i].coalescer = coalescer;
+        jobs[i].service = service;
+        jobs[i].lat = 45.0 + i * 0.5;
+        jobs[i].lon = 2.0 + i;
+        if (pthread_create(&threads[i], NULL, run_query, &jobs[i]) != 0) {
+            return false;
+        }
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    g_expected_waiters = 0;
+    return true;
+}
+
+// Test concurrent callers share one download
+bool test_concurrent_single_flight() {
+    printf("Testing concurrent single-flight...\n");
+    reset_fake();
+    ntrip_service_config_t service = make_service("caster.test.com");
+
+    static ntrip_mountpoint_t storage[4 * TABLE_MOUNTPOINTS];
+    ntrip_fetch_coalescer_t coalescer;
+    ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, &g_sync, storage, 4, TABLE_MOUNTPOINTS, 0);
+
+    query_job_t jobs[THREAD_COUNT];
+    if (!run_concurrent(&coalescer, &service, jobs)) {
+        printf("  ❌ Could not start threads\n");
+        return false;
+    }
+
+    if (g_stream_calls != 1 || coalescer.stats.fetches != 1 || coalescer.stats.coalesced != THREAD_COUNT - 1) {
+        printf("  ❌ %d downloads, %u coalesced\n", g_stream_calls, coalescer.stats.coalesced);
+        return false;
+    }
+
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        ntrip_mountpoint_t own;
+        ntrip_query_service_streaming(&g_platform, &service, jobs[i].lat, jobs[i].lon, NULL, &own);
+        if (jobs[i].ret != 0 || !same_result(&jobs[i].result, &own)) {
+            printf("  ❌ Caller %d got %s, expected %s\n", i, jobs[i].result.mountpoint, own.mountpoint);
+            return false;
+        }
+    }
+
+    printf("  ✅ %d callers, 1 download\n", THREAD_COUNT);
+    return true;
+}
+
+// Test a failed download reaches every waiter and is not reused
+bool test_failure_shared() {
+    printf("Testing shared failures...\n");
+    reset_fake();
+    ntrip_service_config_t service = make_service("caster.test.com");
+
+    static ntrip_mountpoint_t storage[2 * TABLE_MOUNTPOINTS];
+    ntrip_fetch_coalescer_t coalescer;
+    ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, &g_sync, storage, 2, TABLE_MOUNTPOINTS, 60000);
+
+    g_stream_status = NTRIP_ATLAS_ERROR_TIMEOUT;
+    query_job_t jobs[THREAD_COUNT];
+    run_concurrent(&coalescer, &service, jobs);
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        if (jobs[i].ret != NTRIP_ATLAS_ERROR_TIMEOUT) {
+            printf("  ❌ Caller %d got %d instead of the timeout\n", i, jobs[i].ret);
+            return false;
+        }
+    }
+
+    g_stream_status = 0;
+    ntrip_mountpoint_t result;
+    if (ntrip_query_service_coalesced(&coalescer, &service, 50.0, 10.0, NULL, &result) != 0 ||
+        coalescer.stats.fetches != 2) {
+        printf("  ❌ Failed download should not be reused\n");
+        return false;
+    }
+
+    printf("  ✅ Timeout delivered to all %d callers, retried afterwards\n", THREAD_COUNT);
+    return true;
+}
+
+// Test full slot tables, truncation and bad input
+bool test_slots_and_limits() {
+    printf("Testing slot exhaustion and limits...\n");
+    reset_fake();
+    ntrip_service_config_t first = make_service("first.test.com");
+    ntrip_service_config_t second = make_service("second.test.com");
+
+    static ntrip_mountpoint_t storage[TABLE_MOUNTPOINTS];
+    ntrip_fetch_coalescer_t coalescer;
+    ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, NULL, storage, 1, TABLE_MOUNTPOINTS, 0);
+
+    // A second caster queried while the only slot is downloading fetches alone
+    g_reentrant_coalescer = &coalescer;
+    g_reentrant_service = &second;
+    ntrip_mountpoint_t result;
+    if (ntrip_query_service_coalesced(&coalescer, &first, 50.0, 10.0, NULL, &result) != 0 ||
+        g_reentrant_result != 0 || coalescer.stats.uncoalesced != 1 || g_stream_calls != 2) {
+        printf("  ❌ Busy slots should fall back to a private stream\n");
+        return false;
+    }
+
+    // A table too small for the sourcetable is flagged
+    ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, NULL, storage, 1, 10, 0);
+    ntrip_query_service_coalesced(&coalescer, &first, 50.0, 10.0, NULL, &result);
+    if (coalescer.stats.truncated != 1 || coalescer.flights[0].mountpoint_count != 10) {
+        printf("  ❌ Truncation not reported\n");
+        return false;
+    }
+
+    ntrip_fetch_sync_t partial = g_sync;
+    partial.wait = NULL;
+    if (ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, NULL, storage, 0, 10, 0) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, NULL, storage, NTRIP_ATLAS_MAX_COALESCED_FETCHES + 1, 1, 0) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_fetch_coalescer_init(&coalescer, &g_platform, &partial, storage, 1, 10, 0) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_query_service_coalesced(NULL, &first, 50.0, 10.0, NULL, &result) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Bad input accepted\n");
+        return false;
+    }
+
+    printf("  ✅ Fallback, truncation and validation correct\n");
+    return true;
+}
+
+// Test NTRIP 2.0 sourcetable filters shrink the download without changing the answer
+bool test_sourcetable_filter() {
+    printf("Testing server-side sourcetable filtering...\n");
+    reset_fake();
+    ntrip_service_config_t plain = make_service("caster.test.com");
+    ntrip_service_config_t filtering = plain;
+    filtering.sourcetable_filter = 1;
+
+    ntrip_selection_criteria_t criteria = {0};
+    strcpy(criteria.required_formats, "RTCM 3.2");
+    criteria.free_only = 1;
+    criteria.min_bitrate = 2400;
+    criteria.max_distance_km = 300.0;
+
+    // Only flagged casters with something to filter on get a query
+    char path[NTRIP_SOURCETABLE_PATH_SIZE];
+    ntrip_selection_criteria_t none = {0};
+    if (ntrip_stream_parser_build_path(path, sizeof(path), &plain, 50.0, 10.0, &criteria) != 1 ||
+        strcmp(path, "/") != 0 ||
+        ntrip_stream_parser_build_path(path, sizeof(path), &filtering, 50.0, 10.0, NULL) != 1 ||
+        ntrip_stream_parser_build_path(path, sizeof(path), &filtering, 50.0, 10.0, &none) != 1) {
+        printf("  ❌ Unfiltered queries should ask for /\n");
+        return false;
+    }
+
+    const char* expected = "/?STR;;;;;;;;;>47.24&<52.76;>5.44&<14.56;;;;;;N;>2399";
+    size_t length = ntrip_stream_parser_build_path(path, sizeof(path), &filtering, 50.0, 10.0, &criteria);
+    if (strcmp(path, expected) != 0 || length != strlen(expected)) {
+        printf("  ❌ Filter path %s\n", path);
+        return false;
+    }
+
+    // Formats stay client-side (they may match format details only), and a
+    // path that does not fit falls back to the whole table
+    ntrip_selection_criteria_t details = {0};
+    strcpy(details.required_formats, "1004");
+    ntrip_selection_criteria_t syntax = {0};
+    strcpy(syntax.required_formats, "RTCM;3");
+    syntax.free_only = 1;
+    if (ntrip_stream_parser_build_path(path, sizeof(path), &filtering, 50.0, 10.0, &details) != 1 ||
+        ntrip_stream_parser_build_path(path, sizeof(path), &filtering, 50.0, 10.0, &syntax) == 1 ||
+        strcmp(path, "/?STR;;;;;;;;;;;;;;;;N") != 0 ||
+        ntrip_stream_parser_build_path(path, 20, &filtering, 50.0, 10.0, &criteria) != 1) {
+        printf("  ❌ Format or overflow handling wrong (%s)\n", path);
+        return false;
+    }
+
+    // Same answer from the full table and from a filtering caster
+    ntrip_mountpoint_t full, filtered, retried;
+    g_chunk_size = 64;
+    if (ntrip_query_service_streaming(&g_platform, &plain, 50.0, 10.0, &criteria, &full) != 0) {
+        printf("  ❌ Full-table query failed\n");
+        return false;
+    }
+    size_t full_bytes = g_bytes_served;
+
+    g_bytes_served = 0;
+    g_caster_filters = true;
+    if (ntrip_query_service_streaming(&g_platform, &filtering, 50.0, 10.0, &criteria, &filtered) != 0 ||
+        !same_result(&full, &filtered) || strcmp(g_last_path, expected) != 0) {
+        printf("  ❌ Filtered query disagrees with the full table\n");
+        return false;
+    }
+    size_t filtered_bytes = g_bytes_served;
+    if (filtered_bytes * 4 > full_bytes) {
+        printf("  ❌ Filter saved too little: %zu of %zu bytes\n", filtered_bytes, full_bytes);
+        return false;
+    }
+
+    // A format found only in format details must survive the filter
+    ntrip_selection_criteria_t msm = criteria;
+    strcpy(msm.required_formats, "MSM");
+    ntrip_mountpoint_t msm_full, msm_filtered;
+    g_caster_filters = false;
+    if (ntrip_query_service_streaming(&g_platform, &plain, 50.0, 10.0, &msm, &msm_full) != 0 ||
+        strstr(msm_full.format_details, "MSM") == NULL || strstr(msm_full.format, "MSM") != NULL) {
+        printf("  ❌ Full table has no details-only MSM match\n");
+        return false;
+    }
+    g_caster_filters = true;
+    if (ntrip_query_service_streaming(&g_platform, &filtering, 50.0, 10.0, &msm, &msm_filtered) != 0 ||
+        !same_result(&msm_full, &msm_filtered)) {
+        printf("  ❌ Filter dropped %s, which matches MSM in its format details\n", msm_full.mountpoint);
+        return false;
+    }
+
+    // A filtering caster with no match has answered; no second download
+    ntrip_mountpoint_t nothing;
+    g_stream_calls = 0;
+    if (ntrip_query_service_streaming(&g_platform, &filtering, -30.0, 150.0, &criteria, &nothing) == 0 ||
+        g_stream_calls != 1) {
+        printf("  ❌ Empty filtered table was retried\n");
+        return false;
+    }
+
+    // A caster rejecting the filter is asked for the whole table
+    g_caster_filters = false;
+    g_caster_rejects_filter = true;
+    g_stream_calls = 0;
+    if (ntrip_query_service_streaming(&g_platform, &filtering, 50.0, 10.0, &criteria, &retried) != 0 ||
+        !same_result(&full, &retried) || g_stream_calls != 2 || strcmp(g_last_path, "/") != 0) {
+        printf("  ❌ Rejected filter not retried without it\n");
+        return false;
+    }
+
+    // The compact record carries the capability
+    ntrip_service_compact_t compact;
+    ntrip_service_config_t expanded;
+    if (ntrip_atlas_compress_service(&filtering, &compact) != NTRIP_ATLAS_SUCCESS ||
+        !(compact.flags & NTRIP_FLAG_SOURCETABLE_FILTER) ||
+        ntrip_atlas_expand_service(&compact, &expanded) != NTRIP_ATLAS_SUCCESS ||
+        !expanded.sourcetable_filter) {
+        printf("  ❌ Capability flag lost in the compact record\n");
+        return false;
+    }
+
+    printf("  ✅ %zu of %zu bytes with the filter, same best %s\n", filtered_bytes, full_bytes, full.mountpoint);
+    return true;
+}
+
+int main() {
+    printf("Stream Parser Tests\n");
+    printf("===================\n\n");
+
+    build_sourcetable();
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Streaming parse", test_streaming_parse},
+        {"Coalesced matches streaming", test_coalesced_matches_streaming},
+        {"Concurrent single-flight", test_concurrent_single_flight},
+        {"Shared failures", test_failure_shared},
+        {"Slots and limits", test_slots_and_limits},
+        {"Sourcetable filter", test_sourcetable_filter},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All stream parser tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some stream parser tests failed!\n");
+        return 1;
+    }
+}
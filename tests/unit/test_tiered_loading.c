@@ -0,0 +1,1091 @@
+/**
+ * Tiered Loading Unit Tests
+ *
+ * Tests discovery over the Tier 1 index: the spatial grid built at load
+ * time must select exactly what a full linear scan would, including
+ * coverage circles that cross the antimeridian or reach a pole, and so
+ * must the scan over a packed discovery index. Also tests cooperative
+ * prefetch of Tier 2 endpoints for fallbacks and nearby services, route
+ * handover plans checked against point-by-point discovery, and the byte-budgeted CLOCK caches behind Tier 2 and Tier 3 loads,
+ * including zero-copy borrows that pin records against eviction, and
+ * service indices wider than 8 bits.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MAX_TEST_SERVICES 200
+
+static ntrip_service_index_t test_index[MAX_TEST_SERVICES];
+static size_t test_index_count = 0;
+static int endpoint_loads = 0;
+
+// Mock platform: hand out the static test index
+static ntrip_atlas_error_t mock_load_discovery_index(
+    ntrip_service_index_t** index,
+    size_t* count,
+    void* platform_data
+) {
+    (void)platform_data;
+    *index = test_index;
+    *count = test_index_count;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+// Mock platform: hostname encodes the service index
+static ntrip_atlas_error_t mock_load_service_endpoints(
+    ntrip_service_idx_t service_index,
+    ntrip_service_endpoints_t* endpoints,
+    void* platform_data
+) {
+    (void)platform_data;
+    endpoint_loads++;
+    memset(endpoints, 0, sizeof(*endpoints));
+    snprintf(endpoints->hostname, sizeof(endpoints->hostname), "svc-%u.test", service_index);
+    endpoints->port = 2101;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+// Mock platform: provider name encodes the service index
+static ntrip_atlas_error_t mock_load_service_metadata(
+    ntrip_service_idx_t service_index,
+    ntrip_service_metadata_t* metadata,
+    void* platform_data
+) {
+    (void)platform_data;
+    memset(metadata, 0, sizeof(*metadata));
+    snprintf(metadata->provider_full, sizeof(metadata->provider_full), "Provider %u", service_index);
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+static ntrip_atlas_error_t init_tiered_with_budget(size_t endpoint_bytes, size_t metadata_bytes) {
+    ntrip_tiered_platform_t platform = {0};
+    platform.load_discovery_index = mock_load_discovery_index;
+    platform.load_service_endpoints = mock_load_service_endpoints;
+    platform.load_service_metadata = mock_load_service_metadata;
+    platform.endpoint_cache_bytes = endpoint_bytes;
+    platform.metadata_cache_bytes = metadata_bytes;
+    return ntrip_atlas_init_with_loading_mode(NTRIP_LOADING_TIERED, &platform);
+}
+
+static ntrip_atlas_error_t init_tiered(void) {
+    return init_tiered_with_budget(0, 0);
+}
+
+// Bytes one cached endpoint costs against the budget
+#define ENDPOINT_ENTRY_BYTES (sizeof(ntrip_service_endpoints_t) + sizeof(ntrip_service_idx_t) + 1)
+
+static void add_service(ntrip_service_idx_t service_index, double lat, double lon, uint8_t radius_km,
+                        uint8_t quality, uint8_t network_type) {
+    ntrip_service_index_t* service = &test_index[test_index_count++];
+    memset(service, 0, sizeof(*service));
+    service->service_index = service_index;
+    service->lat_center_deg100 = (int16_t)round(lat * 100);
+    service->lon_center_deg100 = (int16_t)round(lon * 100);
+    service->radius_km = radius_km;
+    service->quality_rating = quality;
+    service->network_type = network_type;
+    service->auth_method = NTRIP_AUTH_BASIC;
+}
+
+// Deterministic pseudo-random numbers for reproducible layouts
+static uint32_t rng_state = 12345;
+static double random_unit(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return (double)((rng_state >> 8) & 0xFFFFFF) / (double)0xFFFFFF;
+}
+
+// Reference haversine distance (km)
+static double reference_distance(double lat1, double lon1, double lat2, double lon2) {
+    double p1 = lat1 * M_PI / 180.0, p2 = lat2 * M_PI / 180.0;
+    double dlat = p2 - p1, dlon = (lon2 - lon1) * M_PI / 180.0;
+    double a = sin(dlat / 2) * sin(dlat / 2) + cos(p1) * cos(p2) * sin(dlon / 2) * sin(dlon / 2);
+    return 6371.0 * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
+// Linear scan oracle: index of the best covering service, or -1
+static int reference_best(double lat, double lon) {
+    int best = -1;
+    double best_score = 0.0, best_distance = 99999.0;
+
+    for (size_t i = 0; i < test_index_count; i++) {
+        const ntrip_service_index_t* s = &test_index[i];
+        double d = reference_distance(lat, lon, s->lat_center_deg100 / 100.0,
+                                      s->lon_center_deg100 / 100.0);
+        if (d > s->radius_km) {
+            continue;
+        }
+
+        double network = s->network_type == NTRIP_NETWORK_COMMERCIAL ? 0.8 :
+                         s->network_type == NTRIP_NETWORK_COMMUNITY ? 0.6 : 1.0;
+        double auth = s->auth_method == NTRIP_AUTH_NONE ? 1.0 : 0.9;
+        double score = (s->radius_km > 0 ? 1.0 - d / s->radius_km : 1.0) * 0.4 +
+                       s->quality_rating / 5.0 * 0.3 + network * 0.2 + auth * 0.1;
+
+        if (score > best_score || (score == best_score && d < best_distance)) {
+            best = (int)s->service_index;
+            best_score = score;
+            best_distance = d;
+        }
+    }
+    return best;
+}
+
+// Index of the service selected by tiered discovery, or -1
+static int tiered_best(double lat, double lon) {
+    ntrip_best_service_t result;
+    if (ntrip_atlas_find_best_tiered(&result, lat, lon) != NTRIP_ATLAS_SUCCESS) {
+        return -1;
+    }
+    unsigned index = 0;
+    if (sscanf(result.server, "svc-%u.test", &index) != 1) {
+        return -2;
+    }
+    return (int)index;
+}
+
+// Test grid discovery matches a full linear scan
+bool test_matches_linear_scan() {
+    printf("Testing grid discovery matches linear scan...\n");
+
+    test_index_count = 0;
+    rng_state = 12345;
+    for (int i = 0; i < MAX_TEST_SERVICES; i++) {
+        add_service((uint8_t)i,
+                    -85.0 + random_unit() * 170.0,
+                    -180.0 + random_unit() * 360.0,
+                    (uint8_t)(20 + random_unit() * 235),
+                    (uint8_t)(1 + random_unit() * 4.99),
+                    (uint8_t)(random_unit() * 2.99));
+    }
+
+    if (init_tiered() != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Tiered initialization failed\n");
+        return false;
+    }
+
+    // Query near each service (so most queries hit coverage) and at random points
+    int covered = 0;
+    for (int q = 0; q < 4000; q++) {
+        double lat, lon;
+        if (q % 2 == 0) {
+            const ntrip_service_index_t* s = &test_index[(q / 2) % test_index_count];
+            lat = s->lat_center_deg100 / 100.0 + (random_unit() - 0.5) * 5.0;
+            lon = s->lon_center_deg100 / 100.0 + (random_unit() - 0.5) * 5.0;
+            if (lat > 90.0) lat = 90.0;
+            if (lat < -90.0) lat = -90.0;
+            if (lon > 180.0) lon -= 360.0;
+            if (lon < -180.0) lon += 360.0;
+        } else {
+            lat = -90.0 + random_unit() * 180.0;
+            lon = -180.0 + random_unit() * 360.0;
+        }
+
+        int expected = reference_best(lat, lon);
+        int actual = tiered_best(lat, lon);
+        if (expected != actual) {
+            printf("  ❌ (%.3f, %.3f): expected service %d, got %d\n", lat, lon, expected, actual);
+            return false;
+        }
+        if (expected >= 0) {
+            covered++;
+        }
+    }
+
+    printf("  ✅ 4000 queries match linear scan (%d covered)\n", covered);
+    return true;
+}
+
+// Test scanning a packed index selects what a linear scan would
+bool test_packed_index_scan() {
+    printf("Testing packed index scan matches linear scan...\n");
+
+    test_index_count = 0;
+    rng_state = 777;
+    for (int i = 0; i < MAX_TEST_SERVICES; i++) {
+        add_service((uint8_t)i,
+                    -85.0 + random_unit() * 170.0,
+                    -180.0 + random_unit() * 360.0,
+                    (uint8_t)(20 + random_unit() * 235),
+                    (uint8_t)(1 + random_unit() * 4.99),
+                    (uint8_t)(random_unit() * 2.99));
+    }
+
+    static uint8_t packed[MAX_TEST_SERVICES * 16];
+    size_t packed_size = 0;
+    if (ntrip_atlas_pack_discovery_index(test_index, test_index_count, packed, sizeof(packed),
+                                         &packed_size) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Packing failed\n");
+        return false;
+    }
+
+    int covered = 0;
+    for (int q = 0; q < 2000; q++) {
+        double lat, lon;
+        if (q % 2 == 0) {
+            const ntrip_service_index_t* s = &test_index[(q / 2) % test_index_count];
+            lat = fmax(-90.0, fmin(90.0, s->lat_center_deg100 / 100.0 + (random_unit() - 0.5) * 5.0));
+            lon = s->lon_center_deg100 / 100.0 + (random_unit() - 0.5) * 2.0;
+            if (lon > 180.0) lon -= 360.0;
+            if (lon < -180.0) lon += 360.0;
+        } else {
+            lat = -90.0 + random_unit() * 180.0;
+            lon = -180.0 + random_unit() * 360.0;
+        }
+
+        ntrip_service_index_t best;
+        ntrip_atlas_error_t result = ntrip_atlas_find_best_packed(packed, packed_size, lat, lon, &best, NULL);
+        int actual = (result == NTRIP_ATLAS_SUCCESS) ? (int)best.service_index :
+                     (result == NTRIP_ATLAS_ERROR_NO_SERVICES) ? -1 : -2;
+        int expected = reference_best(lat, lon);
+        if (expected != actual) {
+            printf("  ❌ (%.3f, %.3f): expected service %d, got %d\n", lat, lon, expected, actual);
+            return false;
+        }
+        if (expected >= 0) {
+            covered++;
+        }
+    }
+
+    if (ntrip_atlas_find_best_packed(packed, 3, 0.0, 0.0, NULL, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Should reject NULL output\n");
+        return false;
+    }
+
+    printf("  ✅ 2000 queries match linear scan (%d covered, %.1f bytes/service)\n",
+           covered, (double)packed_size / test_index_count);
+    return true;
+}
+
+// Test circles crossing the antimeridian and reaching the poles
+bool test_wraparound_coverage() {
+    printf("Testing antimeridian and polar coverage...\n");
+
+    test_index_count = 0;
+    add_service(1, 0.0, 179.5, 200, 5, NTRIP_NETWORK_GOVERNMENT);     // Crosses ±180°
+    add_service(2, 89.0, 10.0, 250, 5, NTRIP_NETWORK_GOVERNMENT);     // Reaches north pole
+    add_service(3, -60.0, -179.9, 150, 5, NTRIP_NETWORK_GOVERNMENT);  // On the antimeridian
+
+    if (init_tiered() != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Tiered initialization failed\n");
+        return false;
+    }
+
+    struct {
+        double lat, lon;
+        int expected;
+        const char* description;
+    } cases[] = {
+        {0.0, -179.5, 1, "West of antimeridian"},
+        {0.0, 180.0, 1, "On antimeridian (+180)"},
+        {0.0, -180.0, 1, "On antimeridian (-180)"},
+        {89.5, -170.0, 2, "Across the pole"},
+        {90.0, 0.0, 2, "At the pole"},
+        {-60.0, 179.5, 3, "East side of dateline service"},
+        {0.0, 170.0, -1, "Outside all coverage"},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int actual = tiered_best(cases[i].lat, cases[i].lon);
+        if (actual != cases[i].expected) {
+            printf("  ❌ %s: expected service %d, got %d\n",
+                   cases[i].description, cases[i].expected, actual);
+            return false;
+        }
+    }
+
+    printf("  ✅ Wraparound coverage found correctly\n");
+    return true;
+}
+
+// Test index-to-slot lookups for Tier 2 loading
+bool test_service_index_lookup() {
+    printf("Testing service index lookup...\n");
+
+    test_index_count = 0;
+    add_service(7, 40.0, -74.0, 100, 4, NTRIP_NETWORK_GOVERNMENT);
+    add_service(42, 52.0, 13.0, 100, 4, NTRIP_NETWORK_GOVERNMENT);
+    init_tiered();
+
+    ntrip_service_endpoints_t endpoints;
+    if (ntrip_atlas_load_service_endpoints(42, &endpoints) != NTRIP_ATLAS_SUCCESS ||
+        strcmp(endpoints.hostname, "svc-42.test") != 0) {
+        printf("  ❌ Failed to load endpoints for indexed service\n");
+        return false;
+    }
+
+    endpoint_loads = 0;
+    if (ntrip_atlas_load_service_endpoints(8, &endpoints) != NTRIP_ATLAS_ERROR_NOT_FOUND) {
+        printf("  ❌ Should reject service index missing from discovery index\n");
+        return false;
+    }
+    if (endpoint_loads != 0) {
+        printf("  ❌ Unknown service index should not reach the platform loader\n");
+        return false;
+    }
+
+    printf("  ✅ Service index lookup correct\n");
+    return true;
+}
+
+// Test discovery queues runners-up and prefetch serves failover from cache
+bool test_prefetch_fallbacks() {
+    printf("Testing fallback prefetch...\n");
+
+    test_index_count = 0;
+    add_service(10, 40.0, -74.0, 200, 5, NTRIP_NETWORK_GOVERNMENT);
+    add_service(11, 40.1, -74.0, 200, 4, NTRIP_NETWORK_GOVERNMENT);
+    add_service(12, 40.2, -74.0, 200, 3, NTRIP_NETWORK_COMMERCIAL);
+    add_service(13, 40.3, -74.0, 200, 2, NTRIP_NETWORK_COMMUNITY);
+    add_service(14, 52.0, 13.0, 200, 5, NTRIP_NETWORK_GOVERNMENT);  // Elsewhere
+    init_tiered();
+
+    endpoint_loads = 0;
+    if (tiered_best(40.0, -74.0) != 10 || endpoint_loads != 1) {
+        printf("  ❌ Discovery should load only the selected service\n");
+        return false;
+    }
+
+    if (ntrip_atlas_prefetch_pending() != 3) {
+        printf("  ❌ Expected 3 fallbacks queued, got %zu\n", ntrip_atlas_prefetch_pending());
+        return false;
+    }
+
+    if (ntrip_atlas_prefetch_step(2) != 2 || ntrip_atlas_prefetch_step(10) != 1 ||
+        ntrip_atlas_prefetch_pending() != 0) {
+        printf("  ❌ Prefetch step should honour max_loads and drain the queue\n");
+        return false;
+    }
+
+    // Failover to each fallback must not touch the platform loader
+    endpoint_loads = 0;
+    ntrip_service_endpoints_t endpoints;
+    for (ntrip_service_idx_t index = 10; index <= 13; index++) {
+        if (ntrip_atlas_load_service_endpoints(index, &endpoints) != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Failed to load endpoints for service %u\n", index);
+            return false;
+        }
+    }
+    if (endpoint_loads != 0) {
+        printf("  ❌ Failover performed %d blocking loads\n", endpoint_loads);
+        return false;
+    }
+
+    // Hints for cached, queued or unknown services are ignored
+    ntrip_service_idx_t hints[] = {10, 14, 14, 99};
+    if (ntrip_atlas_prefetch_endpoints(hints, 4) != 1) {
+        printf("  ❌ Only service 14 should be newly queued\n");
+        return false;
+    }
+
+    printf("  ✅ Fallbacks prefetched, failover served from cache\n");
+    return true;
+}
+
+// Test prefetch of services in neighbouring cells for a moving rover
+bool test_prefetch_nearby() {
+    printf("Testing nearby prefetch across cell edges...\n");
+
+    // Row of services along 45°N; a grid cell edge lies at 11.25°E
+    test_index_count = 0;
+    for (int i = 0; i <= 10; i++) {
+        add_service((uint8_t)(20 + i), 45.0, i * 3.0, 50, 4, NTRIP_NETWORK_GOVERNMENT);
+    }
+    init_tiered();
+
+    // At 45°N, 11°E: 12°E is ~28km from the coverage edge, 9°E ~107km, the rest >250km
+    if (ntrip_atlas_prefetch_nearby(45.0, 11.0, 200.0) != 2) {
+        printf("  ❌ Expected 2 services queued, got %zu\n", ntrip_atlas_prefetch_pending());
+        return false;
+    }
+
+    ntrip_atlas_prefetch_step(10);
+
+    endpoint_loads = 0;
+    ntrip_service_endpoints_t endpoints;
+    ntrip_atlas_load_service_endpoints(23, &endpoints);   // 9°E
+    ntrip_atlas_load_service_endpoints(24, &endpoints);   // 12°E (neighbouring cell)
+    if (endpoint_loads != 0) {
+        printf("  ❌ Nearby services were not prefetched\n");
+        return false;
+    }
+
+    if (ntrip_atlas_prefetch_nearby(45.0, 11.0, -1.0) != 0 ||
+        ntrip_atlas_prefetch_nearby(95.0, 11.0, 100.0) != 0) {
+        printf("  ❌ Should reject invalid position or radius\n");
+        return false;
+    }
+
+    printf("  ✅ Neighbouring services prefetched\n");
+    return true;
+}
+
+// Point a fraction of the way along a great-circle segment
+static void route_position(const ntrip_route_point_t* a, const ntrip_route_point_t* b, double f,
+                           double* lat, double* lon) {
+    double p1 = a->latitude * M_PI / 180.0, l1 = a->longitude * M_PI / 180.0;
+    double p2 = b->latitude * M_PI / 180.0, l2 = b->longitude * M_PI / 180.0;
+    double ax = cos(p1) * cos(l1), ay = cos(p1) * sin(l1), az = sin(p1);
+    double bx = cos(p2) * cos(l2), by = cos(p2) * sin(l2), bz = sin(p2);
+    double theta = acos(fmin(1.0, ax * bx + ay * by + az * bz));
+    double wa = theta > 0 ? sin((1 - f) * theta) / sin(theta) : 1.0 - f;
+    double wb = theta > 0 ? sin(f * theta) / sin(theta) : f;
+    double x = wa * ax + wb * bx, y = wa * ay + wb * by, z = wa * az + wb * bz;
+    *lat = atan2(z, sqrt(x * x + y * y)) * 180.0 / M_PI;
+    *lon = atan2(y, x) * 180.0 / M_PI;
+}
+
+// Walk a route densely and check every point against the plan
+static bool check_route_plan(const ntrip_route_point_t* points, size_t point_count,
+                             const ntrip_route_plan_t* plan) {
+    double route_km = 0.0;
+    int checked = 0;
+
+    for (size_t s = 0; s + 1 < point_count; s++) {
+        double segment_km = reference_distance(points[s].latitude, points[s].longitude,
+                                               points[s + 1].latitude, points[s + 1].longitude);
+        for (double km = 0.0; km < segment_km; km += 0.25) {
+            double lat, lon;
+            route_position(&points[s], &points[s + 1], km / segment_km, &lat, &lon);
+            double along = route_km + km;
+
+            // Leg in force here; skip points right at a handover
+            size_t leg = 0;
+            bool near_handover = false;
+            for (size_t i = 0; i < plan->leg_count; i++) {
+                if (fabs(plan->legs[i].start_km - along) < 0.01 && i > 0) near_handover = true;
+                if (plan->legs[i].start_km <= along) leg = i;
+            }
+            if (near_handover) {
+                continue;
+            }
+
+            int expected = reference_best(lat, lon);
+            int planned = plan->legs[leg].covered ? (int)plan->legs[leg].service_index : -1;
+            if (expected != planned) {
+                printf("  ❌ At %.2f km (%.4f, %.4f): plan says %d, discovery says %d\n",
+                       along, lat, lon, planned, expected);
+                return false;
+            }
+            checked++;
+        }
+        route_km += segment_km;
+    }
+
+    if (fabs(route_km - plan->total_km) > 0.01) {
+        printf("  ❌ Route length %.3f km, plan says %.3f km\n", route_km, plan->total_km);
+        return false;
+    }
+
+    printf("  %zu legs over %.1f km, %d points verified\n", plan->leg_count, plan->total_km, checked);
+    return true;
+}
+
+// Test a route plan agrees with point discovery everywhere along the route
+bool test_route_planning() {
+    printf("Testing route handover planning...\n");
+
+    // Overlapping casters along 45°N plus one stronger one straddling the route
+    test_index_count = 0;
+    for (int i = 0; i <= 10; i++) {
+        add_service((uint8_t)(40 + i), 45.0, i * 3.0, 150, 3, NTRIP_NETWORK_COMMERCIAL);
+    }
+    add_service(60, 45.8, 14.0, 90, 5, NTRIP_NETWORK_GOVERNMENT);
+    init_tiered();
+
+    ntrip_route_point_t route[] = { {45.0, -2.0}, {45.3, 12.0}, {44.6, 20.0}, {45.0, 33.0} };
+    ntrip_route_leg_t legs[32];
+    ntrip_route_plan_t plan = { .legs = legs, .max_legs = 32 };
+
+    if (ntrip_atlas_plan_route(route, 4, &plan) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Planning failed\n");
+        return false;
+    }
+    if (!check_route_plan(route, 4, &plan)) {
+        return false;
+    }
+    if (legs[0].covered || !legs[1].covered || legs[plan.leg_count - 1].covered) {
+        printf("  ❌ Expected coverage gaps at both ends of the route\n");
+        return false;
+    }
+
+    // Scattered casters and a zigzag route
+    test_index_count = 0;
+    rng_state = 2024;
+    for (int i = 0; i < 60; i++) {
+        add_service((uint8_t)i, 40.0 + random_unit() * 15.0, -5.0 + random_unit() * 30.0,
+                    (uint8_t)(40 + random_unit() * 200), (uint8_t)(1 + random_unit() * 5),
+                    (uint8_t)(random_unit() * 3));
+    }
+    init_tiered();
+
+    ntrip_route_point_t zigzag[] = { {41.0, -4.0}, {53.0, 2.0}, {42.5, 9.0}, {54.0, 16.0}, {47.0, 24.0} };
+    ntrip_route_leg_t many_legs[128];
+    ntrip_route_plan_t zigzag_plan = { .legs = many_legs, .max_legs = 128 };
+    if (ntrip_atlas_plan_route(zigzag, 5, &zigzag_plan) != NTRIP_ATLAS_SUCCESS ||
+        !check_route_plan(zigzag, 5, &zigzag_plan)) {
+        printf("  ❌ Zigzag route plan disagrees with discovery\n");
+        return false;
+    }
+
+    printf("  ✅ Handover points match point-by-point discovery\n");
+    return true;
+}
+
+// Test routes through more overlapping casters than a piece holds
+bool test_route_dense_coverage() {
+    printf("Testing route planning through dense coverage...\n");
+
+    // Two clusters of 20 small circles, close enough to share a 50 km piece
+    test_index_count = 0;
+    rng_state = 77;
+    for (int i = 0; i < 40; i++) {
+        double lon = (i < 20 ? 1.0 : 1.5) + (random_unit() - 0.5) * 0.1;
+        add_service((ntrip_service_idx_t)i, 45.0 + (random_unit() - 0.5) * 0.1, lon, 20,
+                    (uint8_t)(1 + random_unit() * 5), (uint8_t)(random_unit() * 3));
+    }
+    init_tiered();
+
+    ntrip_route_point_t route[] = { {45.0, 0.5}, {45.0, 2.0} };
+    ntrip_route_leg_t legs[64];
+    ntrip_route_plan_t plan = { .legs = legs, .max_legs = 64 };
+    if (ntrip_atlas_plan_route(route, 2, &plan) != NTRIP_ATLAS_SUCCESS ||
+        !check_route_plan(route, 2, &plan)) {
+        printf("  ❌ Split pieces disagree with discovery\n");
+        return false;
+    }
+
+    // 48 circles all covering the whole route
+    test_index_count = 0;
+    for (int i = 0; i < 48; i++) {
+        add_service((ntrip_service_idx_t)i, 45.0 + (i % 7) * 0.05, 1.0 + (i % 11) * 0.1, 200,
+                    (uint8_t)(1 + i % 5), (uint8_t)(i % 3));
+    }
+    init_tiered();
+
+    ntrip_route_point_t dense[] = { {45.0, 0.0}, {45.2, 3.0} };
+    if (ntrip_atlas_plan_route(dense, 2, &plan) != NTRIP_ATLAS_SUCCESS ||
+        !check_route_plan(dense, 2, &plan)) {
+        printf("  ❌ Route through 48 overlapping casters failed\n");
+        return false;
+    }
+
+    printf("  ✅ Plans stay complete past 32 candidates per piece\n");
+    return true;
+}
+
+// Test route plans prefetch endpoints and report overflow and bad input
+bool test_route_prefetch_and_limits() {
+    printf("Testing route prefetch and limits...\n");
+
+    test_index_count = 0;
+    for (int i = 0; i <= 10; i++) {
+        add_service((uint8_t)(40 + i), 45.0, i * 3.0, 150, 3, NTRIP_NETWORK_COMMERCIAL);
+    }
+    init_tiered();
+
+    ntrip_route_point_t route[] = { {45.0, 1.0}, {45.0, 8.0} };
+    ntrip_route_leg_t legs[8];
+    ntrip_route_plan_t plan = { .legs = legs, .max_legs = 8 };
+    if (ntrip_atlas_plan_route(route, 2, &plan) != NTRIP_ATLAS_SUCCESS ||
+        plan.leg_count != 4 || plan.prefetch_queued != 4) {
+        printf("  ❌ Expected 4 legs with endpoints queued, got %zu/%zu\n",
+               plan.leg_count, plan.prefetch_queued);
+        return false;
+    }
+
+    // After the cooperative loader runs, following the plan never touches the platform
+    ntrip_atlas_prefetch_step(10);
+    endpoint_loads = 0;
+    for (size_t i = 0; i < plan.leg_count; i++) {
+        ntrip_service_endpoints_t endpoints;
+        ntrip_atlas_load_service_endpoints(legs[i].service_index, &endpoints);
+    }
+    if (endpoint_loads != 0) {
+        printf("  ❌ Legs were not prefetched\n");
+        return false;
+    }
+
+    ntrip_route_plan_t small = { .legs = legs, .max_legs = 1 };
+    if (ntrip_atlas_plan_route(route, 2, &small) != NTRIP_ATLAS_ERROR_NO_MEMORY || small.leg_count != 4) {
+        printf("  ❌ Overflow should report NO_MEMORY and the needed leg count\n");
+        return false;
+    }
+
+    ntrip_route_point_t bad[] = { {45.0, 1.0}, {95.0, 8.0} };
+    if (ntrip_atlas_plan_route(route, 1, &plan) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_plan_route(bad, 2, &plan) != NTRIP_ATLAS_ERROR_INVALID_PARAM ||
+        ntrip_atlas_plan_route(route, 2, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Bad input accepted\n");
+        return false;
+    }
+
+    printf("  ✅ Endpoints prefetched, limits enforced\n");
+    return true;
+}
+
+// Test cache capacity follows the byte budget and hits are O(1) lookups
+bool test_cache_budget() {
+    printf("Testing byte-budgeted cache sizing...\n");
+
+    test_index_count = 0;
+    for (int i = 0; i < 150; i++) {
+        add_service((uint8_t)i, -60.0 + i * 0.8, 0.0, 50, 4, NTRIP_NETWORK_GOVERNMENT);
+    }
+
+    // Defaults keep the historical 4 endpoint / 2 metadata entries
+    init_tiered();
+    ntrip_tiered_cache_stats_t endpoint_stats, metadata_stats;
+    ntrip_atlas_get_tiered_cache_stats(&endpoint_stats, &metadata_stats);
+    if (endpoint_stats.capacity != 4 || metadata_stats.capacity != 2) {
+        printf("  ❌ Default capacity should be 4/2, got %u/%u\n",
+               endpoint_stats.capacity, metadata_stats.capacity);
+        return false;
+    }
+
+    // Desktop gateway budget: 120 endpoints
+    init_tiered_with_budget(120 * ENDPOINT_ENTRY_BYTES, 0);
+    ntrip_atlas_get_tiered_cache_stats(&endpoint_stats, NULL);
+    if (endpoint_stats.capacity != 120) {
+        printf("  ❌ Expected 120 slots, got %u\n", endpoint_stats.capacity);
+        return false;
+    }
+    printf("  Budget %zu bytes -> %u endpoint slots\n",
+           (size_t)(120 * ENDPOINT_ENTRY_BYTES), endpoint_stats.capacity);
+
+    ntrip_service_endpoints_t endpoints;
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 120; i++) {
+            ntrip_atlas_load_service_endpoints((uint8_t)i, &endpoints);
+        }
+    }
+
+    ntrip_atlas_get_tiered_cache_stats(&endpoint_stats, NULL);
+    if (endpoint_stats.misses != 120 || endpoint_stats.hits != 120 ||
+        endpoint_stats.evictions != 0 || endpoint_stats.entries != 120) {
+        printf("  ❌ Expected 120 misses/120 hits/0 evictions, got %u/%u/%u\n",
+               endpoint_stats.misses, endpoint_stats.hits, endpoint_stats.evictions);
+        return false;
+    }
+
+    // Metadata has its own counters - endpoint stats must not move
+    ntrip_service_metadata_t metadata;
+    ntrip_atlas_load_service_metadata(5, &metadata);
+    ntrip_atlas_load_service_metadata(5, &metadata);
+    ntrip_tiered_cache_stats_t after;
+    ntrip_atlas_get_tiered_cache_stats(&after, &metadata_stats);
+    if (metadata_stats.hits != 1 || metadata_stats.misses != 1 ||
+        after.hits != endpoint_stats.hits || after.misses != endpoint_stats.misses ||
+        strcmp(metadata.provider_full, "Provider 5") != 0) {
+        printf("  ❌ Metadata cache counters incorrect\n");
+        return false;
+    }
+
+    // Trimming frees cached data but keeps capacity and counters
+    ntrip_atlas_trim_caches();
+    size_t tier2 = 1, tier3 = 1;
+    ntrip_atlas_get_tiered_memory_stats(NULL, &tier2, &tier3);
+    ntrip_atlas_get_tiered_cache_stats(&after, NULL);
+    if (tier2 != 0 || tier3 != 0 || after.capacity != 120 || after.hits != 120) {
+        printf("  ❌ Trim should free entries and keep capacity/counters\n");
+        return false;
+    }
+
+    printf("  ✅ Cache sized from budget with correct counters\n");
+    return true;
+}
+
+// Test CLOCK second-chance eviction
+bool test_clock_eviction() {
+    printf("Testing CLOCK eviction...\n");
+
+    test_index_count = 0;
+    for (int i = 0; i < 8; i++) {
+        add_service((uint8_t)i, 40.0 + i, -74.0, 50, 4, NTRIP_NETWORK_GOVERNMENT);
+    }
+    init_tiered_with_budget(3 * ENDPOINT_ENTRY_BYTES, 0);
+
+    ntrip_service_endpoints_t endpoints;
+    ntrip_atlas_load_service_endpoints(0, &endpoints);
+    ntrip_atlas_load_service_endpoints(1, &endpoints);
+    ntrip_atlas_load_service_endpoints(2, &endpoints);
+
+    // Full sweep clears every referenced bit, then service 0 is evicted
+    ntrip_atlas_load_service_endpoints(3, &endpoints);
+
+    // Hit on 1 gives it a second chance, so 2 goes next
+    ntrip_atlas_load_service_endpoints(1, &endpoints);
+    ntrip_atlas_load_service_endpoints(4, &endpoints);
+
+    endpoint_loads = 0;
+    ntrip_atlas_load_service_endpoints(1, &endpoints);
+    ntrip_atlas_load_service_endpoints(3, &endpoints);
+    ntrip_atlas_load_service_endpoints(4, &endpoints);
+    if (endpoint_loads != 0) {
+        printf("  ❌ Services 1, 3 and 4 should be cached\n");
+        return false;
+    }
+
+    ntrip_tiered_cache_stats_t stats;
+    ntrip_atlas_get_tiered_cache_stats(&stats, NULL);
+    if (stats.evictions != 2) {
+        printf("  ❌ Expected 2 evictions, got %u\n", stats.evictions);
+        return false;
+    }
+
+    // Prefetched entries lose to entries that were read
+    init_tiered_with_budget(2 * ENDPOINT_ENTRY_BYTES, 0);
+    ntrip_atlas_load_service_endpoints(0, &endpoints);
+    ntrip_service_idx_t hint = 5;
+    ntrip_atlas_prefetch_endpoints(&hint, 1);
+    ntrip_atlas_prefetch_step(1);
+    ntrip_atlas_load_service_endpoints(6, &endpoints);
+
+    endpoint_loads = 0;
+    ntrip_atlas_load_service_endpoints(0, &endpoints);
+    if (endpoint_loads != 0) {
+        printf("  ❌ Active service was evicted in favour of a prefetch\n");
+        return false;
+    }
+
+    printf("  ✅ CLOCK eviction honours second chances\n");
+    return true;
+}
+
+// Test the cache's service index -> slot map stays exact through heavy eviction
+bool test_cache_map_churn() {
+    printf("Testing cache slot map under eviction churn...\n");
+
+    // Indices spread over the index width so they collide in the map
+    ntrip_service_idx_t stride = (ntrip_service_idx_t)(NTRIP_SERVICE_INDEX_INVALID / 150);
+    test_index_count = 0;
+    for (int i = 0; i < 150; i++) {
+        add_service((ntrip_service_idx_t)(i * stride), -60.0 + i * 0.8, 0.0, 50, 4,
+                    NTRIP_NETWORK_GOVERNMENT);
+    }
+    init_tiered_with_budget(13 * ENDPOINT_ENTRY_BYTES, 0);
+
+    ntrip_service_endpoints_t endpoints;
+    char expected[32];
+    rng_state = 777;
+    for (int i = 0; i < 5000; i++) {
+        // Skewed towards a few hot services so hits, misses and evictions mix
+        int pick = random_unit() < 0.5 ? (int)(random_unit() * 10) : (int)(random_unit() * 150);
+        if (pick > 149) pick = 149;
+        ntrip_service_idx_t index = (ntrip_service_idx_t)(pick * stride);
+
+        if (ntrip_atlas_load_service_endpoints(index, &endpoints) != NTRIP_ATLAS_SUCCESS) {
+            printf("  ❌ Load %d of service %u failed\n", i, (unsigned)index);
+            return false;
+        }
+        snprintf(expected, sizeof(expected), "svc-%u.test", (unsigned)index);
+        if (strcmp(endpoints.hostname, expected) != 0) {
+            printf("  ❌ Service %u returned %s\n", (unsigned)index, endpoints.hostname);
+            return false;
+        }
+
+        // Whatever was just loaded must now be found without the platform
+        endpoint_loads = 0;
+        ntrip_atlas_load_service_endpoints(index, &endpoints);
+        if (endpoint_loads != 0 || strcmp(endpoints.hostname, expected) != 0) {
+            printf("  ❌ Service %u not found right after loading\n", (unsigned)index);
+            return false;
+        }
+    }
+
+    ntrip_tiered_cache_stats_t stats;
+    ntrip_atlas_get_tiered_cache_stats(&stats, NULL);
+    if (stats.capacity != 13 || stats.entries != 13 || stats.evictions == 0 ||
+        stats.hits + stats.misses != 10000) {
+        printf("  ❌ Unexpected stats: %u/%u entries, %u evictions, %u hits, %u misses\n",
+               stats.entries, stats.capacity, stats.evictions, stats.hits, stats.misses);
+        return false;
+    }
+
+    printf("  ✅ %u evictions, every lookup exact\n", stats.evictions);
+    return true;
+}
+
+// Test borrowed records stay in place until released
+bool test_borrowed_records() {
+    printf("Testing zero-copy borrows...\n");
+
+    test_index_count = 0;
+    for (int i = 0; i < 8; i++) {
+        add_service((uint8_t)i, 40.0 + i, -74.0, 50, 4, NTRIP_NETWORK_GOVERNMENT);
+    }
+    init_tiered_with_budget(2 * ENDPOINT_ENTRY_BYTES, 0);
+
+    const ntrip_service_endpoints_t* borrowed = NULL;
+    ntrip_tiered_borrow_t borrow;
+    if (ntrip_atlas_borrow_service_endpoints(0, &borrowed, &borrow) != NTRIP_ATLAS_SUCCESS ||
+        !borrowed || strcmp(borrowed->hostname, "svc-0.test") != 0) {
+        printf("  ❌ Borrow failed\n");
+        return false;
+    }
+
+    // Churn the one remaining slot; the borrowed record must not move
+    ntrip_service_endpoints_t endpoints;
+    for (int i = 1; i < 8; i++) {
+        ntrip_atlas_load_service_endpoints((uint8_t)i, &endpoints);
+    }
+    if (strcmp(borrowed->hostname, "svc-0.test") != 0) {
+        printf("  ❌ Borrowed record was evicted\n");
+        return false;
+    }
+
+    // Repeat borrows hit the cache without a platform load
+    endpoint_loads = 0;
+    const ntrip_service_endpoints_t* again = NULL;
+    ntrip_tiered_borrow_t borrow2;
+    if (ntrip_atlas_borrow_service_endpoints(0, &again, &borrow2) != NTRIP_ATLAS_SUCCESS ||
+        again != borrowed || endpoint_loads != 0) {
+        printf("  ❌ Second borrow should share the cached record\n");
+        return false;
+    }
+
+    // With every slot borrowed, borrows fail but copies still work
+    const ntrip_service_endpoints_t* other = NULL;
+    ntrip_tiered_borrow_t borrow3;
+    ntrip_atlas_borrow_service_endpoints(7, &other, &borrow3);
+    const ntrip_service_endpoints_t* none = NULL;
+    ntrip_tiered_borrow_t borrow4;
+    if (ntrip_atlas_borrow_service_endpoints(5, &none, &borrow4) != NTRIP_ATLAS_ERROR_NO_MEMORY || none) {
+        printf("  ❌ Borrow should fail when every slot is pinned\n");
+        return false;
+    }
+    if (ntrip_atlas_load_service_endpoints(5, &endpoints) != NTRIP_ATLAS_SUCCESS ||
+        strcmp(endpoints.hostname, "svc-5.test") != 0) {
+        printf("  ❌ Copying load should bypass a fully pinned cache\n");
+        return false;
+    }
+
+    // Trimming keeps borrowed records in place
+    ntrip_atlas_trim_caches();
+    ntrip_tiered_cache_stats_t stats;
+    ntrip_atlas_get_tiered_cache_stats(&stats, NULL);
+    if (stats.pinned != 2 || stats.entries != 2 ||
+        strcmp(borrowed->hostname, "svc-0.test") != 0 || strcmp(other->hostname, "svc-7.test") != 0) {
+        printf("  ❌ Trim should keep pinned entries\n");
+        return false;
+    }
+
+    // Once fully released, the slot can be evicted again
+    ntrip_atlas_release_borrow(&borrow);
+    ntrip_atlas_release_borrow(&borrow2);
+    ntrip_atlas_release_borrow(&borrow3);
+    ntrip_atlas_release_borrow(&borrow3);  // Double release is a no-op
+    ntrip_atlas_get_tiered_cache_stats(&stats, NULL);
+    if (stats.pinned != 0 || borrow.record != NULL) {
+        printf("  ❌ Release should unpin and clear the handle\n");
+        return false;
+    }
+    ntrip_atlas_load_service_endpoints(1, &endpoints);
+    ntrip_atlas_load_service_endpoints(2, &endpoints);
+    endpoint_loads = 0;
+    ntrip_atlas_load_service_endpoints(0, &endpoints);
+    if (endpoint_loads != 1) {
+        printf("  ❌ Released record should be evictable\n");
+        return false;
+    }
+
+    // Borrows that outlive re-initialization are ignored on release
+    const ntrip_service_metadata_t* metadata = NULL;
+    if (ntrip_atlas_borrow_service_metadata(3, &metadata, &borrow) != NTRIP_ATLAS_SUCCESS ||
+        strcmp(metadata->provider_full, "Provider 3") != 0) {
+        printf("  ❌ Metadata borrow failed\n");
+        return false;
+    }
+    init_tiered_with_budget(2 * ENDPOINT_ENTRY_BYTES, 0);
+    ntrip_atlas_borrow_service_metadata(3, &metadata, &borrow2);
+    ntrip_atlas_release_borrow(&borrow);
+    ntrip_atlas_get_tiered_cache_stats(NULL, &stats);
+    if (stats.pinned != 1) {
+        printf("  ❌ Stale release should not unpin the new borrow\n");
+        return false;
+    }
+    ntrip_atlas_release_borrow(&borrow2);
+
+    printf("  ✅ Borrowed records are pinned until released\n");
+    return true;
+}
+
+// Test service indices beyond 8 bits through discovery, caches and packing
+bool test_wide_service_indices() {
+    printf("Testing service indices wider than 8 bits...\n");
+
+#if NTRIP_ATLAS_SERVICE_INDEX_BITS == 8
+    printf("  ✅ Skipped: 8-bit service indices configured\n");
+    return true;
+#else
+    // Dense indices past 255 use the slot table
+    test_index_count = 0;
+    for (int i = 0; i < 150; i++) {
+        add_service((ntrip_service_idx_t)(200 + i), -60.0 + i * 0.8, 20.0, 50, 4, NTRIP_NETWORK_GOVERNMENT);
+    }
+    init_tiered();
+
+    ntrip_service_endpoints_t endpoints;
+    if (tiered_best(-60.0 + 149 * 0.8, 20.0) != 349 ||
+        ntrip_atlas_load_service_endpoints(300, &endpoints) != NTRIP_ATLAS_SUCCESS ||
+        strcmp(endpoints.hostname, "svc-300.test") != 0) {
+        printf("  ❌ Dense wide indices not resolved\n");
+        return false;
+    }
+
+    // Packing picks a 2-byte index field and round-trips it
+    static uint8_t packed[MAX_TEST_SERVICES * 16];
+    size_t packed_size = 0;
+    ntrip_packed_index_header_t header;
+    static ntrip_service_index_t unpacked[MAX_TEST_SERVICES];
+    size_t count = 0;
+    if (ntrip_atlas_pack_discovery_index(test_index, test_index_count, packed, sizeof(packed),
+                                         &packed_size) != NTRIP_ATLAS_SUCCESS ||
+        ntrip_atlas_unpack_discovery_index(packed, packed_size, unpacked, MAX_TEST_SERVICES,
+                                           &count) != NTRIP_ATLAS_SUCCESS ||
+        count != test_index_count) {
+        printf("  ❌ Packed round trip failed\n");
+        return false;
+    }
+    memcpy(&header, packed, sizeof(header));
+    for (size_t i = 0; i < count; i++) {
+        if (unpacked[i].service_index != test_index[i].service_index) {
+            printf("  ❌ Packed index %zu decoded as %u\n", i, (unsigned)unpacked[i].service_index);
+            return false;
+        }
+    }
+    if (header.index_bytes != 2) {
+        printf("  ❌ Expected 2-byte packed indices, got %u\n", header.index_bytes);
+        return false;
+    }
+
+    // Sparse indices fall back to scanning Tier 1
+    test_index_count = 0;
+    add_service(7, 40.0, -74.0, 100, 3, NTRIP_NETWORK_GOVERNMENT);
+    add_service(60000, 52.0, 13.0, 100, 4, NTRIP_NETWORK_GOVERNMENT);
+    init_tiered();
+
+    if (tiered_best(52.0, 13.0) != 60000 ||
+        ntrip_atlas_load_service_endpoints(60000, &endpoints) != NTRIP_ATLAS_SUCCESS ||
+        strcmp(endpoints.hostname, "svc-60000.test") != 0 ||
+        ntrip_atlas_load_service_endpoints(59999, &endpoints) != NTRIP_ATLAS_ERROR_NOT_FOUND) {
+        printf("  ❌ Sparse wide indices not resolved\n");
+        return false;
+    }
+
+    size_t tier1 = 0;
+    ntrip_atlas_get_tiered_memory_stats(&tier1, NULL, NULL);
+    if (tier1 > 2 * sizeof(ntrip_service_index_t) + 4096 * sizeof(uint32_t)) {
+        printf("  ❌ Sparse indices should not allocate a full slot table (%zu bytes)\n", tier1);
+        return false;
+    }
+
+    printf("  ✅ Wide service indices resolved, packed in %zu bytes\n", packed_size);
+    return true;
+#endif
+}
+
+// Test memory accounting and mode switching
+bool test_memory_and_modes() {
+    printf("Testing memory accounting and loading modes...\n");
+
+    test_index_count = 0;
+    add_service(1, 40.0, -74.0, 100, 4, NTRIP_NETWORK_GOVERNMENT);
+    init_tiered();
+
+    size_t tier1 = 0, tier2 = 0, tier3 = 0;
+    ntrip_atlas_get_tiered_memory_stats(&tier1, &tier2, &tier3);
+    if (tier1 <= sizeof(ntrip_service_index_t)) {
+        printf("  ❌ Tier 1 usage should include lookup structures, got %zu bytes\n", tier1);
+        return false;
+    }
+    printf("  Tier 1 with grid: %zu bytes\n", tier1);
+
+    if (ntrip_atlas_init_with_loading_mode(NTRIP_LOADING_TIERED, NULL) != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Should reject tiered mode without platform\n");
+        return false;
+    }
+
+    // An index with more entries than Tier 1 slots can address is refused, not truncated
+    test_index_count = (size_t)NTRIP_SERVICE_INDEX_INVALID + 1;
+    ntrip_atlas_error_t oversized = init_tiered();
+    test_index_count = 1;
+    if (oversized != NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Oversized discovery index accepted\n");
+        return false;
+    }
+
+    if (ntrip_atlas_init_with_loading_mode(NTRIP_LOADING_FULL, NULL) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Full mode initialization failed\n");
+        return false;
+    }
+
+    ntrip_best_service_t result;
+    if (ntrip_atlas_find_best_tiered(&result, 40.0, -74.0) != NTRIP_ATLAS_ERROR_MISSING_FEATURE) {
+        printf("  ❌ Tiered discovery should be unavailable in full mode\n");
+        return false;
+    }
+
+    printf("  ✅ Memory accounting and modes correct\n");
+    return true;
+}
+
+int main() {
+    printf("Tiered Loading Tests\n");
+    printf("====================\n\n");
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Matches linear scan", test_matches_linear_scan},
+        {"Packed index scan", test_packed_index_scan},
+        {"Wraparound coverage", test_wraparound_coverage},
+        {"Service index lookup", test_service_index_lookup},
+        {"Prefetch fallbacks", test_prefetch_fallbacks},
+        {"Prefetch nearby", test_prefetch_nearby},
+        {"Route planning", test_route_planning},
+        {"Route dense coverage", test_route_dense_coverage},
+        {"Route prefetch and limits", test_route_prefetch_and_limits},
+        {"Cache budget", test_cache_budget},
+        {"CLOCK eviction", test_clock_eviction},
+        {"Cache map churn", test_cache_map_churn},
+        {"Borrowed records", test_borrowed_records},
+        {"Wide service indices", test_wide_service_indices},
+        {"Memory and modes", test_memory_and_modes},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All tiered loading tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some tiered loading tests failed!\n");
+        return 1;
+    }
+}
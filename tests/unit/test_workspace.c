@@ -0,0 +1,397 @@
+/**
+ * Workspace Unit Tests
+ *
+ * Tests the caller-provided workspace: arena behaviour, that the size
+ * reported for a configuration is exactly what the library draws, and
+ * that tiered discovery, cache loads, borrows and nearest-service sorting
+ * never touch the heap once a workspace is attached. malloc and friends
+ * are interposed to count calls made while a hot path runs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Include the header
+#include "../../libntripatlas/include/ntrip_atlas.h"
+
+// glibc entry points behind the interposed allocator
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static bool heap_armed = false;
+static bool heap_exhausted = false;
+static int heap_calls = 0;
+
+void* malloc(size_t size) {
+    if (heap_armed) heap_calls++;
+    if (heap_exhausted) return NULL;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (heap_armed) heap_calls++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (heap_armed) heap_calls++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (heap_armed && ptr) heap_calls++;
+    __libc_free(ptr);
+}
+
+static void arm_heap_check(void) {
+    heap_calls = 0;
+    heap_armed = true;
+}
+
+static int disarm_heap_check(void) {
+    heap_armed = false;
+    return heap_calls;
+}
+
+#define TEST_SERVICES 200
+
+static ntrip_service_index_t test_index[TEST_SERVICES];
+static ntrip_service_compact_t test_services[TEST_SERVICES];
+static uint64_t workspace_buffer[16384];
+
+// Tiered loading keeps a pointer to the attached workspace, so it outlives each test
+static ntrip_atlas_workspace_t workspace;
+
+// Mock platform: copy Tier 1 into the attached workspace
+static ntrip_atlas_error_t workspace_load_discovery_index(
+    ntrip_service_index_t** index,
+    size_t* count,
+    void* platform_data
+) {
+    (void)platform_data;
+    ntrip_atlas_workspace_t* workspace = ntrip_atlas_get_workspace();
+    ntrip_service_index_t* copy = workspace ?
+        ntrip_atlas_workspace_alloc(workspace, sizeof(test_index)) : test_index;
+    if (!copy) {
+        return NTRIP_ATLAS_ERROR_NO_MEMORY;
+    }
+    if (copy != test_index) {
+        memcpy(copy, test_index, sizeof(test_index));
+    }
+    *index = copy;
+    *count = TEST_SERVICES;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+// Mock platform: hostname encodes the service index
+static ntrip_atlas_error_t workspace_load_service_endpoints(
+    ntrip_service_idx_t service_index,
+    ntrip_service_endpoints_t* endpoints,
+    void* platform_data
+) {
+    (void)platform_data;
+    memset(endpoints, 0, sizeof(*endpoints));
+    snprintf(endpoints->hostname, sizeof(endpoints->hostname), "svc-%u.test", service_index);
+    endpoints->port = 2101;
+    return NTRIP_ATLAS_SUCCESS;
+}
+
+static const ntrip_tiered_platform_t workspace_platform = {
+    .load_discovery_index = workspace_load_discovery_index,
+    .load_service_endpoints = workspace_load_service_endpoints,
+};
+
+// Services on a grid over Europe, each with a 100km circle
+static void build_test_data(void) {
+    for (size_t i = 0; i < TEST_SERVICES; i++) {
+        double lat = 40.0 + (double)(i / 20);
+        double lon = -5.0 + (double)(i % 20);
+
+        ntrip_service_index_t* service = &test_index[i];
+        memset(service, 0, sizeof(*service));
+        service->service_index = (ntrip_service_idx_t)i;
+        service->lat_center_deg100 = (int16_t)round(lat * 100);
+        service->lon_center_deg100 = (int16_t)round(lon * 100);
+        service->radius_km = 100;
+        service->quality_rating = 3;
+        service->network_type = NTRIP_NETWORK_GOVERNMENT;
+
+        ntrip_service_compact_t* compact = &test_services[i];
+        memset(compact, 0, sizeof(*compact));
+        snprintf(compact->hostname, sizeof(compact->hostname), "svc-%zu.test", i);
+        compact->lat_min_deg100 = (int16_t)round((lat - 0.5) * 100);
+        compact->lat_max_deg100 = (int16_t)round((lat + 0.5) * 100);
+        compact->lon_min_deg100 = (int16_t)round((lon - 0.5) * 100);
+        compact->lon_max_deg100 = (int16_t)round((lon + 0.5) * 100);
+    }
+}
+
+static ntrip_atlas_workspace_config_t test_config(void) {
+    ntrip_atlas_workspace_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.discovery_index = test_index;
+    config.discovery_count = TEST_SERVICES;
+    config.loader_bytes = sizeof(test_index);
+    config.max_sort_services = TEST_SERVICES;
+    return config;
+}
+
+// Test arena allocation, alignment and marks
+bool test_workspace_arena() {
+    printf("Testing workspace arena...\n");
+
+    if (ntrip_atlas_workspace_init(&workspace, (uint8_t*)workspace_buffer + 1, 64) !=
+        NTRIP_ATLAS_ERROR_INVALID_PARAM) {
+        printf("  ❌ Misaligned buffer should be rejected\n");
+        return false;
+    }
+
+    if (ntrip_atlas_workspace_init(&workspace, workspace_buffer, 64) != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Failed to initialize workspace\n");
+        return false;
+    }
+
+    uint8_t* a = ntrip_atlas_workspace_alloc(&workspace, 3);
+    size_t mark = ntrip_atlas_workspace_mark(&workspace);
+    uint8_t* b = ntrip_atlas_workspace_alloc(&workspace, 40);
+    if (!a || !b || (uintptr_t)b % NTRIP_ATLAS_WORKSPACE_ALIGN != 0 || b - a != 8) {
+        printf("  ❌ Allocations not aligned and packed\n");
+        return false;
+    }
+
+    if (ntrip_atlas_workspace_alloc(&workspace, 32) != NULL) {
+        printf("  ❌ Allocation beyond the buffer should fail\n");
+        return false;
+    }
+
+    ntrip_atlas_workspace_release(&workspace, mark);
+    if (ntrip_atlas_workspace_alloc(&workspace, 48) != b || workspace.high_water != 56) {
+        printf("  ❌ Released space not reused (high water %zu)\n", workspace.high_water);
+        return false;
+    }
+
+    printf("  ✅ Arena allocation working correctly\n");
+    return true;
+}
+
+// Test that discovery, cache loads and sorting never allocate with a workspace
+bool test_hot_paths_without_heap() {
+    printf("Testing hot paths draw only from the workspace...\n");
+
+    ntrip_atlas_workspace_config_t config = test_config();
+    size_t required = ntrip_atlas_workspace_required_bytes(&config);
+    if (required == 0 || required > sizeof(workspace_buffer)) {
+        printf("  ❌ Unexpected required size %zu\n", required);
+        return false;
+    }
+
+    ntrip_atlas_workspace_init(&workspace, workspace_buffer, required);
+    ntrip_atlas_set_workspace(&workspace);
+
+    arm_heap_check();
+
+    ntrip_atlas_error_t result = ntrip_atlas_init_with_loading_mode(
+        NTRIP_LOADING_TIERED, &workspace_platform);
+
+    ntrip_best_service_t best;
+    ntrip_atlas_error_t find_result = ntrip_atlas_find_best_tiered(&best, 45.05, 2.1);
+    ntrip_atlas_prefetch_nearby(45.05, 2.1, 200.0);
+    ntrip_atlas_prefetch_step(8);
+
+    ntrip_service_endpoints_t endpoints;
+    ntrip_atlas_error_t load_result = NTRIP_ATLAS_SUCCESS;
+    for (ntrip_service_idx_t i = 0; i < 20 && load_result == NTRIP_ATLAS_SUCCESS; i++) {
+        load_result = ntrip_atlas_load_service_endpoints(i, &endpoints);
+    }
+
+    const ntrip_service_endpoints_t* borrowed = NULL;
+    ntrip_tiered_borrow_t borrow;
+    ntrip_atlas_error_t borrow_result = ntrip_atlas_borrow_service_endpoints(7, &borrowed, &borrow);
+    ntrip_atlas_trim_caches();
+    ntrip_atlas_release_borrow(&borrow);
+
+    size_t sorted = ntrip_atlas_filter_and_sort_nearest_services_in(
+        test_services, NULL, TEST_SERVICES, 45.0, 2.0, 500.0, 5, &workspace);
+
+    int calls = disarm_heap_check();
+
+    if (result != NTRIP_ATLAS_SUCCESS || find_result != NTRIP_ATLAS_SUCCESS ||
+        load_result != NTRIP_ATLAS_SUCCESS || borrow_result != NTRIP_ATLAS_SUCCESS) {
+        printf("  ❌ Tiered operations failed (%d, %d, %d, %d)\n",
+               result, find_result, load_result, borrow_result);
+        return false;
+    }
+
+    if (sorted != 5 || strcmp(test_services[0].hostname, "svc-107.test") != 0) {
+        printf("  ❌ Sort returned %zu services, nearest %s\n", sorted, test_services[0].hostname);
+        return false;
+    }
+
+    if (calls != 0) {
+        printf("  ❌ Library made %d heap calls with a workspace attached\n", calls);
+        return false;
+    }
+
+    // Sort scratch is returned; the reported size is exactly the peak drawn
+    if (workspace.high_water != required) {
+        printf("  ❌ Peak usage %zu differs from required %zu\n", workspace.high_water, required);
+        return false;
+    }
+
+    printf("  ✅ No heap calls; %zu workspace bytes used as reported\n", required);
+    return true;
+}
+
+// Test that an undersized workspace is reported rather than overrun
+bool test_undersized_workspace() {
+    printf("Testing undersized workspace...\n");
+
+    ntrip_atlas_workspace_init(&workspace, workspace_buffer, sizeof(test_index) + 64);
+    ntrip_atlas_set_workspace(&workspace);
+
+    ntrip_atlas_error_t result = ntrip_atlas_init_with_loading_mode(
+        NTRIP_LOADING_TIERED, &workspace_platform);
+    if (result != NTRIP_ATLAS_ERROR_NO_MEMORY) {
+        printf("  ❌ Expected NO_MEMORY, got %d\n", result);
+        return false;
+    }
+
+    if (workspace.used != 0) {
+        printf("  ❌ Failed initialization left %zu bytes drawn\n", workspace.used);
+        return false;
+    }
+
+    // Sorting more services than keys fit for ranks without them, not on the heap
+    ntrip_atlas_workspace_init(&workspace, workspace_buffer, 64);
+    arm_heap_check();
+    size_t sorted = ntrip_atlas_filter_and_sort_nearest_services_in(
+        test_services, NULL, TEST_SERVICES, 45.0, 2.0, 500.0, 5, &workspace);
+    int calls = disarm_heap_check();
+    if (sorted != 5 || strcmp(test_services[0].hostname, "svc-107.test") != 0 || calls != 0) {
+        printf("  ❌ Oversized sort returned %zu services (nearest %s) with %d heap calls\n",
+               sorted, test_services[0].hostname, calls);
+        return false;
+    }
+
+    printf("  ✅ Undersized workspace reported, heap never used\n");
+    return true;
+}
+
+// Test that sorting without a workspace still ranks when malloc fails
+bool test_sort_without_heap_memory() {
+    printf("Testing sort when the heap is exhausted...\n");
+
+    ntrip_service_compact_t expected[TEST_SERVICES];
+    memcpy(expected, test_services, sizeof(test_services));
+    size_t expected_count = ntrip_atlas_filter_and_sort_nearest_services(
+        expected, TEST_SERVICES, 47.3, 6.8, 300.0, 7);
+
+    heap_exhausted = true;
+    arm_heap_check();
+    size_t sorted = ntrip_atlas_filter_and_sort_nearest_services(
+        test_services, TEST_SERVICES, 47.3, 6.8, 300.0, 7);
+    int calls = disarm_heap_check();
+    heap_exhausted = false;
+
+    if (calls != 1 || sorted != 7 || expected_count != 7) {
+        printf("  ❌ Sorted %zu of %zu services after %d heap calls\n",
+               sorted, expected_count, calls);
+        return false;
+    }
+
+    for (size_t i = 0; i < sorted; i++) {
+        if (strcmp(test_services[i].hostname, expected[i].hostname) != 0) {
+            printf("  ❌ Rank %zu: expected %s, got %s\n",
+                   i, expected[i].hostname, test_services[i].hostname);
+            return false;
+        }
+    }
+
+    printf("  ✅ Failed allocation ranked without keys, same order\n");
+    return true;
+}
+
+// Test that detaching the workspace reclaims it and returns to the heap
+bool test_detach_workspace() {
+    printf("Testing workspace detach...\n");
+
+    ntrip_atlas_workspace_config_t config = test_config();
+    ntrip_atlas_workspace_init(&workspace, workspace_buffer,
+                               ntrip_atlas_workspace_required_bytes(&config));
+    ntrip_atlas_set_workspace(&workspace);
+
+    if (ntrip_atlas_init_with_loading_mode(NTRIP_LOADING_TIERED, &workspace_platform) !=
+        NTRIP_ATLAS_SUCCESS || workspace.used == 0) {
+        printf("  ❌ Tiered loading did not use the workspace\n");
+        return false;
+    }
+
+    // Re-initializing without a workspace releases it and uses the heap
+    ntrip_atlas_set_workspace(NULL);
+    arm_heap_check();
+    ntrip_atlas_error_t result = ntrip_atlas_init_with_loading_mode(
+        NTRIP_LOADING_TIERED, &workspace_platform);
+    int calls = disarm_heap_check();
+
+    if (result != NTRIP_ATLAS_SUCCESS || workspace.used != 0) {
+        printf("  ❌ Workspace not reclaimed (%zu bytes still used)\n", workspace.used);
+        return false;
+    }
+
+    if (calls == 0) {
+        printf("  ❌ Heap interposition did not observe the fallback\n");
+        return false;
+    }
+
+    ntrip_atlas_init_with_loading_mode(NTRIP_LOADING_FULL, NULL);
+
+    printf("  ✅ Detached workspace reclaimed; heap used instead\n");
+    return true;
+}
+
+int main() {
+    printf("Workspace Tests\n");
+    printf("===============\n\n");
+
+    build_test_data();
+
+    struct {
+        const char* name;
+        bool (*test_func)();
+    } tests[] = {
+        {"Workspace arena", test_workspace_arena},
+        {"Hot paths without heap", test_hot_paths_without_heap},
+        {"Undersized workspace", test_undersized_workspace},
+        {"Sort without heap memory", test_sort_without_heap_memory},
+        {"Detach workspace", test_detach_workspace},
+    };
+
+    int passed = 0;
+    int total = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < total; i++) {
+        printf("Test %d: %s\n", i + 1, tests[i].name);
+        if (tests[i].test_func()) {
+            printf("✅ PASS\n\n");
+            passed++;
+        } else {
+            printf("❌ FAIL\n\n");
+        }
+    }
+
+    printf("Results: %d/%d tests passed\n", passed, total);
+
+    if (passed == total) {
+        printf("🎉 All workspace tests passed!\n");
+        return 0;
+    } else {
+        printf("💥 Some tests failed\n");
+        return 1;
+    }
+}
@@ -188,8 +188,8 @@ void test_spatial_integration() {
     printf("\nTest: Spatial Indexing Integration\n");
     printf("===================================\n");
 
-    // Initialize spatial index
-    ntrip_atlas_error_t result = ntrip_atlas_init_spatial_index();
+    // Initialize spatial index on storage sized by the generator
+    ntrip_atlas_error_t result = init_generated_spatial_index();
     assert(result == NTRIP_ATLAS_SUCCESS);
 
     size_t service_count;
@@ -227,11 +227,11 @@ void test_spatial_integration() {
             for (uint16_t lat_tile = min_lat_tile; lat_tile <= max_lat_tile; lat_tile++) {
                 for (uint16_t lon_tile = min_lon_tile; lon_tile <= max_lon_tile; lon_tile++) {
                     ntrip_tile_key_t tile_key = ntrip_atlas_encode_tile_key(level, lat_tile, lon_tile);
-                    ntrip_atlas_error_t add_result = ntrip_atlas_add_service_to_tile(tile_key, (uint8_t)i);
+                    ntrip_atlas_error_t add_result = ntrip_atlas_add_service_to_tile(tile_key, (ntrip_service_idx_t)i);
                     if (add_result != NTRIP_ATLAS_SUCCESS) {
                         const char* error_msg;
                         if (add_result == -21) {
-                            error_msg = "SPATIAL_INDEX_FULL (maximum 16384 tiles reached)";
+                            error_msg = "SPATIAL_INDEX_FULL (generated capacity exceeded)";
                         } else if (add_result == -22) {
                             error_msg = "TILE_FULL (maximum 64 services per tile reached)";
                         } else {
@@ -246,8 +246,16 @@ void test_spatial_integration() {
         }
     }
 
+    // Generated capacities must match the populated index exactly
+    ntrip_spatial_index_stats_t stats;
+    assert(ntrip_atlas_get_spatial_index_stats(&stats) == NTRIP_ATLAS_SUCCESS);
+    assert(stats.populated_tiles == NTRIP_GENERATED_SPATIAL_TILES);
+    assert(stats.total_service_assignments == NTRIP_GENERATED_SPATIAL_ASSIGNMENTS);
+    printf("✅ Spatial index uses %zu bytes for %u tiles\n",
+           stats.memory_used_bytes, (unsigned)stats.populated_tiles);
+
     // Test spatial lookup with generated services
-    uint8_t found_services[8];
+    ntrip_service_idx_t found_services[8];
     size_t found_count = ntrip_atlas_find_services_by_location_fast(
         -33.8688, 151.2093, found_services, 8  // Sydney
     );
@@ -256,7 +264,7 @@ void test_spatial_integration() {
     assert(found_count > 0);
 
     // Test integrated spatial-geographic lookup
-    uint8_t verified_services[8];
+    ntrip_service_idx_t verified_services[8];
     size_t verified_count = ntrip_atlas_find_services_spatial_geographic(
         -33.8688, 151.2093, services, service_count, verified_services, 8
     );
@@ -269,6 +277,47 @@ void test_spatial_integration() {
     printf("✅ Generated services work correctly with spatial indexing\n");
 }
 
+/**
+ * Test nearest-service ranking with the generated geometry table
+ */
+void test_nearest_with_generated_geometry() {
+    printf("\nTest: Nearest Services With Generated Geometry\n");
+    printf("==============================================\n");
+
+    size_t service_count, geometry_count;
+    const ntrip_service_compact_t* services = get_generated_services(&service_count);
+    const ntrip_service_geometry_t* geometry = get_generated_service_geometry(&geometry_count);
+    assert(geometry_count == service_count);
+    assert(service_count == NTRIP_GENERATED_SERVICE_COUNT);
+
+    const double locations[][2] = {
+        { -33.8688, 151.2093 },  // Sydney
+        { 48.1351, 11.5820 },    // Munich
+        { 40.7128, -74.0060 },   // New York
+    };
+
+    for (size_t l = 0; l < sizeof(locations) / sizeof(locations[0]); l++) {
+        ntrip_service_compact_t derived[NTRIP_GENERATED_SERVICE_COUNT];
+        ntrip_service_compact_t precomputed[NTRIP_GENERATED_SERVICE_COUNT];
+        memcpy(derived, services, sizeof(derived));
+        memcpy(precomputed, services, sizeof(precomputed));
+
+        // Same services in the same order whether centers come from the table or the boxes
+        size_t derived_count = ntrip_atlas_filter_and_sort_nearest_services(
+            derived, service_count, locations[l][0], locations[l][1], 500.0, 5);
+        size_t precomputed_count = ntrip_atlas_filter_and_sort_nearest_services_in(
+            precomputed, geometry, service_count, locations[l][0], locations[l][1], 500.0, 5, NULL);
+
+        assert(derived_count > 0);
+        assert(precomputed_count == derived_count);
+        for (size_t i = 0; i < derived_count; i++) {
+            assert(strcmp(derived[i].hostname, precomputed[i].hostname) == 0);
+        }
+        printf("✅ (%.2f, %.2f): nearest %s of %zu\n",
+               locations[l][0], locations[l][1], precomputed[0].hostname, precomputed_count);
+    }
+}
+
 /**
  * Test correct service discovery ordering: local first, global fallback
  */
@@ -286,7 +335,7 @@ void test_service_discovery_ordering() {
     printf("📍 Testing service discovery order for Sydney (%.4f°, %.4f°):\n", sydney_lat, sydney_lon);
 
     // Step 1: Get spatially-indexed (local/regional) services first
-    uint8_t local_services[8];
+    ntrip_service_idx_t local_services[8];
     size_t local_count = ntrip_atlas_find_services_by_location_fast(
         sydney_lat, sydney_lon, local_services, 8
     );
@@ -294,7 +343,7 @@ void test_service_discovery_ordering() {
     printf("\n🏛️  LOCAL/REGIONAL services found first (HIGHEST QUALITY):\n");
     int australian_found = 0;
     for (size_t i = 0; i < local_count; i++) {
-        uint8_t service_idx = local_services[i];
+        ntrip_service_idx_t service_idx = local_services[i];
         const ntrip_service_compact_t* service = &services[service_idx];
         const char* provider = get_provider_name(service->provider_index);
         printf("  Priority %zu: Service %d - %s (%s)\n", i+1, service_idx, service->hostname, provider);
@@ -336,6 +385,7 @@ int main() {
     test_service_coverage();
     test_authentication_flags();
     test_spatial_integration();
+    test_nearest_with_generated_geometry();
     test_service_discovery_ordering();
 
     printf("\n🎉 All YAML generated service tests passed!\n");
@@ -19,6 +19,8 @@ def convert_endpoints(old_endpoints: list) -> list:
             'port': ep.get('port', 2101),
             'ssl': ep.get('ssl', False)
         }
+        if ep.get('sourcetable_filter'):
+            new_ep['sourcetable_filter'] = True
         new_endpoints.append(new_ep)
     return new_endpoints
 
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+CRC-24Q Table Generator for NTRIP Atlas
+
+Writes the slicing-by-8 lookup tables used by the RTCM3 frame scanner.
+Entries hold the 24-bit CRC in their top three bytes (polynomial
+0x1864CFB shifted left by 8), so eight input bytes fold into the CRC
+with one 32-bit XOR and eight lookups. Slice 0 alone is the classic
+byte-at-a-time table.
+
+Usage:
+    python3 crc24q_tables.py libntripatlas/src/ntrip_crc24q_tables.h
+"""
+
+import sys
+
+POLY = 0x864CFB00  # CRC-24Q polynomial aligned to the top of 32 bits
+SLICES = 8
+PER_LINE = 6
+
+
+def build_tables():
+    """Return SLICES tables of 256 entries."""
+    tables = [[0] * 256 for _ in range(SLICES)]
+    for byte in range(256):
+        crc = byte << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ POLY) if crc & 0x80000000 else (crc << 1)
+            crc &= 0xFFFFFFFF
+        tables[0][byte] = crc
+
+    # Slice k advances a byte's contribution past k further zero bytes
+    for k in range(1, SLICES):
+        for byte in range(256):
+            previous = tables[k - 1][byte]
+            tables[k][byte] = ((previous << 8) & 0xFFFFFFFF) ^ tables[0][previous >> 24]
+    return tables
+
+
+def format_header(tables):
+    lines = [
+        "/**",
+        " * NTRIP Atlas - CRC-24Q Slicing Tables",
+        " *",
+        " * Generated by tools/generators/crc24q_tables.py - do not edit.",
+        " * Entries carry the CRC in their top 24 bits. Slices past the first",
+        " * are only compiled when NTRIP_ATLAS_CRC24Q_SLICES is 8.",
+        " *",
+        " * Licensed under MIT License",
+        " */",
+        "",
+        "#ifndef NTRIP_CRC24Q_TABLES_H",
+        "#define NTRIP_CRC24Q_TABLES_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "static const uint32_t crc24q_table[NTRIP_ATLAS_CRC24Q_SLICES][256] = {",
+    ]
+    for k, table in enumerate(tables):
+        if k == 1:
+            lines.append("#if NTRIP_ATLAS_CRC24Q_SLICES > 1")
+        lines.append("    {")
+        for start in range(0, 256, PER_LINE):
+            row = ", ".join("0x%08X" % value for value in table[start:start + PER_LINE])
+            last = start + PER_LINE >= 256
+            lines.append("        " + row + ("" if last else ","))
+        lines.append("    }" + ("" if k == SLICES - 1 else ","))
+    lines.append("#endif")
+    lines.append("};")
+    lines.append("")
+    lines.append("#endif // NTRIP_CRC24Q_TABLES_H")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: crc24q_tables.py <output.h>")
+        return 1
+    with open(sys.argv[1], "w") as output:
+        output.write(format_header(build_tables()))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -23,7 +23,7 @@ extern const ntrip_service_compact_t* get_sample_services(size_t* count);
 extern ntrip_atlas_error_t ntrip_atlas_init_spatial_index(void);
 extern ntrip_atlas_error_t ntrip_atlas_lat_lon_to_tile(double lat, double lon, uint8_t level, uint16_t* tile_lat, uint16_t* tile_lon);
 extern ntrip_tile_key_t ntrip_atlas_encode_tile_key(uint8_t level, uint16_t lat_tile, uint16_t lon_tile);
-extern ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(ntrip_tile_key_t tile_key, uint8_t service_index);
+extern ntrip_atlas_error_t ntrip_atlas_add_service_to_tile(ntrip_tile_key_t tile_key, ntrip_service_idx_t service_index);
 extern ntrip_atlas_error_t ntrip_atlas_get_spatial_index_stats(ntrip_spatial_index_stats_t* stats);
 
 /**
@@ -31,7 +31,7 @@ extern ntrip_atlas_error_t ntrip_atlas_get_spatial_index_stats(ntrip_spatial_ind
  */
 static ntrip_atlas_error_t assign_service_to_level(
     const ntrip_service_compact_t* service,
-    uint8_t service_index,
+    ntrip_service_idx_t service_index,
     uint8_t level
 ) {
     // Convert service coverage from int16 to double
@@ -98,7 +98,7 @@ static ntrip_atlas_error_t populate_spatial_index(void) {
 
         // Assign service to all relevant levels (0-4)
         for (uint8_t level = 0; level <= 4; level++) {
-            ntrip_atlas_error_t result = assign_service_to_level(service, (uint8_t)i, level);
+            ntrip_atlas_error_t result = assign_service_to_level(service, (ntrip_service_idx_t)i, level);
             if (result != NTRIP_ATLAS_SUCCESS) {
                 printf("  ❌ Failed to assign service %zu to level %d (error %d)\n",
                        i, level, result);
@@ -140,7 +140,7 @@ static void test_service_lookup_at_locations(void) {
                test_locations[i].lat,
                test_locations[i].lon);
 
-        uint8_t found_services[16];
+        ntrip_service_idx_t found_services[16];
         size_t found_count = ntrip_atlas_find_services_by_location_fast(
             test_locations[i].lat,
             test_locations[i].lon,
@@ -161,7 +161,7 @@ static void test_service_lookup_at_locations(void) {
             const ntrip_service_compact_t* services = get_sample_services(&service_count);
 
             for (size_t j = 0; j < found_count && j < 5; j++) {  // Limit to first 5 services
-                uint8_t service_idx = found_services[j];
+                ntrip_service_idx_t service_idx = found_services[j];
                 if (service_idx < service_count) {
                     printf("    %s (quality %d)\n",
                            services[service_idx].hostname,
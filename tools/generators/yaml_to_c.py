@@ -13,6 +13,7 @@ This replaces the architectural violation of hardcoded service_database.c
 
 import os
 import sys
+import math
 import yaml
 import glob
 from typing import List, Dict, Any
@@ -118,6 +119,91 @@ def generate_coverage_bitmaps(services: List[Dict[str, Any]]) -> tuple[str, dict
 
     return "\n".join(c_code), coverage_data
 
+# Geometry constants (must match libntripatlas/src/ntrip_service_geometry.c)
+EARTH_RADIUS_KM = 6371.0
+Q30_SCALE = float(1 << 30)
+MAX_GREAT_CIRCLE_KM = 20016
+
+def to_q30(value: float) -> int:
+    """Convert a value in [-1, 1] to Q30, rounding half away from zero like llround()."""
+    value = max(-1.0, min(1.0, value))
+    scaled = value * Q30_SCALE
+    return int(math.floor(abs(scaled) + 0.5)) * (1 if scaled >= 0 else -1)
+
+def lat_lon_to_unit_vector(lat: float, lon: float) -> tuple:
+    """Q30 unit vector for a lat/lon in decimal degrees."""
+    lat_rad = lat * math.pi / 180.0
+    lon_rad = lon * math.pi / 180.0
+    cos_lat = math.cos(lat_rad)
+    return (to_q30(cos_lat * math.cos(lon_rad)),
+            to_q30(cos_lat * math.sin(lon_rad)),
+            to_q30(math.sin(lat_rad)))
+
+def unit_vector_distance_km(a: tuple, b: tuple) -> float:
+    """Great-circle distance between two Q30 unit vectors via the chord."""
+    chord = math.sqrt(sum(((a[i] - b[i]) / Q30_SCALE) ** 2 for i in range(3)))
+    return EARTH_RADIUS_KM * 2.0 * math.asin(min(1.0, chord / 2.0))
+
+def compute_service_geometry(lat_min: int, lat_max: int, lon_min: int, lon_max: int) -> dict:
+    """Precompute center vector and bounding radius from deg100 bounds."""
+    center = lat_lon_to_unit_vector((lat_min + lat_max) / 200.0, (lon_min + lon_max) / 200.0)
+
+    radius_km = MAX_GREAT_CIRCLE_KM
+    if lon_max - lon_min <= 18000:
+        max_km = 0.0
+        for lat in (lat_min, lat_max):
+            for lon in (lon_min, lon_max):
+                corner = lat_lon_to_unit_vector(lat / 100.0, lon / 100.0)
+                max_km = max(max_km, unit_vector_distance_km(center, corner))
+        radius_km = min(int(math.ceil(max_km)) + 1, MAX_GREAT_CIRCLE_KM)
+
+    radius_angle = radius_km / EARTH_RADIUS_KM
+    return {
+        'center': center,
+        'radius_km': radius_km,
+        'cos_radius_q30': to_q30(math.cos(radius_angle)),
+        'sin_radius_q30': to_q30(math.sin(radius_angle)),
+    }
+
+# Spatial index constants (must match libntripatlas/src/ntrip_spatial_indexing.c)
+SPATIAL_INDEX_LEVELS = 5
+SPATIAL_INDEX_MAX_SERVICES_PER_TILE = 64
+
+def lat_lon_to_tile(lat: float, lon: float, level: int) -> tuple:
+    """Tile coordinates at a level, as ntrip_atlas_lat_lon_to_tile() computes them."""
+    lat_tiles = 2 << level
+    lon_tiles = 4 << level
+    tile_lat = min(int((lat + 90.0) * lat_tiles / 180.0), lat_tiles - 1)
+    tile_lon = min(int((lon + 180.0) * lon_tiles / 360.0), lon_tiles - 1)
+    return tile_lat, tile_lon
+
+def compute_spatial_capacity(services: List[Dict[str, Any]]) -> tuple:
+    """Exact (tiles, assignments) when every regional service is added to the
+    tiles its bounding box overlaps at each level; global services are skipped."""
+    tile_counts = {}
+    for service in services:
+        if service.get('country') == 'GLOBAL':
+            continue
+        bbox = service['coverage']['bounding_box']
+        lat_min = int(bbox["lat_min"] * 100) / 100.0
+        lat_max = int(bbox["lat_max"] * 100) / 100.0
+        lon_min = int(bbox["lon_min"] * 100) / 100.0
+        lon_max = int(bbox["lon_max"] * 100) / 100.0
+
+        for level in range(SPATIAL_INDEX_LEVELS):
+            if lon_max < lon_min:  # Wraparound is treated as global at every level
+                min_tile = lat_lon_to_tile(-90.0, -180.0, level)
+                max_tile = lat_lon_to_tile(90.0, 180.0, level)
+            else:
+                min_tile = lat_lon_to_tile(lat_min, lon_min, level)
+                max_tile = lat_lon_to_tile(lat_max, lon_max, level)
+            for tile_lat in range(min_tile[0], max_tile[0] + 1):
+                for tile_lon in range(min_tile[1], max_tile[1] + 1):
+                    key = (level, tile_lat, tile_lon)
+                    tile_counts[key] = min(tile_counts.get(key, 0) + 1,
+                                           SPATIAL_INDEX_MAX_SERVICES_PER_TILE)
+    return len(tile_counts), sum(tile_counts.values())
+
 def generate_service_array(services: List[Dict[str, Any]], coverage_data: dict, coverage_code: str) -> str:
     """Generate C array of ntrip_service_compact_t structures."""
 
@@ -141,6 +227,7 @@ def generate_service_array(services: List[Dict[str, Any]], coverage_data: dict,
     c_code.append("")
     c_code.append('#include "ntrip_atlas.h"')
     c_code.append('#include "ntrip_coverage_bitmaps.h"')
+    c_code.append('#include "ntrip_generated_services.h"')
     c_code.append("")
 
     # Generate provider table
@@ -199,6 +286,10 @@ def generate_service_array(services: List[Dict[str, Any]], coverage_data: dict,
         if service.get('country') == 'GLOBAL':
             flags.append("NTRIP_FLAG_GLOBAL_SERVICE")
 
+        # NTRIP 2.0 casters that answer "/?STR;..." sourcetable filter queries
+        if endpoint.get('sourcetable_filter', False):
+            flags.append("NTRIP_FLAG_SOURCETABLE_FILTER")
+
         flag_value = " | ".join(flags) if flags else "0"
 
         # Map network type to integer
@@ -227,18 +318,50 @@ def generate_service_array(services: List[Dict[str, Any]], coverage_data: dict,
     c_code.append("};")
     c_code.append("")
 
-    # Generate accessor functions
-    c_code.append(f"#define GENERATED_SERVICE_COUNT {len(services)}")
+    # Generate precomputed geometry table (parallel to service array)
+    c_code.append("// Precomputed coverage geometry: Q30 center vector + bounding radius")
+    c_code.append("static const ntrip_service_geometry_t generated_service_geometry[] = {")
+    for i, service in enumerate(services):
+        bbox = service['coverage']['bounding_box']
+        geometry = compute_service_geometry(
+            int(bbox["lat_min"] * 100), int(bbox["lat_max"] * 100),
+            int(bbox["lon_min"] * 100), int(bbox["lon_max"] * 100)
+        )
+        x, y, z = geometry['center']
+        c_code.append(f"    {{ {{ {x}, {y}, {z} }}, {geometry['cos_radius_q30']}, "
+                      f"{geometry['sin_radius_q30']}, {geometry['radius_km']}, 0 }}"
+                      + ("," if i < len(services) - 1 else "") + f"  // {service['id']}")
+    c_code.append("};")
     c_code.append("")
+
+    # Generate accessor functions
     c_code.append("const ntrip_service_compact_t* get_generated_services(size_t* count) {")
-    c_code.append("    *count = GENERATED_SERVICE_COUNT;")
+    c_code.append("    *count = NTRIP_GENERATED_SERVICE_COUNT;")
     c_code.append("    return generated_services;")
     c_code.append("}")
     c_code.append("")
+    c_code.append("const ntrip_service_geometry_t* get_generated_service_geometry(size_t* count) {")
+    c_code.append("    *count = NTRIP_GENERATED_SERVICE_COUNT;")
+    c_code.append("    return generated_service_geometry;")
+    c_code.append("}")
+    c_code.append("")
     c_code.append("const char* get_provider_name(uint8_t provider_index) {")
     c_code.append(f"    if (provider_index >= {len(provider_map)}) return \"Unknown\";")
     c_code.append("    return provider_names[provider_index];")
     c_code.append("}")
+    c_code.append("")
+
+    # Spatial index storage sized exactly for this database
+    c_code.append("// Spatial index storage sized for the regional services above")
+    c_code.append("static uint32_t generated_spatial_storage[")
+    c_code.append("    (NTRIP_SPATIAL_INDEX_STORAGE_SIZE(NTRIP_GENERATED_SPATIAL_TILES,")
+    c_code.append("                                      NTRIP_GENERATED_SPATIAL_ASSIGNMENTS) + 3) / 4];")
+    c_code.append("")
+    c_code.append("ntrip_atlas_error_t init_generated_spatial_index(void) {")
+    c_code.append("    return ntrip_atlas_init_spatial_index_with_storage(")
+    c_code.append("        generated_spatial_storage, sizeof(generated_spatial_storage),")
+    c_code.append("        NTRIP_GENERATED_SPATIAL_TILES, NTRIP_GENERATED_SPATIAL_ASSIGNMENTS);")
+    c_code.append("}")
 
     return "\n".join(c_code)
 
@@ -258,6 +381,12 @@ def generate_header(services: List[Dict[str, Any]]) -> str:
     h_code.append("")
     h_code.append('#include "ntrip_atlas.h"')
     h_code.append("")
+    spatial_tiles, spatial_assignments = compute_spatial_capacity(services)
+    h_code.append("// Exact table capacities for this database")
+    h_code.append(f"#define NTRIP_GENERATED_SERVICE_COUNT {len(services)}")
+    h_code.append(f"#define NTRIP_GENERATED_SPATIAL_TILES {max(spatial_tiles, 1)}")
+    h_code.append(f"#define NTRIP_GENERATED_SPATIAL_ASSIGNMENTS {max(spatial_assignments, 1)}")
+    h_code.append("")
     h_code.append("/**")
     h_code.append(" * Get generated service database")
     h_code.append(" * @param count Output parameter for service count")
@@ -266,12 +395,25 @@ def generate_header(services: List[Dict[str, Any]]) -> str:
     h_code.append("const ntrip_service_compact_t* get_generated_services(size_t* count);")
     h_code.append("")
     h_code.append("/**")
+    h_code.append(" * Get precomputed geometry (parallel to the service array)")
+    h_code.append(" * @param count Output parameter for entry count")
+    h_code.append(" * @return Pointer to geometry array")
+    h_code.append(" */")
+    h_code.append("const ntrip_service_geometry_t* get_generated_service_geometry(size_t* count);")
+    h_code.append("")
+    h_code.append("/**")
     h_code.append(" * Get provider name by index")
     h_code.append(" * @param provider_index Provider index from service")
     h_code.append(" * @return Provider name string")
     h_code.append(" */")
     h_code.append("const char* get_provider_name(uint8_t provider_index);")
     h_code.append("")
+    h_code.append("/**")
+    h_code.append(" * Initialize the spatial index on storage sized for this database")
+    h_code.append(" * @return NTRIP_ATLAS_SUCCESS or error code")
+    h_code.append(" */")
+    h_code.append("ntrip_atlas_error_t init_generated_spatial_index(void);")
+    h_code.append("")
     h_code.append("#endif // NTRIP_GENERATED_SERVICES_H")
 
     return "\n".join(h_code)
@@ -181,6 +181,11 @@ class ServiceValidator:
                 if not isinstance(ssl, bool):
                     self.errors.append(f"{prefix}: SSL must be boolean, got: {type(ssl).__name__}")
 
+            # Optional NTRIP 2.0 sourcetable filter capability
+            if 'sourcetable_filter' in endpoint and not isinstance(endpoint['sourcetable_filter'], bool):
+                self.errors.append(f"{prefix}: sourcetable_filter must be boolean, "
+                                   f"got: {type(endpoint['sourcetable_filter']).__name__}")
+
             # Hostname validation
             if 'hostname' in endpoint:
                 hostname = endpoint['hostname']